@@ -0,0 +1,68 @@
+/*
+ * benchmark.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Benchmarks of the calculation hot paths, run from the command line without opening the window:
+//  FreeFluidsGui --bench-pure [result.json] [database]
+//  FreeFluidsGui --bench-mix [result.json] [database] [mixtures directory]
+//  FreeFluidsGui --self-check
+//The pure fluids are fixed substances and EOS of Substances.db3, at liquid, vapor, supercritical and near critical states.
+//Results are written as JSON: ns per call for each FreeFluidsC function, its cost in Helmholtz derivative evaluations,
+//the cost of a calculation point with all the rows of the substance table and with only density and enthalpy requested,
+//the throughput of complete calculation points for increasing number of threads, and the cost of the P,H flash by
+//FreeFluidsC and by the pure flash engine, with the engine batch throughput. For water, the P,H flash by IAPWS-IF97 is
+//timed too, and its deviations from IAPWS95 over regions 1 and 2 are reported.
+//The mixtures are the files saved by the mixture export (*.md), and Peng-Robinson systems of 2 to 15 components
+//generated from the database. Each equilibrium routine is run over a grid of conditions, reporting wall time, failures
+//to converge, iterations (for the solvers that count them) and the minimum Gr or tpd reached.
+//The self checks run the consistency checks that need no database file, as the write batch with failing rows.
+
+#ifndef BENCHMARK
+#define BENCHMARK
+
+#include <QtSql/QSqlDatabase>
+#include <QString>
+
+typedef struct{
+    double minTime;//seconds each measurement lasts at least
+    int repeats;//measurements of each case, the median is reported
+    int maxThreads;//maximum number of threads for the throughput test. 0 uses all the available cores
+} BenchSettings;
+
+//Fills the settings with the default values
+void BenchDefaultSettings(BenchSettings *set);
+
+//Pure substance benchmark. Writes the JSON result to fileName. Returns the number of fluids benchmarked, -1 if the file can not be written
+int BenchPureRun(QSqlDatabase *db,const BenchSettings *set,const QString &fileName);
+
+//Mixture equilibrium benchmark, on the mixture files (*.md) of mixDir and on generated systems of 2 to 15 components.
+//Writes the JSON result to fileName. Returns the number of mixtures benchmarked, -1 if the file can not be written
+int BenchMixRun(QSqlDatabase *db,const QString &mixDir,const QString &fileName);
+
+//Entry point for the command line benchmark options. Returns the process exit code
+int BenchMain(int argc,char *argv[]);
+
+//True if the command line asks for a benchmark, or for the self checks
+bool BenchRequested(int argc,char *argv[]);
+
+#endif // BENCHMARK
@@ -0,0 +1,94 @@
+/*
+ * calcarena.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Arena allocation for the temporaries of a calculation job (a mixture creation, a grid of points, a global optimization).
+//Allocation is a pointer increment inside a single block, and CalcArenaReset frees everything in O(1) at the end of
+//the job. If a job needs more than the block, overflow chunks are taken from the system and, at the next reset, the
+//block is enlarged to hold them all, so a repeated job of the same size runs without system allocations.
+//The counters allow to check that a loop of jobs is allocation free in the steady state.
+//An arena is used by one thread. CalcArenaThread gives a scratch arena for each thread.
+
+#ifndef CALCARENA
+#define CALCARENA
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+
+typedef struct CalcArenaChunk CalcArenaChunk;
+
+typedef struct{
+    char *base;//main block
+    size_t size;//size of the main block, bytes
+    size_t used;//bytes used in the main block
+    size_t peak;//maximum bytes used in a job, including the overflow chunks
+    CalcArenaChunk *extra;//overflow chunks in use, the last one first
+    size_t extraBytes;//bytes used in the overflow chunks
+    size_t pending;//size of the overflow chunks already freed, to be added to the main block when it is empty
+    uint64_t allocs;//number of allocations
+    uint64_t resets;//number of resets
+    uint64_t systemAllocs;//number of blocks and chunks taken from the system
+} CalcArena;
+
+//Position of an arena, see CalcArenaMark
+typedef struct{
+    size_t used;
+    CalcArenaChunk *extra;
+    size_t chunkUsed;
+    size_t extraBytes;
+} CalcArenaPos;
+
+//Initializes the arena with a main block of the given size. Size 0 delays the block until the first reset
+void CalcArenaInit(CalcArena *arena,size_t size);
+
+//Returns uninitialized memory of the given size and alignment (a power of 2), valid until the next reset
+void *CalcArenaAlloc(CalcArena *arena,size_t bytes,size_t align);
+
+//Position of the arena, to release later the allocations made after it, as a stack
+CalcArenaPos CalcArenaMark(const CalcArena *arena);
+
+//Releases the allocations made after the mark. When the arena becomes empty, the overflow chunks are merged in the main block
+void CalcArenaRelease(CalcArena *arena,const CalcArenaPos *mark);
+
+//Releases all the allocations of the job in O(1). Merges the overflow chunks into a larger main block
+void CalcArenaReset(CalcArena *arena);
+
+//Gives back all the memory to the system
+void CalcArenaFree(CalcArena *arena);
+
+//Scratch arena of the calling thread, for the solver temporaries. Released with CalcArenaMark/CalcArenaRelease
+CalcArena *CalcArenaThread();
+
+//Number of system allocations made by all the arenas since the program start
+uint64_t CalcArenaSystemAllocs();
+
+//Array of n objects of type T, value initialized (zero filled for plain structs). The destructors are not called,
+//so T must be trivially destructible
+template<class T> T *CalcArenaNew(CalcArena *arena,int n){
+    T *p=(T*)CalcArenaAlloc(arena,n*sizeof(T),alignof(T));
+    for(int i=0;i<n;i++) new(&p[i]) T();
+    return p;
+}
+
+#endif // CALCARENA
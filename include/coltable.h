@@ -0,0 +1,111 @@
+/*
+ * coltable.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Columnar binary tables of calculated properties, for loading by simulators without parsing text.
+//The header identifies the substance and EOS used, and describes each column by name and units. The values are
+//stored as doubles, column by column, split in chunks of a fixed number of rows that can be compressed (zlib, via
+//qCompress) independently. Without compression every column is contiguous and 64 bytes aligned, so a mapped file
+//gives direct access to the values without copying.
+//File layout: ColTableHeader, ColTableColumn[nColumns], for each column ColTableChunk[nChunks], and the chunks.
+
+#ifndef COLTABLE
+#define COLTABLE
+
+#include <stdint.h>
+#include <QFile>
+#include <QString>
+
+#define COL_TABLE_MAGIC 0x54434646 //"FFCT" in little endian files
+#define COL_TABLE_VERSION 1
+#define COL_TABLE_COMPRESSED 1 //flag: chunks compressed with qCompress
+#define COL_TABLE_FLOAT64 1 //column type
+#define COL_TABLE_MAX_CHUNK_ROWS (1<<27) //1 GiB chunks: qCompress and qUncompress take the size, and give the result, as int
+
+typedef struct{
+    int32_t magic;
+    int32_t version;
+    int32_t nColumns;
+    int32_t chunkRows;//rows in each chunk, the last one can be shorter. At most COL_TABLE_MAX_CHUNK_ROWS
+    int64_t nRows;
+    int32_t subsId;//substance and EOS ids in the database. 0 if not applicable
+    int32_t eosId;
+    int32_t eosModel;//enum FF_EosType
+    int32_t eos;//enum FF_EOS
+    int32_t flags;
+    int32_t reserved;
+    char subsName[64];//zero terminated
+    int64_t columnOffset;//from the beginning of the file, for ColTableColumn[nColumns]
+} ColTableHeader;
+
+typedef struct{
+    char name[56];//zero terminated
+    char unit[24];//zero terminated
+    int32_t type;
+    int32_t nChunks;
+    int64_t chunkOffset;//for ColTableChunk[nChunks]
+} ColTableColumn;
+
+typedef struct{
+    int64_t offset;//of the chunk data
+    int64_t bytes;//stored size, compressed or not
+} ColTableChunk;
+
+//Column to be written: name, units and nRows values
+typedef struct{
+    QString name;
+    QString unit;
+    const double *values;
+} ColTableColumnData;
+
+typedef struct{
+    QFile *file;//NULL if the table is not open
+    const uchar *base;//mapped file
+    qint64 size;
+} ColTable;
+
+//Writes the table. The header supplies the ids, name and flags, the counts and offsets are filled here.
+//chunkRows<=0 writes each column as a single chunk. Returns 0 if the file can not be written
+int ColTableWrite(const QString &fileName,const ColTableHeader *header,int nColumns,const ColTableColumnData columns[],int64_t nRows,int chunkRows);
+
+//Opens and maps a table. Returns 0 if the file does not exist or is not a valid table: the chunk directory must
+//agree with the rows in the header, and the uncompressed columns be contiguous
+int ColTableOpen(const QString &fileName,ColTable *table);
+
+//Unmaps and closes the table
+void ColTableClose(ColTable *table);
+
+//Header and column description of an open table
+const ColTableHeader *ColTableGetHeader(const ColTable *table);
+const ColTableColumn *ColTableGetColumn(const ColTable *table,int column);
+
+//Position of the column with the given name, -1 if not found
+int ColTableFind(const ColTable *table,const char *name);
+
+//Direct access to the values of an uncompressed column. NULL if the table is compressed
+const double *ColTableValues(const ColTable *table,int column);
+
+//Copies, decompressing if needed, the values of a column to values[nRows]. Returns 0 on error
+int ColTableRead(const ColTable *table,int column,double values[]);
+
+#endif // COLTABLE
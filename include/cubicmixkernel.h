@@ -0,0 +1,94 @@
+/*
+ * cubicmixkernel.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+//Specialized fugacity coefficients calculation for cubic EOS mixtures with quadratic mixing rules (VdW and
+//Panagiotopoulos-Reid). The matrix sqrt(ai*aj)(1-kij) is computed once per temperature, in aligned storage,
+//and the composition dependent part is done with vectorized matrix-vector products.
+//The kernel also keeps the hot parameters of the substances (critical constants, the active cubic EOS and alpha function
+//parameters and the interaction coefficients) as aligned arrays across the components. FF_MixData holds full copies of
+//all the data of every substance, so the loops reading from it stride across mostly cold bytes. It is only read when
+//the kernel is prepared, or for alpha functions without native implementation.
+
+#ifndef CUBICMIXKERNEL
+#define CUBICMIXKERNEL
+
+#include "FFbasic.h"
+#include "FFeosPure.h"
+#include "FFeosMix.h"
+
+#define CMK_DIM 16 //padded dimension of the vectors and matrices, enough for the 15 substances of a mixture
+
+enum CubicMixAlpha{CMK_ALPHA_SOAVE,CMK_ALPHA_PRSV1,CMK_ALPHA_TWU91,CMK_ALPHA_GENERIC};//alpha function of a substance
+enum CubicMixKijForm{CMK_KIJ_POL1,CMK_KIJ_POL2,CMK_KIJ_POL3};//kij=p0+p1*T+p2*T^2, p0+p1*T+p2/T^2, p0+p1/T+p2*T
+
+typedef struct{
+    int n;//number of substances
+    int nPad;//n rounded up to the vector width
+    int rule;//FF_VdW or FF_PR
+    double T;//temperature for which a, S and D have been calculated. 0 if not calculated
+    double u,w;//cubic EOS form: P=RT/(V-b)-a/(V^2+u*b*V+w*b^2)
+    alignas(32) double a[CMK_DIM];//pure substance a(T)
+    alignas(32) double b[CMK_DIM];//pure substance co-volume
+    alignas(32) double c[CMK_DIM];//pure substance volume translation
+    alignas(32) double S[CMK_DIM][CMK_DIM];//sqrt(ai*aj)(1-kij)+sqrt(ai*aj)(1-kji). Symmetric
+    alignas(32) double D[CMK_DIM][CMK_DIM];//sqrt(ai*aj)(kij-kji), only used by the Panagiotopoulos-Reid rule
+    alignas(32) double DT[CMK_DIM][CMK_DIM];//transpose of D
+    alignas(32) double da[CMK_DIM];//pure substance da/dT
+    //hot substance parameters, as structure of arrays
+    alignas(32) double Tc[CMK_DIM];//critical temperature
+    alignas(32) double Pc[CMK_DIM];//critical pressure
+    alignas(32) double omega[CMK_DIM];//acentric factor
+    alignas(32) double a0[CMK_DIM];//cubic EOS a constant: a(T)=a0*alpha(T)
+    alignas(32) double alphaTc[CMK_DIM];//critical temperature of the EOS, used by the alpha function
+    alignas(32) double alphaP[3][CMK_DIM];//alpha function parameters: m for Soave, m and k1 for PRSV1, L, M and N for Twu91
+    int alpha[CMK_DIM];//CubicMixAlpha
+    int kijForm;//CubicMixKijForm
+    alignas(32) double kijP[3][CMK_DIM][CMK_DIM];//coefficients of the interaction equation
+} CubicMixKernel;
+
+//Prepares the kernel for the mixture. Returns 0 if the mixture is not a cubic one with VdW or PR mixing rule
+int CubicMixKernelInit(FF_MixData *mix,CubicMixKernel *ker);
+
+//Calculates the temperature dependent part: a(T) and the interaction matrices. Does nothing if T has not changed
+void CubicMixKernelSetT(FF_MixData *mix,double T,CubicMixKernel *ker);
+
+//Natural logarithm of the fugacity coefficients, vectorized. Option 'l' for liquid, 'g' for gas, 's' for the stable root.
+//Returns also the compressibility factor, the molar volume and the state of the root used ('L','G','U').
+//Returns 0, with lnPhi not calculated, if there is no root with a physical volume (Z>B). The caller must then use the
+//FreeFluidsC mixture routine, as for the mixtures not supported by the kernel
+int CubicMixLnPhi(const CubicMixKernel *ker,double P,const double x[],char option,double lnPhi[],double *Z,double *V,char *state);
+
+//Interaction parameter kij and its temperature derivative, in the form selected for the mixture
+double CubicMixKijDer(FF_MixData *mix,int i,int j,double T,double *dkij);
+
+//The same from the coefficients kept in the kernel
+double CubicMixKernelKijDer(const CubicMixKernel *ker,int i,int j,double T,double *dkij);
+
+//Reference scalar implementation of the same calculation, straight from the definitions. Returns 0 as CubicMixLnPhi
+int CubicMixLnPhiRef(FF_MixData *mix,double T,double P,const double x[],char option,double lnPhi[],double *Z);
+
+//Checks the vectorized kernel against the scalar reference and against the FreeFluidsC generic path (FF_MixPhiEOS),
+//for liquid and gas roots. Returns the maximum absolute difference found in ln(phi) for each comparison
+void CubicMixKernelCheck(FF_MixData *mix,double T,double P,const double x[],double *maxDiffRef,double *maxDiffGeneric);
+
+#endif // CUBICMIXKERNEL
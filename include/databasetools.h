@@ -29,6 +29,7 @@
 
 #include "FFeosPure.h"
 #include "FFphysprop.h"
+#include "unifacstore.h"
 //#include "FFbaseClasses.h"
 
 //EOS conversion from QString to enumeration
@@ -55,6 +56,43 @@ void GetCorrDataByType(const int *IdProduct,const QString *type,QSqlDatabase *db
 
 void GetCorrDataById(FF_Correlation *corr,QSqlDatabase *db);
 
+//Correlation of the substance for a physical property name of the database ("Cp0","Vp","Ldens"...). NULL if not used
+FF_Correlation *CorrelationForProperty(FF_SubstanceData *subsData,const QString &property);
+
+//Get a substance for unattended use: basic data, the preferred correlation for each property, and the first EOS of each type.
+//The model is set to the multiparameter EOS if available, else to the SAFT one, else to the cubic one
+void GetPreferredData(int id,FF_SubstanceData *subsData,QSqlDatabase *db);
+
+
+//Batch of insertions on the database. The rows are grouped in transactions, and each insert statement is prepared once
+typedef struct{
+    QSqlDatabase *db;
+    int flushSize;//rows per transaction
+    int pending;//rows added since the last commit
+    bool inTransaction;
+    QSqlQuery *cubicInsert,*saftInsert,*corrInsert;//prepared statements, created on first use
+    int nWritten,nFailed;//rows committed and rows rejected
+} DataBaseWriteBatch;
+
+//Prepares a batch of insertions on the database. Rows are committed in transactions of flushSize rows.
+//If wal is true and the database is SQLite, it is changed to write ahead log journaling
+int DataBaseWriteBatchBegin(QSqlDatabase *db,int flushSize,bool wal,DataBaseWriteBatch *batch);
+
+//Adds a new eos to the batch. Returns 0 if the insertion failed
+int DataBaseWriteBatchAddEos(DataBaseWriteBatch *batch,int idSubs,enum FF_EosType eosType,void *eosData,double *Tmin,double *Tmax, QString *description);
+
+//Adds a new correlation to the batch. Returns 0 if the insertion failed
+int DataBaseWriteBatchAddCorr(DataBaseWriteBatch *batch,int idSubs,FF_Correlation *corr,double *Tmin,double *Tmax, QString *description);
+
+//Commits the rows added since the last flush. Returns 0 if the commit failed
+int DataBaseWriteBatchFlush(DataBaseWriteBatch *batch);
+
+//Commits the pending rows and releases the prepared statements. Returns the number of rows written
+int DataBaseWriteBatchEnd(DataBaseWriteBatch *batch);
+
+//Checks the write batch on an in memory database, with failing rows inside transactions of several rows.
+//Returns 1 if the rows counted as written are the rows stored. report receives the details
+int DataBaseWriteBatchCheck(QString *report);
 
 //Adds a new eos to the database
 void AddEosToDataBase(int idSubs,enum FF_EosType eosType,void *eosData,double *Tmin,double *Tmax, QString *description,QSqlDatabase *db);
@@ -65,5 +103,8 @@ void AddCorrToDataBase(int idSubs,FF_Correlation *corr,double *Tmin,double *Tmax
 //Writes the Unifac information from the database to a file from where it can be extracted using C
 void WriteUnifacToFile(QSqlDatabase *db);
 
+//Writes the Unifac information from the database to a binary store, to be memory mapped with UnifacStoreOpen. Returns 0 on failure
+int WriteUnifacToBinary(QSqlDatabase *db,const QString &fileName);
+
 #endif // DATABASETOOLS
 
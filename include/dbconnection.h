@@ -0,0 +1,52 @@
+/*
+ * dbconnection.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Database connections for worker threads.
+//A QSqlDatabase can only be used from the thread that created it. The parameters of the main connection are registered
+//once, and each worker thread asking for a connection gets its own one, opened on first use with the same driver and
+//database, and closed when the thread finishes. The main thread keeps using the main connection.
+//Prepared statements are cached per thread and connection, so a worker loading many substances prepares each query once.
+
+#ifndef DBCONNECTION
+#define DBCONNECTION
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql>
+
+//Registers the main connection. To be called once it is open, from the thread that owns it
+void DbConnectionRegister(QSqlDatabase *mainDb);
+
+//Connection for the calling thread: the main one for the registering thread, else a connection of its own.
+//Returns NULL if no connection has been registered or it can not be opened
+QSqlDatabase *DbConnectionForThread();
+
+//Prepared statement for the sql text on the connection, created on first use by the calling thread. NULL if it can not be
+//prepared. The bound values are kept between uses, and finish() should be called when the results have been read
+QSqlQuery *DbConnectionStatement(QSqlDatabase *db,const QString &sql);
+
+//Releases the cached statements and, for a worker thread, closes its connection. It is done automatically when a
+//worker thread ends, but the main thread must call it before closing the main connection
+void DbConnectionRelease();
+
+#endif // DBCONNECTION
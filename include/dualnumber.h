@@ -0,0 +1,186 @@
+/*
+ * dualnumber.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Forward mode automatic differentiation with N directions. A Dual<N> holds a value and its derivatives with respect
+//to N independent variables, that are seeded with DualVar. Any expression written with the operators and functions
+//defined here gives its exact derivatives along with the value.
+//It is used by the mixture saturation solver, for the T and P derivatives of ln(phi). The pure substance Helmholtz
+//routines are not instantiated on Dual: FF_ArrDerCubic/SAFT/SWTV are C routines taking doubles, and the models of
+//eoskernel.h already return the analytic first and second derivatives, that cover every property of the substance
+//table. dPsat/dT comes from Clapeyron equation.
+
+#ifndef DUALNUMBER
+#define DUALNUMBER
+
+#include <math.h>
+
+template<int N> struct Dual{
+    double v;//value
+    double d[N];//derivatives
+};
+
+//A constant
+template<int N> inline Dual<N> DualConst(double v){
+    Dual<N> r;
+    r.v=v;
+    for(int k=0;k<N;k++) r.d[k]=0;
+    return r;
+}
+
+//The independent variable number k
+template<int N> inline Dual<N> DualVar(double v,int k){
+    Dual<N> r=DualConst<N>(v);
+    r.d[k]=1;
+    return r;
+}
+
+//Chain rule: f(a) with f'(a)=df
+template<int N> inline Dual<N> DualChain(const Dual<N> &a,double f,double df){
+    Dual<N> r;
+    r.v=f;
+    for(int k=0;k<N;k++) r.d[k]=df*a.d[k];
+    return r;
+}
+
+template<int N> inline Dual<N> operator+(const Dual<N> &a,const Dual<N> &b){
+    Dual<N> r;
+    r.v=a.v+b.v;
+    for(int k=0;k<N;k++) r.d[k]=a.d[k]+b.d[k];
+    return r;
+}
+
+template<int N> inline Dual<N> operator-(const Dual<N> &a,const Dual<N> &b){
+    Dual<N> r;
+    r.v=a.v-b.v;
+    for(int k=0;k<N;k++) r.d[k]=a.d[k]-b.d[k];
+    return r;
+}
+
+template<int N> inline Dual<N> operator-(const Dual<N> &a){
+    Dual<N> r;
+    r.v=-a.v;
+    for(int k=0;k<N;k++) r.d[k]=-a.d[k];
+    return r;
+}
+
+template<int N> inline Dual<N> operator*(const Dual<N> &a,const Dual<N> &b){
+    Dual<N> r;
+    r.v=a.v*b.v;
+    for(int k=0;k<N;k++) r.d[k]=a.d[k]*b.v+a.v*b.d[k];
+    return r;
+}
+
+template<int N> inline Dual<N> operator/(const Dual<N> &a,const Dual<N> &b){
+    Dual<N> r;
+    double ib=1/b.v;
+    r.v=a.v*ib;
+    for(int k=0;k<N;k++) r.d[k]=(a.d[k]-r.v*b.d[k])*ib;
+    return r;
+}
+
+template<int N> inline Dual<N> operator+(const Dual<N> &a,double b){
+    Dual<N> r=a;
+    r.v+=b;
+    return r;
+}
+
+template<int N> inline Dual<N> operator+(double a,const Dual<N> &b){
+    return b+a;
+}
+
+template<int N> inline Dual<N> operator-(const Dual<N> &a,double b){
+    Dual<N> r=a;
+    r.v-=b;
+    return r;
+}
+
+template<int N> inline Dual<N> operator-(double a,const Dual<N> &b){
+    Dual<N> r=-b;
+    r.v+=a;
+    return r;
+}
+
+template<int N> inline Dual<N> operator*(const Dual<N> &a,double b){
+    Dual<N> r;
+    r.v=a.v*b;
+    for(int k=0;k<N;k++) r.d[k]=a.d[k]*b;
+    return r;
+}
+
+template<int N> inline Dual<N> operator*(double a,const Dual<N> &b){
+    return b*a;
+}
+
+template<int N> inline Dual<N> operator/(const Dual<N> &a,double b){
+    return a*(1/b);
+}
+
+template<int N> inline Dual<N> operator/(double a,const Dual<N> &b){
+    return DualChain(b,a/b.v,-a/(b.v*b.v));
+}
+
+template<int N> inline Dual<N> &operator+=(Dual<N> &a,const Dual<N> &b){
+    a=a+b;
+    return a;
+}
+
+template<int N> inline Dual<N> &operator-=(Dual<N> &a,const Dual<N> &b){
+    a=a-b;
+    return a;
+}
+
+template<int N> inline Dual<N> &operator*=(Dual<N> &a,const Dual<N> &b){
+    a=a*b;
+    return a;
+}
+
+template<int N> inline Dual<N> log(const Dual<N> &a){
+    return DualChain(a,log(a.v),1/a.v);
+}
+
+template<int N> inline Dual<N> exp(const Dual<N> &a){
+    double e=exp(a.v);
+    return DualChain(a,e,e);
+}
+
+template<int N> inline Dual<N> sqrt(const Dual<N> &a){
+    double s=sqrt(a.v);
+    return DualChain(a,s,0.5/s);
+}
+
+template<int N> inline Dual<N> pow(const Dual<N> &a,double b){
+    double p=pow(a.v,b);
+    return DualChain(a,p,b*p/a.v);
+}
+
+//Value of a plain double, so templates can be instantiated for double and for Dual<N>
+inline double DualValue(double a){
+    return a;
+}
+
+template<int N> inline double DualValue(const Dual<N> &a){
+    return a.v;
+}
+
+#endif // DUALNUMBER
@@ -0,0 +1,313 @@
+/*
+ * eoskernel.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+//Compile time specialized pure substance EOS layer.
+//Each EOS family/variant is a small model class with an inline ArrDer(T,V,result) function, giving the reduced
+//residual Helmholtz energy and its derivatives in the same order as FF_ArrDerCubic/SAFT/SWTV:
+//Arr, dArr/dV, d2Arr/dV2, dArr/dT, d2Arr/dT2, d2Arr/dTdV.
+//The model is selected once, by EosKernelBuild, when the substance EOS is fixed. Solver loops written as templates
+//on the model class, and entered once per call by EosKernelDispatch, get the Helmholtz derivatives fully inlined,
+//without switching on the EOS in every evaluation. The function pointers of EosKernel are for single evaluations, and
+//they dispatch in every call.
+//Variants without a native implementation use model classes that call the FreeFluidsC functions directly. This is the
+//case of SAFT, and of the cubic and multiparameter EOS that do not pass the check against FreeFluidsC.
+
+#ifndef EOSKERNEL
+#define EOSKERNEL
+
+#include <math.h>
+#include "FFbasic.h"
+#include "FFeosPure.h"
+#include "eostcache.h"
+
+//Cubic EOS: P=RT/(V-b)-Theta(T)/(V^2+u*b*V+w*b^2), with volume translation c
+typedef struct{
+    double a,b,c,u,w;
+    double Tc;
+    double d1,d2,D;//(u+D)/2, (u-D)/2, sqrt(u^2-4w)
+} EosCubicConst;
+
+//Soave type alpha function: (1+m(1-Tr^0.5))^2. Used by PR76, PR78 and SRK
+struct EosAlphaSoave{
+    double m;
+    inline void Alpha(const EosCubicConst &k,double T,double *al,double *dal,double *d2al) const{
+        double s=sqrt(T/k.Tc);
+        double ds=0.5/(s*k.Tc);
+        double d2s=-0.25/(s*s*s*k.Tc*k.Tc);
+        double f=1+m*(1-s);
+        double df=-m*ds;
+        double d2f=-m*d2s;
+        *al=f*f;
+        *dal=2*f*df;
+        *d2al=2*(df*df+f*d2f);
+    }
+};
+
+//Stryjek-Vera alpha function: kappa=m+k1(1+Tr^0.5)(0.7-Tr)
+struct EosAlphaPRSV1{
+    double m,k1;
+    inline void Alpha(const EosCubicConst &k,double T,double *al,double *dal,double *d2al) const{
+        double Tr=T/k.Tc;
+        double s=sqrt(Tr);
+        double ds=0.5/(s*k.Tc);
+        double d2s=-0.25/(s*s*s*k.Tc*k.Tc);
+        double kappa=m+k1*(1+s)*(0.7-Tr);
+        double dkappa=k1*(ds*(0.7-Tr)-(1+s)/k.Tc);
+        double d2kappa=k1*(d2s*(0.7-Tr)-2*ds/k.Tc);
+        double f=1+kappa*(1-s);
+        double df=dkappa*(1-s)-kappa*ds;
+        double d2f=d2kappa*(1-s)-2*dkappa*ds-kappa*d2s;
+        *al=f*f;
+        *dal=2*f*df;
+        *d2al=2*(df*df+f*d2f);
+    }
+};
+
+//Twu 1991 alpha function: Tr^(N(M-1))*exp(L(1-Tr^(NM)))
+struct EosAlphaTwu91{
+    double L,M,N;
+    inline void Alpha(const EosCubicConst &k,double T,double *al,double *dal,double *d2al) const{
+        double Tr=T/k.Tc;
+        double TrNM=pow(Tr,N*M);
+        double g=N*(M-1)*log(Tr)+L*(1-TrNM);
+        double dg=N*(M-1)/T-L*N*M*TrNM/T;
+        double d2g=-N*(M-1)/(T*T)-L*N*M*(N*M-1)*TrNM/(T*T);
+        *al=exp(g);
+        *dal=*al*dg;
+        *d2al=*al*(d2g+dg*dg);
+    }
+};
+
+//Helmholtz derivatives of a cubic EOS once Theta and its temperature derivatives are known
+inline void EosCubicArrDer(const EosCubicConst &k,double Theta,double dTheta,double d2Theta,double T,double V,double result[6]){
+    double Ve=V+k.c;
+    double V1=Ve+k.d1*k.b,V2=Ve+k.d2*k.b;
+    double Q=log(V1/V2);
+    double dQ=1/V1-1/V2;
+    double d2Q=-1/(V1*V1)+1/(V2*V2);
+    double RbD=R*k.b*k.D;
+    double G=Theta/(RbD*T);
+    double dG=(dTheta/T-Theta/(T*T))/RbD;
+    double d2G=(d2Theta/T-2*dTheta/(T*T)+2*Theta/(T*T*T))/RbD;
+    result[0]=-log(1-k.b/Ve)-G*Q;
+    result[1]=1/Ve-1/(Ve-k.b)-G*dQ;
+    result[2]=-1/(Ve*Ve)+1/((Ve-k.b)*(Ve-k.b))-G*d2Q;
+    result[3]=-dG*Q;
+    result[4]=-d2G*Q;
+    result[5]=-dG*dQ;
+}
+
+//Cubic EOS with the alpha function given at compile time
+template<class Alpha> struct EosCubic{
+    EosCubicConst k;
+    Alpha alpha;
+    inline void ThetaDeriv(double T,double *Theta,double *dTheta,double *d2Theta) const{
+        double al,dal,d2al;
+        alpha.Alpha(k,T,&al,&dal,&d2al);
+        *Theta=k.a*al;
+        *dTheta=k.a*dal;
+        *d2Theta=k.a*d2al;
+    }
+    inline void ArrDer(double T,double V,double result[6]) const{
+        double Theta,dTheta,d2Theta;
+        ThetaDeriv(T,&Theta,&dTheta,&d2Theta);
+        EosCubicArrDer(k,Theta,dTheta,d2Theta,T,V,result);
+    }
+};
+
+//Cubic EOS calculated by FreeFluidsC, for the alpha functions without native implementation
+struct EosCubicGeneric{
+    FF_CubicEOSdata *data;
+    inline void ArrDer(double T,double V,double result[6]) const{
+        FF_CubicParam param;
+        EosTCacheCubic(data,T,&param);
+        FF_ArrDerCubic(&T,&V,&param,result);
+    }
+};
+
+//SAFT family, evaluated by FreeFluidsC: there is no native implementation, dispatch is the only gain
+struct EosSAFT{
+    FF_SaftEOSdata *data;
+    inline void ArrDer(double T,double V,double result[6]) const{
+        FF_ArrDerSAFT(&T,&V,data,result);
+    }
+};
+
+#define EOS_SW_MAXTERMS 64 //a multiple of the vector width, so the term arrays can always be padded
+#define EOS_SW_MAXFINAL 4 //non analytical terms
+#define EOS_SW_MAXC 16 //distinct delta exponents of the exponential terms
+
+//Multiparameter EOS with polynomial, exponential and gaussian terms, Arr=sum of n*delta^d*tau^t*exp(E(delta)+F(tau)),
+//and the non analytical terms of IAPWS95 type, n*Delta^b*delta*psi.
+//The term parameters are kept by type in contiguous arrays, padded with null terms to the vector width. PhiDer computes
+//ln(delta), ln(tau) and each distinct delta^c once, and evaluates the exponentials of the terms with SIMD kernels
+struct EosSW{
+    double tRef,rhoRef;
+    int nPol,nExp,nSpec,nFinal;
+    int nPad;//number of terms rounded up to the vector width
+    int nC;//distinct exponents of the exponential terms
+    double cVal[EOS_SW_MAXC];
+    int cIdx[EOS_SW_MAXTERMS];//index in cVal of the exponent of each exponential term
+    double n[EOS_SW_MAXTERMS],d[EOS_SW_MAXTERMS],t[EOS_SW_MAXTERMS],c[EOS_SW_MAXTERMS];
+    double a[EOS_SW_MAXTERMS],e[EOS_SW_MAXTERMS],b[EOS_SW_MAXTERMS],g[EOS_SW_MAXTERMS];
+    double nf[EOS_SW_MAXFINAL],af[EOS_SW_MAXFINAL],bf[EOS_SW_MAXFINAL],Af[EOS_SW_MAXFINAL];
+    double Bf[EOS_SW_MAXFINAL],Cf[EOS_SW_MAXFINAL],Df[EOS_SW_MAXFINAL],betaf[EOS_SW_MAXFINAL];
+    //Pads the term arrays and groups the exponents of the exponential terms. Returns 0 if there are too many distinct exponents
+    int Prepare();
+    //Reduced Helmholtz derivatives in delta and tau: phi, phi_d, phi_dd, phi_t, phi_tt, phi_dt. Vectorized
+    void PhiDer(double delta,double tau,double phi[6]) const;
+    //Contribution of the non analytical terms, added to phi
+    void PhiDerFinal(double delta,double tau,double phi[6]) const;
+    //Scalar reference of PhiDer, term by term
+    inline void PhiDerRef(double delta,double tau,double phi[6]) const{
+        int i,nT=nPol+nExp+nSpec;
+        double lnD=log(delta),lnT=log(tau);
+        for(i=0;i<6;i++) phi[i]=0;
+        for(i=0;i<nT;i++){
+            double E=0,dE=0,d2E=0,F=0,dF=0,d2F=0;
+            if(i>=nPol+nExp){//gaussian
+                E=-a[i]*(delta-e[i])*(delta-e[i]);
+                dE=-2*a[i]*(delta-e[i]);
+                d2E=-2*a[i];
+                F=-b[i]*(tau-g[i])*(tau-g[i]);
+                dF=-2*b[i]*(tau-g[i]);
+                d2F=-2*b[i];
+            }
+            else if(i>=nPol){//exponential
+                double dc=exp(c[i]*lnD);
+                E=-dc;
+                dE=-c[i]*dc/delta;
+                d2E=-c[i]*(c[i]-1)*dc/(delta*delta);
+            }
+            double v=n[i]*exp(d[i]*lnD+t[i]*lnT+E+F);
+            double gd=d[i]/delta+dE;
+            double gt=t[i]/tau+dF;
+            phi[0]+=v;
+            phi[1]+=v*gd;
+            phi[2]+=v*(gd*gd-d[i]/(delta*delta)+d2E);
+            phi[3]+=v*gt;
+            phi[4]+=v*(gt*gt-t[i]/(tau*tau)+d2F);
+            phi[5]+=v*gd*gt;
+        }
+        PhiDerFinal(delta,tau,phi);
+    }
+    inline void ArrDer(double T,double V,double result[6]) const{
+        double phi[6];
+        double delta=1/(V*rhoRef),tau=tRef/T;
+        PhiDer(delta,tau,phi);
+        result[0]=phi[0];
+        result[1]=-phi[1]*delta/V;
+        result[2]=(phi[2]*delta+2*phi[1])*delta/(V*V);
+        result[3]=-phi[3]*tau/T;
+        result[4]=(phi[4]*tau+2*phi[3])*tau/(T*T);
+        result[5]=phi[5]*delta*tau/(V*T);
+    }
+};
+
+//Multiparameter EOS evaluated by FreeFluidsC (too many terms, or not matching the native evaluation)
+struct EosSWGeneric{
+    FF_SWEOSdata *data;
+    inline void ArrDer(double T,double V,double result[6]) const{
+        FF_ArrDerSWTV(&T,&V,data,result);
+    }
+};
+
+//Pressure from any model
+template<class Model> inline double EosPressure(const Model &m,double T,double V){
+    double r[6];
+    m.ArrDer(T,V,r);
+    return R*T*(1/V-r[1]);
+}
+
+//Batch of Helmholtz derivatives, the model is inlined in the loop
+template<class Model> void EosArrDerBatch(const Model &m,int n,const double T[],const double V[],double result[][6]){
+    for(int i=0;i<n;i++) m.ArrDer(T[i],V[i],result[i]);
+}
+
+enum EosKernelVariant{EOS_KER_NONE,EOS_KER_SOAVE,EOS_KER_PRSV1,EOS_KER_TWU91,EOS_KER_CUBICGEN,EOS_KER_SAFT,EOS_KER_SW,EOS_KER_SWGEN};
+
+//The EOS of a substance, resolved to one model class. The function pointers are instantiations of the templates for that class
+typedef struct EosKernel EosKernel;
+struct EosKernel{
+    enum EosKernelVariant variant;
+    void (*arrDer)(const EosKernel *ker,double T,double V,double result[6]);
+    void (*arrDerBatch)(const EosKernel *ker,int n,const double T[],const double V[],double result[][6]);
+    double (*pressure)(const EosKernel *ker,double T,double V);
+    EosCubic<EosAlphaSoave> soave;
+    EosCubic<EosAlphaPRSV1> prsv1;
+    EosCubic<EosAlphaTwu91> twu91;
+    EosCubicGeneric cubicGen;
+    EosSAFT saft;
+    EosSW sw;
+    EosSWGeneric swGen;
+};
+
+//Model of the kernel for each model class, for the code templated on the model
+template<class Model> struct EosKernelModel;
+template<> struct EosKernelModel<EosCubic<EosAlphaSoave> >{
+    static const EosCubic<EosAlphaSoave> &Get(const EosKernel *ker){return ker->soave;}
+};
+template<> struct EosKernelModel<EosCubic<EosAlphaPRSV1> >{
+    static const EosCubic<EosAlphaPRSV1> &Get(const EosKernel *ker){return ker->prsv1;}
+};
+template<> struct EosKernelModel<EosCubic<EosAlphaTwu91> >{
+    static const EosCubic<EosAlphaTwu91> &Get(const EosKernel *ker){return ker->twu91;}
+};
+template<> struct EosKernelModel<EosCubicGeneric>{
+    static const EosCubicGeneric &Get(const EosKernel *ker){return ker->cubicGen;}
+};
+template<> struct EosKernelModel<EosSAFT>{
+    static const EosSAFT &Get(const EosKernel *ker){return ker->saft;}
+};
+template<> struct EosKernelModel<EosSW>{
+    static const EosSW &Get(const EosKernel *ker){return ker->sw;}
+};
+template<> struct EosKernelModel<EosSWGeneric>{
+    static const EosSWGeneric &Get(const EosKernel *ker){return ker->swGen;}
+};
+
+//Single dispatch on the variant: returns Op<Model>::Run(args) for the model class of the kernel. Op<Model>::Run is a
+//solver templated on the model, that takes the model with EosKernelModel<Model>::Get
+template<template<class> class Op,class... Args> inline auto EosKernelDispatch(const EosKernel *ker,Args... args)->decltype(Op<EosSW>::Run(args...)){
+    switch(ker->variant){
+    case EOS_KER_SOAVE: return Op<EosCubic<EosAlphaSoave> >::Run(args...);
+    case EOS_KER_PRSV1: return Op<EosCubic<EosAlphaPRSV1> >::Run(args...);
+    case EOS_KER_TWU91: return Op<EosCubic<EosAlphaTwu91> >::Run(args...);
+    case EOS_KER_CUBICGEN: return Op<EosCubicGeneric>::Run(args...);
+    case EOS_KER_SAFT: return Op<EosSAFT>::Run(args...);
+    case EOS_KER_SW: return Op<EosSW>::Run(args...);
+    default: return Op<EosSWGeneric>::Run(args...);
+    }
+}
+
+//Selects and prepares the model for the substance EOS. The native models are checked against FreeFluidsC at build time,
+//falling back to the model calling FreeFluidsC if they disagree. Returns 0 if the substance has no EOS
+int EosKernelBuild(FF_SubstanceData *subs,EosKernel *ker);
+
+//Selects and prepares the model for cubic EOS data alone, as held in FF_MixData. Returns 0 if the EOS is not defined
+int EosKernelBuildCubic(FF_CubicEOSdata *data,EosKernel *ker);
+
+//Name of the variant selected, for information
+const char *EosKernelVariantName(const EosKernel *ker);
+
+#endif // EOSKERNEL
@@ -0,0 +1,47 @@
+/*
+ * eostcache.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Temperature level cache of the EOS parameters.
+//The cubic parameters of a substance (a, b, c, u, w) and Theta(T) with its temperature derivatives are kept per
+//substance and temperature, so repeated calls at the same T (isothermal flashes, bubble P, stability checks)
+//do not call FF_FixedParamCubic and FF_ThetaDerivCubic again. An entry is reused only if the temperature and the
+//substance parameters are the same, so a change in the parameters invalidates it automatically.
+//The cache is private to each thread, so it can be used from the worker threads without locking.
+
+#ifndef EOSTCACHE
+#define EOSTCACHE
+
+#include "FFbasic.h"
+#include "FFeosPure.h"
+
+//Cubic parameters with Theta, dTheta/dT and d2Theta/dT2 at T, from the cache of the calling thread when possible
+void EosTCacheCubic(const FF_CubicEOSdata *data,double T,FF_CubicParam *param);
+
+//Empties the cache of the calling thread
+void EosTCacheClear();
+
+//Hits and misses of the cache of the calling thread, since the last clear
+void EosTCacheStats(long *hits,long *misses);
+
+#endif // EOSTCACHE
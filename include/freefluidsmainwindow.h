@@ -39,6 +39,22 @@
 #include "FFequilibrium.h"
 //#include "FFbaseClasses.h"
 #include "databasetools.h"
+#include "dbconnection.h"
+#include "globalopt.h"
+#include "cubicmixkernel.h"
+#include "eoskernel.h"
+#include "unifackernel.h"
+#include "satsolver.h"
+#include "solvertelemetry.h"
+#include "satcache.h"
+#include "coltable.h"
+#include "modelicaexport.h"
+#include "subsindex.h"
+#include "perfcounters.h"
+#include "calcarena.h"
+#include "pureflash.h"
+#include "if97.h"
+#include "subscalcplan.h"
 
 
 namespace Ui {
@@ -54,13 +70,16 @@ public:
     ~FreeFluidsMainWindow();
 
 private slots:
+    void cbSubsCalcSelSearch(const QString &text);//Slot for the substance search, as the text is typed
+    void cbSubsCalcSelFound(const QModelIndex &index);//Slot for the selection of a substance found by the search
     void cbSubsCalcSelLoad(int);//Slot for loading the existing EOS and Cp0 correlations for the selected substance
     void cbSubsCalcEosUpdate(int position);//Slot for eos data update
     void cbSubsCalcCp0Update(int position);//Slot for cp0 data update
     void twSubsCalcUpdate();//Slot for substance calculation, and display in table
     void btnSubsCalcAltCalc();//Slot for alternative calculation (no from T andP)
-    void twSubsCalcExport();//Slot for table content exportation in csv ; delimited format
+    void twSubsCalcExport();//Slot for table content exportation in csv ; delimited format, or columnar binary
     void btnSubsCalcExportSubs();//Slot for substance exportation in binary format
+    void twSubsCalcRowMenu(const QPoint &pos);//Context menu of the table rows, to leave rows out of the calculation
     void btnSubsCalcTransfer();//Slot for transfer from eos calculation to correlation calculation data tables
     void cbSubsToolsCorrLoad(int position);//Slot for correlation selection load on substance and screen
     void btnSubsToolsFillTable();//Slot for filling table with data from correlations
@@ -108,6 +127,13 @@ private slots:
     //Slot for checking stability of the results obtained
     void mixResStabCheck();
     void on_actionDisplay_license_triggered();
+    void on_actionBenchmark_global_optimizers_triggered();
+    void on_actionCheck_cubic_mixture_kernel_triggered();
+    void on_actionCheck_UNIFAC_kernel_triggered();
+    void on_actionRegenerate_UNIFAC_store_triggered();
+    void on_actionBulk_Modelica_export_triggered();
+    void on_actionRecord_trace_toggled(bool checked);
+    void perfShow();//Displays the counters of the last action in the performance dock
 
 private:
     Ui::FreeFluidsMainWindow *ui;
@@ -115,9 +141,16 @@ private:
 private:
     //general usage
     QSqlDatabase db;
-    QSqlQueryModel *subsListModel;
+    UnifacStore unifacStore;//memory mapped UNIFAC parameters
+    SubsIndex subsIndex;//search index of the substances, by name, CAS number, formula and synonyms
+    SubsListModel *subsListModel;
+    SubsMatchModel *subsMatchModel;//substances found by the last search
     QDoubleValidator *presBarValidator;
     QDoubleValidator *tempCValidator;
+    QDockWidget *perfDock;//performance counters of the last action
+    QLabel *perfSummary;
+    QTableWidget *perfTable;
+    void perfStart(const char *action);//Starts counting for a new action, and schedules the display of its counters
 
     //Substance calculation usage
     FF_SubstanceData *subsData;//To hold substance information, for substance calculation or addition to mixture
@@ -127,6 +160,13 @@ private:
     QSqlQueryModel *subsCalcCp0Model;
     QTableView *tvSubsCalcSelCp0;
     QCompleter *subsCompleter;
+    EosKernel subsEosKernel;//EOS model of the substance, resolved at calculation time
+    PureFlashEngine *subsFlash;//inverse flash of the substance, for the alternative calculation
+    int subsIF97;//1 if the IAPWS-IF97 region equations have been selected for water, instead of IAPWS95
+    double subsCalcValues[57][11];//numerical results of the last substance calculation, by table row and point. NaN if not calculated
+    SubsCalcMask subsCalcRows;//rows of the table in the plan of the last substance calculation
+    void subsCalcSetValue(int row,int point,double value);//Writes a result to the table and keeps its value, if the row is in the plan
+    int twSubsCalcExportColumnar(const QString &fileName,bool compress);//Writes the results in columnar binary format
 
     //Subst tools usage
     QSqlQueryModel *subsToolsCorrModel;
@@ -136,6 +176,7 @@ private:
     //QDataWidgetMapper *mapper;
 
     //Mixture calculation usage
+    CalcArena mixArena;//holds the substances and temporaries of the mixture creation, reset at each creation
     FF_SubstanceData **subsPoint;
     FF_SubstanceData *substance;
     FF_MixData *mix;
@@ -148,7 +189,16 @@ private:
     QSqlQueryModel *mixIntParamSelModel;//model for display the interaction parameters available for the pair, in the combobox
     QTableView *tvMixIntParamSel;//table for display the interaction parameters available for the pair
 
+    SatWarmStart mixSatWarm[4];//last bubble P, dew P, bubble T and dew T solutions, used as warm start
+    UnifacKernel mixUnifac[4];//precompiled UNIFAC Std, PSRK, Dortmund and NIST models of the mixture, built with the system
     int eosSel[15],cp0Sel[15];//the number of row selected(in the combobox) for eos and cp0 correlation, for each possible substance
+    QString unifacDbFile();//Database file the UNIFAC store is generated from. Empty if the database is not a file
+    void openUnifacStore();//Opens the UNIFAC store next to the database, generating it again if it does not match
+    const UnifacKernel *mixUnifacKernel();//The precompiled UNIFAC model for the selected activity model, or NULL
+    SolverTelemetry mixTelem;//convergence record of the last parallel global optimization
+    void mixShowSolverInfo(const SolverTelemetry *tel,const char *ffRoutine);//Shows the convergence record of the last calculation
+    void getGlobalOptSettings(GlobalOptSettings *set);//Reads the settings for the parallel global optimizers
+    void stabilityCheck(FF_FeedData *data,double *tpd,double tpdX[]);//Tangent plane distance minimization with the selected optimizer
     void getMixEosCpSel();//Pass the number of the rows selected for eos, and cp0 correlation, for each possible substance, to an array format
     void writeMixResultsTable(int nPhases,FF_MixData*mix,FF_ThermoProperties *th0A,FF_PhaseThermoProp *thA,FF_ThermoProperties *th0B,
                               FF_PhaseThermoProp *thB, FF_ThermoProperties *th0C,FF_PhaseThermoProp *thC);//Write in the results table the thermodynamic records
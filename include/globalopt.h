@@ -0,0 +1,76 @@
+/*
+ * globalopt.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+//Multi-threaded global optimizers for the two phases P,T flash and the stability check.
+//They minimize the same objectives as FF_TwoPhasesFlashPTSA/DE and FF_StabilityCheckSA, but evaluate the
+//differential evolution population, or the parallel tempering chains, concurrently.
+//The random numbers of each population member, or chain, are derived from a single seed, so the result
+//does not depend on the number of threads used.
+//Every worker thread evaluates the objective on its own copy of the mixture and feed data, so FreeFluidsC
+//is never called concurrently on the same FF_MixData.
+
+#ifndef GLOBALOPT
+#define GLOBALOPT
+
+#include "FFbasic.h"
+#include "FFeosMix.h"
+#include "FFequilibrium.h"
+#include "unifackernel.h"
+#include "solvertelemetry.h"
+
+typedef struct{
+    int nThreads;//number of worker threads. 0 uses all the available cores
+    unsigned int seed;//base seed for the random number generators
+    int nPop;//differential evolution population. 0 means 10 members per variable
+    int nGen;//differential evolution maximum number of generations
+    double F;//differential evolution mutation factor
+    double CR;//differential evolution crossover probability
+    int nChains;//number of parallel tempering chains
+    int nRounds;//number of chain exchange rounds
+    int nSteps;//Metropolis steps done by each chain between exchanges
+    double tempMin,tempMax;//temperature ladder of the tempering chains
+    double tol;//convergence tolerance on the objective function
+    const UnifacKernel *unifac;//precompiled UNIFAC kernel of the mixture, used for gamma-gamma if it matches the activity model. Can be NULL
+    SolverTelemetry *telem;//receives the convergence record: one step per generation, or per exchange round. Can be NULL
+    double *tolTime;//receives the ms taken until the best values of the population, or chains, were within tol. -1 if they never were. Can be NULL
+} GlobalOptSettings;
+
+//Fills the settings with the default values
+void GlobalOptDefaultSettings(GlobalOptSettings *set);
+
+//Returns the number of threads that will be really used with the given settings
+int GlobalOptThreads(const GlobalOptSettings *set);
+
+//Two phases P,T flash by parallel differential evolution. Returns 0 if the thermodynamic model is not supported
+int TwoPhasesFlashPTParallelDE(FF_FeedData *data,const GlobalOptSettings *set,double x[],double y[],double phiB[],double phiA[],double *beta,double *Gr);
+
+//Two phases P,T flash by parallel tempering simulated annealing. Returns 0 if the thermodynamic model is not supported
+int TwoPhasesFlashPTParallelSA(FF_FeedData *data,const GlobalOptSettings *set,double x[],double y[],double phiB[],double phiA[],double *beta,double *Gr);
+
+//Tangent plane distance minimization by parallel differential evolution. Returns 0 if the thermodynamic model is not supported
+int StabilityCheckParallelDE(FF_FeedData *data,const GlobalOptSettings *set,double *tpd,double tpdX[]);
+
+//Tangent plane distance minimization by parallel tempering simulated annealing. Returns 0 if the thermodynamic model is not supported
+int StabilityCheckParallelSA(FF_FeedData *data,const GlobalOptSettings *set,double *tpd,double tpdX[]);
+
+#endif // GLOBALOPT
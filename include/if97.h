@@ -0,0 +1,71 @@
+/*
+ * if97.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//IAPWS-IF97 industrial formulation for water: regions 1 (liquid), 2 (vapor) and 4 (saturation), with the backward
+//equations T(p,h) and T(p,s) of regions 1 and 2. The properties are given in the units of FF_ThermoProperties (molar),
+//with the same reference state as IAPWS95: internal energy and entropy of the liquid at the triple point equal to 0.
+//The P,H and P,S states are solved without iteration: the backward equation gives T, and one Newton correction on the
+//forward equation brings it to the consistency of the formulation.
+//Region 3 (near the critical point, above 623.15 K and the B23 line) and region 5 (above 1073.15 K) are not covered:
+//the functions return 0 there, and the calculation is left to IAPWS95.
+
+#ifndef IF97
+#define IF97
+
+#include "FFbasic.h"
+#include "FFeosPure.h"
+#include "pureflash.h"
+
+#define IF97_MW 18.015268 //molecular weight used by IAPWS
+
+typedef struct{
+    int nPoints;//points of the grid in regions 1 and 2
+    double maxV,maxCp,maxSS;//maximum relative deviations
+    double maxH,maxS;//maximum absolute deviations, J/mol and J/(mol*K)
+    double worstT,worstP;//state of the maximum relative deviation in volume
+} IF97Deviations;
+
+//Region of the state: 1 liquid, 2 vapor, 3 near critical, 5 high temperature. 0 if outside the range of IF97
+int IF97Region(double T,double P);
+
+//Saturation pressure at T (Pa), and saturation temperature at P (K), by the region 4 equation. 0 outside its range
+double IF97Psat(double T);
+double IF97Tsat(double P);
+
+//Properties at T,P in regions 1 and 2. lnPhi receives ln of the fugacity coefficient, and can be NULL.
+//Returns the region, or 0 if the state is not in regions 1 or 2
+int IF97ThermoTP(double T,double P,FF_ThermoProperties *th,double *lnPhi);
+
+//Saturated liquid and gas at T, up to 623.15 K. Returns 0 outside the range
+int IF97SatT(double T,double *P,FF_ThermoProperties *thL,FF_ThermoProperties *thG);
+
+//State from P and molar H, or P and molar S. liqFraction is the liquid molar fraction. In the two phases region Cp, Cv,
+//SS, JT and IT are returned as NaN. Returns the region (4 for liquid-gas mixtures), or 0 if not covered
+int IF97ThermoPH(double P,double H,FF_ThermoProperties *th,double *liqFraction);
+int IF97ThermoPS(double P,double S,FF_ThermoProperties *th,double *liqFraction);
+
+//Compares IF97 with the IAPWS95 model of the engine on a T,P grid in regions 1 and 2
+void IF97Check(const PureFlashEngine *eng,IF97Deviations *dev);
+
+#endif // IF97
@@ -0,0 +1,63 @@
+/*
+ * modelicaexport.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Export of substances to the FreeFluids Modelica library: DataRecord constants for FreeFluids.MediaCommon, and binary
+//substance files (.sd) for FreeFluids.ExternalMedia.
+//The bulk export loads the substances through a cache, formats the records in parallel into memory buffers, and writes
+//the whole package with a single write, and each binary file with another.
+
+#ifndef MODELICAEXPORT
+#define MODELICAEXPORT
+
+#include <vector>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+
+#include "FFbasic.h"
+
+//Converts a substance name to a valid Modelica identifier
+QString ModelicaName(const QString &name);
+
+//Gives the substance a PR78 EOS from its basic data if it has no cubic EOS, as needed by ExternalMedia
+void ModelicaDefaultCubic(FF_SubstanceData *subs);
+
+//Appends the FreeFluids.MediaCommon.DataRecord declaration of the substance to out
+void ModelicaDataRecord(const FF_SubstanceData *subs,const QString &name,const QString &description,QString *out);
+
+//Product ids from a comma separated list of ids, or from a SQL condition on the Products table. Returns the number of ids
+int ModelicaSelectIds(const QString &selection,QSqlDatabase *db,std::vector<int> *ids);
+
+//Substance loaded by GetPreferredData, kept in memory for the following exports. Can be called from several threads,
+//each one with its own connection
+const FF_SubstanceData *ModelicaCachedSubstance(int id,QSqlDatabase *db);
+
+//Empties the substance cache. To be called when the database is modified
+void ModelicaClearCache();
+
+//Writes a package with the DataRecord of each substance to fileName, and a .sd file for each one in the same directory.
+//The substances are loaded and formatted by nThreads threads, the workers using their own database connection (see dbconnection.h).
+//nThreads=0 uses all the available cores. Returns the number of substances exported, or -1 if the package can not be written
+int ModelicaBulkExport(const std::vector<int> &ids,const QString &packageName,const QString &fileName,int nThreads,QSqlDatabase *db);
+
+#endif // MODELICAEXPORT
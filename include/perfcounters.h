@@ -0,0 +1,108 @@
+/*
+ * perfcounters.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+//Low overhead instrumentation of the calls to FreeFluidsC and of the database queries.
+//Each instrumented call site registers a named counter on first use. Every thread keeps its own table of counters
+//(number of calls, total time and a logarithmic histogram of the call times), written without locks and only read
+//when a snapshot is taken. PerfBegin starts a new action (as pressing Calc), forgetting the previous counts, and
+//PerfSnapshot gives the totals of all the threads since then.
+//While a trace is being recorded (perftrace.h) every instrumented call is also written to the timeline.
+
+#ifndef PERFCOUNTERS
+#define PERFCOUNTERS
+
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+#include "perftrace.h"
+
+#define PERF_MAX_COUNTERS 256 //maximum number of instrumented call sites
+#define PERF_BUCKETS 96 //histogram buckets, two per octave of nanoseconds
+
+enum PerfKind{PERF_CALL,PERF_SQL};
+
+typedef struct{
+    const char *name;//name of the call, or of the function doing the query for PERF_SQL
+    enum PerfKind kind;
+    uint64_t count;//number of calls
+    double total;//total time, s
+    double mean;//mean time per call, s
+    double p99;//99th percentile of the time per call, s (upper bound of its histogram bucket)
+    double max;//longest call, s
+} PerfStat;
+
+typedef struct{
+    const char *action;//name given to PerfBegin
+    double wall;//time since PerfBegin, s
+    uint64_t calls;//total number of PERF_CALL calls
+    uint64_t sqlTrips;//total number of PERF_SQL queries
+    double sqlTime;//time spent in the queries, s
+    std::vector<PerfStat> stats;//by decreasing total time
+} PerfSnapshotData;
+
+//Registers a counter and returns its index. Called once per call site by the macros. Returns -1 if the table is full
+int PerfRegister(const char *name,enum PerfKind kind);
+
+//Name and kind of a registered counter
+const char *PerfCounterName(int id);
+enum PerfKind PerfCounterKind(int id);
+
+//Adds a call of the given duration to the counter, in the table of the calling thread
+void PerfRecord(int id,uint64_t ns);
+
+//Enables or disables the recording. Enabled by default
+void PerfSetEnabled(bool enabled);
+bool PerfEnabled();
+
+//Starts a new action: the counters of all threads are cleared (each thread does it lazily, on its next record)
+void PerfBegin(const char *action);
+
+//Totals of all the threads, including the finished ones, since the last PerfBegin
+void PerfSnapshot(PerfSnapshotData *snap);
+
+//Times the scope in which it is declared, and traces it if recording
+class PerfScope{
+public:
+    explicit PerfScope(int id):id(id),traced(false){
+        if (id<0) return;
+        if (TraceEnabled()) traced=(TraceBegin(PerfCounterName(id),PerfCounterKind(id)==PERF_SQL ? "SQL" : "FreeFluidsC")>=0);
+        if (PerfEnabled()) start=std::chrono::steady_clock::now();
+        else this->id=-1;
+    }
+    ~PerfScope(){
+        if (id>=0) PerfRecord(id,(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-start).count());
+        if (traced) TraceEnd();
+    }
+private:
+    int id;
+    bool traced;
+    std::chrono::steady_clock::time_point start;
+};
+
+//Times a call, keeping its value: x=FF_PERF("FF_Name",FF_Name(...)); It can be used also as a statement
+#define FF_PERF(name,...) [&](){static const int perfId_=PerfRegister(name,PERF_CALL);PerfScope perfScope_(perfId_);return __VA_ARGS__;}()
+
+//Times a database round trip, counted under the name of the enclosing function: if (FF_PERF_SQL(query.exec()))
+#define FF_PERF_SQL(...) [&](const char *perfFunc_){static const int perfId_=PerfRegister(perfFunc_,PERF_SQL);PerfScope perfScope_(perfId_);return __VA_ARGS__;}(__func__)
+
+#endif // PERFCOUNTERS
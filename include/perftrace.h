@@ -0,0 +1,77 @@
+/*
+ * perftrace.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+//Timeline recorder in the Chrome trace event format, that can be opened with chrome://tracing or Perfetto.
+//When recording, each thread appends begin/end events, with their arguments, to a buffer of its own. Nothing is written
+//to disk until TraceStop, that merges the buffers of all the threads, including the finished ones, into a JSON file.
+//When not recording, a scope costs a single relaxed atomic load.
+
+#ifndef PERFTRACE
+#define PERFTRACE
+
+#include <atomic>
+
+#define TRACE_MAX_ARGS 4 //arguments per event
+#define TRACE_MAX_EVENTS 500000 //per thread. Later events are dropped, and counted
+
+extern std::atomic<bool> traceEnabled;
+
+//True while recording
+inline bool TraceEnabled(){
+    return traceEnabled.load(std::memory_order_relaxed);
+}
+
+//Starts recording, discarding any previous events. The calling thread is named as the main one
+void TraceStart();
+
+//Stops recording and writes the events to the file. To be called when no calculation is running. Returns the number
+//of events written, or -1 if the file could not be written
+int TraceStop(const char *fileName);
+
+//Appends a begin event to the buffer of the calling thread and returns its position, or -1 if not recorded.
+//The name and category must be string literals, or live until TraceStop
+int TraceBegin(const char *name,const char *cat);
+
+//Adds an argument to a recorded begin event of the calling thread. It can be done at any moment before TraceStop
+void TraceArg(int event,const char *name,double value);
+
+//Appends the end event of the last begin event of the calling thread
+void TraceEnd();
+
+//Begin and end events for the scope in which it is declared. Arguments can be added while it lives
+class TraceScope{
+public:
+    TraceScope(const char *name,const char *cat):event(-1){
+        if (TraceEnabled()) event=TraceBegin(name,cat);
+    }
+    ~TraceScope(){
+        if (event>=0) TraceEnd();
+    }
+    void arg(const char *name,double value){
+        if (event>=0) TraceArg(event,name,value);
+    }
+private:
+    int event;
+};
+
+#endif // PERFTRACE
@@ -0,0 +1,84 @@
+/*
+ * pureflash.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Inverse flashes of pure substances on the compile time specialized EOS models (eoskernel.h).
+//Given P and H, S or U, T and S, or V and U, H or S, the state is found by a Newton method on T and ln(V), with the
+//Helmholtz derivatives of the model and the ideal gas part of FreeFluidsC. The Newton method starts from the saturated
+//phase on the right side when P or T are known and the substance has a saturation table (satcache.h), or from the
+//nearest node of a coarse T,V table of the substance. States inside the saturation dome are returned as liquid-gas
+//mixtures, with the saturation solved with the same model.
+//An engine is prepared once for the substance and is only read afterwards, so the batch calculation shares it
+//between threads.
+
+#ifndef PUREFLASH
+#define PUREFLASH
+
+#include "FFbasic.h"
+#include "FFeosPure.h"
+#include "eoskernel.h"
+
+#define PURE_FLASH_NSAT 64 //nodes of the saturation seed table
+#define PURE_FLASH_NT 32 //temperature nodes of the coarse table
+#define PURE_FLASH_NV 32 //volume nodes of the coarse table
+
+//Known variables. D specifications are given by the molar volume
+enum PureFlashSpec{PURE_FLASH_PH,PURE_FLASH_PS,PURE_FLASH_PU,PURE_FLASH_TS,PURE_FLASH_UV,PURE_FLASH_DH,PURE_FLASH_DS};
+
+typedef struct{
+    EosKernel ker;//residual part
+    FF_SubstanceData *subs;//Cp0 correlation for the ideal gas part
+    double refT,refP;//reference state of the ideal gas part
+    double MW;
+    int water;//1 if the ideal gas part is the IAPWS95 one
+    int nSat;//nodes of the saturation table, 0 if the substance has no saturation table
+    double satT[PURE_FLASH_NSAT],satLnP[PURE_FLASH_NSAT],satLnVL[PURE_FLASH_NSAT],satLnVG[PURE_FLASH_NSAT];
+    double Tc;//end of the saturation table, or critical temperature if there is no table
+    double Vc;//volume that separates liquid and gas when there is no saturation table
+    double gridT[PURE_FLASH_NT],gridLnV[PURE_FLASH_NV];
+    double gridP[PURE_FLASH_NT][PURE_FLASH_NV],gridH[PURE_FLASH_NT][PURE_FLASH_NV];
+    double gridS[PURE_FLASH_NT][PURE_FLASH_NV],gridU[PURE_FLASH_NT][PURE_FLASH_NV];
+} PureFlashEngine;
+
+//Prepares the engine for the active EOS of the substance, with the given reference state for the ideal gas part.
+//The substance must not change while the engine is used. Returns 0 if the substance has no EOS
+int PureFlashInit(FF_SubstanceData *subs,double refT,double refP,PureFlashEngine *eng);
+
+//Thermodynamic properties at T,V with the model of the engine
+void PureFlashProps(const PureFlashEngine *eng,double T,double V,FF_ThermoProperties *th);
+
+//Saturation at T: pressure and volumes of liquid and gas. Returns 0 if T is outside the saturation table or it does not converge
+int PureFlashSatT(const PureFlashEngine *eng,double T,double *P,double *VL,double *VG);
+
+//State from the two known variables, in the order of the specification name (P and H for PURE_FLASH_PH, U and V for
+//PURE_FLASH_UV, V and H for PURE_FLASH_DH). liqFraction is the liquid molar fraction: 1 for liquid, 0 for gas or
+//supercritical fluid. In the two phases region Cp, Cv, SS, JT and IT are not defined and are returned as NaN.
+//Returns 0 if the state is not found
+int PureFlash(const PureFlashEngine *eng,enum PureFlashSpec spec,double x,double y,FF_ThermoProperties *th,double *liqFraction);
+
+//Batch of states, calculated by nThreads threads (0 uses all the available cores). solved[] can be NULL.
+//The points not solved have T=NaN. Returns the number of points solved
+int PureFlashBatch(const PureFlashEngine *eng,enum PureFlashSpec spec,int n,const double x[],const double y[],
+                   FF_ThermoProperties th[],double liqFraction[],int solved[],int nThreads);
+
+#endif // PUREFLASH
@@ -0,0 +1,67 @@
+/*
+ * satcache.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Saturation curve cache for pure substances.
+//For each substance calculated, a table of saturated properties is built, on first use, between a low temperature
+//(about the triple point) and close to the critical point of the EOS. The nodes are placed by adaptive refinement,
+//until interpolation reproduces the exact EOS calculation, and the properties are interpolated by piecewise cubic
+//Hermite polynomials in T. ln(Psat) uses the slope given by Clapeyron equation, so dPsat/dT is analytic.
+//Enthalpies and entropies are the residual ones, as given by FF_ExtResidualThermoEOSs, because the ideal gas part
+//depends on the reference state and the Cp0 correlation, not on the EOS.
+//The tables are kept by product id and EOS id. Hits are found in a list private to each thread, without locking.
+//If the EOS data are changed in place, keeping the ids (as when fitting parameters), SatCacheInvalidate must be called.
+//Substances without product id are not cached.
+
+#ifndef SATCACHE
+#define SATCACHE
+
+#include "FFbasic.h"
+#include "FFeosPure.h"
+
+typedef struct{
+    double T,P;//saturation temperature and pressure
+    double dP_dT;//from Clapeyron equation
+    double VL,VG;//molar volumes of saturated liquid and gas
+    double HL,HG,SL,SG;//residual enthalpies and entropies
+    double CpL;//residual Cp of the saturated liquid
+    double ArrL,ZL;//reduced residual Helmholtz energy and compressibility factor of the saturated liquid
+    double dP_dTL,dP_dVL;//partial derivatives of P in the saturated liquid
+} SatProps;
+
+//Saturated properties at T. Returns 0 if T is outside the range of the table, or if it can not be built
+int SatCacheProps(FF_SubstanceData *subs,double T,SatProps *sp);
+
+//Saturation temperature at P, inverting the table. Returns 0 if P is outside the range of the table
+int SatCacheTsat(FF_SubstanceData *subs,double P,double *T);
+
+//Temperature range covered by the table of the substance, and number of nodes. Returns 0 if there is no table
+int SatCacheRange(FF_SubstanceData *subs,double *Tmin,double *Tmax,int *nNodes);
+
+//Discards the tables of a substance. To be called after changing its EOS data in place
+void SatCacheInvalidate(int subsId);
+
+//Discards all the tables
+void SatCacheClear();
+
+#endif // SATCACHE
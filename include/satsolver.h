@@ -0,0 +1,72 @@
+/*
+ * satsolver.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Bubble and dew point solvers for cubic EOS mixtures with VdW or PR mixing rules.
+//The saturation variable (P or T) is found by Newton iterations on ln(sum(K*z)) (ln(sum(z/K)) for the dew point),
+//with the derivatives of ln(phi) with respect to T and P obtained analytically by dual numbers, while the incipient
+//phase composition is updated from the same K values. The fugacity coefficients come from the cubic mixture kernel.
+//A solution is kept as warm start for the next calculation of the same type, and used when the fixed variable and
+//the composition have changed only slightly. The phase volumes and compressibility factors of the final EOS
+//evaluation are returned, so they do not need to be calculated again, together with the convergence record.
+
+#ifndef SATSOLVER
+#define SATSOLVER
+
+#include "FFbasic.h"
+#include "FFeosMix.h"
+#include "solvertelemetry.h"
+
+typedef struct{
+    int valid;//1 if it holds a converged solution
+    int numSubs;
+    double fixed;//the fixed variable: T for bubble/dew P, P for bubble/dew T
+    double var;//the calculated variable
+    double z[15];//the fixed composition
+    double w[15];//the incipient phase composition
+} SatWarmStart;
+
+typedef struct{
+    double T,P;
+    double x[15],y[15];//liquid and gas compositions
+    double lnPhiL[15],lnPhiG[15];
+    double ZL,ZG,VL,VG;//from the final EOS evaluation
+    int iterations;
+    int warm;//1 if started from the previous solution
+    SolverTelemetry telem;//convergence record, filled also when the calculation fails
+} SatResult;
+
+//Bubble pressure at T for the liquid composition x. Pguess is used if >0 and there is no usable warm start.
+//Returns 0 if the mixture is not supported or the calculation has not converged
+int SatBubbleP(FF_MixData *mix,double T,const double x[],double Pguess,SatWarmStart *warm,SatResult *res);
+
+//Dew pressure at T for the gas composition y
+int SatDewP(FF_MixData *mix,double T,const double y[],double Pguess,SatWarmStart *warm,SatResult *res);
+
+//Bubble temperature at P for the liquid composition x
+int SatBubbleT(FF_MixData *mix,double P,const double x[],double Tguess,SatWarmStart *warm,SatResult *res);
+
+//Dew temperature at P for the gas composition y
+int SatDewT(FF_MixData *mix,double P,const double y[],double Tguess,SatWarmStart *warm,SatResult *res);
+
+#endif // SATSOLVER
@@ -0,0 +1,118 @@
+/*
+ * solvertelemetry.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+//Convergence records of the iterative solvers: saturation (satsolver.h) and parallel global optimizers (globalopt.h).
+//Every solve fills a SolverTelemetry with the starting method, the final status, the iteration count by step type and,
+//if enabled, the step type, residual norm and main variable of the last SOLVER_TELEM_RING iterations in a ring buffer.
+//SolverTelemetryStats accumulates many records, as in batch runs, keeping the points that needed more iterations or
+//failed, to locate the pathological regions.
+//The FreeFluidsC solvers used as fallback can not be followed, and are reported as such by the callers.
+
+#ifndef SOLVERTELEMETRY
+#define SOLVERTELEMETRY
+
+#include <string>
+
+#define SOLVER_TELEM_RING 32 //last iterations kept in the record
+#define SOLVER_TELEM_WORST 8 //worst points kept by the statistics
+
+enum SolverStep{SOLVER_STEP_WILSON,SOLVER_STEP_WARM,SOLVER_STEP_GUESS,SOLVER_STEP_RANDOM,SOLVER_STEP_SS,SOLVER_STEP_NEWTON,
+                SOLVER_STEP_NEWTON_CLIPPED,SOLVER_STEP_DE,SOLVER_STEP_SA,SOLVER_STEP_COUNT};
+enum SolverStatus{SOLVER_RUNNING,SOLVER_CONVERGED,SOLVER_MAXITER,SOLVER_EOS_FAILURE,SOLVER_SINGULAR,SOLVER_DIVERGED,SOLVER_TRIVIAL,
+                  SOLVER_UNSUPPORTED,SOLVER_STATUS_COUNT};
+
+typedef struct{
+    int iteration;
+    enum SolverStep step;
+    double residual;//residual norm before the step
+    double var;//main variable after the step: P or T for saturation, best objective for the optimizers
+} SolverIteration;
+
+typedef struct{
+    const char *solver;
+    enum SolverStatus status;
+    enum SolverStep start;//how the initial estimation was obtained
+    int iterations;
+    double residual;//final residual norm
+    int steps[SOLVER_STEP_COUNT];//iterations done with each step type
+    int detail;//1 if the iterations are recorded in the ring, as set when the record began
+    SolverIteration ring[SOLVER_TELEM_RING];//iteration i is at ring[(i-1)%SOLVER_TELEM_RING]
+} SolverTelemetry;
+
+typedef struct{
+    double x,y;//location given by the caller, as T and P
+    int iterations;
+    enum SolverStatus status;
+    double residual;
+} SolverTelemetryPoint;
+
+typedef struct{
+    int calls;
+    int status[SOLVER_STATUS_COUNT];
+    int start[SOLVER_STEP_COUNT];
+    long steps[SOLVER_STEP_COUNT];
+    long iterations;
+    int maxIterations;
+    int nWorst;
+    SolverTelemetryPoint worst[SOLVER_TELEM_WORST];//failed first, then by decreasing iterations
+} SolverTelemetryStats;
+
+//Enables or disables the recording of the iterations in the ring, for the records begun afterwards. The summary is
+//always filled. Enabled by default
+void SolverTelemetrySetEnabled(bool enabled);
+bool SolverTelemetryEnabled();
+
+//Starts a record
+void SolverTelemetryBegin(SolverTelemetry *tel,const char *solver,enum SolverStep start);
+
+//Records an iteration
+inline void SolverTelemetryStep(SolverTelemetry *tel,enum SolverStep step,double residual,double var){
+    tel->iterations++;
+    tel->steps[step]++;
+    tel->residual=residual;
+    if (tel->detail){
+        SolverIteration &it=tel->ring[(tel->iterations-1)%SOLVER_TELEM_RING];
+        it.iteration=tel->iterations;
+        it.step=step;
+        it.residual=residual;
+        it.var=var;
+    }
+}
+
+//Closes a record with the final status. It returns 1 if converged, else 0, to be used as the solver result
+int SolverTelemetryEnd(SolverTelemetry *tel,enum SolverStatus status,double residual);
+
+const char *SolverStepName(enum SolverStep step);
+const char *SolverStatusName(enum SolverStatus status);
+
+//One line summary of a record
+std::string SolverTelemetrySummary(const SolverTelemetry *tel);
+
+//The recorded iterations, one per line, oldest first. Empty if the record was made without detail
+std::string SolverTelemetryDetail(const SolverTelemetry *tel);
+
+//Statistics of many records
+void SolverTelemetryStatsInit(SolverTelemetryStats *stats);
+void SolverTelemetryAccumulate(SolverTelemetryStats *stats,const SolverTelemetry *tel,double x,double y);
+
+#endif // SOLVERTELEMETRY
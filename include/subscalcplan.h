@@ -0,0 +1,69 @@
+/*
+ * subscalcplan.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Evaluation plan of the substance calculation table. The caller requests a set of table rows as a bit mask, and the plan
+//tells which calculation stages are needed for them, with their dependencies: the saturation is solved only for the
+//saturated properties and the pressure corrections of the liquid, the residual properties only if a row uses them, etc.
+//The rows of the phase determination (T, phase, T in K) are always in the plan.
+
+#ifndef SUBSCALCPLAN
+#define SUBSCALCPLAN
+
+#define SUBS_CALC_ROWS 57 //rows of the substance calculation table
+
+typedef unsigned long long SubsCalcMask;//bit i requests row i of the table
+
+#define SUBS_CALC_ROW(i) (1ULL<<(i))
+#define SUBS_CALC_RANGE(first,last) (((~0ULL)>>(63-(last)))&~(SUBS_CALC_ROW(first)-1))
+#define SUBS_CALC_ALL SUBS_CALC_RANGE(0,SUBS_CALC_ROWS-1)
+
+//Groups of rows
+#define SUBS_CALC_STATE (SUBS_CALC_ROW(0)|SUBS_CALC_ROW(1)|SUBS_CALC_ROW(56))//T, phase and T in K
+#define SUBS_CALC_PHI SUBS_CALC_RANGE(2,3)//fugacity coefficients
+#define SUBS_CALC_VOLUME SUBS_CALC_RANGE(4,6)//Z, V and density
+#define SUBS_CALC_IDEAL SUBS_CALC_RANGE(7,9)//ideal gas H, S and Cp
+#define SUBS_CALC_THERMO SUBS_CALC_RANGE(10,23)//H, U, S, Cp, Cv, sound speed, JT and derivatives
+#define SUBS_CALC_SAT SUBS_CALC_RANGE(24,34)//vapor pressure and saturated properties
+#define SUBS_CALC_ARR SUBS_CALC_RANGE(35,40)//reduced residual Helmholtz energy and derivatives
+#define SUBS_CALC_TRANSPORT SUBS_CALC_RANGE(41,55)//correlations and estimation methods of liquid and gas properties
+
+//Rows calculated from the vapor pressure: the saturation ones, and the liquid density (correlation and Rackett) and
+//viscosity corrected from Vp to P. The vapor pressure is solved only if one of them is in the plan
+#define SUBS_CALC_VP_ROWS (SUBS_CALC_SAT|SUBS_CALC_RANGE(41,42)|SUBS_CALC_ROW(44))
+
+typedef struct{
+    SubsCalcMask rows;//rows that will be written: the requested ones plus the state ones
+    int ideal;//ideal gas properties
+    int thermo;//residual properties by the EOS
+    int vp;//vapor pressure, needed by the SUBS_CALC_VP_ROWS in the plan
+    int satPhases;//properties of the saturated phases, including Hv and dVp/dT
+    int arr;//Helmholtz derivatives by the EOS kernel
+    int liqDens,liqVisc,liqThC,surfTens,gasVisc,gasThC,liqCp;//correlations and estimation methods
+} SubsCalcPlan;
+
+//Builds the plan for the requested rows. Rows that can not be calculated for the substance, as those of a missing
+//correlation, must not be requested, so they do not bring their dependencies into the plan
+void SubsCalcPlanBuild(SubsCalcMask requested,SubsCalcPlan *plan);
+
+#endif // SUBSCALCPLAN
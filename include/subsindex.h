@@ -0,0 +1,102 @@
+/*
+ * subsindex.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Substance search index and list models for the substance selection combobox.
+//The index is built once from the Products table: for each product, its name, CAS number, formula and synonyms (if
+//present in the database) are normalized (lower case letters and digits only). Searches of less than three characters
+//use a sorted table of the keys for prefix lookup, longer ones intersect the posting lists of the trigrams of the text,
+//so any substring is found without scanning all the products.
+//SubsListModel shows the products, in name order, fetching rows as the view needs them. SubsMatchModel holds the
+//result of a search, for the completer.
+
+#ifndef SUBSINDEX
+#define SUBSINDEX
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <QAbstractTableModel>
+#include <QAbstractListModel>
+#include <QtSql/QSqlDatabase>
+
+typedef struct{
+    int id;
+    QString name;
+    double MW;
+    int firstKey,nKeys;//position of its keys in SubsIndex.keys
+} SubsIndexEntry;
+
+typedef struct{
+    std::vector<SubsIndexEntry> entries;//in name order
+    std::vector<std::string> keys;//normalized search keys, grouped by entry
+    std::vector<int> keyEntry;//entry of each key
+    std::vector<int> sortedKeys;//key positions, in alphabetical order of the key
+    std::unordered_map<uint32_t,std::vector<int> > trigrams;//trigram -> entries containing it, in increasing order
+    std::unordered_map<int,int> byId;//product id -> entry
+} SubsIndex;
+
+//Builds the index from the database. Returns the number of products
+int SubsIndexBuild(QSqlDatabase *db,SubsIndex *index);
+
+//Finds up to maxResults entries matching the text. Entries with a key starting with the text go first, then the ones
+//containing it, each group in name order. Returns the number of entries found
+int SubsIndexFind(const SubsIndex *index,const QString &text,int maxResults,std::vector<int> *found);
+
+//Entry of a product id, -1 if not present
+int SubsIndexEntryOfId(const SubsIndex *index,int id);
+
+//Id, name and MW of the products, in name order, fetched in pages as the view scrolls
+class SubsListModel : public QAbstractTableModel{
+public:
+    SubsListModel(const SubsIndex *index,QObject *parent=0);
+    int rowCount(const QModelIndex &parent=QModelIndex()) const;
+    int columnCount(const QModelIndex &parent=QModelIndex()) const;
+    QVariant data(const QModelIndex &index,int role=Qt::DisplayRole) const;
+    QVariant headerData(int section,Qt::Orientation orientation,int role=Qt::DisplayRole) const;
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
+    void ensureFetched(int row);//makes the row available
+    void reset();//call after rebuilding the index
+    int id(int row) const;
+    QString name(int row) const;
+    double MW(int row) const;
+private:
+    const SubsIndex *index;
+    int fetched;//rows made available to the views
+};
+
+//Names of the entries found by a search. Qt::UserRole gives the product id
+class SubsMatchModel : public QAbstractListModel{
+public:
+    SubsMatchModel(QObject *parent=0);
+    int rowCount(const QModelIndex &parent=QModelIndex()) const;
+    QVariant data(const QModelIndex &index,int role=Qt::DisplayRole) const;
+    void setMatches(const SubsIndex *index,const std::vector<int> &found);
+private:
+    std::vector<int> ids;
+    std::vector<QString> names;
+};
+
+#endif // SUBSINDEX
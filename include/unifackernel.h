@@ -0,0 +1,74 @@
+/*
+ * unifackernel.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Precompiled UNIFAC activity model for a mixture (Standard, PSRK, Dortmund and NIST variants).
+//Only the subgroups present in the mixture are kept, with their occurrence in each substance stored by subgroup,
+//and the interaction parameters already mapped from main groups to subgroups. The Psi(T) matrix and the
+//residual group activities in the pure substances are calculated once per temperature, so the evaluation of
+//the activity coefficients is reduced to two small dense matrix-vector products.
+
+#ifndef UNIFACKERNEL
+#define UNIFACKERNEL
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql>
+
+#include "FFbasic.h"
+#include "FFeosPure.h"
+#include "FFeosMix.h"
+#include "unifacstore.h"
+
+#define UK_MAXSG 32 //maximum number of different subgroups in a mixture
+
+typedef struct{
+    enum FF_ActModel model;//FF_UNIFACStd, FF_UNIFACPSRK, FF_UNIFACDort or FF_UNIFACNist
+    int nSubs;//number of substances. 0 if the kernel is not available
+    int nSg;//number of different subgroups
+    int missing;//number of main group pairs without interaction parameters in the database, taken as 0
+    double rExp;//exponent of r in the combinatorial term: 1, or 0.75 for Dortmund and NIST
+    int subg[UK_MAXSG],group[UK_MAXSG];//subgroup and main group numbers
+    double Rk[UK_MAXSG],Qk[UK_MAXSG];
+    double nu[UK_MAXSG][15];//occurrence of each subgroup in each substance
+    double r[15],q[15],rP[15];//substance volume and area, and r^rExp
+    double A[UK_MAXSG][UK_MAXSG],B[UK_MAXSG][UK_MAXSG],C[UK_MAXSG][UK_MAXSG];//a(m,n)=A+B*T+C*T^2 between subgroups m and n
+    double T;//temperature of Psi and lnGammaPure. 0 if not calculated
+    double Psi[UK_MAXSG][UK_MAXSG];//exp(-a(m,n)/T)
+    double lnGammaPure[15][UK_MAXSG];//residual ln(Gamma) of each subgroup in the pure substance
+} UnifacKernel;
+
+//Builds the kernel for the substances and the UNIFAC variant, reading the subgroups and interactions from the binary
+//store if it is open, or from the database if not (store can be NULL).
+//Returns 0 if the model is not a UNIFAC one, a subgroup is not found, or there are too many subgroups
+int UnifacKernelBuild(enum FF_ActModel model,int numSubs,FF_SubstanceData *subs[],const UnifacStore *store,QSqlDatabase *db,UnifacKernel *ker);
+
+//Calculates Psi and the pure substance residual terms. Does nothing if T has not changed
+void UnifacKernelSetT(UnifacKernel *ker,double T);
+
+//Natural logarithm of the activity coefficients, combinatorial and residual parts
+void UnifacKernelLnGamma(const UnifacKernel *ker,const double x[],double lnGammaC[],double lnGammaR[]);
+
+//Compares the kernel with FF_ActivityDerivatives, setting it at T. Returns the maximum absolute difference in ln(gamma)
+double UnifacKernelCheck(FF_MixData *mix,UnifacKernel *ker,double T,const double x[]);
+
+#endif // UNIFACKERNEL
@@ -0,0 +1,108 @@
+/*
+ * unifacstore.h
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+//Binary UNIFAC parameter store, replacing the fixed-width text files written by WriteUnifacToFile.
+//A single file holds the four UNIFAC variants (Standard, PSRK, Dortmund and NIST). For each variant there is a
+//dense table of subgroups indexed by subgroup number, a table of interactions sorted by main groups (i,j), and a
+//dense (i,j) index into it, so any parameter is found without search. The file is generated by WriteUnifacToBinary
+//and memory mapped when opened, nothing is parsed or copied at load time.
+//The store is kept next to the database file, and its header holds the size and modification time of the database it
+//was generated from. A store that does not match the database is not opened, so it is generated again. Databases that
+//are not a file (ODBC) can not be checked, the store must be regenerated after editing the UNIFAC tables.
+//File layout: UnifacStoreHeader, then for each variant the subgroup table, the index and the interaction table.
+
+#ifndef UNIFACSTORE
+#define UNIFACSTORE
+
+#include <stdint.h>
+#include <QFile>
+#include <QString>
+
+#include "FFbasic.h"
+
+#define UNIFAC_STORE_MAGIC 0x55464646 //"FFFU" in little endian files
+#define UNIFAC_STORE_VERSION 2
+#define UNIFAC_STORE_VARIANTS 4 //Standard, PSRK, Dortmund, NIST, in this order
+
+typedef struct{
+    int32_t group;//main group. 0 if the subgroup is not defined for the variant
+    int32_t reserved;
+    double Rk,Qk;
+} UnifacStoreSubgroup;
+
+typedef struct{
+    int32_t i,j;//main groups
+    double A,B,C;//a(i,j)=A+B*T+C*T^2. B and C are 0 for Standard UNIFAC
+} UnifacStoreInteraction;
+
+typedef struct{
+    int32_t maxSubgroup;//the subgroup table has maxSubgroup+1 entries
+    int32_t maxGroup;//the index has (maxGroup+1)*(maxGroup+1) entries
+    int32_t nInteractions;
+    int32_t reserved;
+    int64_t subgroupOffset;//from the beginning of the file, for UnifacStoreSubgroup[maxSubgroup+1]
+    int64_t indexOffset;//for int32_t[(maxGroup+1)*(maxGroup+1)], position in the interaction table or -1
+    int64_t interactionOffset;//for UnifacStoreInteraction[nInteractions]
+} UnifacStoreVariant;
+
+typedef struct{
+    int32_t magic;
+    int32_t version;
+    int32_t nVariants;
+    int32_t reserved;
+    int64_t dbSize;//size of the database file the store was generated from. 0 if it is not a file
+    int64_t dbTime;//its modification time, in ms since the epoch
+    UnifacStoreVariant variant[UNIFAC_STORE_VARIANTS];
+} UnifacStoreHeader;
+
+typedef struct{
+    QFile *file;//NULL if the store is not open
+    const uchar *base;//mapped file
+    qint64 size;
+    QString dbFile;//database file the store is checked against. Empty if not checked
+} UnifacStore;
+
+//Size and modification time of the database file, as kept in the store header. Returns 0 if it is not a file
+int UnifacStoreFingerprint(const QString &dbFile,int64_t *dbSize,int64_t *dbTime);
+
+//Path of the store for the database file: in the same directory, or in the application one if it is not a file
+QString UnifacStorePath(const QString &dbFile);
+
+//Opens and maps the store file. If dbFile is not empty, the store must have been generated from that database file as
+//it is now. Returns 0 if the file does not exist, is not a valid store, or does not match the database
+int UnifacStoreOpen(const QString &fileName,const QString &dbFile,UnifacStore *store);
+
+//Returns 1 if the store is open and its database file has not changed since the store was generated
+int UnifacStoreCurrent(const UnifacStore *store);
+
+//Unmaps and closes the store
+void UnifacStoreClose(UnifacStore *store);
+
+//Main group, Rk and Qk of a subgroup for the UNIFAC variant. Returns 0 if not available
+int UnifacStoreGetSubgroup(const UnifacStore *store,enum FF_ActModel model,int subgroup,int *group,double *Rk,double *Qk);
+
+//Interaction parameters between main groups i and j for the UNIFAC variant. Returns 0 if not available
+int UnifacStoreGetInteraction(const UnifacStore *store,enum FF_ActModel model,int i,int j,double *A,double *B,double *C);
+
+#endif // UNIFACSTORE
@@ -0,0 +1,811 @@
+/*
+ * benchmark.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "benchmark.h"
+#include "databasetools.h"
+#include "dbconnection.h"
+#include "eoskernel.h"
+#include "satsolver.h"
+#include "globalopt.h"
+#include "calcarena.h"
+#include "pureflash.h"
+#include "if97.h"
+#include "subscalcplan.h"
+#include "FFeosPure.h"
+#include "FFeosMix.h"
+#include "FFequilibrium.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <QCoreApplication>
+#include <QFile>
+#include <QDir>
+#include <QStringList>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtSql>
+
+//Fluids of the pure substance benchmark: product and EOS ids in Substances.db3
+static const struct{
+    const char *name;
+    int idProduct,idEos;
+    enum FF_EosType type;
+} benchPureFluids[]={
+    {"propane PCSAFT",760,222,FF_SAFTtype},
+    {"propane SW",760,845,FF_SWtype},
+    {"propane PR78",760,69,FF_CubicType},
+    {"R134a SW",8268,871,FF_SWtype},
+    {"water IAPWS95",399,76,FF_SWtype},
+    {"ethylene glycol PCSAFT 4C",61,952,FF_SAFTtype},
+    {"ethylene glycol PRMC",61,951,FF_CubicType}
+};
+
+//States, as reduced temperature and pressure factor over the vapor pressure (or over Pc if supercritical)
+static const struct{
+    const char *name;
+    double Tr,Pfactor;
+} benchStates[]={
+    {"liquid",0.6,2.0},
+    {"vapor",0.8,0.5},
+    {"supercritical",1.2,2.0},
+    {"near critical",0.98,1.01}
+};
+
+static volatile double benchSink;//keeps the compiler from removing the calls
+
+//Fills the settings with the default values
+void BenchDefaultSettings(BenchSettings *set){
+    set->minTime=0.1;
+    set->repeats=5;
+    set->maxThreads=0;
+}
+
+//Nanoseconds per call of func: the call is repeated for at least minTime, and the median of the repeats is taken
+template<class F> static double BenchTime(const BenchSettings *set,F func){
+    typedef std::chrono::steady_clock Clock;
+    std::vector<double> ns;
+    long n=1;
+    func();//warm up
+    for (int r=0;r<set->repeats;r++){
+        double elapsed;
+        for (;;){
+            Clock::time_point t0=Clock::now();
+            for (long i=0;i<n;i++) func();
+            elapsed=std::chrono::duration<double>(Clock::now()-t0).count();
+            if (elapsed>=set->minTime) break;
+            n=(elapsed>0) ? (long)(n*std::min(1.2*set->minTime/elapsed,100.0))+1 : n*100;
+        }
+        ns.push_back(1e9*elapsed/n);
+    }
+    std::sort(ns.begin(),ns.end());
+    return ns[ns.size()/2];
+}
+
+//Loads the substance with the given EOS as the active model
+static int BenchLoadSubstance(QSqlDatabase *db,int idProduct,int idEos,enum FF_EosType type,FF_SubstanceData *subs){
+    GetPreferredData(idProduct,subs,db);
+    if (!(subs->baseProp.MW>0)) return 0;
+    subs->model=type;
+    if (type==FF_SAFTtype) subs->saftData.id=idEos;
+    else if (type==FF_SWtype) subs->swData.id=idEos;
+    else subs->cubicData.id=idEos;
+    GetEOSData(&subs->model,subs,db);
+    return 1;
+}
+
+//Critical constants of the active EOS
+static void BenchCritical(const FF_SubstanceData *subs,double *Tc,double *Pc){
+    if (subs->model==FF_SAFTtype){
+        *Tc=subs->saftData.Tc;
+        *Pc=subs->saftData.Pc;
+    }
+    else if (subs->model==FF_SWtype){
+        *Tc=subs->swData.Tc;
+        *Pc=subs->swData.Pc;
+    }
+    else{
+        *Tc=subs->cubicData.Tc;
+        *Pc=subs->cubicData.Pc;
+    }
+    if (!(*Tc>0)) *Tc=subs->baseProp.Tc;
+    if (!(*Pc>0)) *Pc=subs->baseProp.Pc;
+}
+
+//Helmholtz derivatives by FreeFluidsC, as the generic path does it
+static void BenchArrDer(FF_SubstanceData *subs,double T,double V,double result[6]){
+    if (subs->model==FF_SAFTtype) FF_ArrDerSAFT(&T,&V,&subs->saftData,result);
+    else if (subs->model==FF_SWtype) FF_ArrDerSWTV(&T,&V,&subs->swData,result);
+    else{
+        FF_CubicParam param;
+        FF_FixedParamCubic(&subs->cubicData,&param);
+        FF_ThetaDerivCubic(&T,&subs->cubicData,&param);
+        FF_ArrDerCubic(&T,&V,&param,result);
+    }
+}
+
+//Volume at T,P, and the phase found
+static double BenchVolume(FF_SubstanceData *subs,double T,double P,char *state){
+    double answerL[3],answerG[3];
+    char option='s';
+    FF_VfromTPeosS(&T,&P,subs,&option,answerL,answerG,state);
+    if ((*state=='g')||(*state=='G')) return answerG[0];
+    return answerL[0];
+}
+
+//A calculation point, as done for each column of the substance calculation table, with the EOS stages of the plan
+static void BenchPoint(FF_SubstanceData *subs,const SubsCalcPlan *plan,double T,double P,double Tc){
+    FF_ThermoProperties th;
+    char state;
+    th.T=T;
+    th.P=P;
+    th.H=0;
+    th.V=BenchVolume(subs,T,P,&state);
+    th.MW=subs->baseProp.MW;
+    if (plan->thermo) FF_ThermoEOSs(subs,&th);
+    if (plan->vp&&(T<Tc)){
+        double Vp;
+        FF_VpEOSs(&T,subs,&Vp);
+        th.P+=Vp;
+    }
+    benchSink=th.P+th.H;
+}
+
+//P,H flash by FreeFluidsC, as the substance alternative calculation does it
+static void BenchFlashPH(FF_SubstanceData *subs,double P,double H){
+    FF_ThermoProperties th;
+    double refT=298.15,refP=1.01325e5,liqFraction;
+    char var='H';
+    th.MW=subs->baseProp.MW;
+    th.P=P;
+    th.H=H;
+    if (subs->model==FF_SAFTtype) FF_ThermoEOSfromPX(&subs->model,&subs->saftData,&subs->cp0Corr.form,subs->cp0Corr.coef,&refT,&refP,&var,&th,&liqFraction);
+    else if (subs->model==FF_SWtype) FF_ThermoEOSfromPX(&subs->model,&subs->swData,&subs->cp0Corr.form,subs->cp0Corr.coef,&refT,&refP,&var,&th,&liqFraction);
+    else FF_ThermoEOSfromPX(&subs->model,&subs->cubicData,&subs->cp0Corr.form,subs->cp0Corr.coef,&refT,&refP,&var,&th,&liqFraction);
+    benchSink=th.T;
+}
+
+static QJsonObject BenchCall(const char *function,double ns,double nsArrDer){
+    QJsonObject call;
+    call["function"]=function;
+    call["nsPerCall"]=ns;
+    if (nsArrDer>0) call["arrDerEquivalent"]=ns/nsArrDer;//cost of the call in Helmholtz derivative evaluations
+    return call;
+}
+
+//Pure substance benchmark. Writes the JSON result to fileName. Returns the number of fluids benchmarked, -1 if the file can not be written
+int BenchPureRun(QSqlDatabase *db,const BenchSettings *set,const QString &fileName){
+    QJsonArray fluids;
+    int nDone=0;
+    int hwThreads=std::thread::hardware_concurrency();
+    int maxThreads=(set->maxThreads>0) ? set->maxThreads : std::max(hwThreads,1);
+    FF_SubstanceData *subs=new FF_SubstanceData;
+    for (unsigned f=0;f<sizeof(benchPureFluids)/sizeof(benchPureFluids[0]);f++){
+        QJsonObject fluid;
+        QString eosName;
+        double Tc,Pc;
+        fluid["name"]=benchPureFluids[f].name;
+        fluid["idProduct"]=benchPureFluids[f].idProduct;
+        fluid["idEos"]=benchPureFluids[f].idEos;
+        if (BenchLoadSubstance(db,benchPureFluids[f].idProduct,benchPureFluids[f].idEos,benchPureFluids[f].type,subs)==0){
+            fluid["error"]="substance not found";
+            fluids.append(fluid);
+            continue;
+        }
+        enum FF_EOS eos=(subs->model==FF_SAFTtype) ? subs->saftData.eos : (subs->model==FF_SWtype) ? subs->swData.eos : subs->cubicData.eos;
+        ConvertEnumerationToEos(&eos,&eosName);
+        BenchCritical(subs,&Tc,&Pc);
+        EosKernel ker;
+        EosKernelBuild(subs,&ker);
+        fluid["eos"]=eosName;
+        fluid["kernel"]=EosKernelVariantName(&ker);
+        fluid["Tc"]=Tc;
+        fluid["Pc"]=Pc;
+
+        //single thread cost of each call, at each state
+        QJsonArray states;
+        std::vector<double> pointT,pointP,pointV;
+        double phiMaxDiff=0;
+        for (unsigned s=0;s<sizeof(benchStates)/sizeof(benchStates[0]);s++){
+            QJsonObject st;
+            double T=benchStates[s].Tr*Tc,P,V,Vp=0;
+            char state;
+            if (T<Tc){
+                FF_VpEOSs(&T,subs,&Vp);
+                P=benchStates[s].Pfactor*Vp;
+            }
+            else P=benchStates[s].Pfactor*Pc;
+            if (!(P>0)) P=benchStates[s].Pfactor*Pc;
+            V=BenchVolume(subs,T,P,&state);
+            pointT.push_back(T);
+            pointP.push_back(P);
+            pointV.push_back(V);
+            st["state"]=benchStates[s].name;
+            st["T"]=T;
+            st["P"]=P;
+            st["V"]=V;
+            st["phase"]=QString(QChar(state));
+
+            double r[6];
+            double nsArr=BenchTime(set,[&](){BenchArrDer(subs,T,V,r);benchSink=r[1];});
+            double nsKer=BenchTime(set,[&](){ker.arrDer(&ker,T,V,r);benchSink=r[1];});
+            double nsV=BenchTime(set,[&](){benchSink=BenchVolume(subs,T,P,&state);});
+            FF_ThermoProperties th;
+            th.MW=subs->baseProp.MW;
+            double nsTh=BenchTime(set,[&](){th.T=T;th.V=V;FF_ThermoEOSs(subs,&th);benchSink=th.H;});
+            double nsExt=BenchTime(set,[&](){th.T=T;th.V=V;FF_ExtResidualThermoEOSs(subs,&th);benchSink=th.H;});
+            QJsonArray calls;
+            calls.append(BenchCall("FF_VfromTPeosS",nsV,nsArr));
+            calls.append(BenchCall("FF_ThermoEOSs",nsTh,nsArr));
+            calls.append(BenchCall("FF_ExtResidualThermoEOSs",nsExt,nsArr));
+            if (T<Tc){
+                double vp;
+                double nsVp=BenchTime(set,[&](){FF_VpEOSs(&T,subs,&vp);benchSink=vp;});
+                calls.append(BenchCall("FF_VpEOSs",nsVp,nsArr));
+            }
+            calls.append(BenchCall((subs->model==FF_SAFTtype) ? "FF_ArrDerSAFT" : (subs->model==FF_SWtype) ? "FF_ArrDerSWTV" : "FF_ArrDerCubic",nsArr,0));
+            calls.append(BenchCall("EosKernel arrDer",nsKer,nsArr));
+            if (ker.variant==EOS_KER_SW){//vectorized multiparameter terms against the scalar evaluation
+                double delta=1/(V*ker.sw.rhoRef),tau=ker.sw.tRef/T,phi[6],phiRef[6];
+                double nsRef=BenchTime(set,[&](){ker.sw.PhiDerRef(delta,tau,phiRef);benchSink=phiRef[1];});
+                double nsSimd=BenchTime(set,[&](){ker.sw.PhiDer(delta,tau,phi);benchSink=phi[1];});
+                for (int k=0;k<6;k++) if (fabs(phiRef[k])>0) phiMaxDiff=std::max(phiMaxDiff,fabs(phi[k]-phiRef[k])/fabs(phiRef[k]));
+                calls.append(BenchCall("EosSW PhiDerRef",nsRef,nsArr));
+                calls.append(BenchCall("EosSW PhiDer",nsSimd,nsArr));
+                st["phiDerSpeedup"]=nsRef/nsSimd;
+            }
+            st["calls"]=calls;
+            states.append(st);
+            printf("%-28s %-14s VfromTP %9.0f ns  Thermo %8.0f ns  ArrDer %7.0f ns  kernel %7.0f ns\n",benchPureFluids[f].name,benchStates[s].name,nsV,nsTh,nsArr,nsKer);
+        }
+        fluid["states"]=states;
+        if (ker.variant==EOS_KER_SW) fluid["phiDerMaxRelDiff"]=phiMaxDiff;
+
+        //single thread cost of a point with all the rows of the table, and with only density and enthalpy requested
+        SubsCalcPlan planAll,planRhoH;
+        SubsCalcPlanBuild(SUBS_CALC_ALL,&planAll);
+        SubsCalcPlanBuild(SUBS_CALC_ROW(6)|SUBS_CALC_ROW(10),&planRhoH);
+        double nsAll=BenchTime(set,[&](){for (unsigned s=0;s<pointT.size();s++) BenchPoint(subs,&planAll,pointT[s],pointP[s],Tc);})/pointT.size();
+        double nsRhoH=BenchTime(set,[&](){for (unsigned s=0;s<pointT.size();s++) BenchPoint(subs,&planRhoH,pointT[s],pointP[s],Tc);})/pointT.size();
+        QJsonObject pointPlan;
+        pointPlan["nsAllRows"]=nsAll;
+        pointPlan["nsDensityEnthalpy"]=nsRhoH;
+        fluid["pointPlan"]=pointPlan;
+        printf("%-28s point all rows %9.0f ns  density and enthalpy %9.0f ns\n",benchPureFluids[f].name,nsAll,nsRhoH);
+
+        //throughput of complete points with increasing number of threads, each one with its own copy of the substance
+        QJsonArray throughput;
+        double single=0;
+        for (int nThreads=1;;nThreads=std::min(2*nThreads,maxThreads)){
+            std::vector<std::thread> threads;
+            std::vector<long> points(nThreads,0);//written once at the end, to avoid false sharing
+            std::atomic<bool> stop(false);
+            for (int t=0;t<nThreads;t++) threads.push_back(std::thread([&,t](){
+                FF_SubstanceData *copy=new FF_SubstanceData;
+                long n=0;
+                *copy=*subs;
+                while (!stop){
+                    for (unsigned s=0;s<pointT.size();s++) BenchPoint(copy,&planAll,pointT[s],pointP[s],Tc);
+                    n+=pointT.size();
+                }
+                points[t]=n;
+                delete copy;
+            }));
+            std::chrono::steady_clock::time_point t0=std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::duration<double>(set->minTime*set->repeats));
+            stop=true;
+            for (int t=0;t<nThreads;t++) threads[t].join();
+            double elapsed=std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+            long total=0;
+            for (int t=0;t<nThreads;t++) total+=points[t];
+            double rate=total/elapsed;
+            if (nThreads==1) single=rate;
+            QJsonObject tp;
+            tp["threads"]=nThreads;
+            tp["pointsPerSecond"]=rate;
+            tp["speedup"]=(single>0) ? rate/single : 0;
+            throughput.append(tp);
+            printf("%-28s %2d threads %10.0f points/s\n",benchPureFluids[f].name,nThreads,rate);
+            if (nThreads>=maxThreads) break;
+        }
+        fluid["throughput"]=throughput;
+
+        //inverse P,H flash: one state at a time by FreeFluidsC and by the pure flash engine, and engine batches
+        PureFlashEngine *flash=new PureFlashEngine;
+        if (PureFlashInit(subs,298.15,1.01325e5,flash)==1){
+            QJsonObject inverse;
+            QJsonArray batch;
+            std::vector<double> flashP,flashH;
+            for (unsigned s=0;s<pointT.size();s++){
+                FF_ThermoProperties th;
+                PureFlashProps(flash,pointT[s],pointV[s],&th);
+                flashP.push_back(th.P);
+                flashH.push_back(th.H);
+            }
+            double nsFF=BenchTime(set,[&](){for (unsigned s=0;s<flashP.size();s++) BenchFlashPH(subs,flashP[s],flashH[s]);})/flashP.size();
+            double nsEng=BenchTime(set,[&](){
+                FF_ThermoProperties th;
+                double liqFraction;
+                for (unsigned s=0;s<flashP.size();s++) PureFlash(flash,PURE_FLASH_PH,flashP[s],flashH[s],&th,&liqFraction);
+                benchSink=th.T;
+            })/flashP.size();
+            inverse["nsPerPointFreeFluidsC"]=nsFF;
+            inverse["nsPerPointEngine"]=nsEng;
+            if ((subs->model==FF_SWtype)&&(subs->swData.eos==FF_IAPWS95)){//non iterative flash by IAPWS-IF97, and its deviation from IAPWS95
+                IF97Deviations dev;
+                double nsIF97=BenchTime(set,[&](){
+                    FF_ThermoProperties th;
+                    double liqFraction;
+                    for (unsigned s=0;s<flashP.size();s++) IF97ThermoPH(flashP[s],flashH[s],&th,&liqFraction);
+                    benchSink=th.T;
+                })/flashP.size();
+                IF97Check(flash,&dev);
+                QJsonObject if97;
+                if97["nsPerPoint"]=nsIF97;
+                if97["gridPoints"]=dev.nPoints;
+                if97["maxRelDevV"]=dev.maxV;
+                if97["maxRelDevCp"]=dev.maxCp;
+                if97["maxRelDevSS"]=dev.maxSS;
+                if97["maxDevH"]=dev.maxH;
+                if97["maxDevS"]=dev.maxS;
+                if97["worstT"]=dev.worstT;
+                if97["worstP"]=dev.worstP;
+                inverse["IF97"]=if97;
+                printf("%-28s PH flash IF97 %9.0f ns  max. deviation from IAPWS95: V %g  Cp %g  H %g J/mol\n",benchPureFluids[f].name,nsIF97,dev.maxV,dev.maxCp,dev.maxH);
+            }
+            const int nBatch=4096;
+            std::vector<double> x(nBatch),y(nBatch),liq(nBatch);
+            std::vector<FF_ThermoProperties> thBatch(nBatch);
+            for (int i=0;i<nBatch;i++){
+                x[i]=flashP[i%flashP.size()];
+                y[i]=flashH[i%flashP.size()];
+            }
+            for (int nThreads=1;;nThreads=std::min(2*nThreads,maxThreads)){
+                int solved=0;
+                double ns=BenchTime(set,[&](){solved=PureFlashBatch(flash,PURE_FLASH_PH,nBatch,x.data(),y.data(),thBatch.data(),liq.data(),NULL,nThreads);});
+                QJsonObject tp;
+                tp["threads"]=nThreads;
+                tp["pointsPerSecond"]=nBatch/(ns*1e-9);
+                tp["solved"]=solved;
+                batch.append(tp);
+                printf("%-28s PH flash batch %2d threads %10.0f points/s\n",benchPureFluids[f].name,nThreads,nBatch/(ns*1e-9));
+                if (nThreads>=maxThreads) break;
+            }
+            inverse["batch"]=batch;
+            fluid["flashPH"]=inverse;
+            printf("%-28s PH flash FreeFluidsC %9.0f ns  engine %9.0f ns\n",benchPureFluids[f].name,nsFF,nsEng);
+        }
+        delete flash;
+        fluids.append(fluid);
+        nDone++;
+    }
+    delete subs;
+
+    QJsonObject root;
+    root["benchmark"]="pure";
+    root["date"]=QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["hardwareThreads"]=hwThreads;
+    root["minTime"]=set->minTime;
+    root["repeats"]=set->repeats;
+    root["fluids"]=fluids;
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return -1;
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    return nDone;
+}
+
+//Substances of the generated mixtures, in Substances.db3. A system of n components takes the first n
+static const int benchMixIds[15]={759,758,760,757,1177,20,18,1192,21,1251,744,29,24,1250,22};//methane, ethane, propane, butane,
+//pentane, hexane, nitrogen, CO2, heptane, isobutane, benzene, toluene, decane, H2S, cyclohexane
+static const int benchMixSizes[]={2,3,5,8,12,15};
+
+//Results of one routine over the grid of conditions
+typedef struct{
+    const char *routine;
+    int calls,failures;
+    double seconds;
+    long iterations;//-1 if the routine does not report them
+    double minGr;//minimum Gr, or tpd, reached. NaN if the routine does not report it
+    SolverTelemetryStats telem;//convergence statistics, for the routines that give a convergence record
+    int tolCalls;//calls that reached the tolerance. -1 if the routine does not report the time to tol
+    double tolMs;//summed time to tol of those calls
+} BenchMixRoutine;
+
+//The parallel optimizers are run with a single thread, as serial reference, and with all the cores
+static const char *benchParallelSA[2]={"TwoPhasesFlashPTParallelSA 1 thread","TwoPhasesFlashPTParallelSA"};
+static const char *benchParallelDE[2]={"TwoPhasesFlashPTParallelDE 1 thread","TwoPhasesFlashPTParallelDE"};
+static const char *benchStabilityDE[2]={"StabilityCheckParallelDE 1 thread","StabilityCheckParallelDE"};
+
+static BenchMixRoutine *BenchRoutine(std::vector<BenchMixRoutine> *routines,const char *name){
+    for (unsigned i=0;i<routines->size();i++) if (strcmp((*routines)[i].routine,name)==0) return &(*routines)[i];
+    BenchMixRoutine r={name,0,0,0,-1,NAN};
+    SolverTelemetryStatsInit(&r.telem);
+    r.tolCalls=-1;
+    r.tolMs=0;
+    routines->push_back(r);
+    return &routines->back();
+}
+
+//Wall time of a single call, in seconds
+template<class F> static double BenchWall(F func){
+    std::chrono::steady_clock::time_point t0=std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+}
+
+static void BenchRecord(BenchMixRoutine *r,double seconds,bool ok,int iterations,double Gr){
+    r->calls++;
+    r->seconds+=seconds;
+    if (!ok) r->failures++;
+    if (iterations>=0) r->iterations=((r->iterations<0) ? 0 : r->iterations)+iterations;
+    if ((Gr==Gr)&&!(Gr>=r->minGr)) r->minGr=Gr;
+}
+
+//Adds a convergence record at T,P to the statistics of the routine
+static void BenchTelemetry(BenchMixRoutine *r,const SolverTelemetry *tel,double T,double P){
+    SolverTelemetryAccumulate(&r->telem,tel,T,P);
+}
+
+//Adds the time to tol of a global optimizer call, -1 if it did not reach the tolerance
+static void BenchRecordTol(BenchMixRoutine *r,double tolTime){
+    if (r->tolCalls<0) r->tolCalls=0;
+    if (tolTime>=0){
+        r->tolCalls++;
+        r->tolMs+=tolTime;
+    }
+}
+
+//Convergence statistics in JSON format, with the points that were more difficult
+static QJsonObject BenchTelemetryJson(const SolverTelemetryStats *stats){
+    QJsonObject o,status,start,steps;
+    QJsonArray worst;
+    int i;
+    for (i=0;i<SOLVER_STATUS_COUNT;i++) if (stats->status[i]>0) status[SolverStatusName((enum SolverStatus)i)]=stats->status[i];
+    for (i=0;i<SOLVER_STEP_COUNT;i++) if (stats->start[i]>0) start[SolverStepName((enum SolverStep)i)]=stats->start[i];
+    for (i=0;i<SOLVER_STEP_COUNT;i++) if (stats->steps[i]>0) steps[SolverStepName((enum SolverStep)i)]=(double)stats->steps[i];
+    for (i=0;i<stats->nWorst;i++){
+        QJsonObject w;
+        w["T"]=stats->worst[i].x;
+        w["P"]=stats->worst[i].y;
+        w["iterations"]=stats->worst[i].iterations;
+        w["status"]=SolverStatusName(stats->worst[i].status);
+        w["residual"]=stats->worst[i].residual;
+        worst.append(w);
+    }
+    o["status"]=status;
+    o["start"]=start;
+    o["steps"]=steps;
+    o["meanIterations"]=(double)stats->iterations/stats->calls;
+    o["maxIterations"]=stats->maxIterations;
+    o["worst"]=worst;
+    return o;
+}
+
+//Equilibrium check of two phases: max |ln(x*phiX/(y*phiY))|. The phases are tried in both orders, as the routines
+//do not all return the fugacity coefficients in the same order
+static bool BenchIsofugacity(int n,const double x[],const double y[],const double phiX[],const double phiY[]){
+    double d1=0,d2=0;
+    for (int i=0;i<n;i++){
+        if (!((x[i]>0)&&(y[i]>0))) continue;
+        d1=std::max(d1,fabs(log(x[i]*phiX[i]/(y[i]*phiY[i]))));
+        d2=std::max(d2,fabs(log(x[i]*phiY[i]/(y[i]*phiX[i]))));
+    }
+    return std::min(d1,d2)<1e-4;//false also if NaN
+}
+
+static bool BenchFinite(int n,const double v[]){
+    for (int i=0;i<n;i++) if (!(fabs(v[i])<1e300)) return false;
+    return true;
+}
+
+//Reads a mixture file written by the mixture export of the main window: FF_MixData and 15 mole fractions
+static int BenchReadMixture(const QString &fileName,FF_MixData *mix,double z[15]){
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) return 0;
+    bool ok=(file.read((char*)mix,sizeof(FF_MixData))==sizeof(FF_MixData))&&(file.read((char*)z,15*sizeof(double))==15*sizeof(double));
+    file.close();
+    return ok&&(mix->numSubs>0)&&(mix->numSubs<=15);
+}
+
+//Builds a Peng-Robinson, VdW mixing rule, equimolar system with the first n generated substances. The substances are temporaries of the arena
+static int BenchGenerateMixture(QSqlDatabase *db,CalcArena *arena,int n,FF_MixData *mix,double z[15]){
+    CalcArenaPos mark=CalcArenaMark(arena);
+    FF_SubstanceData *subs=CalcArenaNew<FF_SubstanceData>(arena,15);
+    FF_SubstanceData *subsPoint[15];
+    QSqlQuery *query=DbConnectionStatement(db,"SELECT EosParam.Id FROM EosParam INNER JOIN Eos ON EosParam.Eos=Eos.Eos WHERE (IdProduct=?) AND (Eos.Type='Cubic PR') ORDER BY EosParam.Id");
+    int i,ok=(query!=NULL);
+    memset(mix,0,sizeof(FF_MixData));
+    for (i=0;(i<n)&&ok;i++){
+        GetPreferredData(benchMixIds[i],&subs[i],db);
+        query->bindValue(0,benchMixIds[i]);
+        query->exec();
+        ok=query->next()&&(subs[i].baseProp.MW>0);
+        if (ok){
+            subs[i].cubicData.id=query->value(0).toInt();
+            subs[i].model=FF_CubicPRtype;
+            GetEOSData(&subs[i].model,&subs[i],db);
+        }
+        query->finish();
+        subsPoint[i]=&subs[i];
+        z[i]=1.0/n;
+    }
+    if (ok){
+        mix->numSubs=n;
+        mix->eosType=FF_CubicPRtype;
+        mix->mixRule=FF_VdW;
+        mix->thModelActEos=1;
+        mix->refVpEos=0;
+        FF_MixFillDataWithSubsData(&mix->numSubs,subsPoint,mix);
+        for (i=n;i<15;i++) z[i]=0;
+    }
+    CalcArenaRelease(arena,&mark);
+    return ok;
+}
+
+//Runs every routine over a grid of temperatures and pressures around the pseudo critical point of the mixture.
+//Returns also the system allocations made by the arenas after the first temperature, that must be 0
+static QJsonArray BenchMixRoutines(FF_MixData *mix,const double z[15],uint64_t *steadyAllocs){
+    std::vector<BenchMixRoutine> routines;
+    int i,n=mix->numSubs;
+    double Tpc=0,Ppc=0;
+    GlobalOptSettings optSet;
+    SolverTelemetry optTelem;
+    double optTol;
+    GlobalOptDefaultSettings(&optSet);
+    optSet.telem=&optTelem;
+    optSet.tolTime=&optTol;
+    const int optThreads[2]={1,GlobalOptThreads(&optSet)};
+    routines.reserve(32);
+    for (i=0;i<n;i++){
+        Tpc+=z[i]*mix->cubicData[i].Tc;
+        Ppc+=z[i]*mix->cubicData[i].Pc;
+    }
+    uint64_t allocs0=0;
+    for (int iT=0;iT<3;iT++){
+        if (iT==1) allocs0=CalcArenaSystemAllocs();//the first point warms up the arenas
+        double T=Tpc*(0.6+0.15*iT),P,Pguess=0,Tguess=0,Tout,bubbleP=0,dewP=0;
+        double x[15],y[15],w[15],phiX[15],phiY[15],phiW[15],betaA=-1,betaB=-1,Gr=NAN,tpd=NAN;
+        SatResult sat;
+        double zz[15];
+        for (i=0;i<15;i++) zz[i]=z[i];
+        //saturation at T
+        double t=BenchWall([&](){FF_BubbleP(mix,&T,zz,&Pguess,&bubbleP,y,phiX,phiY);});
+        BenchRecord(BenchRoutine(&routines,"FF_BubbleP"),t,(bubbleP>0)&&BenchIsofugacity(n,zz,y,phiX,phiY),-1,NAN);
+        t=BenchWall([&](){FF_DewP(mix,&T,zz,&Pguess,&dewP,x,phiX,phiY);});
+        BenchRecord(BenchRoutine(&routines,"FF_DewP"),t,(dewP>0)&&BenchIsofugacity(n,x,zz,phiX,phiY),-1,NAN);
+        int satOk=0;
+        t=BenchWall([&](){satOk=SatBubbleP(mix,T,zz,0,NULL,&sat);});
+        BenchRecord(BenchRoutine(&routines,"SatBubbleP"),t,satOk==1,(satOk==1) ? sat.iterations : -1,NAN);
+        BenchTelemetry(BenchRoutine(&routines,"SatBubbleP"),&sat.telem,T,(satOk==1) ? sat.P : 0);
+        t=BenchWall([&](){satOk=SatDewP(mix,T,zz,0,NULL,&sat);});
+        BenchRecord(BenchRoutine(&routines,"SatDewP"),t,satOk==1,(satOk==1) ? sat.iterations : -1,NAN);
+        BenchTelemetry(BenchRoutine(&routines,"SatDewP"),&sat.telem,T,(satOk==1) ? sat.P : 0);
+
+        //pressure inside the two phases region if it has been found
+        if ((bubbleP>0)&&(dewP>0)&&(bubbleP<1e9)&&(dewP<1e9)) P=sqrt(bubbleP*dewP);
+        else P=0.3*Ppc;
+        Tout=0;
+        t=BenchWall([&](){FF_BubbleT(mix,&P,zz,&Tguess,&Tout,y,phiX,phiY);});
+        BenchRecord(BenchRoutine(&routines,"FF_BubbleT"),t,(Tout>0)&&BenchIsofugacity(n,zz,y,phiX,phiY),-1,NAN);
+        Tout=0;
+        t=BenchWall([&](){FF_DewT(mix,&P,zz,&Tguess,&Tout,x,phiX,phiY);});
+        BenchRecord(BenchRoutine(&routines,"FF_DewT"),t,(Tout>0)&&BenchIsofugacity(n,x,zz,phiX,phiY),-1,NAN);
+        t=BenchWall([&](){satOk=SatBubbleT(mix,P,zz,0,NULL,&sat);});
+        BenchRecord(BenchRoutine(&routines,"SatBubbleT"),t,satOk==1,(satOk==1) ? sat.iterations : -1,NAN);
+        BenchTelemetry(BenchRoutine(&routines,"SatBubbleT"),&sat.telem,(satOk==1) ? sat.T : 0,P);
+        t=BenchWall([&](){satOk=SatDewT(mix,P,zz,0,NULL,&sat);});
+        BenchRecord(BenchRoutine(&routines,"SatDewT"),t,satOk==1,(satOk==1) ? sat.iterations : -1,NAN);
+        BenchTelemetry(BenchRoutine(&routines,"SatDewT"),&sat.telem,(satOk==1) ? sat.T : 0,P);
+
+        //flashes and stability at T,P
+        FF_FeedData data;
+        data.mix=mix;
+        data.T=T;
+        data.P=P;
+        for (i=0;i<15;i++) data.z[i]=z[i];
+        t=BenchWall([&](){FF_TwoPhasesFlashPT(mix,&T,&P,zz,x,y,phiX,phiY,&betaA);});
+        BenchRecord(BenchRoutine(&routines,"FF_TwoPhasesFlashPT"),t,(betaA>=0)&&(betaA<=1)&&(((betaA==0)||(betaA==1))||BenchIsofugacity(n,x,y,phiX,phiY)),-1,NAN);
+        t=BenchWall([&](){FF_TwoPhasesFlashPTSA(&data,x,y,phiX,phiY,&betaA,&Gr);});
+        BenchRecord(BenchRoutine(&routines,"FF_TwoPhasesFlashPTSA"),t,(betaA>=0)&&(betaA<=1)&&BenchFinite(n,x),-1,Gr);
+        t=BenchWall([&](){FF_TwoPhasesFlashPTDE(&data,x,y,phiX,phiY,&betaA,&Gr);});
+        BenchRecord(BenchRoutine(&routines,"FF_TwoPhasesFlashPTDE"),t,(betaA>=0)&&(betaA<=1)&&BenchFinite(n,x),-1,Gr);
+        int parOk=0;
+        for (int s=0;s<2;s++){
+            optSet.nThreads=optThreads[s];
+            t=BenchWall([&](){parOk=TwoPhasesFlashPTParallelSA(&data,&optSet,x,y,phiX,phiY,&betaA,&Gr);});
+            if (parOk){
+                BenchMixRoutine *r=BenchRoutine(&routines,benchParallelSA[s]);
+                BenchRecord(r,t,(betaA>=0)&&(betaA<=1)&&BenchFinite(n,x),-1,Gr);
+                BenchTelemetry(r,&optTelem,T,P);
+                BenchRecordTol(r,optTol);
+            }
+        }
+        for (int s=0;s<2;s++){
+            optSet.nThreads=optThreads[s];
+            t=BenchWall([&](){parOk=TwoPhasesFlashPTParallelDE(&data,&optSet,x,y,phiX,phiY,&betaA,&Gr);});
+            if (parOk){
+                BenchMixRoutine *r=BenchRoutine(&routines,benchParallelDE[s]);
+                BenchRecord(r,t,(betaA>=0)&&(betaA<=1)&&BenchFinite(n,x),-1,Gr);
+                BenchTelemetry(r,&optTelem,T,P);
+                BenchRecordTol(r,optTol);
+            }
+        }
+        t=BenchWall([&](){FF_ThreePhasesFlashPTSA(&data,x,y,w,phiX,phiY,phiW,&betaA,&betaB,&Gr);});
+        BenchRecord(BenchRoutine(&routines,"FF_ThreePhasesFlashPTSA"),t,(betaA>=0)&&(betaB>=0)&&(betaA+betaB<=1+1e-9)&&BenchFinite(n,x),-1,Gr);
+        t=BenchWall([&](){FF_StabilityCheck(&data,&tpd,w);});
+        BenchRecord(BenchRoutine(&routines,"FF_StabilityCheck"),t,tpd==tpd,-1,tpd);
+        t=BenchWall([&](){FF_StabilityCheckSA(&data,&tpd,w);});
+        BenchRecord(BenchRoutine(&routines,"FF_StabilityCheckSA"),t,tpd==tpd,-1,tpd);
+        for (int s=0;s<2;s++){
+            optSet.nThreads=optThreads[s];
+            t=BenchWall([&](){parOk=StabilityCheckParallelDE(&data,&optSet,&tpd,w);});
+            if (parOk){
+                BenchMixRoutine *r=BenchRoutine(&routines,benchStabilityDE[s]);
+                BenchRecord(r,t,tpd==tpd,-1,tpd);
+                BenchTelemetry(r,&optTelem,T,P);
+                BenchRecordTol(r,optTol);
+            }
+        }
+
+        //envelopes, only defined for binary systems
+        if (n==2){
+            int numPoints=21;
+            double base[21],bub[21],gas[21],dew[21],liquid[21];
+            int bad=0;
+            t=BenchWall([&](){FF_PressureEnvelope(mix,&T,&numPoints,base,bub,gas,dew,liquid);});
+            for (i=0;i<numPoints;i++) if (!((bub[i]>0)&&(dew[i]>0)&&(bub[i]<1e300)&&(dew[i]<1e300))) bad++;
+            BenchRecord(BenchRoutine(&routines,"FF_PressureEnvelope"),t,bad==0,-1,NAN);
+            t=BenchWall([&](){FF_TemperatureEnvelope(mix,&P,&numPoints,base,bub,gas,dew,liquid);});
+            bad=0;
+            for (i=0;i<numPoints;i++) if (!((bub[i]>0)&&(dew[i]>0)&&(bub[i]<1e300)&&(dew[i]<1e300))) bad++;
+            BenchRecord(BenchRoutine(&routines,"FF_TemperatureEnvelope"),t,bad==0,-1,NAN);
+        }
+    }
+    *steadyAllocs=CalcArenaSystemAllocs()-allocs0;
+    QJsonArray result;
+    for (unsigned k=0;k<routines.size();k++){
+        QJsonObject r;
+        r["routine"]=routines[k].routine;
+        r["calls"]=routines[k].calls;
+        r["failures"]=routines[k].failures;
+        r["wallTime"]=routines[k].seconds;
+        r["msPerCall"]=1e3*routines[k].seconds/routines[k].calls;
+        if (routines[k].iterations>=0) r["iterationsPerCall"]=(double)routines[k].iterations/routines[k].calls;
+        if (routines[k].minGr==routines[k].minGr) r["minGr"]=routines[k].minGr;
+        if (routines[k].telem.calls>0) r["convergence"]=BenchTelemetryJson(&routines[k].telem);
+        if (routines[k].tolCalls>=0){
+            r["tolReached"]=routines[k].tolCalls;
+            if (routines[k].tolCalls>0) r["msToTol"]=routines[k].tolMs/routines[k].tolCalls;
+        }
+        result.append(r);
+    }
+    return result;
+}
+
+//Mixture equilibrium benchmark, on the mixture files (*.md) of mixDir and on generated systems of 2 to 15 components.
+//Writes the JSON result to fileName. Returns the number of mixtures benchmarked, -1 if the file can not be written
+int BenchMixRun(QSqlDatabase *db,const QString &mixDir,const QString &fileName){
+    QJsonArray mixtures;
+    CalcArena arena;//one job per mixture
+    double z[15];
+    int nDone=0;
+    QStringList files=QDir(mixDir).entryList(QStringList("*.md"),QDir::Files,QDir::Name);
+    CalcArenaInit(&arena,0);
+    for (int f=0;f<files.size()+(int)(sizeof(benchMixSizes)/sizeof(benchMixSizes[0]));f++){
+        QJsonObject m;
+        int ok;
+        uint64_t allocs0=CalcArenaSystemAllocs(),steadyAllocs;
+        CalcArenaReset(&arena);
+        FF_MixData *mix=CalcArenaNew<FF_MixData>(&arena,1);
+        std::chrono::steady_clock::time_point t0=std::chrono::steady_clock::now();
+        if (f<files.size()){
+            m["name"]=files[f];
+            m["source"]="file";
+            ok=BenchReadMixture(QDir(mixDir).filePath(files[f]),mix,z);
+        }
+        else{
+            int n=benchMixSizes[f-files.size()];
+            m["name"]=QString("generated %1 components").arg(n);
+            m["source"]="generated";
+            ok=BenchGenerateMixture(db,&arena,n,mix,z);
+        }
+        if (!ok){
+            m["error"]="mixture not available";
+            mixtures.append(m);
+            continue;
+        }
+        m["numSubs"]=mix->numSubs;
+        m["routines"]=BenchMixRoutines(mix,z,&steadyAllocs);
+        double total=std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+        m["wallTime"]=total;
+        QJsonObject mem;
+        mem["systemAllocs"]=(double)(CalcArenaSystemAllocs()-allocs0);
+        mem["steadyStateSystemAllocs"]=(double)steadyAllocs;
+        mem["peakBytes"]=(double)arena.peak;
+        m["arena"]=mem;
+        printf("%-40s %2d components %8.2f s\n",m["name"].toString().toUtf8().constData(),mix->numSubs,total);
+        mixtures.append(m);
+        nDone++;
+    }
+    CalcArenaFree(&arena);
+
+    QJsonObject root;
+    root["benchmark"]="mixture";
+    root["date"]=QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["hardwareThreads"]=(int)std::thread::hardware_concurrency();
+    root["mixtures"]=mixtures;
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return -1;
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    return nDone;
+}
+
+//True if the command line asks for a benchmark
+bool BenchRequested(int argc,char *argv[]){
+    return (argc>1)&&((strcmp(argv[1],"--bench-pure")==0)||(strcmp(argv[1],"--bench-mix")==0)||(strcmp(argv[1],"--self-check")==0));
+}
+
+//Entry point for the command line benchmark options. Returns the process exit code
+//  --bench-pure [result.json] [database]
+//  --bench-mix [result.json] [database] [mixtures directory]
+//  --self-check
+int BenchMain(int argc,char *argv[]){
+    QCoreApplication app(argc,argv);
+    if (strcmp(argv[1],"--self-check")==0){//checks that do not need the substances database
+        QString report;
+        int ok=DataBaseWriteBatchCheck(&report);
+        printf("Write batch check: %s\n%s",ok ? "passed" : "FAILED",report.toUtf8().constData());
+        return ok ? 0 : 1;
+    }
+    BenchSettings set;
+    bool pure=(strcmp(argv[1],"--bench-pure")==0);
+    QString fileName=(argc>2) ? argv[2] : (pure ? "bench_pure.json" : "bench_mix.json");
+    QSqlDatabase db=QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName((argc>3) ? argv[3] : "Substances.db3");
+    if (!db.open()){
+        fprintf(stderr,"It has been impossible to open the database\n");
+        return 1;
+    }
+    BenchDefaultSettings(&set);
+    int n;
+    if (pure) n=BenchPureRun(&db,&set,fileName);
+    else n=BenchMixRun(&db,(argc>4) ? argv[4] : "Data",fileName);
+    DbConnectionRelease();
+    db.close();
+    if (n<0){
+        fprintf(stderr,"It has been impossible to write %s\n",fileName.toUtf8().constData());
+        return 1;
+    }
+    printf("%i %s benchmarked, results in %s\n",n,pure ? "fluids" : "mixtures",fileName.toUtf8().constData());
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * calcarena.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "calcarena.h"
+
+#include <stdlib.h>
+#include <atomic>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#define CALC_ARENA_ALIGN 64 //alignment of the blocks, a cache line
+#define CALC_ARENA_THREAD_SIZE (256*1024) //initial size of the thread scratch arenas
+
+struct CalcArenaChunk{
+    CalcArenaChunk *next;
+    size_t size,used;
+};
+
+static std::atomic<uint64_t> arenaSystemAllocs(0);
+
+//Aligned block from the system. Windows has no posix_memalign, and its aligned blocks must be freed with _aligned_free
+static void *CalcArenaSystemAlloc(size_t bytes){
+    void *p=NULL;
+#ifdef _WIN32
+    p=_aligned_malloc(bytes,CALC_ARENA_ALIGN);
+    if(p==NULL) return NULL;
+#else
+    if(posix_memalign(&p,CALC_ARENA_ALIGN,bytes)!=0) return NULL;
+#endif
+    arenaSystemAllocs.fetch_add(1,std::memory_order_relaxed);
+    return p;
+}
+
+static void CalcArenaSystemFree(void *p){
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static inline size_t CalcArenaAlignUp(size_t v,size_t align){
+    return (v+align-1)&~(align-1);
+}
+
+//Initializes the arena with a main block of the given size. Size 0 delays the block until the first reset
+void CalcArenaInit(CalcArena *arena,size_t size){
+    arena->base=NULL;
+    arena->size=0;
+    arena->used=arena->peak=arena->extraBytes=arena->pending=0;
+    arena->extra=NULL;
+    arena->allocs=arena->resets=arena->systemAllocs=0;
+    if(size>0){
+        arena->base=(char*)CalcArenaSystemAlloc(size);
+        if(arena->base!=NULL){
+            arena->size=size;
+            arena->systemAllocs++;
+        }
+    }
+}
+
+//Returns uninitialized memory of the given size and alignment (a power of 2), valid until the next reset
+void *CalcArenaAlloc(CalcArena *arena,size_t bytes,size_t align){
+    size_t start;
+    arena->allocs++;
+    if(align<sizeof(void*)) align=sizeof(void*);
+    start=CalcArenaAlignUp(arena->used,align);
+    if(start+bytes<=arena->size){
+        arena->used=start+bytes;
+        if(arena->used+arena->extraBytes>arena->peak) arena->peak=arena->used+arena->extraBytes;
+        return arena->base+start;
+    }
+    //the main block is full: last overflow chunk, or a new one
+    CalcArenaChunk *ch=arena->extra;
+    size_t header=CalcArenaAlignUp(sizeof(CalcArenaChunk),CALC_ARENA_ALIGN);
+    if(ch!=NULL){
+        start=CalcArenaAlignUp(ch->used,align);
+        if(start+bytes<=ch->size){
+            arena->extraBytes+=start+bytes-ch->used;
+            ch->used=start+bytes;
+            if(arena->used+arena->extraBytes>arena->peak) arena->peak=arena->used+arena->extraBytes;
+            return (char*)ch+start;
+        }
+    }
+    size_t chSize=header+CalcArenaAlignUp(bytes,align);
+    if(chSize<arena->size/2) chSize=arena->size/2;//grows geometrically
+    if(chSize<4096) chSize=4096;
+    ch=(CalcArenaChunk*)CalcArenaSystemAlloc(chSize);
+    if(ch==NULL) return NULL;
+    arena->systemAllocs++;
+    ch->next=arena->extra;
+    ch->size=chSize;
+    start=CalcArenaAlignUp(header,align);
+    ch->used=start+bytes;
+    arena->extra=ch;
+    arena->extraBytes+=ch->used;
+    if(arena->used+arena->extraBytes>arena->peak) arena->peak=arena->used+arena->extraBytes;
+    return (char*)ch+start;
+}
+
+//Frees the overflow chunks newer than the given one, keeping their size to enlarge the main block
+static void CalcArenaDropChunks(CalcArena *arena,CalcArenaChunk *keep){
+    while(arena->extra!=keep){
+        CalcArenaChunk *next=arena->extra->next;
+        arena->pending+=arena->extra->size;
+        CalcArenaSystemFree(arena->extra);
+        arena->extra=next;
+    }
+}
+
+//Replaces the empty main block by one able to hold also the overflow of the previous jobs
+static void CalcArenaGrow(CalcArena *arena){
+    size_t total=arena->size+arena->pending;
+    char *base=(char*)CalcArenaSystemAlloc(total);
+    if(base==NULL) return;//the old block is kept, and the growth tried again at the next reset
+    CalcArenaSystemFree(arena->base);
+    arena->base=base;
+    arena->size=total;
+    arena->pending=0;
+    arena->systemAllocs++;
+}
+
+//Position of the arena, to release later the allocations made after it, as a stack
+CalcArenaPos CalcArenaMark(const CalcArena *arena){
+    CalcArenaPos pos;
+    pos.used=arena->used;
+    pos.extra=arena->extra;
+    pos.chunkUsed=arena->extra!=NULL ? arena->extra->used : 0;
+    pos.extraBytes=arena->extraBytes;
+    return pos;
+}
+
+//Releases the allocations made after the mark. When the arena becomes empty, the overflow chunks are merged in the main block
+void CalcArenaRelease(CalcArena *arena,const CalcArenaPos *mark){
+    CalcArenaDropChunks(arena,mark->extra);
+    if(arena->extra!=NULL) arena->extra->used=mark->chunkUsed;
+    arena->extraBytes=mark->extraBytes;
+    arena->used=mark->used;
+    if((arena->used==0)&&(arena->extra==NULL)&&(arena->pending>0)) CalcArenaGrow(arena);
+}
+
+//Releases all the allocations of the job in O(1). Merges the overflow chunks into a larger main block
+void CalcArenaReset(CalcArena *arena){
+    arena->resets++;
+    arena->used=0;
+    arena->extraBytes=0;
+    CalcArenaDropChunks(arena,NULL);
+    if(arena->pending>0) CalcArenaGrow(arena);
+}
+
+//Gives back all the memory to the system
+void CalcArenaFree(CalcArena *arena){
+    while(arena->extra!=NULL){
+        CalcArenaChunk *next=arena->extra->next;
+        CalcArenaSystemFree(arena->extra);
+        arena->extra=next;
+    }
+    CalcArenaSystemFree(arena->base);
+    arena->base=NULL;
+    arena->size=arena->used=arena->extraBytes=arena->pending=0;
+}
+
+//Owner of the scratch arena of a thread, frees it when the thread ends
+struct CalcArenaThreadOwner{
+    CalcArena arena;
+    CalcArenaThreadOwner(){CalcArenaInit(&arena,CALC_ARENA_THREAD_SIZE);}
+    ~CalcArenaThreadOwner(){CalcArenaFree(&arena);}
+};
+
+//Scratch arena of the calling thread, for the solver temporaries. Released with CalcArenaMark/CalcArenaRelease
+CalcArena *CalcArenaThread(){
+    static thread_local CalcArenaThreadOwner owner;
+    return &owner.arena;
+}
+
+//Number of system allocations made by all the arenas since the program start
+uint64_t CalcArenaSystemAllocs(){
+    return arenaSystemAllocs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,225 @@
+/*
+ * coltable.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "coltable.h"
+
+#include <string.h>
+#include <vector>
+#include <QByteArray>
+
+//Writes zeros up to the next multiple of 64 bytes
+static void ColTableAlign(QFile *file){
+    static const char zeros[64]={0};
+    qint64 pad=(64-file->pos()%64)%64;
+    if(pad>0) file->write(zeros,pad);
+}
+
+//Writes the table. The header supplies the ids, name and flags, the counts and offsets are filled here.
+//chunkRows<=0 writes each column as a single chunk, or in chunks of COL_TABLE_MAX_CHUNK_ROWS if it is longer.
+//Returns 0 if the file can not be written
+int ColTableWrite(const QString &fileName,const ColTableHeader *header,int nColumns,const ColTableColumnData columns[],int64_t nRows,int chunkRows){
+    ColTableHeader h=*header;
+    int i,k,nChunks;
+    int64_t chunkTableOffset,first,rows;
+    QFile file(fileName);
+    if((nColumns<1)||(nRows<0)) return 0;
+    if((chunkRows<=0)||(chunkRows>nRows)) chunkRows=(nRows>0) ? (int)(nRows<COL_TABLE_MAX_CHUNK_ROWS ? nRows : COL_TABLE_MAX_CHUNK_ROWS) : 1;
+    else if(chunkRows>COL_TABLE_MAX_CHUNK_ROWS) chunkRows=COL_TABLE_MAX_CHUNK_ROWS;
+    if((nRows+chunkRows-1)/chunkRows>0x7fffffff) return 0;//the chunk count is stored as int32
+    nChunks=(int)((nRows+chunkRows-1)/chunkRows);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate)) return 0;
+    h.magic=COL_TABLE_MAGIC;
+    h.version=COL_TABLE_VERSION;
+    h.nColumns=nColumns;
+    h.chunkRows=chunkRows;
+    h.nRows=nRows;
+    h.reserved=0;
+    h.subsName[sizeof(h.subsName)-1]=0;
+    h.columnOffset=sizeof(ColTableHeader);
+    chunkTableOffset=h.columnOffset+nColumns*sizeof(ColTableColumn);
+    std::vector<ColTableColumn> col(nColumns);
+    std::vector<ColTableChunk> chunk((size_t)nColumns*nChunks);
+    memset(&col[0],0,nColumns*sizeof(ColTableColumn));
+    for(i=0;i<nColumns;i++){
+        QByteArray name=columns[i].name.toUtf8(),unit=columns[i].unit.toUtf8();
+        strncpy(col[i].name,name.constData(),sizeof(col[i].name)-1);
+        strncpy(col[i].unit,unit.constData(),sizeof(col[i].unit)-1);
+        col[i].type=COL_TABLE_FLOAT64;
+        col[i].nChunks=nChunks;
+        col[i].chunkOffset=chunkTableOffset+(int64_t)i*nChunks*sizeof(ColTableChunk);
+    }
+    //the directories are written first, and again at the end with the chunk positions
+    file.write((const char*)&h,sizeof(h));
+    file.write((const char*)&col[0],nColumns*sizeof(ColTableColumn));
+    if(nChunks>0) file.write((const char*)&chunk[0],chunk.size()*sizeof(ColTableChunk));
+    for(i=0;i<nColumns;i++){
+        ColTableAlign(&file);
+        for(k=0;k<nChunks;k++){
+            ColTableChunk *c=&chunk[(size_t)i*nChunks+k];
+            first=(int64_t)k*chunkRows;
+            rows=(nRows-first<chunkRows) ? nRows-first : chunkRows;
+            c->offset=file.pos();
+            if(h.flags & COL_TABLE_COMPRESSED){
+                QByteArray packed=qCompress((const uchar*)(columns[i].values+first),(int)(rows*sizeof(double)));
+                c->bytes=packed.size();
+                if(file.write(packed)!=packed.size()) return 0;
+            }
+            else{
+                c->bytes=rows*sizeof(double);
+                if(file.write((const char*)(columns[i].values+first),c->bytes)!=c->bytes) return 0;
+            }
+        }
+    }
+    if(nChunks>0){
+        file.seek(chunkTableOffset);
+        file.write((const char*)&chunk[0],chunk.size()*sizeof(ColTableChunk));
+    }
+    file.close();
+    return 1;
+}
+
+//Checks that a block lies inside the file
+static int ColTableInside(const ColTable *table,int64_t offset,int64_t bytes){
+    return (offset>=(int64_t)sizeof(ColTableHeader))&&(bytes>=0)&&(bytes<=table->size)&&(offset<=table->size-bytes);
+}
+
+//Checks the chunks of a column against the rows given by the header. Uncompressed chunks must hold exactly their rows,
+//be aligned for double and follow each other, as ColTableValues gives the whole column from the first one.
+//Compressed chunks must announce, in the qCompress big endian size prefix, the size of their rows
+static int ColTableChunksValid(const ColTable *table,const ColTableColumn *c){
+    const ColTableHeader *h=ColTableGetHeader(table);
+    const ColTableChunk *chunk=(const ColTableChunk*)(table->base+c->chunkOffset);
+    for(int k=0;k<c->nChunks;k++){
+        int64_t first=(int64_t)k*h->chunkRows;
+        int64_t bytes=((h->nRows-first<h->chunkRows) ? h->nRows-first : h->chunkRows)*sizeof(double);
+        if(!ColTableInside(table,chunk[k].offset,chunk[k].bytes)||(chunk[k].bytes>0x7fffffff)) return 0;
+        if(h->flags & COL_TABLE_COMPRESSED){
+            if(chunk[k].bytes<4) return 0;
+            const uchar *p=table->base+chunk[k].offset;
+            if((((int64_t)p[0]<<24)|(p[1]<<16)|(p[2]<<8)|p[3])!=bytes) return 0;
+        }
+        else{
+            if((chunk[k].bytes!=bytes)||(chunk[k].offset%sizeof(double)!=0)) return 0;
+            if((k>0)&&(chunk[k].offset!=chunk[k-1].offset+chunk[k-1].bytes)) return 0;
+        }
+    }
+    return 1;
+}
+
+//Opens and maps a table. Returns 0 if the file does not exist or is not a valid table: the chunk directory must
+//agree with the rows in the header, and the uncompressed columns be contiguous
+int ColTableOpen(const QString &fileName,ColTable *table){
+    int i;
+    const ColTableHeader *h;
+    table->file=new QFile(fileName);
+    table->base=NULL;
+    table->size=0;
+    if(table->file->open(QIODevice::ReadOnly)){
+        table->size=table->file->size();
+        if(table->size>=(qint64)sizeof(ColTableHeader)) table->base=table->file->map(0,table->size);
+    }
+    if(table->base==NULL){
+        ColTableClose(table);
+        return 0;
+    }
+    h=(const ColTableHeader*)table->base;
+    if((h->magic!=COL_TABLE_MAGIC)||(h->version!=COL_TABLE_VERSION)||(h->nColumns<1)||(h->chunkRows<1)||
+            (h->chunkRows>COL_TABLE_MAX_CHUNK_ROWS)||(h->nRows<0)||
+            !ColTableInside(table,h->columnOffset,h->nColumns*(int64_t)sizeof(ColTableColumn))){
+        ColTableClose(table);
+        return 0;
+    }
+    for(i=0;i<h->nColumns;i++){
+        const ColTableColumn *c=ColTableGetColumn(table,i);
+        if((c->type!=COL_TABLE_FLOAT64)||(c->nChunks!=(h->nRows+h->chunkRows-1)/h->chunkRows)||
+                !ColTableInside(table,c->chunkOffset,c->nChunks*(int64_t)sizeof(ColTableChunk))){
+            ColTableClose(table);
+            return 0;
+        }
+        if(!ColTableChunksValid(table,c)){
+            ColTableClose(table);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+//Unmaps and closes the table
+void ColTableClose(ColTable *table){
+    if(table->file!=NULL){
+        if(table->base!=NULL) table->file->unmap((uchar*)table->base);
+        table->file->close();
+        delete table->file;
+    }
+    table->file=NULL;
+    table->base=NULL;
+    table->size=0;
+}
+
+//Header and column description of an open table
+const ColTableHeader *ColTableGetHeader(const ColTable *table){
+    return (const ColTableHeader*)table->base;
+}
+
+const ColTableColumn *ColTableGetColumn(const ColTable *table,int column){
+    const ColTableHeader *h=ColTableGetHeader(table);
+    if((column<0)||(column>=h->nColumns)) return NULL;
+    return (const ColTableColumn*)(table->base+h->columnOffset)+column;
+}
+
+//Position of the column with the given name, -1 if not found
+int ColTableFind(const ColTable *table,const char *name){
+    const ColTableHeader *h=ColTableGetHeader(table);
+    for(int i=0;i<h->nColumns;i++) if(strncmp(ColTableGetColumn(table,i)->name,name,sizeof(((ColTableColumn*)0)->name))==0) return i;
+    return -1;
+}
+
+//Direct access to the values of an uncompressed column, contiguous as checked by ColTableOpen. NULL if the table is compressed
+const double *ColTableValues(const ColTable *table,int column){
+    const ColTableColumn *c=ColTableGetColumn(table,column);
+    if((c==NULL)||(ColTableGetHeader(table)->flags & COL_TABLE_COMPRESSED)||(c->nChunks<1)) return NULL;
+    return (const double*)(table->base+((const ColTableChunk*)(table->base+c->chunkOffset))->offset);
+}
+
+//Copies, decompressing if needed, the values of a column to values[nRows]. Returns 0 on error
+int ColTableRead(const ColTable *table,int column,double values[]){
+    const ColTableHeader *h=ColTableGetHeader(table);
+    const ColTableColumn *c=ColTableGetColumn(table,column);
+    if(c==NULL) return 0;
+    const ColTableChunk *chunk=(const ColTableChunk*)(table->base+c->chunkOffset);
+    for(int k=0;k<c->nChunks;k++){
+        int64_t first=(int64_t)k*h->chunkRows;
+        int64_t bytes=((h->nRows-first<h->chunkRows) ? h->nRows-first : h->chunkRows)*sizeof(double);
+        if(h->flags & COL_TABLE_COMPRESSED){
+            QByteArray raw=qUncompress(table->base+chunk[k].offset,(int)chunk[k].bytes);
+            if(raw.size()!=bytes) return 0;
+            memcpy(values+first,raw.constData(),bytes);
+        }
+        else{
+            if(chunk[k].bytes!=bytes) return 0;
+            memcpy(values+first,table->base+chunk[k].offset,bytes);
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,395 @@
+/*
+ * cubicmixkernel.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "cubicmixkernel.h"
+#include "eostcache.h"
+#include "eoskernel.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CMK_WIDTH 4
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CMK_WIDTH 2
+#else
+#define CMK_WIDTH 1
+#endif
+
+//Binary interaction parameter at T, according to the interaction equation selected for the mixture
+static double CubicMixKij(FF_MixData *mix,int i,int j,double T){
+    double *p=mix->intParam[i][j];
+    if((mix->intForm==FF_Pol2)||(mix->intForm==FF_Pol2C)||(mix->intForm==FF_Pol2J)||(mix->intForm==FF_Pol2K)) return p[0]+p[1]*T+p[2]/(T*T);
+    else if((mix->intForm==FF_Pol3)||(mix->intForm==FF_Pol3C)||(mix->intForm==FF_Pol3J)||(mix->intForm==FF_Pol3K)) return p[0]+p[1]/T+p[2]*T;
+    return p[0]+p[1]*T+p[2]*T*T;//Pol1, also when no equation has been selected
+}
+
+//Interaction parameter kij and its temperature derivative
+double CubicMixKijDer(FF_MixData *mix,int i,int j,double T,double *dkij){
+    double *p=mix->intParam[i][j];
+    if((mix->intForm==FF_Pol2)||(mix->intForm==FF_Pol2C)||(mix->intForm==FF_Pol2J)||(mix->intForm==FF_Pol2K)){
+        *dkij=p[1]-2*p[2]/(T*T*T);
+        return p[0]+p[1]*T+p[2]/(T*T);
+    }
+    else if((mix->intForm==FF_Pol3)||(mix->intForm==FF_Pol3C)||(mix->intForm==FF_Pol3J)||(mix->intForm==FF_Pol3K)){
+        *dkij=-p[1]/(T*T)+p[2];
+        return p[0]+p[1]/T+p[2]*T;
+    }
+    *dkij=p[1]+2*p[2]*T;
+    return p[0]+p[1]*T+p[2]*T*T;
+}
+
+//Interaction parameter kij and its temperature derivative, from the coefficients kept in the kernel
+double CubicMixKernelKijDer(const CubicMixKernel *ker,int i,int j,double T,double *dkij){
+    double p0=ker->kijP[0][i][j],p1=ker->kijP[1][i][j],p2=ker->kijP[2][i][j];
+    if(ker->kijForm==CMK_KIJ_POL2){
+        *dkij=p1-2*p2/(T*T*T);
+        return p0+p1*T+p2/(T*T);
+    }
+    else if(ker->kijForm==CMK_KIJ_POL3){
+        *dkij=-p1/(T*T)+p2;
+        return p0+p1/T+p2*T;
+    }
+    *dkij=p1+2*p2*T;
+    return p0+p1*T+p2*T*T;
+}
+
+//Pure substance a(T), b and c
+static void CubicMixPureParam(FF_MixData *mix,int i,double T,FF_CubicParam *param){
+    EosTCacheCubic(&mix->cubicData[i],T,param);
+}
+
+//Prepares the kernel for the mixture. Returns 0 if the mixture is not a cubic one with VdW or PR mixing rule
+int CubicMixKernelInit(FF_MixData *mix,CubicMixKernel *ker){
+    int i;
+    FF_CubicParam param;
+    EosKernel eos;
+    if(!((mix->eosType==FF_CubicType)||(mix->eosType==FF_CubicPRtype)||(mix->eosType==FF_CubicSRKtype))) return 0;
+    if(!((mix->mixRule==FF_VdW)||(mix->mixRule==FF_PR))) return 0;
+    if((mix->numSubs<1)||(mix->numSubs>15)) return 0;
+    memset(ker,0,sizeof(CubicMixKernel));
+    ker->n=mix->numSubs;
+    ker->nPad=((ker->n+CMK_WIDTH-1)/CMK_WIDTH)*CMK_WIDTH;
+    ker->rule=mix->mixRule;
+    for(i=0;i<ker->n;i++){
+        FF_FixedParamCubic(&mix->cubicData[i],&param);
+        if(i==0){
+            ker->u=param.u;
+            ker->w=param.w;
+        }
+        else if((param.u!=ker->u)||(param.w!=ker->w)) return 0;//all substances must use the same cubic form
+        ker->b[i]=param.b;
+        ker->c[i]=param.c;
+        ker->Tc[i]=mix->baseProp[i].Tc;
+        ker->Pc[i]=mix->baseProp[i].Pc;
+        ker->omega[i]=mix->baseProp[i].w;
+        //the alpha function, if it has a native implementation validated against FreeFluidsC
+        ker->alpha[i]=CMK_ALPHA_GENERIC;
+        if(EosKernelBuildCubic(&mix->cubicData[i],&eos)==1){
+            if(eos.variant==EOS_KER_SOAVE){
+                ker->alpha[i]=CMK_ALPHA_SOAVE;
+                ker->alphaP[0][i]=eos.soave.alpha.m;
+            }
+            else if(eos.variant==EOS_KER_PRSV1){
+                ker->alpha[i]=CMK_ALPHA_PRSV1;
+                ker->alphaP[0][i]=eos.prsv1.alpha.m;
+                ker->alphaP[1][i]=eos.prsv1.alpha.k1;
+            }
+            else if(eos.variant==EOS_KER_TWU91){
+                ker->alpha[i]=CMK_ALPHA_TWU91;
+                ker->alphaP[0][i]=eos.twu91.alpha.L;
+                ker->alphaP[1][i]=eos.twu91.alpha.M;
+                ker->alphaP[2][i]=eos.twu91.alpha.N;
+            }
+            ker->a0[i]=eos.soave.k.a;
+            ker->alphaTc[i]=eos.soave.k.Tc;
+        }
+        if(ker->alpha[i]==CMK_ALPHA_GENERIC) ker->a0[i]=1;//a(T) comes whole from FreeFluidsC
+    }
+    if(ker->u*ker->u-4*ker->w<=0) return 0;
+    if((mix->intForm==FF_Pol2)||(mix->intForm==FF_Pol2C)||(mix->intForm==FF_Pol2J)||(mix->intForm==FF_Pol2K)) ker->kijForm=CMK_KIJ_POL2;
+    else if((mix->intForm==FF_Pol3)||(mix->intForm==FF_Pol3C)||(mix->intForm==FF_Pol3J)||(mix->intForm==FF_Pol3K)) ker->kijForm=CMK_KIJ_POL3;
+    else ker->kijForm=CMK_KIJ_POL1;
+    for(i=0;i<ker->n;i++) for(int j=0;j<ker->n;j++) for(int k=0;k<3;k++) ker->kijP[k][i][j]=mix->intParam[i][j][k];
+    ker->T=0;
+    return 1;
+}
+
+//Calculates the temperature dependent part: a(T) and the interaction matrices. Does nothing if T has not changed.
+//Only the substances with an alpha function without native implementation read their data from the mixture
+void CubicMixKernelSetT(FF_MixData *mix,double T,CubicMixKernel *ker){
+    int i,j;
+    FF_CubicParam param;
+    EosCubicConst k;
+    double sqA[CMK_DIM],al,dal,d2al,dk;
+    if(T==ker->T) return;
+    for(i=0;i<ker->n;i++){
+        k.Tc=ker->alphaTc[i];
+        switch(ker->alpha[i]){
+        case CMK_ALPHA_SOAVE:{
+            EosAlphaSoave f={ker->alphaP[0][i]};
+            f.Alpha(k,T,&al,&dal,&d2al);
+            break;
+        }
+        case CMK_ALPHA_PRSV1:{
+            EosAlphaPRSV1 f={ker->alphaP[0][i],ker->alphaP[1][i]};
+            f.Alpha(k,T,&al,&dal,&d2al);
+            break;
+        }
+        case CMK_ALPHA_TWU91:{
+            EosAlphaTwu91 f={ker->alphaP[0][i],ker->alphaP[1][i],ker->alphaP[2][i]};
+            f.Alpha(k,T,&al,&dal,&d2al);
+            break;
+        }
+        default:
+            CubicMixPureParam(mix,i,T,&param);
+            al=param.Theta;
+            dal=param.dTheta;
+            break;
+        }
+        ker->a[i]=ker->a0[i]*al;
+        ker->da[i]=ker->a0[i]*dal;
+        sqA[i]=sqrt(ker->a[i]);
+    }
+    for(i=0;i<ker->n;i++){
+        for(j=0;j<ker->n;j++){
+            double kij=CubicMixKernelKijDer(ker,i,j,T,&dk);
+            double kji=CubicMixKernelKijDer(ker,j,i,T,&dk);
+            ker->S[i][j]=sqA[i]*sqA[j]*(2-kij-kji);
+            if(ker->rule==FF_PR){
+                ker->D[i][j]=sqA[i]*sqA[j]*(kij-kji);
+                ker->DT[j][i]=ker->D[i][j];
+            }
+        }
+    }
+    ker->T=T;
+}
+
+//y[0..nPad)=sum for j<n of x[j]*A[j][0..nPad). As A is stored by rows this is a sequence of axpy operations.
+//Unaligned loads are used, so the kernel can live also in heap memory allocated without alignment
+static inline void CubicMixAxpy(int n,int nPad,const double A[][CMK_DIM],const double *x,double *y){
+    int i,j;
+#if defined(__AVX__)
+    for(i=0;i<nPad;i+=4) _mm256_storeu_pd(y+i,_mm256_setzero_pd());
+    for(j=0;j<n;j++){
+        __m256d xj=_mm256_set1_pd(x[j]);
+        for(i=0;i<nPad;i+=4) _mm256_storeu_pd(y+i,_mm256_add_pd(_mm256_loadu_pd(y+i),_mm256_mul_pd(xj,_mm256_loadu_pd(&A[j][i]))));
+    }
+#elif defined(__SSE2__)
+    for(i=0;i<nPad;i+=2) _mm_storeu_pd(y+i,_mm_setzero_pd());
+    for(j=0;j<n;j++){
+        __m128d xj=_mm_set1_pd(x[j]);
+        for(i=0;i<nPad;i+=2) _mm_storeu_pd(y+i,_mm_add_pd(_mm_loadu_pd(y+i),_mm_mul_pd(xj,_mm_loadu_pd(&A[j][i]))));
+    }
+#else
+    for(i=0;i<nPad;i++) y[i]=0;
+    for(j=0;j<n;j++) for(i=0;i<nPad;i++) y[i]+=x[j]*A[j][i];
+#endif
+}
+
+//Real roots of Z^3+a2*Z^2+a1*Z+a0=0, in increasing order. Returns the number of roots
+static int CubicMixRoots(double a2,double a1,double a0,double Z[3]){
+    int i,nRoots;
+    double q=(a2*a2-3*a1)/9;
+    double r=(2*a2*a2*a2-9*a2*a1+27*a0)/54;
+    if(r*r<q*q*q){
+        double theta=acos(r/sqrt(q*q*q));
+        double sq=-2*sqrt(q);
+        Z[0]=sq*cos(theta/3)-a2/3;
+        Z[1]=sq*cos((theta+2*M_PI)/3)-a2/3;
+        Z[2]=sq*cos((theta-2*M_PI)/3)-a2/3;
+        nRoots=3;
+        for(i=0;i<2;i++) for(int j=0;j<2-i;j++) if(Z[j]>Z[j+1]){
+            double aux=Z[j];
+            Z[j]=Z[j+1];
+            Z[j+1]=aux;
+        }
+    }
+    else{
+        double A=-copysign(cbrt(fabs(r)+sqrt(r*r-q*q*q)),r);
+        double B=(A!=0) ? q/A : 0;
+        Z[0]=A+B-a2/3;
+        nRoots=1;
+    }
+    for(i=0;i<nRoots;i++){//Newton polishing
+        double f=((Z[i]+a2)*Z[i]+a1)*Z[i]+a0;
+        double df=(3*Z[i]+2*a2)*Z[i]+a1;
+        if(df!=0) Z[i]=Z[i]-f/df;
+    }
+    return nRoots;
+}
+
+//Selects the compressibility factor for the requested phase, and its state. Returns 0 if no root is greater than B,
+//as then there is no physical volume
+static int CubicMixSelectZ(double A,double B,double u,double w,char option,double *Zsel,char *state){
+    double Z[3],ZL,ZG;
+    double sq=sqrt(u*u-4*w);
+    int nRoots=CubicMixRoots(-(1+B-u*B),A+w*B*B-u*B-u*B*B,-(A*B+w*B*B+w*B*B*B),Z);
+    int i,first=0;
+    for(i=0;i<nRoots;i++) if(Z[i]<=B) first=i+1;//roots not physically valid
+    if(first>=nRoots){
+        *state='U';
+        return 0;
+    }
+    ZL=Z[first];
+    ZG=Z[nRoots-1];
+    if(ZL==ZG){
+        if((option=='l')||(option=='g')) *state='U';
+        else *state=(ZL>0.3) ? 'G' : 'L';
+        *Zsel=ZL;
+        return 1;
+    }
+    if(option=='l'){
+        *state='L';
+        *Zsel=ZL;
+        return 1;
+    }
+    else if(option=='g'){
+        *state='G';
+        *Zsel=ZG;
+        return 1;
+    }
+    //stable root: the one with lower residual Gibbs energy
+    double lnPhiL=ZL-1-log(ZL-B)-A/(B*sq)*log((2*ZL+B*(u+sq))/(2*ZL+B*(u-sq)));
+    double lnPhiG=ZG-1-log(ZG-B)-A/(B*sq)*log((2*ZG+B*(u+sq))/(2*ZG+B*(u-sq)));
+    if(lnPhiL<lnPhiG){
+        *state='L';
+        *Zsel=ZL;
+        return 1;
+    }
+    *state='G';
+    *Zsel=ZG;
+    return 1;
+}
+
+//Natural logarithm of the fugacity coefficients, vectorized. Option 'l' for liquid, 'g' for gas, 's' for the stable root.
+//Returns also the compressibility factor, the molar volume and the state of the root used ('L','G','U').
+//Returns 0, with lnPhi not calculated, if there is no root with a physical volume
+int CubicMixLnPhi(const CubicMixKernel *ker,double P,const double x[],char option,double lnPhi[],double *Z,double *V,char *state){
+    int i;
+    int n=ker->n,nPad=ker->nPad;
+    alignas(32) double xa[CMK_DIM],x2[CMK_DIM],s[CMK_DIM],d[CMK_DIM],e[CMK_DIM];
+    double a=0,b=0,c=0,q=0;
+    double RT=R*ker->T;
+    for(i=0;i<nPad;i++){
+        xa[i]=(i<n) ? x[i] : 0;
+        x2[i]=xa[i]*xa[i];
+    }
+    CubicMixAxpy(n,nPad,ker->S,xa,s);//s=(M+Mt)x, d(n^2*a)/dni for the VdW rule
+    for(i=0;i<n;i++){
+        a+=xa[i]*s[i];
+        b+=xa[i]*ker->b[i];
+        c+=xa[i]*ker->c[i];
+    }
+    a=0.5*a;
+    if(ker->rule==FF_PR){//asymmetric term: sum(xi^2*xj*sqrt(ai*aj)(kij-kji))
+        CubicMixAxpy(n,nPad,ker->DT,xa,d);//d=D x
+        CubicMixAxpy(n,nPad,ker->D,x2,e);//e=Dt x^2
+        for(i=0;i<n;i++) q+=x2[i]*d[i];
+        a+=q;
+        for(i=0;i<n;i++) s[i]=s[i]+2*xa[i]*d[i]+e[i]-q;
+    }
+    double A=a*P/(RT*RT);
+    double B=b*P/RT;
+    double sq=sqrt(ker->u*ker->u-4*ker->w);
+    if(CubicMixSelectZ(A,B,ker->u,ker->w,option,Z,state)==0) return 0;
+    double lnZB=log(*Z-B);
+    double L=A/(B*sq)*log((2* *Z+B*(ker->u+sq))/(2* *Z+B*(ker->u-sq)));
+    for(i=0;i<n;i++){
+        double bi=ker->b[i]/b;
+        lnPhi[i]=bi*(*Z-1)-lnZB+L*(bi-s[i]/a)-ker->c[i]*P/RT;
+    }
+    *V=*Z*RT/P-c;
+    return 1;
+}
+
+//Reference scalar implementation of the same calculation, straight from the definitions. Returns 0 as CubicMixLnPhi
+int CubicMixLnPhiRef(FF_MixData *mix,double T,double P,const double x[],char option,double lnPhi[],double *Z){
+    int i,j,k,n=mix->numSubs;
+    FF_CubicParam param;
+    double ai[15],bi[15],ci[15],dn2a[15];
+    double a=0,b=0,u=0,w=0,RT=R*T;
+    char state;
+    for(i=0;i<n;i++){
+        CubicMixPureParam(mix,i,T,&param);
+        ai[i]=param.Theta;
+        bi[i]=param.b;
+        ci[i]=param.c;
+        u=param.u;
+        w=param.w;
+        b+=x[i]*bi[i];
+    }
+    //a=sum(xi*xj*aij), with aij=sqrt(ai*aj)(1-kij+(kij-kji)*xi) for the PR rule
+    for(i=0;i<n;i++) for(j=0;j<n;j++){
+        double kij=CubicMixKij(mix,i,j,T),kji=CubicMixKij(mix,j,i,T);
+        double aij=sqrt(ai[i]*ai[j])*(1-kij);
+        if(mix->mixRule==FF_PR) aij=aij+sqrt(ai[i]*ai[j])*(kij-kji)*x[i];
+        a+=x[i]*x[j]*aij;
+    }
+    //d(n^2*a)/dnk
+    for(k=0;k<n;k++){
+        dn2a[k]=0;
+        for(j=0;j<n;j++){
+            double kkj=CubicMixKij(mix,k,j,T),kjk=CubicMixKij(mix,j,k,T);
+            double sq=sqrt(ai[k]*ai[j]);
+            dn2a[k]+=x[j]*sq*(2-kkj-kjk);
+            if(mix->mixRule==FF_PR) dn2a[k]+=2*x[k]*x[j]*sq*(kkj-kjk)+x[j]*x[j]*sq*(kjk-kkj);
+        }
+        if(mix->mixRule==FF_PR) for(i=0;i<n;i++) for(j=0;j<n;j++){
+            dn2a[k]-=x[i]*x[i]*x[j]*sqrt(ai[i]*ai[j])*(CubicMixKij(mix,i,j,T)-CubicMixKij(mix,j,i,T));
+        }
+    }
+    double A=a*P/(RT*RT);
+    double B=b*P/RT;
+    double sq=sqrt(u*u-4*w);
+    if(CubicMixSelectZ(A,B,u,w,option,Z,&state)==0) return 0;
+    for(i=0;i<n;i++){
+        lnPhi[i]=bi[i]/b*(*Z-1)-log(*Z-B)+A/(B*sq)*(bi[i]/b-dn2a[i]/a)*log((2* *Z+B*(u+sq))/(2* *Z+B*(u-sq)))-ci[i]*P/RT;
+    }
+    return 1;
+}
+
+//Checks the vectorized kernel against the scalar reference and against the FreeFluidsC generic path (FF_MixPhiEOS),
+//for liquid and gas roots. Returns the maximum absolute difference found in ln(phi) for each comparison
+void CubicMixKernelCheck(FF_MixData *mix,double T,double P,const double x[],double *maxDiffRef,double *maxDiffGeneric){
+    CubicMixKernel ker;
+    int i,k;
+    char options[2]={'l','g'};
+    double lnPhi[15],lnPhiRef[15],phi[15],Z,ZRef,V;
+    char state;
+    *maxDiffRef=*maxDiffGeneric=-1;
+    if(CubicMixKernelInit(mix,&ker)==0) return;
+    CubicMixKernelSetT(mix,T,&ker);
+    *maxDiffRef=*maxDiffGeneric=0;
+    for(k=0;k<2;k++){
+        if(CubicMixLnPhi(&ker,P,x,options[k],lnPhi,&Z,&V,&state)==0) continue;//no physical root, the kernel is not used
+        CubicMixLnPhiRef(mix,T,P,x,options[k],lnPhiRef,&ZRef);
+        FF_MixPhiEOS(mix,&T,&P,(double *)x,&options[k],phi);
+        for(i=0;i<ker.n;i++){
+            if(fabs(lnPhi[i]-lnPhiRef[i])>*maxDiffRef) *maxDiffRef=fabs(lnPhi[i]-lnPhiRef[i]);
+            if(fabs(lnPhi[i]-log(phi[i]))>*maxDiffGeneric) *maxDiffGeneric=fabs(lnPhi[i]-log(phi[i]));
+        }
+    }
+}
@@ -22,13 +22,18 @@
  */
 
 #include "databasetools.h"
+#include "dbconnection.h"
+#include "perfcounters.h"
 
 #include <QtSql/QSqlDatabase>
 #include <QtSql>
 
 #include <math.h>
+#include <string.h>
 #include <stdio.h>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 
 //EOS conversion from Qstring to enumeration
 void ConvertEosToEnumeration(const QString *eosModel,enum FF_EOS *eos)
@@ -154,7 +159,7 @@ void GetBasicData(int id,FF_SubstanceData *subsData,QSqlDatabase *db){
     query1.prepare("SELECT * FROM Products WHERE (Id=?)");
     //this will ask for product common parameters
     query1.addBindValue(id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     query1.first();
     strncpy(subsData->name,query1.value(query1.record().indexOf("Name")).toString().toStdString().c_str(),50);
     strncpy(subsData->CAS,query1.value(query1.record().indexOf("CAS")).toString().toStdString().c_str(),22);
@@ -234,7 +239,7 @@ void GetBasicData(int id,FF_SubstanceData *subsData,QSqlDatabase *db){
     }
     query1.prepare("SELECT * FROM Products_UnifacSt WHERE (IdProduct=?)");
     query1.addBindValue(id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     i=0;
     while (query1.next()) {
         subsData->UnifStdSubg[i][0]=query1.value(query1.record().indexOf("UnifacSubgroup")).toInt();
@@ -243,7 +248,7 @@ void GetBasicData(int id,FF_SubstanceData *subsData,QSqlDatabase *db){
     }
     query1.prepare("SELECT * FROM Products_UnifacPSRK WHERE (IdProduct=?)");
     query1.addBindValue(id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     i=0;
     while (query1.next()) {
         subsData->UnifPSRKSubg[i][0]=query1.value(query1.record().indexOf("UnifacSubgroup")).toInt();
@@ -252,7 +257,7 @@ void GetBasicData(int id,FF_SubstanceData *subsData,QSqlDatabase *db){
     }
     query1.prepare("SELECT * FROM Products_UnifacDort WHERE (IdProduct=?)");
     query1.addBindValue(id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     i=0;
     while (query1.next()) {
         subsData->UnifDortSubg[i][0]=query1.value(query1.record().indexOf("UnifacSubgroup")).toInt();
@@ -261,7 +266,7 @@ void GetBasicData(int id,FF_SubstanceData *subsData,QSqlDatabase *db){
     }
     query1.prepare("SELECT * FROM Products_UnifacNist WHERE (IdProduct=?)");
     query1.addBindValue(id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     i=0;
     while (query1.next()) {
         subsData->UnifNistSubg[i][0]=query1.value(query1.record().indexOf("UnifacSubgroup")).toInt();
@@ -276,7 +281,7 @@ void GetEosData(const int *IdProduct,enum FF_EOS *eos,const int *IdEos,const int
     QSqlQuery query1(*db),query2(*db),query4(*db);
     query1.prepare("SELECT MW,Tc,Pc,w,Zc,VdWV,Cp0Form,Cp0A,Cp0B,Cp0C,Cp0D,Cp0E,Cp0LimI,Cp0LimS FROM Products WHERE (Id=?)");//this will ask for product common parameters
     query1.addBindValue(*IdProduct);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     query1.first();
     //printf("Buenas bifurcamos acceso a BBDD por EOS\n");
     //printf("MW:%f\n",query1.value(query1.record().indexOf("MW")).toDouble());
@@ -293,7 +298,7 @@ void GetEosData(const int *IdProduct,enum FF_EOS *eos,const int *IdEos,const int
             //So data and dataV contain the same address value
             query2.prepare("SELECT MW,Tc,Pc,Zc,sigma,m,epsilon,kAB,epsilonAB,mu,xp,nPos,nNeg,nAcid FROM EosParam WHERE (Id=?)");//and this for eos parameters
             query2.addBindValue(*IdEos);
-            query2.exec();
+            FF_PERF_SQL(query2.exec());
             query2.first();
             if (query2.value(query2.record().indexOf("MW")).toDouble() > 0) data->MW=query2.value(query2.record().indexOf("MW")).toDouble();
             else data->MW=query1.value(query1.record().indexOf("MW")).toDouble();
@@ -328,7 +333,7 @@ void GetEosData(const int *IdProduct,enum FF_EOS *eos,const int *IdEos,const int
          FF_SWEOSdata *data=( FF_SWEOSdata*)dataV;
         query2.prepare("SELECT MW,Tc,Pc,Zc,tRef,rhoRef,nPol,nExp,nSpec,nFinal,Tmin,Tmax,Pmax FROM EosParam WHERE (Id=?)");//and this for eos parameters
         query2.addBindValue(*IdEos);
-        query2.exec();
+        FF_PERF_SQL(query2.exec());
         query2.first();
         if (query2.value(query2.record().indexOf("MW")).toDouble() > 0) data->MW=query2.value(query2.record().indexOf("MW")).toDouble();
         else data->MW=query1.value(query1.record().indexOf("MW")).toDouble();
@@ -351,7 +356,7 @@ void GetEosData(const int *IdProduct,enum FF_EOS *eos,const int *IdEos,const int
         QSqlQuery query3(*db);
         query3.prepare("SELECT * FROM SWparam WHERE (IdEos=?) ORDER BY Position");
         query3.addBindValue(*IdEos);
-        query3.exec();
+        FF_PERF_SQL(query3.exec());
         query3.first();
         int i,j;
         do
@@ -395,7 +400,7 @@ void GetEosData(const int *IdProduct,enum FF_EOS *eos,const int *IdEos,const int
              FF_CubicEOSdata *data=( FF_CubicEOSdata*)dataV;
             query2.prepare("SELECT MW,Tc,Pc,Zc,w,c,k1,k2,k3,k4 FROM EosParam WHERE (Id=?)");//and this for eos parameters
             query2.addBindValue(*IdEos);
-            query2.exec();
+            FF_PERF_SQL(query2.exec());
             query2.first();
             //k1Num=query2.record().indexOf("k1");
             //k2Num=query2.record().indexOf("k2");
@@ -423,7 +428,7 @@ void GetEosData(const int *IdProduct,enum FF_EOS *eos,const int *IdEos,const int
 
     query4.prepare("SELECT * FROM CorrelationParam WHERE (Id=?)");//this will ask for Cp0 correlation parameters
     query4.addBindValue(*IdCorrParam);
-    query4.exec();
+    FF_PERF_SQL(query4.exec());
     query4.first();
     cp0->form =query4.value(query4.record().indexOf("NumCorrelation")).toInt();
     cp0->coef[0] =query4.value(query4.record().indexOf("A")).toDouble();
@@ -451,7 +456,7 @@ void GetEOSData(int *eosType,FF_SubstanceData *subsData,QSqlDatabase *db)
     //We query the Products table for general data
     query1.prepare("SELECT MW,Tc,Pc,w,Zc,VdWV FROM Products WHERE (Id=?)");//this will ask for product common parameters
     query1.addBindValue(subsData->id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     query1.first();
     //printf("MW:%f\n",query1.value(query1.record().indexOf("MW")).toDouble());
     if (*eosType==FF_SAFTtype)//Depending on the eos we query different fields from the EoPparam table, and store the result in different places of the Substance object
@@ -459,7 +464,7 @@ void GetEOSData(int *eosType,FF_SubstanceData *subsData,QSqlDatabase *db)
             //printf("Hola soy FF_PCSAFT en BD\n");
             query2.prepare("SELECT Eos,MW,Tc,Pc,Zc,sigma,m,epsilon,lambdaA,lambdaR,chi,kAB,epsilonAB,mu,xp,nPos,nNeg,nAcid FROM EosParam WHERE (Id=?)");//and this for eos parameters
             query2.addBindValue(subsData->saftData.id);
-            query2.exec();
+            FF_PERF_SQL(query2.exec());
             query2.first();
             eosString=query2.value(query2.record().indexOf("Eos")).toString().toStdString();
             ConvertEosToEnumeration2(&eosString,&subsData->saftData.eos);
@@ -496,7 +501,7 @@ void GetEOSData(int *eosType,FF_SubstanceData *subsData,QSqlDatabase *db)
     {
         query2.prepare("SELECT Eos,MW,Tc,Pc,Zc,tRef,rhoRef,nPol,nExp,nSpec,nFinal,Tmin,Tmax,Pmax FROM EosParam WHERE (Id=?)");//and this for eos parameters
         query2.addBindValue(subsData->swData.id);
-        query2.exec();
+        FF_PERF_SQL(query2.exec());
         query2.first();
         eosString=query2.value(query2.record().indexOf("Eos")).toString().toStdString();
         ConvertEosToEnumeration2(&eosString,&subsData->swData.eos);
@@ -522,7 +527,7 @@ void GetEOSData(int *eosType,FF_SubstanceData *subsData,QSqlDatabase *db)
         QSqlQuery query3(*db);
         query3.prepare("SELECT * FROM SWparam WHERE (IdEos=?) ORDER BY Position");
         query3.addBindValue(subsData->swData.id);
-        query3.exec();
+        FF_PERF_SQL(query3.exec());
         query3.first();
         int i,j;
         do
@@ -564,7 +569,7 @@ void GetEOSData(int *eosType,FF_SubstanceData *subsData,QSqlDatabase *db)
         {
             query2.prepare("SELECT Eos,MW,Tc,Pc,Zc,w,c,k1,k2,k3,k4 FROM EosParam WHERE (Id=?)");//and this for eos parameters
             query2.addBindValue(subsData->cubicData.id);
-            query2.exec();
+            FF_PERF_SQL(query2.exec());
             query2.first();
             eosString=query2.value(query2.record().indexOf("Eos")).toString().toStdString();
             ConvertEosToEnumeration2(&eosString,&subsData->cubicData.eos);
@@ -606,7 +611,7 @@ void GetCorrDataByType(const int *IdProduct,const QString *type,QSqlDatabase *db
 
     query1.addBindValue(*IdProduct);
     query1.addBindValue(*type);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     query1.first();
     *corrNum=query1.value(query1.record().indexOf("NumCorrelation")).toInt();
     coef[0]=query1.value(query1.record().indexOf("A")).toDouble();
@@ -628,7 +633,7 @@ void GetCorrDataById( FF_Correlation *corr,QSqlDatabase *db)//
     //query1.prepare("SELECT * FROM Products INNER JOIN CorrelationParam ON Products.Id = CorrelationParam.IdProduct WHERE"
     //               " (CorrelationParam.Id=?)");
     query1.addBindValue(corr->id);
-    query1.exec();
+    FF_PERF_SQL(query1.exec());
     query1.first();
     //*MW=query1.value(query1.record().indexOf("MW")).toDouble();
     corr->form=query1.value(query1.record().indexOf("NumCorrelation")).toInt();
@@ -654,83 +659,304 @@ void GetCorrDataById( FF_Correlation *corr,QSqlDatabase *db)//
     //printf("Tmin, Tmax: %f %f\n",corr->limI,corr->limS);
 }
 
-//Adds a new eos to the database
-void AddEosToDataBase(int idSubs,enum FF_EosType eosType,void *eosData,double *Tmin,double *Tmax, QString *description,QSqlDatabase *db){
-    QSqlQuery query(*db);
+//Correlation of the substance for a physical property name of the database ("Cp0","Vp","Ldens"...). NULL if not used
+FF_Correlation *CorrelationForProperty(FF_SubstanceData *subsData,const QString &property){
+    if (property=="Cp0") return &subsData->cp0Corr;
+    else if (property=="Ldens") return &subsData->lDensCorr;
+    else if (property=="Vp") return &subsData->vpCorr;
+    else if (property=="Bt") return &subsData->btCorr;
+    else if (property=="HvSat") return &subsData->hVsatCorr;
+    else if (property=="LCp") return &subsData->lCpCorr;
+    else if (property=="LTfromH") return &subsData->lTfromHCorr;
+    else if (property=="Lvisc") return &subsData->lViscCorr;
+    else if (property=="LthC") return &subsData->lThCCorr;
+    else if (property=="LsurfT") return &subsData->lSurfTCorr;
+    else if (property=="LbulkModR") return &subsData->lBulkModRCorr;
+    else if (property=="GdensSat") return &subsData->gDensCorr;
+    else if (property=="Gvisc") return &subsData->gViscCorr;
+    else if (property=="GthC") return &subsData->gThCCorr;
+    return NULL;
+}
+
+//Get a substance for unattended use: basic data, the preferred correlation for each property, and the first EOS of each type.
+//The model is set to the multiparameter EOS if available, else to the SAFT one, else to the cubic one
+void GetPreferredData(int id,FF_SubstanceData *subsData,QSqlDatabase *db){
+    QSqlQuery *queryCorr,*queryEos;
+    std::vector<FF_Correlation*> used;
+    std::vector<int> score;
+    memset(subsData,0,sizeof(FF_SubstanceData));
+    subsData->id=id;
+    subsData->refT=0.0;
+    subsData->refP=101325;
+    subsData->model=FF_NoType;
+    subsData->cubicData.eos=FF_IdealGas;
+    subsData->saftData.eos=FF_IdealGas;
+    subsData->swData.eos=FF_IdealGas;
+    GetBasicData(id,subsData,db);
+
+    //all the correlations in one query. Preferred ones first, then the ones marked as correct. The statements are prepared once per thread
+    queryCorr=DbConnectionStatement(db,"SELECT PhysProp.Property AS Property, CorrelationParam.* FROM PhysProp INNER JOIN (Correlations INNER JOIN CorrelationParam ON "
+                      "Correlations.Number = CorrelationParam.NumCorrelation) ON PhysProp.Id = Correlations.IdPhysProp WHERE (CorrelationParam.IdProduct=?) "
+                      "ORDER BY CorrelationParam.Id");
+    queryEos=DbConnectionStatement(db,"SELECT EosParam.Id AS Id,Eos.Type AS Type FROM EosParam INNER JOIN Eos ON EosParam.Eos=Eos.Eos WHERE (IdProduct=?) ORDER BY EosParam.Id");
+    if ((queryCorr==NULL)||(queryEos==NULL)) return;
+    queryCorr->bindValue(0,id);
+    FF_PERF_SQL(queryCorr->exec());
+    QSqlRecord rec=queryCorr->record();
+    int iProp=rec.indexOf("Property"),iId=rec.indexOf("Id"),iForm=rec.indexOf("NumCorrelation"),iMin=rec.indexOf("Tmin"),iMax=rec.indexOf("Tmax");
+    int iPref=rec.indexOf("Preferred"),iOk=rec.indexOf("Correct");
+    int iCoef[14];
+    const char *coefNames[14]={"A","B","C","D","E","F","G","H","I","J","K","L","M","N"};
+    for (int k=0;k<14;k++) iCoef[k]=rec.indexOf(coefNames[k]);
+    while (queryCorr->next()){
+        FF_Correlation *corr=CorrelationForProperty(subsData,queryCorr->value(iProp).toString());
+        if (corr==NULL) continue;
+        int s=2*queryCorr->value(iPref).toBool()+queryCorr->value(iOk).toBool();
+        size_t k=std::find(used.begin(),used.end(),corr)-used.begin();
+        if (k<used.size()){
+            if (s<=score[k]) continue;
+            score[k]=s;
+        }
+        else{
+            used.push_back(corr);
+            score.push_back(s);
+        }
+        corr->id=queryCorr->value(iId).toInt();
+        corr->form=queryCorr->value(iForm).toInt();
+        for (int j=0;j<14;j++) corr->coef[j]=queryCorr->value(iCoef[j]).toDouble();
+        corr->limI=queryCorr->value(iMin).toDouble();
+        corr->limS=queryCorr->value(iMax).toDouble();
+    }
+    queryCorr->finish();
+
+    //first EOS of each type
+    queryEos->bindValue(0,id);
+    FF_PERF_SQL(queryEos->exec());
+    while (queryEos->next()){
+        QString type=queryEos->value(1).toString();
+        if (((type=="Cubic PR")||(type=="Cubic SRK"))&&(subsData->cubicData.id==0)) subsData->cubicData.id=queryEos->value(0).toInt();
+        else if ((type=="SAFT")&&(subsData->saftData.id==0)) subsData->saftData.id=queryEos->value(0).toInt();
+        else if ((type=="Multiparameter")&&(subsData->swData.id==0)) subsData->swData.id=queryEos->value(0).toInt();
+    }
+    queryEos->finish();
+    if (subsData->cubicData.id>0){
+        subsData->model=FF_CubicType;
+        GetEOSData(&subsData->model,subsData,db);
+    }
+    if (subsData->saftData.id>0){
+        subsData->model=FF_SAFTtype;
+        GetEOSData(&subsData->model,subsData,db);
+    }
+    if (subsData->swData.id>0){
+        subsData->model=FF_SWtype;
+        GetEOSData(&subsData->model,subsData,db);
+    }
+}
+
+//Insert statements of the write batch
+#define DB_INSERT_CUBIC "INSERT INTO EosParam(IdProduct,Eos,MW,Tc,Pc,Zc,w,c,k1,k2,k3,k4,Tmin,Tmax,Description) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)"
+#define DB_INSERT_SAFT "INSERT INTO EosParam(IdProduct,Eos,MW,Tc,Pc,Zc,w,sigma,m,epsilon,lambdaA,lambdaR,kAB,epsilonAB,mu,xp,nPos,nNeg,nAcid,Tmin,Tmax,Description) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)"
+#define DB_INSERT_CORR "INSERT INTO CorrelationParam(IdProduct,NumCorrelation,A,B,C,D,E,F,Tmin,Tmax,Reference) VALUES (?,?,?,?,?,?,?,?,?,?,?)"
+
+//Returns the statement, preparing it the first time it is used in the batch
+static QSqlQuery *WriteBatchStatement(DataBaseWriteBatch *batch,QSqlQuery **statement,const char *sql){
+    if (*statement==NULL){
+        *statement=new QSqlQuery(*batch->db);
+        if (!(*statement)->prepare(sql)){
+            delete *statement;
+            *statement=NULL;
+        }
+    }
+    return *statement;
+}
+
+//Executes the bound statement, inside the open transaction. The transaction is opened by the first row after a flush,
+//even if that row fails, so it is tracked by inTransaction and not by the count of pending rows
+static int WriteBatchExec(DataBaseWriteBatch *batch,QSqlQuery *query){
+    if ((!batch->inTransaction)&&(batch->flushSize>1)) batch->inTransaction=batch->db->transaction();
+    if (FF_PERF_SQL(query->exec())) batch->nWritten++;
+    else{
+        batch->nFailed++;
+        return 0;
+    }
+    batch->pending++;
+    if (batch->pending>=batch->flushSize) DataBaseWriteBatchFlush(batch);
+    return 1;
+}
+
+//Prepares a batch of insertions on the database. Rows are committed in transactions of flushSize rows.
+//If wal is true and the database is SQLite, it is changed to write ahead log journaling
+int DataBaseWriteBatchBegin(QSqlDatabase *db,int flushSize,bool wal,DataBaseWriteBatch *batch){
+    batch->db=db;
+    batch->flushSize=flushSize>0 ? flushSize : 1;
+    batch->pending=0;
+    batch->inTransaction=false;
+    batch->nWritten=batch->nFailed=0;
+    batch->cubicInsert=batch->saftInsert=batch->corrInsert=NULL;
+    if (!db->isOpen()) return 0;
+    if (wal&&(db->driverName()=="QSQLITE")){
+        QSqlQuery pragma(*db);
+        FF_PERF_SQL(pragma.exec("PRAGMA journal_mode=WAL"));
+        FF_PERF_SQL(pragma.exec("PRAGMA synchronous=NORMAL"));
+    }
+    return 1;
+}
+
+//Adds a new eos to the batch. Returns 0 if the insertion failed
+int DataBaseWriteBatchAddEos(DataBaseWriteBatch *batch,int idSubs,enum FF_EosType eosType,void *eosData,double *Tmin,double *Tmax, QString *description){
+    QSqlQuery *query;
     QString eos;
     if (eosType==FF_CubicType){
         FF_CubicEOSdata *cubicData=(FF_CubicEOSdata*)eosData;
+        if ((query=WriteBatchStatement(batch,&batch->cubicInsert,DB_INSERT_CUBIC))==NULL) return 0;
         ConvertEnumerationToEos(&cubicData->eos,&eos);
-        query.prepare("INSERT INTO EosParam(IdProduct,Eos,MW,Tc,Pc,Zc,w,c,k1,k2,k3,k4,Tmin,Tmax,Description) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
-        query.addBindValue(idSubs);
-        query.addBindValue(eos);
-        query.addBindValue(cubicData->MW);
-        query.addBindValue(cubicData->Tc);
-        query.addBindValue(cubicData->Pc);
-        query.addBindValue(cubicData->Zc);
-        query.addBindValue(cubicData->w);
-        query.addBindValue(cubicData->c);
-        query.addBindValue(cubicData->k1);
-        query.addBindValue(cubicData->k2);
-        query.addBindValue(cubicData->k3);
-        query.addBindValue(cubicData->k4);
-        query.addBindValue(*Tmin);
-        query.addBindValue(*Tmax);
-        query.addBindValue(*description);
-        query.exec();
+        query->bindValue(0,idSubs);
+        query->bindValue(1,eos);
+        query->bindValue(2,cubicData->MW);
+        query->bindValue(3,cubicData->Tc);
+        query->bindValue(4,cubicData->Pc);
+        query->bindValue(5,cubicData->Zc);
+        query->bindValue(6,cubicData->w);
+        query->bindValue(7,cubicData->c);
+        query->bindValue(8,cubicData->k1);
+        query->bindValue(9,cubicData->k2);
+        query->bindValue(10,cubicData->k3);
+        query->bindValue(11,cubicData->k4);
+        query->bindValue(12,*Tmin);
+        query->bindValue(13,*Tmax);
+        query->bindValue(14,*description);
+        return WriteBatchExec(batch,query);
     }
     else if(eosType==FF_SAFTtype){
         FF_SaftEOSdata *saftData=(FF_SaftEOSdata*)eosData;
+        if ((query=WriteBatchStatement(batch,&batch->saftInsert,DB_INSERT_SAFT))==NULL) return 0;
         ConvertEnumerationToEos(&saftData->eos,&eos);
-        //printf("%i %i %f %f %f %f %f %f %f %f\n",idSubs,saftData->eos,saftData->MW,saftData->Tc,saftData->Pc,saftData->Zc,saftData->w,saftData->sigma,saftData->m,saftData->epsilon);
-        //printf("%f %f %f %f %f %f %i %i %i\n",saftData->la,saftData->lr,saftData->kAB,saftData->epsilonAB,saftData->mu,saftData->xp,saftData->nPos,saftData->nNeg,saftData->nAcid);
-        //printf("%f %f %s\n",*Tmin,*Tmax,*description);
-        query.prepare("INSERT INTO EosParam(IdProduct,Eos,MW,Tc,Pc,Zc,w,sigma,m,epsilon,lambdaA,lambdaR,kAB,epsilonAB,mu,xp,nPos,nNeg,nAcid,Tmin,Tmax,Description) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
-        query.addBindValue(idSubs);
-        query.addBindValue(eos);
-        query.addBindValue(saftData->MW);
-        query.addBindValue(saftData->Tc);
-        query.addBindValue(saftData->Pc);
-        query.addBindValue(saftData->Zc);
-        query.addBindValue(saftData->w);
-        query.addBindValue(saftData->sigma);
-        query.addBindValue(saftData->m);
-        query.addBindValue(saftData->epsilon);
-        query.addBindValue(saftData->la);
-        query.addBindValue(saftData->lr);
-        query.addBindValue(saftData->kAB);
-        query.addBindValue(saftData->epsilonAB);
-        query.addBindValue(saftData->mu);
-        query.addBindValue(saftData->xp);
-        query.addBindValue(saftData->nPos);
-        query.addBindValue(saftData->nNeg);
-        query.addBindValue(saftData->nAcid);
-        query.addBindValue(*Tmin);
-        query.addBindValue(*Tmax);
-        query.addBindValue(*description);
-        query.exec();
-        //printf("Inserted\n");
+        query->bindValue(0,idSubs);
+        query->bindValue(1,eos);
+        query->bindValue(2,saftData->MW);
+        query->bindValue(3,saftData->Tc);
+        query->bindValue(4,saftData->Pc);
+        query->bindValue(5,saftData->Zc);
+        query->bindValue(6,saftData->w);
+        query->bindValue(7,saftData->sigma);
+        query->bindValue(8,saftData->m);
+        query->bindValue(9,saftData->epsilon);
+        query->bindValue(10,saftData->la);
+        query->bindValue(11,saftData->lr);
+        query->bindValue(12,saftData->kAB);
+        query->bindValue(13,saftData->epsilonAB);
+        query->bindValue(14,saftData->mu);
+        query->bindValue(15,saftData->xp);
+        query->bindValue(16,saftData->nPos);
+        query->bindValue(17,saftData->nNeg);
+        query->bindValue(18,saftData->nAcid);
+        query->bindValue(19,*Tmin);
+        query->bindValue(20,*Tmax);
+        query->bindValue(21,*description);
+        return WriteBatchExec(batch,query);
     }
+    return 0;
+}
 
+//Adds a new correlation to the batch. Returns 0 if the insertion failed
+int DataBaseWriteBatchAddCorr(DataBaseWriteBatch *batch,int idSubs,FF_Correlation *corr,double *Tmin,double *Tmax, QString *description){
+    QSqlQuery *query;
+    if ((query=WriteBatchStatement(batch,&batch->corrInsert,DB_INSERT_CORR))==NULL) return 0;
+    query->bindValue(0,idSubs);
+    query->bindValue(1,corr->form);
+    for (int i=0;i<6;i++) query->bindValue(2+i,corr->coef[i]);
+    query->bindValue(8,*Tmin);
+    query->bindValue(9,*Tmax);
+    query->bindValue(10,*description);
+    return WriteBatchExec(batch,query);
+}
+
+//Commits the rows added since the last flush. Returns 0 if the commit failed
+int DataBaseWriteBatchFlush(DataBaseWriteBatch *batch){
+    int ok=1;
+    if (batch->inTransaction){
+        if (!batch->db->commit()){
+            batch->db->rollback();
+            batch->nWritten-=batch->pending;
+            batch->nFailed+=batch->pending;
+            ok=0;
+        }
+        batch->inTransaction=false;//closed by the commit or by the rollback
+    }
+    batch->pending=0;
+    return ok;
+}
+
+//Commits the pending rows and releases the prepared statements. Returns the number of rows written
+int DataBaseWriteBatchEnd(DataBaseWriteBatch *batch){
+    DataBaseWriteBatchFlush(batch);
+    delete batch->cubicInsert;
+    delete batch->saftInsert;
+    delete batch->corrInsert;
+    batch->cubicInsert=batch->saftInsert=batch->corrInsert=NULL;
+    return batch->nWritten;
+}
+
+//Checks the write batch on an in memory SQLite database, whose correlation table rejects rows with negative equation number.
+//Rows fail inside transactions of several rows, including the first row after a flush, and the rows counted as written
+//are compared with the rows really stored. Returns 1 if the check passes. report receives the details
+int DataBaseWriteBatchCheck(QString *report){
+    //row sequences: one failing row right after a flush, one in the middle of a transaction, and one failing first row
+    static const int forms[3][8]={{1,1,1,-1,1,1,1,1},{1,1,-1,1,1,1,1,1},{-1,1,1,1,1,1,1,1}};
+    static const int flushSizes[3]={3,4,5};
+    int passed=1;
+    report->clear();
+    {
+        QSqlDatabase db=QSqlDatabase::addDatabase("QSQLITE","FFWriteBatchCheck");
+        db.setDatabaseName(":memory:");
+        if (!db.open()){
+            *report="It has been impossible to open the check database";
+            passed=0;
+        }
+        for (int c=0;(c<3)&&(passed==1);c++){
+            QSqlQuery query(db);
+            DataBaseWriteBatch batch;
+            FF_Correlation corr;
+            double Tmin=200,Tmax=400;
+            QString description="write batch check";
+            int expectedFailed=0,stored;
+            query.exec("DROP TABLE IF EXISTS CorrelationParam");
+            query.exec("CREATE TABLE CorrelationParam(Id INTEGER PRIMARY KEY,IdProduct INTEGER,NumCorrelation INTEGER CHECK(NumCorrelation>0),"
+                       "A REAL,B REAL,C REAL,D REAL,E REAL,F REAL,Tmin REAL,Tmax REAL,Reference TEXT)");
+            DataBaseWriteBatchBegin(&db,flushSizes[c],false,&batch);
+            for (int i=0;i<8;i++){
+                corr.form=forms[c][i];
+                for (int k=0;k<6;k++) corr.coef[k]=i+k;
+                if (forms[c][i]<0) expectedFailed++;
+                DataBaseWriteBatchAddCorr(&batch,1,&corr,&Tmin,&Tmax,&description);
+            }
+            DataBaseWriteBatchEnd(&batch);
+            query.exec("SELECT COUNT(*) FROM CorrelationParam");
+            stored=query.next() ? query.value(0).toInt() : -1;
+            report->append(QString("flush size %1: written %2, failed %3, stored %4\n").arg(flushSizes[c]).arg(batch.nWritten).arg(batch.nFailed).arg(stored));
+            if ((stored!=8-expectedFailed)||(batch.nWritten!=stored)||(batch.nFailed!=expectedFailed)) passed=0;
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("FFWriteBatchCheck");
+    return passed;
+}
+
+//Adds a new eos to the database
+void AddEosToDataBase(int idSubs,enum FF_EosType eosType,void *eosData,double *Tmin,double *Tmax, QString *description,QSqlDatabase *db){
+    DataBaseWriteBatch batch;
+    DataBaseWriteBatchBegin(db,1,false,&batch);
+    DataBaseWriteBatchAddEos(&batch,idSubs,eosType,eosData,Tmin,Tmax,description);
+    DataBaseWriteBatchEnd(&batch);
 }
 
 
 //Adds a new correlation to the database
 void AddCorrToDataBase(int idSubs,FF_Correlation *corr,double *Tmin,double *Tmax, QString *description,QSqlDatabase *db){
-    QSqlQuery query(*db);
-        query.prepare("INSERT INTO CorrelationParam(IdProduct,NumCorrelation,A,B,C,D,E,F,Tmin,Tmax,Reference) VALUES (?,?,?,?,?,?,?,?,?,?,?)");
-        query.addBindValue(idSubs);
-        query.addBindValue(corr->form);
-        query.addBindValue(corr->coef[0]);
-        query.addBindValue(corr->coef[1]);
-        query.addBindValue(corr->coef[2]);
-        query.addBindValue(corr->coef[3]);
-        query.addBindValue(corr->coef[4]);
-        query.addBindValue(corr->coef[5]);
-        query.addBindValue(*Tmin);
-        query.addBindValue(*Tmax);
-        query.addBindValue(*description);
-        query.exec();
+    DataBaseWriteBatch batch;
+    DataBaseWriteBatchBegin(db,1,false,&batch);
+    DataBaseWriteBatchAddCorr(&batch,idSubs,corr,Tmin,Tmax,description);
+    DataBaseWriteBatchEnd(&batch);
 }
 
 //Writes the Unifac information from the database to a file from where it can be extracted using C
@@ -739,7 +965,7 @@ void WriteUnifacToFile(QSqlDatabase *db){
     double r,q,A12,B12,C12,A21,B21,C21;
     QSqlQuery query(*db);
     query.prepare("SELECT * FROM UnifacSubgroups");
-    query.exec();
+    FF_PERF_SQL(query.exec());
     FILE *fStd, *fPSRK, *fDort, *fNist;
     fStd=fopen("UnifacSubgStd.txt","w+");
     fPSRK=fopen("UnifacSubgPSRK.txt","w+");
@@ -780,7 +1006,7 @@ void WriteUnifacToFile(QSqlDatabase *db){
     fclose(fDort);
     fclose(fNist);
     query.prepare("SELECT * FROM UnifacStInteraction");
-    query.exec();
+    FF_PERF_SQL(query.exec());
     fStd=fopen("UnifacInterStd.txt","w+");
     while (query.next()){
             g1=query.value(query.record().indexOf("i")).toInt();
@@ -791,7 +1017,7 @@ void WriteUnifacToFile(QSqlDatabase *db){
     }
     fclose(fStd);
     query.prepare("SELECT * FROM UnifacPSRKInteraction");
-    query.exec();
+    FF_PERF_SQL(query.exec());
     fPSRK=fopen("UnifacInterPSRK.txt","w+");
     while (query.next()){
             g1=query.value(query.record().indexOf("i")).toInt();
@@ -806,7 +1032,7 @@ void WriteUnifacToFile(QSqlDatabase *db){
     }
     fclose(fPSRK);
     query.prepare("SELECT * FROM UnifacDortInteraction");
-    query.exec();
+    FF_PERF_SQL(query.exec());
     fDort=fopen("UnifacInterDort.txt","w+");
     while (query.next()){
             g1=query.value(query.record().indexOf("i")).toInt();
@@ -821,7 +1047,7 @@ void WriteUnifacToFile(QSqlDatabase *db){
     }
     fclose(fDort);
     query.prepare("SELECT * FROM UnifacNistInteraction");
-    query.exec();
+    FF_PERF_SQL(query.exec());
     fNist=fopen("UnifacInterNist.txt","w+");
     while (query.next()){
             g1=query.value(query.record().indexOf("i")).toInt();
@@ -836,3 +1062,96 @@ void WriteUnifacToFile(QSqlDatabase *db){
     }
     fclose(fNist);
 }
+
+//Writes the Unifac information from the database to a binary store, to be memory mapped with UnifacStoreOpen. Returns 0 on failure
+int WriteUnifacToBinary(QSqlDatabase *db,const QString &fileName){
+    const char *subgCol[UNIFAC_STORE_VARIANTS]={"SubgroupVL","SubgroupPSRK","SubgroupDortmund","SubgroupNist"};
+    const char *groupCol[UNIFAC_STORE_VARIANTS]={"GroupVL","GroupPSRK","GroupDortmund","GroupNist"};
+    const char *RkCol[UNIFAC_STORE_VARIANTS]={"Rk","RkPSRK","RkDortmund","RkNist"};
+    const char *QkCol[UNIFAC_STORE_VARIANTS]={"Qk","QkPSRK","QkDortmund","QkNist"};
+    const char *interTable[UNIFAC_STORE_VARIANTS]={"UnifacStInteraction","UnifacPSRKInteraction","UnifacDortInteraction","UnifacNistInteraction"};
+    std::vector<UnifacStoreSubgroup> subg[UNIFAC_STORE_VARIANTS];
+    std::vector<UnifacStoreInteraction> inter[UNIFAC_STORE_VARIANTS];
+    std::vector<int32_t> index[UNIFAC_STORE_VARIANTS];
+    UnifacStoreHeader header;
+    int k,sg;
+    int64_t offset;
+    memset(&header,0,sizeof(header));
+    QSqlQuery query(*db);
+    //all the variants are read in a single pass over the subgroups table
+    query.prepare("SELECT * FROM UnifacSubgroups");
+    if(!FF_PERF_SQL(query.exec())) return 0;
+    while (query.next()){
+        for(k=0;k<UNIFAC_STORE_VARIANTS;k++){
+            sg=query.value(query.record().indexOf(subgCol[k])).toInt();
+            if((sg<=0)||query.value(query.record().indexOf(QkCol[k])).isNull()) continue;//without area the subgroup is unusable
+            if((int)subg[k].size()<=sg){
+                UnifacStoreSubgroup empty={0,0,0,0};
+                subg[k].resize(sg+1,empty);
+            }
+            subg[k][sg].group=query.value(query.record().indexOf(groupCol[k])).toInt();
+            subg[k][sg].Rk=query.value(query.record().indexOf(RkCol[k])).toDouble();
+            subg[k][sg].Qk=query.value(query.record().indexOf(QkCol[k])).toDouble();
+        }
+    }
+    for(k=0;k<UNIFAC_STORE_VARIANTS;k++){
+        UnifacStoreVariant *v=&header.variant[k];
+        int hasBC=(k>0);//Standard UNIFAC has only A
+        if(subg[k].empty()) subg[k].resize(1);
+        v->maxSubgroup=subg[k].size()-1;
+        for(sg=0;sg<=v->maxSubgroup;sg++) if(subg[k][sg].group>v->maxGroup) v->maxGroup=subg[k][sg].group;
+        query.prepare(QString("SELECT * FROM ")+interTable[k]);
+        if(!FF_PERF_SQL(query.exec())) return 0;
+        while (query.next()){
+            UnifacStoreInteraction ij,ji;
+            ij.i=ji.j=query.value(query.record().indexOf("i")).toInt();
+            ij.j=ji.i=query.value(query.record().indexOf("j")).toInt();
+            ij.A=query.value(query.record().indexOf("Aij")).toDouble();
+            ji.A=query.value(query.record().indexOf("Aji")).toDouble();
+            ij.B=ij.C=ji.B=ji.C=0;
+            if(hasBC){
+                ij.B=query.value(query.record().indexOf("Bij")).toDouble();
+                ij.C=query.value(query.record().indexOf("Cij")).toDouble();
+                ji.B=query.value(query.record().indexOf("Bji")).toDouble();
+                ji.C=query.value(query.record().indexOf("Cji")).toDouble();
+            }
+            if((ij.i<=0)||(ij.j<=0)) continue;
+            inter[k].push_back(ij);
+            inter[k].push_back(ji);
+            if(ij.i>v->maxGroup) v->maxGroup=ij.i;
+            if(ij.j>v->maxGroup) v->maxGroup=ij.j;
+        }
+        //sorted by (i,j). If a pair appears twice, the first record read is kept
+        std::stable_sort(inter[k].begin(),inter[k].end(),[](const UnifacStoreInteraction &a,const UnifacStoreInteraction &b){
+            return (a.i<b.i)||((a.i==b.i)&&(a.j<b.j));});
+        inter[k].erase(std::unique(inter[k].begin(),inter[k].end(),[](const UnifacStoreInteraction &a,const UnifacStoreInteraction &b){
+            return (a.i==b.i)&&(a.j==b.j);}),inter[k].end());
+        v->nInteractions=inter[k].size();
+        index[k].assign((size_t)(v->maxGroup+1)*(v->maxGroup+1),-1);
+        for(sg=0;sg<v->nInteractions;sg++) index[k][inter[k][sg].i*(v->maxGroup+1)+inter[k][sg].j]=sg;
+        if(index[k].size()%2==1) index[k].push_back(-1);//keeps the next table aligned to 8 bytes
+    }
+    header.magic=UNIFAC_STORE_MAGIC;
+    header.version=UNIFAC_STORE_VERSION;
+    header.nVariants=UNIFAC_STORE_VARIANTS;
+    if(db->driverName()=="QSQLITE") UnifacStoreFingerprint(db->databaseName(),&header.dbSize,&header.dbTime);
+    offset=sizeof(header);
+    for(k=0;k<UNIFAC_STORE_VARIANTS;k++){
+        header.variant[k].subgroupOffset=offset;
+        offset+=subg[k].size()*sizeof(UnifacStoreSubgroup);
+        header.variant[k].indexOffset=offset;
+        offset+=index[k].size()*sizeof(int32_t);
+        header.variant[k].interactionOffset=offset;
+        offset+=inter[k].size()*sizeof(UnifacStoreInteraction);
+    }
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly|QIODevice::Truncate)) return 0;
+    file.write((const char*)&header,sizeof(header));
+    for(k=0;k<UNIFAC_STORE_VARIANTS;k++){
+        file.write((const char*)subg[k].data(),subg[k].size()*sizeof(UnifacStoreSubgroup));
+        file.write((const char*)index[k].data(),index[k].size()*sizeof(int32_t));
+        if(!inter[k].empty()) file.write((const char*)inter[k].data(),inter[k].size()*sizeof(UnifacStoreInteraction));
+    }
+    file.close();
+    return (file.error()==QFileDevice::NoError);
+}
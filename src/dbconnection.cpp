@@ -0,0 +1,127 @@
+/*
+ * dbconnection.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "dbconnection.h"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+//Parameters of the main connection
+static struct{
+    std::mutex mutex;
+    QSqlDatabase *mainDb;
+    std::thread::id owner;
+    QString driver,database,user,password,host,options;
+    int port;
+} dbMain;
+
+static std::atomic<int> dbThreadCount(0);//to give a distinct name to each worker connection
+
+//Connection and statements of a thread
+struct DbThreadState{
+    QString name;//name of the worker connection, empty if not created
+    QSqlDatabase db;
+    std::map<std::pair<QString,QString>,QSqlQuery*> statements;//by connection name and sql text
+    void release(){
+        for (std::map<std::pair<QString,QString>,QSqlQuery*>::iterator it=statements.begin();it!=statements.end();++it) delete it->second;
+        statements.clear();
+        if (!name.isEmpty()){
+            db.close();
+            db=QSqlDatabase();
+            QSqlDatabase::removeDatabase(name);
+            name.clear();
+        }
+    }
+    ~DbThreadState(){
+        release();
+    }
+};
+
+static thread_local DbThreadState dbThread;
+
+//Registers the main connection. To be called once it is open, from the thread that owns it
+void DbConnectionRegister(QSqlDatabase *mainDb){
+    std::lock_guard<std::mutex> lock(dbMain.mutex);
+    dbMain.mainDb=mainDb;
+    dbMain.owner=std::this_thread::get_id();
+    dbMain.driver=mainDb->driverName();
+    dbMain.database=mainDb->databaseName();
+    dbMain.user=mainDb->userName();
+    dbMain.password=mainDb->password();
+    dbMain.host=mainDb->hostName();
+    dbMain.port=mainDb->port();
+    dbMain.options=mainDb->connectOptions();
+}
+
+//Connection for the calling thread: the main one for the registering thread, else a connection of its own.
+//Returns NULL if no connection has been registered or it can not be opened
+QSqlDatabase *DbConnectionForThread(){
+    if (!dbThread.name.isEmpty()) return &dbThread.db;
+    std::unique_lock<std::mutex> lock(dbMain.mutex);
+    if (dbMain.mainDb==NULL) return NULL;
+    if (std::this_thread::get_id()==dbMain.owner) return dbMain.mainDb;
+    QString driver=dbMain.driver,database=dbMain.database,user=dbMain.user,password=dbMain.password;
+    QString host=dbMain.host,options=dbMain.options;
+    int port=dbMain.port;
+    lock.unlock();
+    QString name="FreeFluidsWorker"+QString::number(++dbThreadCount);
+    dbThread.db=QSqlDatabase::addDatabase(driver,name);
+    dbThread.db.setDatabaseName(database);
+    dbThread.db.setUserName(user);
+    dbThread.db.setPassword(password);
+    dbThread.db.setHostName(host);
+    if (port>=0) dbThread.db.setPort(port);
+    //SQLite writers from other threads lock the file for a moment, wait for them instead of failing
+    if ((driver=="QSQLITE")&&options.isEmpty()) options="QSQLITE_BUSY_TIMEOUT=5000";
+    dbThread.db.setConnectOptions(options);
+    dbThread.name=name;
+    if (!dbThread.db.open()){
+        dbThread.release();
+        return NULL;
+    }
+    return &dbThread.db;
+}
+
+//Prepared statement for the sql text on the connection, created on first use by the calling thread. NULL if it can not be
+//prepared. The bound values are kept between uses, and finish() should be called when the results have been read
+QSqlQuery *DbConnectionStatement(QSqlDatabase *db,const QString &sql){
+    std::pair<QString,QString> key(db->connectionName(),sql);
+    std::map<std::pair<QString,QString>,QSqlQuery*>::iterator it=dbThread.statements.find(key);
+    if (it!=dbThread.statements.end()) return it->second;
+    QSqlQuery *query=new QSqlQuery(*db);
+    if (!query->prepare(sql)){
+        delete query;
+        return NULL;
+    }
+    dbThread.statements[key]=query;
+    return query;
+}
+
+//Releases the cached statements and, for a worker thread, closes its connection. It is done automatically when a
+//worker thread ends, but the main thread must call it before closing the main connection
+void DbConnectionRelease(){
+    dbThread.release();
+}
@@ -0,0 +1,452 @@
+/*
+ * eoskernel.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "eoskernel.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define EOS_SW_WIDTH 4
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define EOS_SW_WIDTH 2
+#else
+#define EOS_SW_WIDTH 1
+#endif
+
+//Coefficients of the exponential kernels: exp(x)=2^k*exp(r), with r=x-k*ln2 in [-ln2/2,ln2/2] and exp(r) by its Taylor
+//series to r^13, that is below 1e-17 relative. x is clamped to [-708,709] and below -708 the result is 0
+#define EOS_EXP_LOG2E 1.4426950408889634
+#define EOS_EXP_LN2HI 6.93145751953125e-1
+#define EOS_EXP_LN2LO 1.42860682030941723212e-6
+static const double eosExpCoef[14]={1.0/6227020800,1.0/479001600,1.0/39916800,1.0/3628800,1.0/362880,1.0/40320,1.0/5040,
+                                    1.0/720,1.0/120,1.0/24,1.0/6,0.5,1,1};
+
+#if defined(__AVX__)
+static inline __m256d EosExp4(__m256d x){
+    __m256d under=_mm256_cmp_pd(x,_mm256_set1_pd(-708),_CMP_LT_OQ);
+    x=_mm256_max_pd(_mm256_min_pd(x,_mm256_set1_pd(709)),_mm256_set1_pd(-708));
+    __m256d k=_mm256_round_pd(_mm256_mul_pd(x,_mm256_set1_pd(EOS_EXP_LOG2E)),_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC);
+    __m256d r=_mm256_sub_pd(_mm256_sub_pd(x,_mm256_mul_pd(k,_mm256_set1_pd(EOS_EXP_LN2HI))),_mm256_mul_pd(k,_mm256_set1_pd(EOS_EXP_LN2LO)));
+    __m256d p=_mm256_set1_pd(eosExpCoef[0]);
+    for(int i=1;i<14;i++) p=_mm256_add_pd(_mm256_mul_pd(p,r),_mm256_set1_pd(eosExpCoef[i]));
+    //2^k built in the exponent field, two lanes at a time as AVX has no 256 bits integer shifts
+    __m128i ki=_mm_add_epi32(_mm256_cvtpd_epi32(k),_mm_set1_epi32(1023));
+    __m128i lo=_mm_slli_epi64(_mm_cvtepi32_epi64(ki),52);
+    __m128i hi=_mm_slli_epi64(_mm_cvtepi32_epi64(_mm_srli_si128(ki,8)),52);
+    __m256d scale=_mm256_castsi256_pd(_mm256_insertf128_si256(_mm256_castsi128_si256(lo),hi,1));
+    return _mm256_andnot_pd(under,_mm256_mul_pd(p,scale));
+}
+#elif defined(__SSE2__)
+static inline __m128d EosExp2(__m128d x){
+    __m128d under=_mm_cmplt_pd(x,_mm_set1_pd(-708));
+    x=_mm_max_pd(_mm_min_pd(x,_mm_set1_pd(709)),_mm_set1_pd(-708));
+    __m128i ki=_mm_cvtpd_epi32(_mm_mul_pd(x,_mm_set1_pd(EOS_EXP_LOG2E)));//rounded to nearest
+    __m128d k=_mm_cvtepi32_pd(ki);
+    __m128d r=_mm_sub_pd(_mm_sub_pd(x,_mm_mul_pd(k,_mm_set1_pd(EOS_EXP_LN2HI))),_mm_mul_pd(k,_mm_set1_pd(EOS_EXP_LN2LO)));
+    __m128d p=_mm_set1_pd(eosExpCoef[0]);
+    for(int i=1;i<14;i++) p=_mm_add_pd(_mm_mul_pd(p,r),_mm_set1_pd(eosExpCoef[i]));
+    ki=_mm_add_epi32(ki,_mm_set1_epi32(1023));
+    __m128d scale=_mm_castsi128_pd(_mm_slli_epi64(_mm_unpacklo_epi32(ki,_mm_setzero_si128()),52));
+    return _mm_andnot_pd(under,_mm_mul_pd(p,scale));
+}
+#endif
+
+//Pads the term arrays and groups the exponents of the exponential terms. Returns 0 if there are too many distinct exponents
+int EosSW::Prepare(){
+    int i,k,nT=nPol+nExp+nSpec;
+    nPad=(nT+3)/4*4;
+    for(i=nT;i<nPad;i++) n[i]=d[i]=t[i]=c[i]=a[i]=e[i]=b[i]=g[i]=0;
+    nC=0;
+    for(i=nPol;i<nPol+nExp;i++){
+        for(k=0;(k<nC)&&(cVal[k]!=c[i]);k++);
+        if(k==nC){
+            if(nC==EOS_SW_MAXC) return 0;
+            cVal[nC++]=c[i];
+        }
+        cIdx[i]=k;
+    }
+    return 1;
+}
+
+//Reduced Helmholtz derivatives in delta and tau, vectorized. The exponent of each term and the derivatives of its
+//logarithm are prepared by type, in loops without branches, and then the exponentials and the sums go by vectors
+void EosSW::PhiDer(double delta,double tau,double phi[6]) const{
+    int i,k;
+    double x[EOS_SW_MAXTERMS],gd[EOS_SW_MAXTERMS],hd[EOS_SW_MAXTERMS],gt[EOS_SW_MAXTERMS],ht[EOS_SW_MAXTERMS];
+    double dc[EOS_SW_MAXC];
+    double lnD=log(delta),lnT=log(tau),iD=1/delta,iT=1/tau,iD2=iD*iD,iT2=iT*iT;
+    int nT=nPol+nExp+nSpec;
+    for(k=0;k<nC;k++) dc[k]=exp(cVal[k]*lnD);
+    for(i=0;i<nPad;i++){//polynomial part, common to all the terms
+        x[i]=d[i]*lnD+t[i]*lnT;
+        gd[i]=d[i]*iD;
+        hd[i]=-d[i]*iD2;
+        gt[i]=t[i]*iT;
+        ht[i]=-t[i]*iT2;
+    }
+    for(i=nPol;i<nPol+nExp;i++){//exponential terms: E=-delta^c
+        double dci=dc[cIdx[i]];
+        x[i]-=dci;
+        gd[i]-=c[i]*dci*iD;
+        hd[i]-=c[i]*(c[i]-1)*dci*iD2;
+    }
+    for(i=nPol+nExp;i<nT;i++){//gaussian terms
+        double dd=delta-e[i],tt=tau-g[i];
+        x[i]-=a[i]*dd*dd+b[i]*tt*tt;
+        gd[i]-=2*a[i]*dd;
+        hd[i]-=2*a[i];
+        gt[i]-=2*b[i]*tt;
+        ht[i]-=2*b[i];
+    }
+#if defined(__AVX__)
+    __m256d s[6];
+    for(k=0;k<6;k++) s[k]=_mm256_setzero_pd();
+    for(i=0;i<nPad;i+=4){
+        __m256d v=_mm256_mul_pd(_mm256_loadu_pd(n+i),EosExp4(_mm256_loadu_pd(x+i)));
+        __m256d vgd=_mm256_loadu_pd(gd+i),vgt=_mm256_loadu_pd(gt+i);
+        __m256d wd=_mm256_mul_pd(v,vgd);
+        __m256d wt=_mm256_mul_pd(v,vgt);
+        s[0]=_mm256_add_pd(s[0],v);
+        s[1]=_mm256_add_pd(s[1],wd);
+        s[2]=_mm256_add_pd(s[2],_mm256_add_pd(_mm256_mul_pd(wd,vgd),_mm256_mul_pd(v,_mm256_loadu_pd(hd+i))));
+        s[3]=_mm256_add_pd(s[3],wt);
+        s[4]=_mm256_add_pd(s[4],_mm256_add_pd(_mm256_mul_pd(wt,vgt),_mm256_mul_pd(v,_mm256_loadu_pd(ht+i))));
+        s[5]=_mm256_add_pd(s[5],_mm256_mul_pd(wd,vgt));
+    }
+    for(k=0;k<6;k++){
+        double r[4];
+        _mm256_storeu_pd(r,s[k]);
+        phi[k]=(r[0]+r[1])+(r[2]+r[3]);
+    }
+#elif defined(__SSE2__)
+    __m128d s[6];
+    for(k=0;k<6;k++) s[k]=_mm_setzero_pd();
+    for(i=0;i<nPad;i+=2){
+        __m128d v=_mm_mul_pd(_mm_loadu_pd(n+i),EosExp2(_mm_loadu_pd(x+i)));
+        __m128d vgd=_mm_loadu_pd(gd+i),vgt=_mm_loadu_pd(gt+i);
+        __m128d wd=_mm_mul_pd(v,vgd);
+        __m128d wt=_mm_mul_pd(v,vgt);
+        s[0]=_mm_add_pd(s[0],v);
+        s[1]=_mm_add_pd(s[1],wd);
+        s[2]=_mm_add_pd(s[2],_mm_add_pd(_mm_mul_pd(wd,vgd),_mm_mul_pd(v,_mm_loadu_pd(hd+i))));
+        s[3]=_mm_add_pd(s[3],wt);
+        s[4]=_mm_add_pd(s[4],_mm_add_pd(_mm_mul_pd(wt,vgt),_mm_mul_pd(v,_mm_loadu_pd(ht+i))));
+        s[5]=_mm_add_pd(s[5],_mm_mul_pd(wd,vgt));
+    }
+    for(k=0;k<6;k++){
+        double r[2];
+        _mm_storeu_pd(r,s[k]);
+        phi[k]=r[0]+r[1];
+    }
+#else
+    for(k=0;k<6;k++) phi[k]=0;
+    for(i=0;i<nT;i++){
+        double v=n[i]*exp(x[i]);
+        phi[0]+=v;
+        phi[1]+=v*gd[i];
+        phi[2]+=v*(gd[i]*gd[i]+hd[i]);
+        phi[3]+=v*gt[i];
+        phi[4]+=v*(gt[i]*gt[i]+ht[i]);
+        phi[5]+=v*gd[i]*gt[i];
+    }
+#endif
+    PhiDerFinal(delta,tau,phi);
+}
+
+//Non analytical terms n*Delta^b*delta*psi, with Delta=theta^2+B*((delta-1)^2)^a, theta=(1-tau)+A*((delta-1)^2)^(1/(2beta))
+//and psi=exp(-C*(delta-1)^2-D*(tau-1)^2), as in the IAPWS95 formulation. They are few, and are done in scalar form
+void EosSW::PhiDerFinal(double delta,double tau,double phi[6]) const{
+    for(int i=0;i<nFinal;i++){
+        double dm=delta-1,tm=tau-1;
+        if(fabs(dm)<1e-10) dm=1e-10;//the derivatives of Delta are singular at delta=1
+        double dm2=dm*dm;
+        double ex=1/(2*betaf[i]);
+        double q=pow(dm2,ex);
+        double theta=-tm+Af[i]*q;
+        double Dl=theta*theta+Bf[i]*pow(dm2,af[i]);
+        double psi=exp(-Cf[i]*dm2-Df[i]*tm*tm);
+        double psiD=-2*Cf[i]*dm*psi;
+        double psiDD=(2*Cf[i]*dm2-1)*2*Cf[i]*psi;
+        double psiT=-2*Df[i]*tm*psi;
+        double psiTT=(2*Df[i]*tm*tm-1)*2*Df[i]*psi;
+        double psiDT=4*Cf[i]*Df[i]*dm*tm*psi;
+        double dDl=dm*(Af[i]*theta*2/betaf[i]*q/dm2+2*Bf[i]*af[i]*pow(dm2,af[i]-1));
+        double d2Dl=dDl/dm+dm2*(4*Bf[i]*af[i]*(af[i]-1)*pow(dm2,af[i]-2)+2*Af[i]*Af[i]/(betaf[i]*betaf[i])*(q/dm2)*(q/dm2)
+                                +Af[i]*theta*4/betaf[i]*(ex-1)*q/(dm2*dm2));
+        double Db=pow(Dl,bf[i]);
+        double Db1=bf[i]*Db/Dl;//b*Delta^(b-1)
+        double Db2=bf[i]*(bf[i]-1)*Db/(Dl*Dl);//b*(b-1)*Delta^(b-2)
+        double dDb=Db1*dDl;
+        double d2Db=Db1*d2Dl+Db2*dDl*dDl;
+        double tDb=-2*theta*Db1;
+        double t2Db=2*Db1+4*theta*theta*Db2;
+        double dtDb=-Af[i]*2/betaf[i]*Db1*dm*q/dm2-2*theta*Db2*dDl;
+        double ni=nf[i];
+        phi[0]+=ni*Db*delta*psi;
+        phi[1]+=ni*(Db*(psi+delta*psiD)+dDb*delta*psi);
+        phi[2]+=ni*(Db*(2*psiD+delta*psiDD)+2*dDb*(psi+delta*psiD)+d2Db*delta*psi);
+        phi[3]+=ni*delta*(tDb*psi+Db*psiT);
+        phi[4]+=ni*delta*(t2Db*psi+2*tDb*psiT+Db*psiTT);
+        phi[5]+=ni*(Db*(psiT+delta*psiDT)+delta*dDb*psiT+tDb*(psi+delta*psiD)+dtDb*delta*psi);
+    }
+}
+
+//Instantiations of the templates for each model, selected through the member of EosKernel that holds it
+template<class Model,Model EosKernel::*member> static void KerArrDer(const EosKernel *ker,double T,double V,double result[6]){
+    (ker->*member).ArrDer(T,V,result);
+}
+
+template<class Model,Model EosKernel::*member> static void KerArrDerBatch(const EosKernel *ker,int n,const double T[],const double V[],double result[][6]){
+    EosArrDerBatch(ker->*member,n,T,V,result);
+}
+
+template<class Model,Model EosKernel::*member> static double KerPressure(const EosKernel *ker,double T,double V){
+    return EosPressure(ker->*member,T,V);
+}
+
+template<class Model,Model EosKernel::*member> static void KerSet(EosKernel *ker,enum EosKernelVariant variant){
+    ker->variant=variant;
+    ker->arrDer=&KerArrDer<Model,member>;
+    ker->arrDerBatch=&KerArrDerBatch<Model,member>;
+    ker->pressure=&KerPressure<Model,member>;
+}
+
+//Compares two sets of Helmholtz derivatives
+static int EosKernelSame(const double r1[6],const double r2[6]){
+    for(int i=0;i<6;i++){
+        if(!(fabs(r1[i]-r2[i])<=1e-7*fabs(r2[i])+1e-12)) return 0;
+    }
+    return 1;
+}
+
+//Checks a native model against the FreeFluidsC calculation at two temperatures and two volumes
+template<class Native,class Reference> static int EosKernelValidate(const Native &nat,const Reference &ref,const double T[2],const double V[2]){
+    double r1[6],r2[6];
+    for(int i=0;i<2;i++) for(int j=0;j<2;j++){
+        nat.ArrDer(T[i],V[j],r1);
+        ref.ArrDer(T[i],V[j],r2);
+        if(EosKernelSame(r1,r2)==0) return 0;
+    }
+    return 1;
+}
+
+//Fills the constant part of a cubic model
+static void EosKernelCubicConst(FF_CubicEOSdata *data,EosCubicConst *k){
+    FF_CubicParam param;
+    FF_FixedParamCubic(data,&param);
+    k->a=param.a;
+    k->b=param.b;
+    k->c=param.c;
+    k->u=param.u;
+    k->w=param.w;
+    k->Tc=data->Tc;
+    k->D=sqrt(param.u*param.u-4*param.w);
+    k->d1=(param.u+k->D)/2;
+    k->d2=(param.u-k->D)/2;
+}
+
+static void EosKernelBuildCubicModel(FF_CubicEOSdata *data,EosKernel *ker){
+    double w=data->w;
+    double T[2],V[2];
+    ker->cubicGen.data=data;
+    KerSet<EosCubicGeneric,&EosKernel::cubicGen>(ker,EOS_KER_CUBICGEN);
+    if(data->Tc<=0) return;
+    EosKernelCubicConst(data,&ker->soave.k);
+    if(!(ker->soave.k.u*ker->soave.k.u-4*ker->soave.k.w>0)) return;
+    ker->prsv1.k=ker->twu91.k=ker->soave.k;
+    T[0]=0.7*data->Tc;
+    T[1]=1.3*data->Tc;
+    V[0]=1.5*ker->soave.k.b;
+    V[1]=20*ker->soave.k.b;
+    switch(data->eos){
+    case FF_PR76:
+        ker->soave.alpha.m=0.37464+1.54226*w-0.26992*w*w;
+        if(EosKernelValidate(ker->soave,ker->cubicGen,T,V)) KerSet<EosCubic<EosAlphaSoave>,&EosKernel::soave>(ker,EOS_KER_SOAVE);
+        break;
+    case FF_PR78:
+        if(w<=0.491) ker->soave.alpha.m=0.37464+1.54226*w-0.26992*w*w;
+        else ker->soave.alpha.m=0.379642+1.48503*w-0.164423*w*w+0.016666*w*w*w;
+        if(EosKernelValidate(ker->soave,ker->cubicGen,T,V)) KerSet<EosCubic<EosAlphaSoave>,&EosKernel::soave>(ker,EOS_KER_SOAVE);
+        break;
+    case FF_SRK:
+        ker->soave.alpha.m=0.48+1.574*w-0.176*w*w;
+        if(EosKernelValidate(ker->soave,ker->cubicGen,T,V)) KerSet<EosCubic<EosAlphaSoave>,&EosKernel::soave>(ker,EOS_KER_SOAVE);
+        break;
+    case FF_PRSV1:
+        ker->prsv1.alpha.m=0.378893+1.4897153*w-0.17131848*w*w+0.0196554*w*w*w;
+        ker->prsv1.alpha.k1=data->k1;
+        if(EosKernelValidate(ker->prsv1,ker->cubicGen,T,V)) KerSet<EosCubic<EosAlphaPRSV1>,&EosKernel::prsv1>(ker,EOS_KER_PRSV1);
+        break;
+    case FF_PRTWU91:
+    case FF_SRKTWU91:
+        ker->twu91.alpha.L=data->k1;
+        ker->twu91.alpha.M=data->k2;
+        ker->twu91.alpha.N=data->k3;
+        if(EosKernelValidate(ker->twu91,ker->cubicGen,T,V)) KerSet<EosCubic<EosAlphaTwu91>,&EosKernel::twu91>(ker,EOS_KER_TWU91);
+        break;
+    default:
+        break;
+    }
+}
+
+//Checks the native multiparameter model against FreeFluidsC by groups of terms: polynomial, exponential, gaussian and
+//non analytical. Each group is compared alone, with the coefficients of the other terms nulled in both models. Besides
+//the validation states, a state near the reducing point (delta=1.05, tau=0.98) is checked, as far from it the gaussian
+//and non analytical terms are negligible, and an error in their parameters would pass unnoticed
+static int EosKernelValidateSWGroups(const EosSW &sw,const FF_SWEOSdata *data,const double T[2],const double V[2]){
+    int nT=sw.nPol+sw.nExp+sw.nSpec;
+    int first[4]={0,sw.nPol,sw.nPol+sw.nExp,nT};
+    int last[4]={sw.nPol,sw.nPol+sw.nExp,nT,nT+sw.nFinal};
+    double Tg[3]={T[0],T[1],sw.tRef/0.98},Vg[3]={V[0],V[1],1/(1.05*sw.rhoRef)};
+    double r1[6],r2[6];
+    int ok=1;
+    EosSW grp;
+    EosSWGeneric grpGen;
+    FF_SWEOSdata *grpData=new FF_SWEOSdata;
+    grpGen.data=grpData;
+    for(int g=0;(g<4)&&(ok==1);g++){
+        if(first[g]==last[g]) continue;
+        grp=sw;
+        *grpData=*data;
+        for(int i=0;i<nT+sw.nFinal;i++){
+            if((i>=first[g])&&(i<last[g])) continue;
+            if(i<nT) grp.n[i]=0;
+            else grp.nf[i-nT]=0;
+            grpData->n[i]=0;
+        }
+        for(int i=0;i<3;i++) for(int j=0;j<3;j++){
+            if((i==2)!=(j==2)) continue;//the reducing point state goes alone
+            grp.ArrDer(Tg[i],Vg[j],r1);
+            grpGen.ArrDer(Tg[i],Vg[j],r2);
+            if(EosKernelSame(r1,r2)==0) ok=0;
+        }
+    }
+    delete grpData;
+    return ok;
+}
+
+static void EosKernelBuildSW(FF_SubstanceData *subs,EosKernel *ker){
+    FF_SWEOSdata *data=&subs->swData;
+    EosSW *sw=&ker->sw;
+    int i,nT=data->nPol+data->nExp+data->nSpec;
+    double T[2],V[2];
+    ker->swGen.data=data;
+    KerSet<EosSWGeneric,&EosKernel::swGen>(ker,EOS_KER_SWGEN);
+    if((data->nFinal>EOS_SW_MAXFINAL)||(nT>EOS_SW_MAXTERMS)||(data->tRef<=0)||(data->rhoRef<=0)) return;
+    sw->tRef=data->tRef;
+    sw->nPol=data->nPol;
+    sw->nExp=data->nExp;
+    sw->nSpec=data->nSpec;
+    sw->nFinal=(data->nFinal>0) ? data->nFinal : 0;
+    for(i=0;i<nT;i++){
+        sw->n[i]=data->n[i];
+        sw->d[i]=data->d[i];
+        sw->t[i]=data->t[i];
+        sw->c[i]=data->c[i];
+        sw->a[i]=sw->e[i]=sw->b[i]=sw->g[i]=0;
+    }
+    for(i=0;i<data->nSpec;i++){//the gaussian parameters are stored from 0 in FF_SWEOSdata, as loaded from SWparam
+        int k=data->nPol+data->nExp+i;
+        sw->a[k]=data->a[i];
+        sw->e[k]=data->e[i];
+        sw->b[k]=data->b[i];
+        sw->g[k]=data->g[i];
+    }
+    for(i=0;i<sw->nFinal;i++){//stored after the other terms
+        sw->nf[i]=data->n[nT+i];
+        sw->af[i]=data->af[i];
+        sw->bf[i]=data->bf[i];
+        sw->Af[i]=data->Af[i];
+        sw->Bf[i]=data->Bf[i];
+        sw->Cf[i]=data->Cf[i];
+        sw->Df[i]=data->Df[i];
+        sw->betaf[i]=data->betaf[i];
+    }
+    if(sw->Prepare()==0) return;
+    T[0]=0.8*data->tRef;
+    T[1]=1.5*data->tRef;
+    //the reducing density can be stored as molar or mass density
+    sw->rhoRef=data->rhoRef;
+    V[0]=0.5/sw->rhoRef;
+    V[1]=10/sw->rhoRef;
+    if(EosKernelValidate(*sw,ker->swGen,T,V)&&EosKernelValidateSWGroups(*sw,data,T,V)){
+        KerSet<EosSW,&EosKernel::sw>(ker,EOS_KER_SW);
+        return;
+    }
+    if(data->MW>0){
+        sw->rhoRef=data->rhoRef/(data->MW*1e-3);
+        V[0]=0.5/sw->rhoRef;
+        V[1]=10/sw->rhoRef;
+        if(EosKernelValidate(*sw,ker->swGen,T,V)&&EosKernelValidateSWGroups(*sw,data,T,V)) KerSet<EosSW,&EosKernel::sw>(ker,EOS_KER_SW);
+    }
+}
+
+//Selects and prepares the model for the substance EOS. The native models are checked against FreeFluidsC at build time,
+//falling back to the model calling FreeFluidsC if they disagree. Returns 0 if the substance has no EOS
+int EosKernelBuild(FF_SubstanceData *subs,EosKernel *ker){
+    memset(ker,0,sizeof(EosKernel));
+    ker->variant=EOS_KER_NONE;
+    switch(subs->model){
+    case FF_SAFTtype:
+        ker->saft.data=&subs->saftData;
+        KerSet<EosSAFT,&EosKernel::saft>(ker,EOS_KER_SAFT);
+        break;
+    case FF_SWtype:
+        EosKernelBuildSW(subs,ker);
+        break;
+    case FF_CubicType:
+    case FF_CubicPRtype:
+    case FF_CubicSRKtype:
+        EosKernelBuildCubicModel(&subs->cubicData,ker);
+        break;
+    default:
+        return 0;
+    }
+    return 1;
+}
+
+//Selects and prepares the model for cubic EOS data alone, as held in FF_MixData. Returns 0 if the EOS is not defined
+int EosKernelBuildCubic(FF_CubicEOSdata *data,EosKernel *ker){
+    memset(ker,0,sizeof(EosKernel));
+    ker->variant=EOS_KER_NONE;
+    if(data->Tc<=0) return 0;
+    EosKernelBuildCubicModel(data,ker);
+    return 1;
+}
+
+//Name of the variant selected, for information
+const char *EosKernelVariantName(const EosKernel *ker){
+    switch(ker->variant){
+    case EOS_KER_SOAVE: return "Cubic, Soave alpha";
+    case EOS_KER_PRSV1: return "Cubic, PRSV1 alpha";
+    case EOS_KER_TWU91: return "Cubic, Twu91 alpha";
+    case EOS_KER_CUBICGEN: return "Cubic, FreeFluidsC";
+    case EOS_KER_SAFT: return "SAFT, FreeFluidsC";
+    case EOS_KER_SW: return "Multiparameter";
+    case EOS_KER_SWGEN: return "Multiparameter, FreeFluidsC";
+    default: return "None";
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * eostcache.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "eostcache.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#define EOSTC_SLOTS 32 //direct mapped, must be a power of 2
+
+typedef struct{
+    const FF_CubicEOSdata *data;//substance of the entry. NULL if the slot is empty
+    double T;
+    FF_CubicEOSdata copy;//parameters used for the calculation
+    FF_CubicParam param;
+} EosTCacheCubicEntry;
+
+static thread_local EosTCacheCubicEntry cubicCache[EOSTC_SLOTS];
+static thread_local long cacheHits=0,cacheMisses=0;
+
+//Slot of a substance and temperature
+static int EosTCacheSlot(const void *data,double T){
+    uint64_t h,t;
+    memcpy(&t,&T,sizeof(double));
+    h=(uint64_t)(uintptr_t)data;
+    h^=t+0x9e3779b97f4a7c15ULL+(h<<6)+(h>>2);
+    h^=h>>29;
+    h*=0xbf58476d1ce4e5b9ULL;
+    h^=h>>32;
+    return (int)(h&(EOSTC_SLOTS-1));
+}
+
+//Cubic parameters with Theta, dTheta/dT and d2Theta/dT2 at T, from the cache of the calling thread when possible
+void EosTCacheCubic(const FF_CubicEOSdata *data,double T,FF_CubicParam *param){
+    EosTCacheCubicEntry *e=&cubicCache[EosTCacheSlot(data,T)];
+    if((e->data==data)&&(e->T==T)&&(memcmp(&e->copy,data,sizeof(FF_CubicEOSdata))==0)){
+        *param=e->param;
+        cacheHits++;
+        return;
+    }
+    cacheMisses++;
+    memcpy(&e->copy,data,sizeof(FF_CubicEOSdata));
+    FF_FixedParamCubic(&e->copy,&e->param);
+    FF_ThetaDerivCubic(&T,&e->copy,&e->param);
+    e->data=data;
+    e->T=T;
+    *param=e->param;
+}
+
+//Empties the cache of the calling thread
+void EosTCacheClear(){
+    memset(cubicCache,0,sizeof(cubicCache));
+    cacheHits=cacheMisses=0;
+}
+
+//Hits and misses of the cache of the calling thread, since the last clear
+void EosTCacheStats(long *hits,long *misses){
+    *hits=cacheHits;
+    *misses=cacheMisses;
+}
@@ -24,6 +24,7 @@
 #include "ui_freefluidsmainwindow.h"
 #include <iostream>
 #include <string>
+#include <string.h>
 
 FreeFluidsMainWindow::FreeFluidsMainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -53,35 +54,69 @@ FreeFluidsMainWindow::FreeFluidsMainWindow(QWidget *parent) :
             "Click Cancel to finish", QMessageBox::Cancel);
         }
     }
-    //QueryModel(no editable) for holding the substances list
-    subsListModel=new QSqlQueryModel(this);
-    subsListModel->setQuery("SELECT Id,Name,MW from Products ORDER BY Name");
-    //subsListModel->setQuery("SELECT Id,Name,MW from Products WHERE (Id<=2001 OR InGitHub=1) ORDER BY Name");
+    //Worker threads open their own connections with the same parameters
+    if (db.isOpen()) DbConnectionRegister(&db);
+    //Binary Unifac parameters store, generated from the database if not present or older than the database
+    unifacStore.file=NULL;
+    unifacStore.base=NULL;
+    openUnifacStore();
+    //Search index and model (no editable) for holding the substances list. Rows are fetched as the list is scrolled
+    SubsIndexBuild(&db,&subsIndex);
+    subsListModel=new SubsListModel(&subsIndex,this);
+    subsListModel->reset();
     //Data entry validators
     presBarValidator=new QDoubleValidator(0.0,10000.0,5,this);
     //presBarValidator->setNotation(QDoubleValidator::StandardNotation);
     tempCValidator=new QDoubleValidator(-273.15,4000.0,2,this);
     //tempCValidator->setNotation(QDoubleValidator::StandardNotation);
+    //The completer shows the result of the index search, it does not filter by itself. It is not set as the combobox completer,
+    //as the combobox would then look for the chosen text among the rows fetched, and could select a wrong or no row
+    subsMatchModel=new SubsMatchModel(this);
     subsCompleter= new QCompleter(this);
-    subsCompleter->setModel(subsListModel);
+    subsCompleter->setModel(subsMatchModel);
     subsCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    subsCompleter->setCompletionColumn(1);
-    subsCompleter->setCompletionMode(QCompleter::CompletionMode(1));
-    //std::cout<<subsCompleter->completionModel()->
+    subsCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    subsCompleter->setMaxVisibleItems(15);
+    //Performance dock: calls to FreeFluidsC and database queries done by the last action. Shown from the Tools menu
+    perfDock=new QDockWidget("Performance",this);
+    perfDock->setObjectName("perfDock");
+    QWidget *perfWidget=new QWidget(perfDock);
+    QVBoxLayout *perfLayout=new QVBoxLayout(perfWidget);
+    perfSummary=new QLabel(perfWidget);
+    perfTable=new QTableWidget(0,7,perfWidget);
+    perfTable->setHorizontalHeaderLabels(QStringList()<<"Call"<<"Type"<<"Count"<<"Total (ms)"<<"Mean (us)"<<"p99 (us)"<<"Max (us)");
+    perfTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    perfTable->verticalHeader()->setVisible(false);
+    perfLayout->addWidget(perfSummary);
+    perfLayout->addWidget(perfTable);
+    perfDock->setWidget(perfWidget);
+    addDockWidget(Qt::BottomDockWidgetArea,perfDock);
+    perfDock->hide();
+    ui->menu_Tools->addAction(perfDock->toggleViewAction());
 
     //Common setup
     //************
 
     subsData = new FF_SubstanceData;
     subsDataRef= new FF_SubstanceData;
+    subsFlash=new PureFlashEngine;
+    subsIF97=0;
+    CalcArenaInit(&mixArena,16*sizeof(FF_SubstanceData));
     mix = new FF_MixData;
     //fill with 0 the eos binary interaction parameters array
     for(int i=0;i<15;i++) for(int j=0;j<15;j++) for(int k=0;k<6;k++) mix->intParam[i][j][k]=0;
+    for(int i=0;i<4;i++) mixUnifac[i].nSubs=0;
+    for(int i=0;i<4;i++) mixSatWarm[i].valid=0;
 
     //Combobox for substance selection model assignation
-    ui->cbSubsCalcSelSubs->setCompleter(subsCompleter);
+    ui->cbSubsCalcSelSubs->setEditable(true);
+    ui->cbSubsCalcSelSubs->setInsertPolicy(QComboBox::NoInsert);
     ui->cbSubsCalcSelSubs->setModel(subsListModel);
     ui->cbSubsCalcSelSubs->setModelColumn(1);
+    ui->cbSubsCalcSelSubs->setCompleter(NULL);//removes the one created by setEditable
+    subsCompleter->setWidget(ui->cbSubsCalcSelSubs->lineEdit());
+    connect(ui->cbSubsCalcSelSubs->lineEdit(),SIGNAL(textEdited(QString)),this,SLOT(cbSubsCalcSelSearch(QString)));
+    connect(subsCompleter,SIGNAL(activated(QModelIndex)),this,SLOT(cbSubsCalcSelFound(QModelIndex)));
     connect(ui->cbSubsCalcSelSubs,SIGNAL(currentIndexChanged(int)),this,SLOT(cbSubsCalcSelLoad(int)));//A new substance selection must update available EOS and Cp0
 
 
@@ -132,6 +167,10 @@ FreeFluidsMainWindow::FreeFluidsMainWindow(QWidget *parent) :
         }
 
     }
+    subsCalcRows=SUBS_CALC_ALL;
+    //The rows hidden from the context menu of the vertical header are left out of the calculation
+    ui->twSubsCalc->verticalHeader()->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(ui->twSubsCalc->verticalHeader(),SIGNAL(customContextMenuRequested(QPoint)),this,SLOT(twSubsCalcRowMenu(QPoint)));
 
     //Button for alternative calculation
     connect(ui->btnSubsCalcAltCalc,SIGNAL(clicked()),this,SLOT(btnSubsCalcAltCalc()));
@@ -441,9 +480,13 @@ FreeFluidsMainWindow::~FreeFluidsMainWindow()
     delete ui;
     delete subsData;
     delete subsDataRef;
+    delete subsFlash;
+    CalcArenaFree(&mixArena);
     //delete[] substance;
     //delete[] subsPoint;
     delete mix;
+    UnifacStoreClose(&unifacStore);
+    DbConnectionRelease();
     QString database=db.connectionName();
     db.close();
     //db.removeDatabase(database);
@@ -452,13 +495,62 @@ FreeFluidsMainWindow::~FreeFluidsMainWindow()
 //Common functions
 //****************
 
+//Slot for the substance search, as the name, CAS number, formula or synonym is typed
+void FreeFluidsMainWindow::cbSubsCalcSelSearch(const QString &text)
+{
+    std::vector<int> found;
+    SubsIndexFind(&subsIndex,text,100,&found);
+    subsMatchModel->setMatches(&subsIndex,found);
+    if (found.empty()) subsCompleter->popup()->hide();
+    else subsCompleter->complete();
+}
+
+//Slot for the selection of a substance found by the search
+void FreeFluidsMainWindow::cbSubsCalcSelFound(const QModelIndex &index)
+{
+    int row=SubsIndexEntryOfId(&subsIndex,index.data(Qt::UserRole).toInt());//the list is in the same order as the index
+    if (row<0) return;
+    subsListModel->ensureFetched(row);
+    ui->cbSubsCalcSelSubs->setCurrentIndex(row);//loads the substance through currentIndexChanged
+}
+
+//Starts counting for a new action, and schedules the display of its counters for when the slot has finished
+void FreeFluidsMainWindow::perfStart(const char *action)
+{
+    PerfBegin(action);
+    if (perfDock->isVisible()) QTimer::singleShot(0,this,SLOT(perfShow()));
+}
+
+//Displays the counters of the last action in the performance dock
+void FreeFluidsMainWindow::perfShow()
+{
+    PerfSnapshotData snap;
+    PerfSnapshot(&snap);
+    if (snap.action==NULL) return;
+    perfSummary->setText(QString("%1: %2 ms. FreeFluidsC calls: %3. SQL round trips: %4 (%5 ms). Arena system allocations: %6 (mixture arena %7 kB)")
+                         .arg(snap.action).arg(1e3*snap.wall,0,'f',2).arg(snap.calls).arg(snap.sqlTrips).arg(1e3*snap.sqlTime,0,'f',2)
+                         .arg(CalcArenaSystemAllocs()).arg(mixArena.size/1024));
+    perfTable->setRowCount(snap.stats.size());
+    for (int i=0;i<(int)snap.stats.size();i++){
+        const PerfStat &st=snap.stats[i];
+        perfTable->setItem(i,0,new QTableWidgetItem(st.name));
+        perfTable->setItem(i,1,new QTableWidgetItem(st.kind==PERF_SQL ? "SQL" : "Call"));
+        perfTable->setItem(i,2,new QTableWidgetItem(QString::number(st.count)));
+        perfTable->setItem(i,3,new QTableWidgetItem(QString::number(1e3*st.total,'f',3)));
+        perfTable->setItem(i,4,new QTableWidgetItem(QString::number(1e6*st.mean,'f',2)));
+        perfTable->setItem(i,5,new QTableWidgetItem(QString::number(1e6*st.p99,'f',2)));
+        perfTable->setItem(i,6,new QTableWidgetItem(QString::number(1e6*st.max,'f',2)));
+    }
+    perfTable->resizeColumnsToContents();
+}
+
 //Slot for loading the existing EOS and correlations for the selected substance
 void FreeFluidsMainWindow::cbSubsCalcSelLoad(int position)
 {
-    //Delete old substance,create a new one, and clear screen
-    delete subsData;
-    subsData= new FF_SubstanceData;
-    subsData->id=subsListModel->record(position).value("Id").toInt();
+    perfStart("Substance load");
+    //Clear the old substance, reusing its memory, and clear screen
+    memset(subsData,0,sizeof(FF_SubstanceData));
+    subsData->id=subsListModel->id(position);
     subsData->refT=0.0;
     subsData->refP=101325;
     subsData->vpCorr.form=0;
@@ -570,10 +662,14 @@ void FreeFluidsMainWindow::cbSubsCalcSelLoad(int position)
 
     //Charge EOS, Cp0, and correlations comboboxes with the options available for the substance
     QSqlQuery queryEos,queryCp0,queryCorr;
+    //IAPWS-IF97 is offered for the substances having IAPWS95, whose parameters are used out of the IF97 regions
     queryEos.prepare("SELECT EosParam.Eos As Eos,EosParam.Description As Description,EosParam.Id As Id,EosParam.Tmin as Tmin,EosParam.Tmax as Tmax,Eos.Type As Type "
-                     "FROM EosParam INNER JOIN Eos ON EosParam.Eos=Eos.Eos WHERE ((IdProduct)=?) ORDER BY EosParam.Eos");
+                     "FROM EosParam INNER JOIN Eos ON EosParam.Eos=Eos.Eos WHERE ((IdProduct)=?) "
+                     "UNION SELECT 'IF97' As Eos,'IAPWS-IF97 industrial formulation, IAPWS95 out of regions 1 and 2' As Description,EosParam.Id As Id,"
+                     "273.15 As Tmin,1073.15 As Tmax,'IF97' As Type FROM EosParam WHERE ((IdProduct=?) AND (EosParam.Eos='IAPWS95')) ORDER BY Eos");
     queryEos.addBindValue(subsData->id);
-    queryEos.exec();
+    queryEos.addBindValue(subsData->id);
+    FF_PERF_SQL(queryEos.exec());
     subsCalcEOSModel->setQuery(queryEos);
     tvSubsCalcSelEOS->setColumnHidden(2,true);
     tvSubsCalcSelEOS->setColumnWidth(0,78);
@@ -589,9 +685,9 @@ void FreeFluidsMainWindow::cbSubsCalcSelLoad(int position)
                      "Correlations.IdEquation) ON PhysProp.Id = Correlations.IdPhysProp WHERE (((CorrelationParam.IdProduct)=?) "
                      "AND ((PhysProp.Property)=?)) ORDER BY Equation");
 
-    queryCp0.addBindValue(subsListModel->record(position).value("Id"));
+    queryCp0.addBindValue(subsListModel->id(position));
     queryCp0.addBindValue("Cp0");
-    queryCp0.exec();
+    FF_PERF_SQL(queryCp0.exec());
     subsCalcCp0Model->setQuery(queryCp0);
     tvSubsCalcSelCp0->setColumnHidden(6,true);
     tvSubsCalcSelCp0->resizeColumnsToContents();
@@ -603,8 +699,8 @@ void FreeFluidsMainWindow::cbSubsCalcSelLoad(int position)
                       "Correlations.Number = CorrelationParam.NumCorrelation) ON CorrelationEquations.Id = Correlations.IdEquation) "
                       "ON PhysProp.Id = Correlations.IdPhysProp WHERE (((CorrelationParam.IdProduct)=?))ORDER BY Property;");
 
-    queryCorr.addBindValue(subsListModel->record(position).value("Id"));
-    queryCorr.exec();
+    queryCorr.addBindValue(subsListModel->id(position));
+    FF_PERF_SQL(queryCorr.exec());
     subsToolsCorrModel->setQuery(queryCorr);
     tvSubsToolsSelCorr->setColumnHidden(7,true);
     tvSubsToolsSelCorr->resizeColumnsToContents();
@@ -622,6 +718,7 @@ void FreeFluidsMainWindow::cbSubsCalcEosUpdate(int position){
     eosTypeString=subsCalcEOSModel->record(position).value("Type").toString().toStdString();
     std::string eosInfo=subsCalcEOSModel->record(position).value("Description").toString().toStdString();
     eosInfo=eosInfo + "  Tmin:"+subsCalcEOSModel->record(position).value("Tmin").toString().toStdString()+"  Tmax:"+subsCalcEOSModel->record(position).value("Tmax").toString().toStdString();
+    subsIF97=0;
     if((eosTypeString=="Cubic PR")||(eosTypeString=="Cubic SRK")){
         subsData->model=FF_CubicType;
         subsData->cubicData.id=subsCalcEOSModel->record(position).value("Id").toInt();
@@ -640,7 +737,15 @@ void FreeFluidsMainWindow::cbSubsCalcEosUpdate(int position){
         ui->leSubsCalcSW->setText(QString::fromStdString(eosInfo));
         ui->chbSubsCalcSW->setChecked(true);
     }
+    else if (eosTypeString=="IF97"){//the IAPWS95 parameters are loaded, for the EOS kernel and the states out of IF97
+        subsData->model=FF_SWtype;
+        subsData->swData.id=subsCalcEOSModel->record(position).value("Id").toInt();
+        ui->leSubsCalcSW->setText(QString::fromStdString(eosInfo));
+        ui->chbSubsCalcSW->setChecked(true);
+        subsIF97=1;
+    }
     GetEOSData(&subsData->model,subsData,&db);
+    SatCacheInvalidate(subsData->id);//the EOS data could have been changed by a fit, keeping the ids
     //std::cout<<"Cubic eos:"<<subs->cubicData.id<<" Saft eos:"<<subs->saftData.id<<" SW eos:"<<subs->swData.id<<std::endl;
     //printf("Cubic k1:%f\n",subsData->cubicData.k1);
     //printf("SW n[0] :%f\n",subsData->swData.n[0]);
@@ -670,8 +775,24 @@ void FreeFluidsMainWindow::cbSubsCalcCp0Update(int position){
 //Slot for substance calculation, and display in table
 void FreeFluidsMainWindow::twSubsCalcUpdate()
 {
+    perfStart("Substance calculation");
+    TraceScope trace("Substance calculation","GUI");
+    trace.arg("id",subsData->id);
     int i,j;//the loop variables
     for (i=0;i<ui->twSubsCalc->rowCount();i++) for (j=0;j<ui->twSubsCalc->columnCount();j++) ui->twSubsCalc->item(i,j)->setText("");//we clear the content
+    for (i=0;i<57;i++) for (j=0;j<11;j++) subsCalcValues[i][j]=NAN;
+
+    //Evaluation plan for the visible rows. Without saturated properties checked, their rows are not requested
+    SubsCalcMask requested=0;
+    SubsCalcPlan plan;
+    for (i=0;i<SUBS_CALC_ROWS;i++) if (!ui->twSubsCalc->isRowHidden(i)) requested|=SUBS_CALC_ROW(i);
+    if (!ui->chbSubsCalcSatProp->isChecked()) requested&=~SUBS_CALC_SAT;
+    //the rows of missing correlations would only add their dependencies, as the vapor pressure for the liquid viscosity
+    if (subsData->lDensCorr.form<=0) requested&=~SUBS_CALC_ROW(41);
+    if (subsData->lViscCorr.form<=0) requested&=~SUBS_CALC_ROW(44);
+    requested&=~SUBS_CALC_ROW(43);//Tait density is not calculated yet
+    SubsCalcPlanBuild(requested,&plan);
+    subsCalcRows=plan.rows;
 
     //if (!((subsId>0)&&(eosId>0))) return;//Without substance or eos calculation is impossible
     //std::cout<<subsId<<" "<<eosId<<" "<<cp0Id<<" "<<eosModel.toStdString()<<std::endl;
@@ -690,14 +811,18 @@ void FreeFluidsMainWindow::twSubsCalcUpdate()
     double phiL,phiG;
     QString phase;
     double Z;
-    double Vp,Tminus,VpMinus,dVp_dT;
+    double Vp,dVp_dT;
+    SatProps sat;//saturated properties from the saturation table
+    int satCached;
     double Hv;//vaporization enthalpy
     double lCpSat;//cp of saturated liquid
     double lCsigma;//specific heat capacity of liquid along saturation line
     double lHsat,gHsat,lSsat,gSsat;//saturated enthalpies and entropies
     double ArrLsat, ZLsat;//Saturated liquid reduced residual Helmholtz
     double ArrDerivatives[6];
-    FF_CubicParam param;
+    FF_ThermoProperties thIF,thSatL,thSatG;//IAPWS-IF97 state and saturated phases
+    double lnPhiIF;
+    int region;//IAPWS-IF97 region of the state. 0 if not evaluated by IF97
 
     //Now we add some phys.prop. predictions and pressure corrections
     int nPoints=1;
@@ -708,7 +833,10 @@ void FreeFluidsMainWindow::twSubsCalcUpdate()
     if(subsData->model==FF_SAFTtype) MW=subsData->saftData.MW;
     else if(subsData->model==FF_SWtype) MW=subsData->swData.MW;
     else MW=subsData->cubicData.MW;
-    FF_TbEOSs(&thR.P,subsData,&Tb);//boiling point calculation
+    if(SatCacheTsat(subsData,thR.P,&Tb)==0) FF_PERF("FF_TbEOSs",FF_TbEOSs(&thR.P,subsData,&Tb));//boiling point, from the saturation table if possible
+    //the EOS model is resolved here once, not in every point. Without a model the Helmholtz rows are left empty
+    int kernelOk=(EosKernelBuild(subsData,&subsEosKernel)==1)&&(subsEosKernel.variant!=EOS_KER_NONE);
+    ui->statusBar->showMessage(QString("EOS kernel: ")+EosKernelVariantName(&subsEosKernel));
     th0.MW=thR.MW=MW;
     ui->leSubsCalcMW->setText(QString::number(MW));
     ui->leSubsCalcTb->setText(QString::number(Tb-273.15));
@@ -716,175 +844,244 @@ void FreeFluidsMainWindow::twSubsCalcUpdate()
         th0.T=thVp.T=thR.T=initT+i*Tincrement;
         thR.P=1e5*ui->leSubsCalcPres->text().toDouble();//we read the selected pressure. Necessary to do each time, because it is changed
 
-        FF_VfromTPeosS(&thR.T,&thR.P,subsData,&option,answerL,answerG,&state);//Volume, Arr, Z and fugacity coeff. retrieval
-        phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
-        phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
-        if (state=='f') phase="Calc.fail";
-        else if ((state=='U')||(state=='l')||(state=='g')) phase="Unique";
-        else if (state=='L') phase="Liquid";
-        else if (state=='G') phase="Gas";
-        else if (state=='E') phase="Equilibrium";
-        if ((state=='l')||(state=='L')||(state=='U')||(state=='E')){
-            thR.V=answerL[0];
-            Z=answerL[2];
-        }
-        else if ((state=='g')||(state=='G')){
-            thR.V=answerG[0];
-            Z=answerG[2];
+        region=0;
+        if(subsIF97==1) region=FF_PERF("IF97ThermoTP",IF97ThermoTP(thR.T,thR.P,&thIF,&lnPhiIF));//direct evaluation in regions 1 and 2
+        if(region>0){//only the fugacity of the phase existing in the region is known
+            if(thR.T>=647.096) state='U';
+            else state=(region==1) ? 'L' : 'G';
+            phase=(state=='U') ? "Unique" : ((state=='L') ? "Liquid" : "Gas");
+            phiL=(state=='G') ? NAN : exp(lnPhiIF);
+            phiG=(state=='L') ? NAN : exp(lnPhiIF);
+            thR.V=thIF.V;
+            Z=thR.P*thR.V/(R*thR.T);
+        }
+        else{
+            FF_PERF("FF_VfromTPeosS",FF_VfromTPeosS(&thR.T,&thR.P,subsData,&option,answerL,answerG,&state));//Volume, Arr, Z and fugacity coeff. retrieval
+            phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
+            phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+            if (state=='f') phase="Calc.fail";
+            else if ((state=='U')||(state=='l')||(state=='g')) phase="Unique";
+            else if (state=='L') phase="Liquid";
+            else if (state=='G') phase="Gas";
+            else if (state=='E') phase="Equilibrium";
+            if ((state=='l')||(state=='L')||(state=='U')||(state=='E')){
+                thR.V=answerL[0];
+                Z=answerL[2];
+            }
+            else if ((state=='g')||(state=='G')){
+                thR.V=answerG[0];
+                Z=answerG[2];
+            }
         }
         //printf("state:%c\n",state);
         th0.V=thR.V;
-        if (subsData->swData.eos==FF_IAPWS95) FF_IdealThermoWater(&th0);
-        else FF_IdealThermoEOS(&subsData->cp0Corr.form,subsData->cp0Corr.coef,&subsData->refT,&subsData->refP,&th0);
-        FF_ThermoEOSs(subsData,&thR);
-        if (ui->chbSubsCalcSatProp->isChecked()){
-            FF_VpEOSs(&thR.T,subsData,&Vp);//Vapor pressure calculation
-            Tminus=thR.T-0.01;
-            FF_VpEOSs(&Tminus,subsData,&VpMinus);
-            dVp_dT=(Vp-VpMinus)/(thR.T-Tminus);
+        if (plan.ideal){
+            if (subsData->swData.eos==FF_IAPWS95) FF_PERF("FF_IdealThermoWater",FF_IdealThermoWater(&th0));
+            else FF_PERF("FF_IdealThermoEOS",FF_IdealThermoEOS(&subsData->cp0Corr.form,subsData->cp0Corr.coef,&subsData->refT,&subsData->refP,&th0));
+        }
+        if(region>0) thR=thIF;
+        else if(plan.thermo) FF_PERF("FF_ThermoEOSs",FF_ThermoEOSs(subsData,&thR));
+        satCached=0;//1 if the saturation comes from the table, 2 if from IAPWS-IF97
+        if (plan.vp){
+            if((subsIF97==1)&&(FF_PERF("IF97SatT",IF97SatT(thR.T,&Vp,&thSatL,&thSatG))==1)){
+                satCached=2;
+                dVp_dT=(thSatG.H-thSatL.H)/(thR.T*(thSatG.V-thSatL.V));//Clapeyron equation
+            }
+            else if(SatCacheProps(subsData,thR.T,&sat)==1){
+                satCached=1;
+                Vp=sat.P;
+                dVp_dT=sat.dP_dT;
+            }
+            else{//outside the table
+                FF_PERF("FF_VpEOSs",FF_VpEOSs(&thR.T,subsData,&Vp));//Vapor pressure calculation
+                dVp_dT=0;//from Clapeyron equation, once the saturated phases are known
+            }
         }
         else{
             Vp=0;
             dVp_dT=0;
         }
-        if(subsData->model==FF_SAFTtype) FF_ArrDerSAFT(&thR.T,&thR.V,&subsData->saftData,ArrDerivatives);
-        else if(subsData->model==FF_SWtype) FF_ArrDerSWTV(&thR.T,&thR.V,&subsData->swData,ArrDerivatives);
-        else{
-            FF_FixedParamCubic(&subsData->cubicData,&param);
-            FF_ThetaDerivCubic(&thR.T,&subsData->cubicData,&param);
-            FF_ArrDerCubic(&thR.T,&thR.V,&param,ArrDerivatives);
+        if(plan.arr&&kernelOk) subsEosKernel.arrDer(&subsEosKernel,thR.T,thR.V,ArrDerivatives);
+
+        if(satCached==1){
+            answerLVp[0]=sat.VL;
+            answerGVp[0]=sat.VG;
+            gHsat=sat.HG+th0.H;
+            gSsat=sat.SG+th0.S-R*log(Vp/ thR.P);
+            lHsat=sat.HL+th0.H;
+            lSsat=sat.SL+th0.S-R*log(Vp/ thR.P);
+            Hv=sat.HG-sat.HL;
+            lCpSat=sat.CpL+th0.Cp;
+            ArrLsat=sat.ArrL;
+            ZLsat=sat.ZL;
+            thVp.dP_dT=sat.dP_dTL;
+            thVp.dP_dV=sat.dP_dVL;
         }
+        else if(satCached==2){//IF97 gives the complete properties of the saturated phases
+            double ArrSat[6];
+            answerLVp[0]=thSatL.V;
+            answerGVp[0]=thSatG.V;
+            lHsat=thSatL.H;
+            gHsat=thSatG.H;
+            lSsat=thSatL.S;
+            gSsat=thSatG.S;
+            Hv=gHsat-lHsat;
+            lCpSat=thSatL.Cp;
+            if(kernelOk){
+                subsEosKernel.arrDer(&subsEosKernel,thR.T,thSatL.V,ArrSat);
+                ArrLsat=ArrSat[0];
+            }
+            else ArrLsat=NAN;
+            ZLsat=Vp*thSatL.V/(R*thR.T);
+            thVp.dP_dT=thSatL.dP_dT;
+            thVp.dP_dV=thSatL.dP_dV;
+        }
+        else if ((Vp>0) && (Vp<1e10) && plan.satPhases){//If Vp has been calculated as is lower than Pc, and the saturated phases are requested
 
-        if ((Vp>0) && (Vp<1e10)){//If Vp has been calculated as is lower than Pc
-
-            FF_VfromTPeosS(&thR.T,&Vp,subsData,&option,answerLVp,answerGVp,&state);//We calculate liquid and gas volumes at Vp
+            FF_PERF("FF_VfromTPeosS",FF_VfromTPeosS(&thR.T,&Vp,subsData,&option,answerLVp,answerGVp,&state));//We calculate liquid and gas volumes at Vp
             thVp.T=thR.T;
             thVp.V=answerGVp[0];
-            FF_ExtResidualThermoEOSs(subsData,&thVp);//with the gas volume we calculate the residual thermo properties
+            FF_PERF("FF_ExtResidualThermoEOSs",FF_ExtResidualThermoEOSs(subsData,&thVp));//with the gas volume we calculate the residual thermo properties
             gHsat=thVp.H+th0.H;
             gSsat=thVp.S+th0.S-R*log(Vp/ thR.P);
             Hv=thVp.H;
 
             thVp.V=answerLVp[0];
-            FF_ExtResidualThermoEOSs(subsData,&thVp);//with the liquid volume we calculate the residual thermo properties
+            FF_PERF("FF_ExtResidualThermoEOSs",FF_ExtResidualThermoEOSs(subsData,&thVp));//with the liquid volume we calculate the residual thermo properties
             lHsat=thVp.H+th0.H;
             lSsat=thVp.S+th0.S-R*log(Vp/ thR.P);
             Hv=Hv-thVp.H;//vaporization enthalpy is the difference
+            dVp_dT=Hv/(thR.T*(answerGVp[0]-answerLVp[0]));//Clapeyron equation, exact at the solved saturation
             lCpSat=thVp.Cp+th0.Cp;
             ArrLsat=thVp.A/(R*thVp.T);
             ZLsat=thVp.P*thVp.V/(R*thVp.T);
         }
 
         //here we write the results to the table
-        ui->twSubsCalc->item(0,i)->setText(QString::number(thR.T-273.15));
+        subsCalcSetValue(0,i,thR.T-273.15);
         ui->twSubsCalc->item(1,i)->setText(phase);
-        ui->twSubsCalc->item(2,i)->setText(QString::number(phiL));
-        ui->twSubsCalc->item(3,i)->setText(QString::number(phiG));
-        ui->twSubsCalc->item(4,i)->setText(QString::number(Z));//Z
-        ui->twSubsCalc->item(5,i)->setText(QString::number(thR.V*1e6));//Molar volume cm3/mol
-        ui->twSubsCalc->item(6,i)->setText(QString::number(MW/thR.V/1000));//rho kgr/m3
-        ui->twSubsCalc->item(7,i)->setText(QString::number(th0.H/MW));//H0 KJ/kgr
-        ui->twSubsCalc->item(8,i)->setText(QString::number(th0.S/MW));
-        ui->twSubsCalc->item(9,i)->setText(QString::number(th0.Cp/MW));//Cp0 KJ/kgr·K
-        ui->twSubsCalc->item(10,i)->setText(QString::number(thR.H/MW));
-        ui->twSubsCalc->item(11,i)->setText(QString::number(thR.U/MW));
-        ui->twSubsCalc->item(12,i)->setText(QString::number(thR.S/MW));
-        ui->twSubsCalc->item(13,i)->setText(QString::number(thR.Cp/MW));
-        ui->twSubsCalc->item(14,i)->setText(QString::number(thR.Cv/MW));
-        ui->twSubsCalc->item(15,i)->setText(QString::number(thR.SS));
-        ui->twSubsCalc->item(16,i)->setText(QString::number(thR.JT*1e5));
-        ui->twSubsCalc->item(17,i)->setText(QString::number(thR.IT*1e2));
-        ui->twSubsCalc->item(18,i)->setText(QString::number(thR.dP_dT*1e-5));
-        ui->twSubsCalc->item(19,i)->setText(QString::number(thR.dP_dV*1e-5*subsData->baseProp.MW/1000));
-        ui->twSubsCalc->item(20,i)->setText(QString::number(-thR.dP_dT/thR.dP_dV*1000/subsData->baseProp.MW));//(dV/dT)P
-        ui->twSubsCalc->item(21,i)->setText(QString::number(-thR.dP_dT/(thR.dP_dV*thR.V)));
-        ui->twSubsCalc->item(22,i)->setText(QString::number(-1/(thR.dP_dV*thR.V)));//Isothermal compressibility
-        ui->twSubsCalc->item(23,i)->setText(QString::number(log(-(thR.V*thR.dP_dV*thR.V)/(8.3144*thR.T))));//Ln of reduced bulk modulus
-        if (Vp>0){
-            ui->twSubsCalc->item(24,i)->setText(QString::number(Vp/100000));//Vapor pressure bar
-            ui->twSubsCalc->item(25,i)->setText(QString::number(MW/answerLVp[0]/1000));//liquid rho at Vp kgr/m3
-            ui->twSubsCalc->item(26,i)->setText(QString::number(MW/answerGVp[0]/1000));//gas rho at Vp kgr/m3
-            ui->twSubsCalc->item(27,i)->setText(QString::number(lHsat/MW));//sat.liquid enthalpy (KJ/kg)
-            ui->twSubsCalc->item(28,i)->setText(QString::number(gHsat/MW));//sat.gas enthalpy (KJ/kg)
-            ui->twSubsCalc->item(29,i)->setText(QString::number(lSsat/MW));//sat.liquid entropy (KJ/kg·K)
-            ui->twSubsCalc->item(30,i)->setText(QString::number(gSsat/MW));//sat.gas entropy (KJ/kg·K)
-            ui->twSubsCalc->item(31,i)->setText(QString::number(Hv/MW));//Saturated vaporization enthalpy
-            ui->twSubsCalc->item(32,i)->setText(QString::number(lCpSat/MW));//Saturated liquid heat capacity
-            ui->twSubsCalc->item(33,i)->setText(QString::number(ArrLsat));//Saturated liquid reduced residual Helmholtz
-            ui->twSubsCalc->item(34,i)->setText(QString::number((lCpSat+dVp_dT*(answerLVp[0]+thR.T*thVp.dP_dT/thVp.dP_dV))/MW));//liquid heat capacity along saturationline
-        }
-        ui->twSubsCalc->item(35,i)->setText(QString::number(ArrDerivatives[0]));
-        ui->twSubsCalc->item(36,i)->setText(QString::number(ArrDerivatives[1]));
-        ui->twSubsCalc->item(37,i)->setText(QString::number(ArrDerivatives[2]));
-        ui->twSubsCalc->item(38,i)->setText(QString::number(ArrDerivatives[3]));
-        ui->twSubsCalc->item(39,i)->setText(QString::number(ArrDerivatives[4]));
-        ui->twSubsCalc->item(40,i)->setText(QString::number(ArrDerivatives[5]));
+        subsCalcValues[1][i]=state;//the phase is kept as the character code of the state
+        subsCalcSetValue(2,i,phiL);
+        subsCalcSetValue(3,i,phiG);
+        subsCalcSetValue(4,i,Z);//Z
+        subsCalcSetValue(5,i,thR.V*1e6);//Molar volume cm3/mol
+        subsCalcSetValue(6,i,MW/thR.V/1000);//rho kgr/m3
+        subsCalcSetValue(7,i,th0.H/MW);//H0 KJ/kgr
+        subsCalcSetValue(8,i,th0.S/MW);
+        subsCalcSetValue(9,i,th0.Cp/MW);//Cp0 KJ/kgr·K
+        subsCalcSetValue(10,i,thR.H/MW);
+        subsCalcSetValue(11,i,thR.U/MW);
+        subsCalcSetValue(12,i,thR.S/MW);
+        subsCalcSetValue(13,i,thR.Cp/MW);
+        subsCalcSetValue(14,i,thR.Cv/MW);
+        subsCalcSetValue(15,i,thR.SS);
+        subsCalcSetValue(16,i,thR.JT*1e5);
+        subsCalcSetValue(17,i,thR.IT*1e2);
+        subsCalcSetValue(18,i,thR.dP_dT*1e-5);
+        subsCalcSetValue(19,i,thR.dP_dV*1e-5*subsData->baseProp.MW/1000);
+        subsCalcSetValue(20,i,-thR.dP_dT/thR.dP_dV*1000/subsData->baseProp.MW);//(dV/dT)P
+        subsCalcSetValue(21,i,-thR.dP_dT/(thR.dP_dV*thR.V));
+        subsCalcSetValue(22,i,-1/(thR.dP_dV*thR.V));//Isothermal compressibility
+        subsCalcSetValue(23,i,log(-(thR.V*thR.dP_dV*thR.V)/(8.3144*thR.T)));//Ln of reduced bulk modulus
+        if (Vp>0) subsCalcSetValue(24,i,Vp/100000);//Vapor pressure bar
+        if ((Vp>0)&&plan.satPhases){
+            subsCalcSetValue(25,i,MW/answerLVp[0]/1000);//liquid rho at Vp kgr/m3
+            subsCalcSetValue(26,i,MW/answerGVp[0]/1000);//gas rho at Vp kgr/m3
+            subsCalcSetValue(27,i,lHsat/MW);//sat.liquid enthalpy (KJ/kg)
+            subsCalcSetValue(28,i,gHsat/MW);//sat.gas enthalpy (KJ/kg)
+            subsCalcSetValue(29,i,lSsat/MW);//sat.liquid entropy (KJ/kg·K)
+            subsCalcSetValue(30,i,gSsat/MW);//sat.gas entropy (KJ/kg·K)
+            subsCalcSetValue(31,i,Hv/MW);//Saturated vaporization enthalpy
+            subsCalcSetValue(32,i,lCpSat/MW);//Saturated liquid heat capacity
+            subsCalcSetValue(33,i,ArrLsat);//Saturated liquid reduced residual Helmholtz
+            subsCalcSetValue(34,i,(lCpSat+dVp_dT*(answerLVp[0]+thR.T*thVp.dP_dT/thVp.dP_dV))/MW);//liquid heat capacity along saturationline
+        }
+        if(kernelOk){
+            subsCalcSetValue(35,i,ArrDerivatives[0]);
+            subsCalcSetValue(36,i,ArrDerivatives[1]);
+            subsCalcSetValue(37,i,ArrDerivatives[2]);
+            subsCalcSetValue(38,i,ArrDerivatives[3]);
+            subsCalcSetValue(39,i,ArrDerivatives[4]);
+            subsCalcSetValue(40,i,ArrDerivatives[5]);
+        }
 
         //Correlations data
-        if(subsData->lDensCorr.form>0){
-            FF_PhysPropCorr(&subsData->lDensCorr.form,subsData->lDensCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lplDens);
-            if(thR.P>Vp) FF_LiqDensChuehPrausnitz(&subsData->baseProp,&thR.T,&thR.P,&Vp,&lplDens,&lDens);
+        if(plan.liqDens){
+            if(subsData->lDensCorr.form>0){
+                FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lDensCorr.form,subsData->lDensCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lplDens));
+                if(thR.P>Vp) FF_PERF("FF_LiqDensChuehPrausnitz",FF_LiqDensChuehPrausnitz(&subsData->baseProp,&thR.T,&thR.P,&Vp,&lplDens,&lDens));
+                else lDens=lplDens;
+                subsCalcSetValue(41,i,lDens);
+            }
+            FF_PERF("FF_LiqDensSatRackett",FF_LiqDensSatRackett(&subsData->baseProp,&subsData->lDens.x,&subsData->lDens.y,&thR.T,&lplDens));
+            if(thR.P>Vp) FF_PERF("FF_LiqDensChuehPrausnitz",FF_LiqDensChuehPrausnitz(&subsData->baseProp,&thR.T,&thR.P,&Vp,&lplDens,&lDens));
             else lDens=lplDens;
-            ui->twSubsCalc->item(41,i)->setText(QString::number(lDens));
+            subsCalcSetValue(42,i,lDens);
+            //Tait density calculation is missing here
         }
-        FF_LiqDensSatRackett(&subsData->baseProp,&subsData->lDens.x,&subsData->lDens.y,&thR.T,&lplDens);
-        if(thR.P>Vp) FF_LiqDensChuehPrausnitz(&subsData->baseProp,&thR.T,&thR.P,&Vp,&lplDens,&lDens);
-        else lDens=lplDens;
-        ui->twSubsCalc->item(42,i)->setText(QString::number(lDens));
-        //Tait density calculation is missing here
-        if(subsData->lViscCorr.form>0){
-            FF_PhysPropCorr(&subsData->lViscCorr.form,subsData->lViscCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lplVisc);
-            FF_LiqViscPcorLucas(&thR.T,&thR.P,&Vp,&subsData->baseProp,&lplVisc,&lVisc);
-            ui->twSubsCalc->item(44,i)->setText(QString::number(lVisc));
+        if(plan.liqVisc&&(subsData->lViscCorr.form>0)){
+            FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lViscCorr.form,subsData->lViscCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lplVisc));
+            FF_PERF("FF_LiqViscPcorLucas",FF_LiqViscPcorLucas(&thR.T,&thR.P,&Vp,&subsData->baseProp,&lplVisc,&lVisc));
+            subsCalcSetValue(44,i,lVisc);
         }
 
-        if(subsData->lThCCorr.form>0){
-            FF_PhysPropCorr(&subsData->lThCCorr.form,subsData->lThCCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lThCond);
-            ui->twSubsCalc->item(45,i)->setText(QString::number(lThCond));
+        if(plan.liqThC){
+            if(subsData->lThCCorr.form>0){
+                FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lThCCorr.form,subsData->lThCCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lThCond));
+                subsCalcSetValue(45,i,lThCond);
+            }
+            FF_PERF("FF_LiquidThCondLatini",FF_LiquidThCondLatini(&thR.T,&subsData->baseProp,&lThCond));
+            subsCalcSetValue(46,i,lThCond);
         }
-        FF_LiquidThCondLatini(&thR.T,&subsData->baseProp,&lThCond);
-        ui->twSubsCalc->item(46,i)->setText(QString::number(lThCond));
 
-        if(subsData->lSurfTCorr.form>0){
-            FF_PhysPropCorr(&subsData->lSurfTCorr.form,subsData->lSurfTCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&surfTens);
-            ui->twSubsCalc->item(47,i)->setText(QString::number(surfTens));
+        if(plan.surfTens){
+            if(subsData->lSurfTCorr.form>0){
+                FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lSurfTCorr.form,subsData->lSurfTCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&surfTens));
+                subsCalcSetValue(47,i,surfTens);
+            }
+            FF_PERF("FF_SurfTensSastri",FF_SurfTensSastri(&thR.T,&subsData->baseProp,&surfTens));
+            subsCalcSetValue(48,i,surfTens);
+            FF_PERF("FF_SurfTensMcLeod",FF_SurfTensMcLeod(&thR.T,subsData,&surfTens));
+            subsCalcSetValue(49,i,surfTens);
         }
-        FF_SurfTensSastri(&thR.T,&subsData->baseProp,&surfTens);
-        ui->twSubsCalc->item(48,i)->setText(QString::number(surfTens));
-        FF_SurfTensMcLeod(&thR.T,subsData,&surfTens);
-        ui->twSubsCalc->item(49,i)->setText(QString::number(surfTens));
 
 
-        if(subsData->gViscCorr.form>0){
-            FF_PhysPropCorr(&subsData->gViscCorr.form,subsData->gViscCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lpgVisc);
-            FF_GasViscTPcpLucas(&thR.T,&thR.P,&subsData->baseProp,&lpgVisc,&gVisc);
-            //FF_GasViscTVcpChung(&thR.T,&thR.V,&subsData->baseProp,&lpgVisc,&gVisc);
-            ui->twSubsCalc->item(50,i)->setText(QString::number(gVisc));
-        }
+        if(plan.gasVisc){
+            if(subsData->gViscCorr.form>0){
+                FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->gViscCorr.form,subsData->gViscCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lpgVisc));
+                FF_PERF("FF_GasViscTPcpLucas",FF_GasViscTPcpLucas(&thR.T,&thR.P,&subsData->baseProp,&lpgVisc,&gVisc));
+                //FF_GasViscTVcpChung(&thR.T,&thR.V,&subsData->baseProp,&lpgVisc,&gVisc);
+                subsCalcSetValue(50,i,gVisc);
+            }
 
-        lpgVisc=0;
-        ldgVisc=0;
-        //FF_GasViscTVcpChung(&thR.T,&thR.V,&subsData->baseProp,&ldgVisc,&gVisc);
-        FF_GasViscTPcpLucas(&thR.T,&thR.P,&subsData->baseProp,&lpgVisc,&gVisc);
-        ui->twSubsCalc->item(51,i)->setText(QString::number(gVisc));
+            lpgVisc=0;
+            ldgVisc=0;
+            //FF_GasViscTVcpChung(&thR.T,&thR.V,&subsData->baseProp,&ldgVisc,&gVisc);
+            FF_PERF("FF_GasViscTPcpLucas",FF_GasViscTPcpLucas(&thR.T,&thR.P,&subsData->baseProp,&lpgVisc,&gVisc));
+            subsCalcSetValue(51,i,gVisc);
+        }
 
-        if(subsData->gThCCorr.form>0){
-            FF_PhysPropCorr(&subsData->gThCCorr.form,subsData->gThCCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&ldgThC);
-            FF_GasThCondTVcorChung(&thR.T,&thR.V,&subsData->baseProp,&ldgThC,&gThC);
-            ui->twSubsCalc->item(52,i)->setText(QString::number(gThC));
+        if(plan.gasThC){
+            if(subsData->gThCCorr.form>0){
+                FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->gThCCorr.form,subsData->gThCCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&ldgThC));
+                FF_PERF("FF_GasThCondTVcorChung",FF_GasThCondTVcorChung(&thR.T,&thR.V,&subsData->baseProp,&ldgThC,&gThC));
+                subsCalcSetValue(52,i,gThC);
+            }
+            double CpSI=th0.Cp*1000/MW;
+            FF_PERF("FF_GasLpThCondTCpChung",FF_GasLpThCondTCpChung(&thR.T,&CpSI,&subsData->baseProp,&ldgThC));
+            FF_PERF("FF_GasThCondTVcorChung",FF_GasThCondTVcorChung(&thR.T,&thR.V,&subsData->baseProp,&ldgThC,&gThC));
+            subsCalcSetValue(53,i,gThC);
         }
-        double CpSI=th0.Cp*1000/MW;
-        FF_GasLpThCondTCpChung(&thR.T,&CpSI,&subsData->baseProp,&ldgThC);
-        FF_GasThCondTVcorChung(&thR.T,&thR.V,&subsData->baseProp,&ldgThC,&gThC);
-        ui->twSubsCalc->item(53,i)->setText(QString::number(gThC));
 
-        if(subsData->lCpCorr.form>0){
-            FF_PhysPropCorr(&subsData->lCpCorr.form,subsData->lCpCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lCp);
-            ui->twSubsCalc->item(54,i)->setText(QString::number(lCp));
+        if(plan.liqCp){
+            if(subsData->lCpCorr.form>0){
+                FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lCpCorr.form,subsData->lCpCorr.coef,&subsData->baseProp.MW,&nPoints,&thR.T,&lCp));
+                subsCalcSetValue(54,i,lCp);
+            }
+            FF_PERF("FF_LiqCpBondi",FF_LiqCpBondi(subsData,&thR.T,&lCp));
+            subsCalcSetValue(55,i,lCp);
         }
-        FF_LiqCpBondi(subsData,&thR.T,&lCp);
-        ui->twSubsCalc->item(55,i)->setText(QString::number(lCp));
-        ui->twSubsCalc->item(56,i)->setText(QString::number(thR.T));
+        subsCalcSetValue(56,i,thR.T);
     }
 
 
@@ -898,15 +1095,20 @@ void FreeFluidsMainWindow::twSubsCalcUpdate()
 
 //Slot for alternative calculation (not from T and P)
 void FreeFluidsMainWindow::btnSubsCalcAltCalc(){
+    perfStart("Substance alternative calculation");
 
 
     //And now we make calculations
     FF_ThermoProperties thR;//here will be stored the result of the calculations
+    FF_ThermoProperties thF;//result of the inverse flash, kept apart as thR holds the known variables for FreeFluidsC
     double refT=298.15;//reference temperature for thermodynamic properties (as ideal gas)
     double refP=1.01325e5;//reference pressure
     double MW;
     double liqFraction;
     char var;
+    enum PureFlashSpec spec=PURE_FLASH_PH;
+    double x=0,y=0;
+    int solved=0;
 
     //First we need to get the eos data
     if (subsData->model==FF_SAFTtype) MW=subsData->saftData.MW;
@@ -921,16 +1123,25 @@ void FreeFluidsMainWindow::btnSubsCalcAltCalc(){
         var='H';
         thR.P=ui->leSubsCalcP->text().toDouble()*1e5;
         thR.H=MW*ui->leSubsCalcH->text().toDouble();
+        spec=PURE_FLASH_PH;
+        x=thR.P;
+        y=thR.H;
         break;
     case 1://P,U
         var='U';
         thR.P=ui->leSubsCalcP->text().toDouble()*1e5;
         thR.U=MW*ui->leSubsCalcU->text().toDouble();
+        spec=PURE_FLASH_PU;
+        x=thR.P;
+        y=thR.U;
         break;
     case 2://P,S
         var='S';
         thR.P=ui->leSubsCalcP->text().toDouble()*1e5;
         thR.S=MW*ui->leSubsCalcS->text().toDouble();
+        spec=PURE_FLASH_PS;
+        x=thR.P;
+        y=thR.S;
         break;
     case 3://Rho,T
         var='T';
@@ -941,23 +1152,39 @@ void FreeFluidsMainWindow::btnSubsCalcAltCalc(){
         var='H';
         thR.V=MW/ui->leSubsCalcRho->text().toDouble()*1e-3;
         thR.H=MW*ui->leSubsCalcH->text().toDouble();
+        spec=PURE_FLASH_DH;
+        x=thR.V;
+        y=thR.H;
         break;
     }
 
+    //With IAPWS-IF97 selected, P,H and P,S are solved directly by the backward equations. Otherwise, or out of the IF97
+    //regions, the inverse flash over the EOS kernel is tried. Rho,T is direct in FreeFluidsC, and the states not solved
+    //by the flash are left to it
+    if((subsIF97==1)&&((ui->cbSubsCalcKnownVars->currentIndex()==0)||(ui->cbSubsCalcKnownVars->currentIndex()==2))){
+        if(var=='H') solved=(FF_PERF("IF97ThermoPH",IF97ThermoPH(x,y,&thF,&liqFraction))>0) ? 1 : 0;
+        else solved=(FF_PERF("IF97ThermoPS",IF97ThermoPS(x,y,&thF,&liqFraction))>0) ? 1 : 0;
+        if(solved==1) thR=thF;
+    }
+    if((solved==0)&&(ui->cbSubsCalcKnownVars->currentIndex()!=3)&&(FF_PERF("PureFlashInit",PureFlashInit(subsData,refT,refP,subsFlash))==1)){
+        solved=FF_PERF("PureFlash",PureFlash(subsFlash,spec,x,y,&thF,&liqFraction));
+        if(solved==1) thR=thF;
+    }
+
     //Now we make calculations
-    switch (ui->cbSubsCalcKnownVars->currentIndex()){
+    if(solved==0) switch (ui->cbSubsCalcKnownVars->currentIndex()){
     case 0://P,H
     case 1://P,U
     case 2://P,S
-        if (subsData->model==FF_SAFTtype) FF_ThermoEOSfromPX(&subsData->model,&subsData->saftData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction);
-        else if (subsData->model==FF_SWtype) FF_ThermoEOSfromPX(&subsData->model,&subsData->swData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction);
-        else FF_ThermoEOSfromPX(&subsData->model,&subsData->cubicData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction);
+        if (subsData->model==FF_SAFTtype) FF_PERF("FF_ThermoEOSfromPX",FF_ThermoEOSfromPX(&subsData->model,&subsData->saftData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction));
+        else if (subsData->model==FF_SWtype) FF_PERF("FF_ThermoEOSfromPX",FF_ThermoEOSfromPX(&subsData->model,&subsData->swData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction));
+        else FF_PERF("FF_ThermoEOSfromPX",FF_ThermoEOSfromPX(&subsData->model,&subsData->cubicData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction));
         break;
     case 3:
     case 4:
-        if (subsData->model==FF_SAFTtype) FF_ThermoEOSfromVX(&subsData->model,&subsData->saftData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction);
-        else if (subsData->model==FF_SWtype) FF_ThermoEOSfromVX(&subsData->model,&subsData->swData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction);
-        else FF_ThermoEOSfromVX(&subsData->model,&subsData->cubicData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction);
+        if (subsData->model==FF_SAFTtype) FF_PERF("FF_ThermoEOSfromVX",FF_ThermoEOSfromVX(&subsData->model,&subsData->saftData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction));
+        else if (subsData->model==FF_SWtype) FF_PERF("FF_ThermoEOSfromVX",FF_ThermoEOSfromVX(&subsData->model,&subsData->swData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction));
+        else FF_PERF("FF_ThermoEOSfromVX",FF_ThermoEOSfromVX(&subsData->model,&subsData->cubicData,&subsData->cp0Corr.form,subsData->cp0Corr.coef,&refT,&refP,&var,&thR,&liqFraction));
         break;
     }
 
@@ -971,16 +1198,69 @@ void FreeFluidsMainWindow::btnSubsCalcAltCalc(){
     ui->leSubsCalcLiqFrac->setText(QString::number(liqFraction));
 }
 
-//Slot for table content exportation in csv ; delimited format
+//Writes a result of the substance calculation to the table and keeps its value, for the columnar export.
+//The rows out of the plan of the calculation are left empty, as their values have not been calculated
+void FreeFluidsMainWindow::subsCalcSetValue(int row,int point,double value){
+    if ((subsCalcRows&SUBS_CALC_ROW(row))==0) return;
+    ui->twSubsCalc->item(row,point)->setText(QString::number(value));
+    subsCalcValues[row][point]=value;
+}
+
+//Writes the results of the last substance calculation in columnar binary format, one column per property and one row per point
+int FreeFluidsMainWindow::twSubsCalcExportColumnar(const QString &fileName,bool compress){
+    static const char *colNames[57][2]={{"T","C"},{"state","char code"},{"phiL",""},{"phiG",""},{"Z",""},{"V","cm3/mol"},{"rho","kg/m3"},
+        {"H0","kJ/kg"},{"S0","kJ/(kg*K)"},{"Cp0","kJ/(kg*K)"},{"H","kJ/kg"},{"U","kJ/kg"},{"S","kJ/(kg*K)"},{"Cp","kJ/(kg*K)"},{"Cv","kJ/(kg*K)"},
+        {"SS","m/s"},{"JT","K/bar"},{"IT","kJ/bar"},{"dP_dT","bar/K"},{"dP_dV","kg*bar/m3"},{"dV_dT","m3/(kg*K)"},{"beta","1/K"},
+        {"kappaT","1/Pa"},{"lnBr",""},{"Psat","bar"},{"rhoLsat","kg/m3"},{"rhoGsat","kg/m3"},{"HLsat","kJ/kg"},{"HGsat","kJ/kg"},
+        {"SLsat","kJ/(kg*K)"},{"SGsat","kJ/(kg*K)"},{"Hv","kJ/kg"},{"CpLsat","kJ/(kg*K)"},{"ArrLsat",""},{"CsigmaL","kJ/(kg*K)"},
+        {"Arr",""},{"dArr_dV","mol/m3"},{"d2Arr_dV2","(mol/m3)^2"},{"dArr_dT","1/K"},{"d2Arr_dT2","1/K2"},{"d2Arr_dTdV","mol/(m3*K)"},
+        {"rhoLcorr","kg/m3"},{"rhoLRackett","kg/m3"},{"rhoLTait","kg/m3"},{"muLcorr","Pa*s"},{"kLcorr","W/(m*K)"},{"kLLatini","W/(m*K)"},
+        {"sigmaCorr","N/m"},{"sigmaSastri","N/m"},{"sigmaMcLeod","N/m"},{"muGcorr","Pa*s"},{"muGLucas","Pa*s"},{"kGcorr","W/(m*K)"},
+        {"kGChung","W/(m*K)"},{"CpLcorr","J/(kg*K)"},{"CpLBondi","J/(kg*K)"},{"TK","K"}};
+    ColTableHeader header;
+    ColTableColumnData columns[57];
+    memset(&header,0,sizeof(header));
+    header.subsId=subsData->id;
+    header.eosModel=subsData->model;
+    if(subsData->model==FF_SAFTtype){
+        header.eosId=subsData->saftData.id;
+        header.eos=subsData->saftData.eos;
+    }
+    else if(subsData->model==FF_SWtype){
+        header.eosId=subsData->swData.id;
+        header.eos=subsData->swData.eos;
+    }
+    else{
+        header.eosId=subsData->cubicData.id;
+        header.eos=subsData->cubicData.eos;
+    }
+    header.flags=compress ? COL_TABLE_COMPRESSED : 0;
+    QByteArray name=subsListModel->name(ui->cbSubsCalcSelSubs->currentIndex()).toUtf8();
+    strncpy(header.subsName,name.constData(),sizeof(header.subsName)-1);
+    for(int i=0;i<57;i++){
+        columns[i].name=colNames[i][0];
+        columns[i].unit=colNames[i][1];
+        columns[i].values=subsCalcValues[i];
+    }
+    return ColTableWrite(fileName,&header,57,columns,11,0);
+}
+
+//Slot for table content exportation in csv ; delimited format, or in columnar binary format if the extension is .ffc
 void FreeFluidsMainWindow::twSubsCalcExport()
 {
     QFileDialog *dia = new QFileDialog(this,"Choose directory and file name");
-    dia->setNameFilter("*.csv *.txt");
+    dia->setNameFilter("*.csv *.txt *.ffc");
     dia->showNormal();
     QString fileName;
     if (dia->exec())
         fileName = dia->selectedFiles().first();
     std::cout<<fileName.toStdString()<<std::endl;
+    if (fileName.endsWith(".ffc",Qt::CaseInsensitive)){
+        bool compress=QMessageBox::question(this,"Columnar export","Compress the columns?",QMessageBox::Yes|QMessageBox::No)==QMessageBox::Yes;
+        if (twSubsCalcExportColumnar(fileName,compress)==0) QMessageBox::warning(this,"Columnar export","The file could not be written");
+        delete dia;
+        return;
+    }
     QFile *file=new QFile(fileName,this);
     if (file->open(QFile::WriteOnly | QFile::Truncate)) {
         QTextStream out(file);
@@ -1035,20 +1315,25 @@ void FreeFluidsMainWindow::btnSubsCalcExportSubs(){
         delete dia;
         exit (1);
     }
-    if ((subsData->cubicData.eos==0)&&(subsData->baseProp.MW>0)&&(subsData->baseProp.Tc>0)&&(subsData->baseProp.Pc>0)&&(subsData->baseProp.w>0)){
-        subsData->cubicData.eos=FF_PR78;
-        subsData->cubicData.MW=subsData->baseProp.MW;
-        subsData->cubicData.Tc=subsData->baseProp.Tc;
-        subsData->cubicData.Pc=subsData->baseProp.Pc;
-        subsData->cubicData.w=subsData->baseProp.w;
-        subsData->cubicData.c=0;
-    }
+    ModelicaDefaultCubic(subsData);
     fwrite (subsData, sizeof(FF_SubstanceData), 1, outfile);
     fclose(outfile);
 
     delete dia;
 }
 
+//Context menu of the vertical header of the substance calculation table. Hidden rows are not calculated
+void FreeFluidsMainWindow::twSubsCalcRowMenu(const QPoint &pos){
+    int row=ui->twSubsCalc->verticalHeader()->logicalIndexAt(pos);
+    QMenu menu(this);
+    QAction *hideRow=menu.addAction("Hide row, and do not calculate it");
+    QAction *showAll=menu.addAction("Show and calculate all rows");
+    hideRow->setEnabled((row>=0)&&((SUBS_CALC_STATE&SUBS_CALC_ROW(row))==0));//the state rows are always calculated
+    QAction *selected=menu.exec(ui->twSubsCalc->verticalHeader()->mapToGlobal(pos));
+    if (selected==hideRow) ui->twSubsCalc->setRowHidden(row,true);
+    else if (selected==showAll) for (int i=0;i<ui->twSubsCalc->rowCount();i++) ui->twSubsCalc->setRowHidden(i,false);
+}
+
 //Slot for transfer from eos calculation to correlation calculation data tables
 void FreeFluidsMainWindow::btnSubsCalcTransfer(){
     int i,n=4;
@@ -1202,6 +1487,7 @@ void FreeFluidsMainWindow::cbSubsToolsCorrLoad(int position){
 
 //Slot for filling table with data from correlations
 void FreeFluidsMainWindow::btnSubsToolsFillTable(){
+    perfStart("Table filling");
     int n=1;//The table column where we will write next data from correlation calculation
     int i;//the table row index
     int j;
@@ -1224,11 +1510,11 @@ void FreeFluidsMainWindow::btnSubsToolsFillTable(){
     */
     if (ui->chbSubsToolsCp0->isChecked()==true){
         double H[nPoints],S[nPoints];
-        FF_PhysPropCorr(&subsData->cp0Corr.form,subsData->cp0Corr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->cp0Corr.form,subsData->cp0Corr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Cp0");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the vapor pressure
         n++;
-        FF_SpecificEnthalpyEntropyCorr(&subsData->cp0Corr.form,subsData->cp0Corr.coef,&subsData->baseProp.MW,&nPoints,T,H,S);
+        FF_PERF("FF_SpecificEnthalpyEntropyCorr",FF_SpecificEnthalpyEntropyCorr(&subsData->cp0Corr.form,subsData->cp0Corr.coef,&subsData->baseProp.MW,&nPoints,T,H,S));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("H0");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(H[i-initRow+1]));//We fill H0
         n++;
@@ -1237,31 +1523,31 @@ void FreeFluidsMainWindow::btnSubsToolsFillTable(){
         n++;
     }
     if (ui->chbSubsToolsVp->isChecked()==true){
-        FF_PhysPropCorr(&subsData->vpCorr.form,subsData->vpCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->vpCorr.form,subsData->vpCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Vapor press.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the vapor pressure
         n++;
     }
     if (ui->chbSubsToolsLdens->isChecked()==true){
-        if (subsData->baseProp.MWmono>0) FF_PhysPropCorr(&subsData->lDensCorr.form,subsData->lDensCorr.coef,&subsData->baseProp.MWmono,&nPoints,T,y);
-        else FF_PhysPropCorr(&subsData->lDensCorr.form,subsData->lDensCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);//we call the calculation routine
+        if (subsData->baseProp.MWmono>0) FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lDensCorr.form,subsData->lDensCorr.coef,&subsData->baseProp.MWmono,&nPoints,T,y));
+        else FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lDensCorr.form,subsData->lDensCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));//we call the calculation routine
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.dens.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the liquid density
         n++;
     }
     if (ui->chbSubsToolsHv->isChecked()==true){
-        FF_PhysPropCorr(&subsData->hVsatCorr.form,subsData->hVsatCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->hVsatCorr.form,subsData->hVsatCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Hv");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the heat of vaporization
         n++;
     }
     if ((ui->chbSubsToolsLCp->isChecked()==true)&&(n<4)){
         double H[nPoints],S[nPoints];
-        FF_PhysPropCorr(&subsData->lCpCorr.form,subsData->lCpCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lCpCorr.form,subsData->lCpCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.Cp");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the liquid Cp
         n++;
-        FF_SpecificEnthalpyEntropyCorr(&subsData->lCpCorr.form,subsData->lCpCorr.coef,&subsData->baseProp.MW,&nPoints,T,H,S);
+        FF_PERF("FF_SpecificEnthalpyEntropyCorr",FF_SpecificEnthalpyEntropyCorr(&subsData->lCpCorr.form,subsData->lCpCorr.coef,&subsData->baseProp.MW,&nPoints,T,H,S));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.H");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(H[i-initRow+1]));//We fill the liquid H
         n++;
@@ -1270,56 +1556,56 @@ void FreeFluidsMainWindow::btnSubsToolsFillTable(){
         n++;
     }    
     if (ui->chbSubsToolsLvisc->isChecked()==true){
-        FF_PhysPropCorr(&subsData->lViscCorr.form,subsData->lViscCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lViscCorr.form,subsData->lViscCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.visc.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the liquid viscosity
         n++;
     }
     if ((ui->chbSubsToolsLthC->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->lThCCorr.form,subsData->lThCCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lThCCorr.form,subsData->lThCCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.th.cond.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the liquid thermal conductivity
         n++;
     }
     if ((ui->chbSubsToolsLsurfT->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->lSurfTCorr.form,subsData->lSurfTCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lSurfTCorr.form,subsData->lSurfTCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.s.tens.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the surface tension
         n++;
     }
     if ((ui->chbSubsToolsLbulkModR->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->lBulkModRCorr.form,subsData->lBulkModRCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->lBulkModRCorr.form,subsData->lBulkModRCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.bulk mod.R.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the liquid isothermal compressibility
         n++;
     }
 
     if ((ui->chbSubsToolsGdens->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->gDensCorr.form,subsData->gDensCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->gDensCorr.form,subsData->gDensCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Gas dens.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the gas saturated density
         n++;
     }
     if ((ui->chbSubsToolsGvisc->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->gViscCorr.form,subsData->gViscCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->gViscCorr.form,subsData->gViscCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Gas visc.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the gas viscosity
         n++;
     }
     if ((ui->chbSubsToolsGthC->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->gThCCorr.form,subsData->gThCCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->gThCCorr.form,subsData->gThCCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Gas th.con.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the gas thermal conductivity
         n++;
     }
     if ((ui->chbSubsToolsSdens->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->sDensCorr.form,subsData->sDensCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->sDensCorr.form,subsData->sDensCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Sol.dens.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the solid density
         n++;
     }
     if ((ui->chbSubsToolsSCp->isChecked()==true)&&(n<6)){
-        FF_PhysPropCorr(&subsData->sCpCorr.form,subsData->sCpCorr.coef,&subsData->baseProp.MW,&nPoints,T,y);
+        FF_PERF("FF_PhysPropCorr",FF_PhysPropCorr(&subsData->sCpCorr.form,subsData->sCpCorr.coef,&subsData->baseProp.MW,&nPoints,T,y));
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Sol.Cp");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i-initRow+1]));//We fill the solid heat capacity
     }
@@ -1327,7 +1613,7 @@ void FreeFluidsMainWindow::btnSubsToolsFillTable(){
     if ((ui->chbSubsToolsVpAmbrose->isChecked()==true)&&(n<6)){
         //std::cout<<T[0]<<std::endl;
         for (j=0;j<nPoints;j++){
-            FF_VpAmbroseWalton(&subsData->baseProp,&T[j],&y[j]);
+            FF_PERF("FF_VpAmbroseWalton",FF_VpAmbroseWalton(&subsData->baseProp,&T[j],&y[j]));
         }
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Vp Ambrose");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i]));//We fill the Ambrose vapor pressure
@@ -1339,7 +1625,7 @@ void FreeFluidsMainWindow::btnSubsToolsFillTable(){
         pRef=ui->leSubsToolsVpPref->text().toDouble();
         //std::cout<<T[0]<<std::endl;
         for (j=0;j<nPoints;j++){
-            FF_VpRiedelVetere(&subsData->baseProp,&tRef,&pRef,&T[j],&y[j]);
+            FF_PERF("FF_VpRiedelVetere",FF_VpRiedelVetere(&subsData->baseProp,&tRef,&pRef,&T[j],&y[j]));
         }
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Vp Riedel");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i]));//We fill the Ambrose vapor pressure
@@ -1351,7 +1637,7 @@ void FreeFluidsMainWindow::btnSubsToolsFillTable(){
         dRef=ui->leSubsToolsLdensDref->text().toDouble();
         //std::cout<<T[0]<<std::endl;
         for (j=0;j<nPoints;j++){
-            FF_LiqDensSatRackett(&subsData->baseProp,&tRef,&dRef,&T[j],&y[j]);
+            FF_PERF("FF_LiqDensSatRackett",FF_LiqDensSatRackett(&subsData->baseProp,&tRef,&dRef,&T[j],&y[j]));
         }
         ui->twSubsTools->horizontalHeaderItem(n)->setText("Liq.d.Rack.");
         for (i=initRow-1;i<(initRow-1+nPoints);i++)ui->twSubsTools->item(i,n)->setText(QString::number(y[i]));//We fill the Rackett density
@@ -1450,6 +1736,7 @@ void FreeFluidsMainWindow::btnSubsToolsClearCoef(){
 
 //Slot for correlation coefficients calculation
 void FreeFluidsMainWindow::btnSubsToolsFindCorr(){
+    perfStart("Correlation fitting");
     FF_CorrelationData data;
     int fromRow,toRow,cor,numCoef,i;
     //We clear the results
@@ -1514,7 +1801,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindCorr(){
            enforce[i]='y';
         }
     }
-    FF_OptCorrelation(numCoef,lb,ub,enforce,&data,coef,&error);
+    FF_PERF("FF_OptCorrelation",FF_OptCorrelation(numCoef,lb,ub,enforce,&data,coef,&error));
     //if (cor==7) ui->leSubsToolsCoef0->setText(ui->leSubsToolsRc->text());
     //else if (cor==8) ui->leSubsToolsCoef0->setText(ui->leSubsToolsPc->text());
     ui->leSubsToolsCoef0->setText(QString::number(coef[0]));
@@ -1529,6 +1816,8 @@ void FreeFluidsMainWindow::btnSubsToolsFindCorr(){
 
 //Slot for EOS coefficients calculation
 void FreeFluidsMainWindow::btnSubsToolsFindEos(){
+    perfStart("EOS fitting");
+    TraceScope trace("EOS fitting","GUI");
     //We clear the results
     ui->leSubsToolsCoef0->setText("");
     ui->leSubsToolsCoef1->setText("");
@@ -1546,6 +1835,9 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
     eos=ui->cbSubsToolsSelOptEOS->currentIndex();
     fromRow=ui->leSubsToolsFromRow->text().toInt();
     toRow=ui->leSubsToolsToRow->text().toInt();
+    trace.arg("id",subsData->id);
+    trace.arg("eos",eos);
+    trace.arg("points",toRow-fromRow+1);
     if(eos<13){//Cubic eos
         FF_CubicFitData data;
         data.eos=&subsData->cubicData;
@@ -1634,7 +1926,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
             }
         }
         //This is the calculation
-        FF_OptCubicParam(optTime,numCoef,lb,ub,enforce,&data,coef,&error);
+        FF_PERF("FF_OptCubicParam",FF_OptCubicParam(optTime,numCoef,lb,ub,enforce,&data,coef,&error));
 
         //We write the results to the table
         ui->leSubsToolsCoef0->setText(QString::number(coef[0]));
@@ -1644,6 +1936,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
         if (numCoef>4) ui->leSubsToolsCoef4->setText(QString::number(coef[4]));
         if (numCoef>5) ui->leSubsToolsCoef5->setText(QString::number(coef[5]));
         ui->leSubsToolsCorrError->setText(QString::number(error*100));
+        trace.arg("error",error);
         ui->leSubsToolsVpError->setText(QString::number(data.vpError*100));
         if ((data.eos->eos==FF_PR78)||(data.eos->eos==FF_PRFIT3)||(data.eos->eos==FF_PRFIT4)) ui->leSubsToolsLdensError->setText(QString::number(data.ldensError*100));
         else ui->leSubsToolsLdensError->setText("");
@@ -1684,6 +1977,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
             subsData->cubicData.c=-1.0;
             break;
         }
+        SatCacheInvalidate(subsData->id);//same ids, different EOS data
         ui->leSubsCalcCubic->setText("From optimization coefficients");
         ui->chbSubsCalcCubic->setChecked(true);
         ui->leSubsCalcSaft->setText("");
@@ -1845,7 +2139,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
             }
         }
         //This is the calculation
-        FF_OptSAFTparam(optTime,numCoef,lb,ub,enforce,data,coef,&error);
+        FF_PERF("FF_OptSAFTparam",FF_OptSAFTparam(optTime,numCoef,lb,ub,enforce,data,coef,&error));
 
         //We write the results to the table
         ui->leSubsToolsCoef0->setText(QString::number(coef[0]));
@@ -1855,6 +2149,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
         if (numCoef>4) ui->leSubsToolsCoef4->setText(QString::number(coef[4]));
         if (numCoef>5) ui->leSubsToolsCoef5->setText(QString::number(coef[5]));
         ui->leSubsToolsCorrError->setText(QString::number(error*100));
+        trace.arg("error",error);
         ui->leSubsToolsVpError->setText(QString::number(data->vpError*100));
         ui->leSubsToolsLdensError->setText(QString::number(data->ldensError*100));
         ui->leSubsToolsZcError->setText(QString::number(data->zcError*100));
@@ -1869,6 +2164,7 @@ void FreeFluidsMainWindow::btnSubsToolsFindEos(){
         if (numCoef>5) subsData->saftData.lr=coef[5];
         if ((subsData->saftData.eos==FF_PPCSAFT_JC)||(subsData->saftData.eos==FF_PPCSAFT2B_JC)||(subsData->saftData.eos==FF_PSAFTVRMie_JC)) subsData->saftData.xp=ui->leSubsToolsNumDipoles->text().toDouble()/coef[1];
 
+        SatCacheInvalidate(subsData->id);//same ids, different EOS data
         ui->leSubsCalcCubic->setText("");
         ui->chbSubsCalcCubic->setChecked(false);
         ui->leSubsCalcSaft->setText("From optimization coefficients");
@@ -1927,6 +2223,7 @@ void FreeFluidsMainWindow::twSubsToolsDoOperation(){
 
 //Slot for adding EOS to database
 void FreeFluidsMainWindow::btnSubsToolAddEos(){
+    perfStart("EOS addition");
     double lowLimit,highLimit;
     QString comment;
     lowLimit=ui->leSubsToolsAddLowT->text().toDouble();
@@ -1945,11 +2242,12 @@ void FreeFluidsMainWindow::btnSubsToolAddEos(){
         //printf("saftData.eos:%i\n",saftData.eos);
         AddEosToDataBase(subsData->id,eosType,&subsData->saftData,&lowLimit,&highLimit,&comment,&db);
     }
-
+    ModelicaClearCache();//the substances kept for export could be outdated
 }
 
 //Slot for adding correlation to database
 void FreeFluidsMainWindow::btnSubsToolAddCorr(){
+    perfStart("Correlation addition");
     double lowLimit,highLimit;
     QString comment;
     int selection;
@@ -2013,7 +2311,7 @@ void FreeFluidsMainWindow::btnSubsToolAddCorr(){
             query.addBindValue(subsData->baseProp.LnuA);
             query.addBindValue(subsData->baseProp.LnuB);
             query.addBindValue(subsData->id);
-            query.exec();
+            FF_PERF_SQL(query.exec());
         break;
     }
     case 12://Not used
@@ -2044,6 +2342,7 @@ void FreeFluidsMainWindow::btnSubsToolAddCorr(){
         break;
     }
     AddCorrToDataBase(subsData->id,&corr,&lowLimit,&highLimit,&comment,&db);
+    ModelicaClearCache();
 }
 
 //Slot for exporting the substance in Modelica FreeFluids.Media format
@@ -2062,87 +2361,9 @@ void FreeFluidsMainWindow::btnSubsToolsExport(){
         QTextStream out(file);
         out.setRealNumberNotation(QTextStream::ScientificNotation);
         out<<"//To be copied in the FreeFluids.MediaCommon.MediaDataAL/MZ package\n";
-        out<<"  constant FreeFluids.MediaCommon.DataRecord "<<subsName.toUtf8()<<"(\n    name = \""<<subsName.toUtf8()<<"\", description = \""<<subsDescription.toUtf8();
-        out<<"\", CAS = \""<<subsData->CAS<<"\", family = "<<subsData->baseProp.type<<", MW = "<<subsData->baseProp.MW<<", molarMass = "<<subsData->baseProp.MW*1e-3;
-        out<<", Tc = "<<subsData->baseProp.Tc<<", criticalPressure = "<<subsData->baseProp.Pc<<", Vc = "<<subsData->baseProp.Vc<<", Zc = "<<subsData->baseProp.Zc;
-        out<<", w = "<<subsData->baseProp.w<<", Tb = "<<subsData->baseProp.Tb;
-        if (subsData->baseProp.mu<1.0e2) out<<", mu = "<<subsData->baseProp.mu;
-        if (subsData->lIsothComp.y>0) out<<", IsothComp = "<<subsData->lIsothComp.y;
-        if (subsData->baseProp.LnuA>0.0) out<<", lnuA = "<<subsData->baseProp.LnuA<<", lnuB = "<<subsData->baseProp.LnuB;
-
-        if (subsData->cp0Corr.form>0){
-            out<<",\n    Cp0Corr = "<<subsData->cp0Corr.form<<", Cp0Coef = {"<<subsData->cp0Corr.coef[0]<<", "<<subsData->cp0Corr.coef[1]<<", ";
-            out<<subsData->cp0Corr.coef[2]<<", "<<subsData->cp0Corr.coef[3]<<", "<<subsData->cp0Corr.coef[4]<<", "<<subsData->cp0Corr.coef[5]<<", ";
-            out<<subsData->cp0Corr.coef[6]<<", "<<subsData->cp0Corr.coef[7]<<", "<<subsData->cp0Corr.coef[8]<<", "<<subsData->cp0Corr.coef[9]<<", ";
-            out<<subsData->cp0Corr.coef[10]<<", "<<subsData->cp0Corr.coef[11]<<", "<<subsData->cp0Corr.coef[12]<<"}, ";
-            out<<"Cp0LimI = "<<subsData->cp0Corr.limI<<", Cp0LimS = "<<subsData->cp0Corr.limS;
-        }
-        if (subsData->vpCorr.form>0){
-        out<<",\n    VpCorr = "<<subsData->vpCorr.form<<", VpCoef = {"<<subsData->vpCorr.coef[0]<<", "<<subsData->vpCorr.coef[1]<<", ";
-        out<<subsData->vpCorr.coef[2]<<", "<<subsData->vpCorr.coef[3]<<", "<<subsData->vpCorr.coef[4]<<", "<<subsData->vpCorr.coef[5]<<"}, ";
-        out<<"VpLimI = "<<subsData->vpCorr.limI<<", VpLimS = "<<subsData->vpCorr.limS;
-        }
-        if (subsData->btCorr.form>0){
-        out<<",\n    BtCorr = "<<subsData->btCorr.form<<", BtCoef = {"<<subsData->btCorr.coef[0]<<", "<<subsData->btCorr.coef[1]<<", ";
-        out<<subsData->btCorr.coef[2]<<", "<<subsData->btCorr.coef[3]<<", "<<subsData->btCorr.coef[4]<<", "<<subsData->btCorr.coef[5]<<"}, ";
-        out<<"BtLimI = "<<subsData->btCorr.limI<<", BtLimS = "<<subsData->btCorr.limS;
-        }
-        if (subsData->hVsatCorr.form>0){
-        out<<",\n    HvCorr = "<<subsData->hVsatCorr.form<<", HvCoef = {"<<subsData->hVsatCorr.coef[0]<<", "<<subsData->hVsatCorr.coef[1]<<", ";
-        out<<subsData->hVsatCorr.coef[2]<<", "<<subsData->hVsatCorr.coef[3]<<", "<<subsData->hVsatCorr.coef[4]<<", "<<subsData->hVsatCorr.coef[5]<<"}, ";
-        out<<"HvLimI = "<<subsData->hVsatCorr.limI<<", HvLimS = "<<subsData->hVsatCorr.limS;
-        }
-        if (subsData->lDensCorr.form>0){
-        out<<",\n    lDensCorr = "<<subsData->lDensCorr.form<<", lDensCoef = {"<<subsData->lDensCorr.coef[0]<<", "<<subsData->lDensCorr.coef[1]<<", ";
-        out<<subsData->lDensCorr.coef[2]<<", "<<subsData->lDensCorr.coef[3]<<", "<<subsData->lDensCorr.coef[4]<<", "<<subsData->lDensCorr.coef[5]<<"}, ";
-        out<<"lDensLimI = "<<subsData->lDensCorr.limI<<", lDensLimS = "<<subsData->lDensCorr.limS;
-        }
-        if (subsData->lCpCorr.form>0){
-        out<<",\n    lCpCorr = "<<subsData->lCpCorr.form<<", lCpCoef = {"<<subsData->lCpCorr.coef[0]<<", "<<subsData->lCpCorr.coef[1]<<", ";
-        out<<subsData->lCpCorr.coef[2]<<", "<<subsData->lCpCorr.coef[3]<<", "<<subsData->lCpCorr.coef[4]<<", "<<subsData->lCpCorr.coef[5]<<"}, ";
-        out<<"lCpLimI = "<<subsData->lCpCorr.limI<<", lCpLimS = "<<subsData->lCpCorr.limS;
-        }
-        if (subsData->lTfromHCorr.form>0){
-        out<<",\n    lTfromHsatCorr = "<<subsData->lTfromHCorr.form<<", lTfromHsatCoef = {"<<subsData->lTfromHCorr.coef[0]<<", "<<subsData->lTfromHCorr.coef[1]<<", ";
-        out<<subsData->lTfromHCorr.coef[2]<<", "<<subsData->lTfromHCorr.coef[3]<<", "<<subsData->lTfromHCorr.coef[4]<<", "<<subsData->lTfromHCorr.coef[5]<<"}, ";
-        out<<"lTfromHsatLimI = "<<subsData->lTfromHCorr.limI<<", lTfromHsatLimS = "<<subsData->lTfromHCorr.limS;
-        }
-        if (subsData->lViscCorr.form>0){
-        out<<",\n    lViscCorr = "<<subsData->lViscCorr.form<<", lViscCoef = {"<<subsData->lViscCorr.coef[0]<<", "<<subsData->lViscCorr.coef[1]<<", ";
-        out<<subsData->lViscCorr.coef[2]<<", "<<subsData->lViscCorr.coef[3]<<", "<<subsData->lViscCorr.coef[4]<<", "<<subsData->lViscCorr.coef[5]<<"}, ";
-        out<<"lViscLimI = "<<subsData->lViscCorr.limI<<", lViscLimS = "<<subsData->lViscCorr.limS;
-        }
-        if (subsData->lThCCorr.form>0){
-        out<<",\n    lThCondCorr = "<<subsData->lThCCorr.form<<", lThCondCoef = {"<<subsData->lThCCorr.coef[0]<<", "<<subsData->lThCCorr.coef[1]<<", ";
-        out<<subsData->lThCCorr.coef[2]<<", "<<subsData->lThCCorr.coef[3]<<", "<<subsData->lThCCorr.coef[4]<<", "<<subsData->lThCCorr.coef[5]<<"}, ";
-        out<<"lThCondLimI = "<<subsData->lThCCorr.limI<<", lThCondLimS = "<<subsData->lThCCorr.limS;
-        }
-        if (subsData->lSurfTCorr.form>0){
-        out<<",\n    lSurfTensCorr = "<<subsData->lSurfTCorr.form<<", lSurfTensCoef = {"<<subsData->lSurfTCorr.coef[0]<<", "<<subsData->lSurfTCorr.coef[1]<<", ";
-        out<<subsData->lSurfTCorr.coef[2]<<", "<<subsData->lSurfTCorr.coef[3]<<", "<<subsData->lSurfTCorr.coef[4]<<", "<<subsData->lSurfTCorr.coef[5]<<"}, ";
-        out<<"lSurfTensLimI = "<<subsData->lSurfTCorr.limI<<", lSurfTensLimS = "<<subsData->lSurfTCorr.limS;
-        }
-        if (subsData->lBulkModRCorr.form>0){
-        out<<",\n    lBulkModRCorr = "<<subsData->lBulkModRCorr.form<<", lBulkModRCoef = {"<<subsData->lBulkModRCorr.coef[0]<<", "<<subsData->lBulkModRCorr.coef[1]<<", ";
-        out<<subsData->lBulkModRCorr.coef[2]<<", "<<subsData->lBulkModRCorr.coef[3]<<", "<<subsData->lBulkModRCorr.coef[4]<<", "<<subsData->lBulkModRCorr.coef[5]<<"}, ";
-        out<<"lBulkModRLimI = "<<subsData->lBulkModRCorr.limI<<", lBulkModRLimS = "<<subsData->lBulkModRCorr.limS;
-        }
-        if (subsData->gDensCorr.form>0){
-        out<<",\n    gSatDensCorr = "<<subsData->gDensCorr.form<<", gSatDensCoef = {"<<subsData->gDensCorr.coef[0]<<", "<<subsData->gDensCorr.coef[1]<<", ";
-        out<<subsData->gDensCorr.coef[2]<<", "<<subsData->gDensCorr.coef[3]<<", "<<subsData->gDensCorr.coef[4]<<", "<<subsData->gDensCorr.coef[5]<<"}, ";
-        out<<"gSatDensLimI = "<<subsData->gDensCorr.limI<<", gSatDensLimS = "<<subsData->gDensCorr.limS;
-        }
-        if (subsData->gViscCorr.form>0){
-        out<<",\n    gViscCorr = "<<subsData->gViscCorr.form<<", gViscCoef = {"<<subsData->gViscCorr.coef[0]<<", "<<subsData->gViscCorr.coef[1]<<", ";
-        out<<subsData->gViscCorr.coef[2]<<", "<<subsData->gViscCorr.coef[3]<<", "<<subsData->gViscCorr.coef[4]<<", "<<subsData->gViscCorr.coef[5]<<"}, ";
-        out<<"gViscLimI = "<<subsData->gViscCorr.limI<<", gViscLimS = "<<subsData->gViscCorr.limS;
-        }
-        if (subsData->gThCCorr.form>0){
-        out<<",\n    gThCondCorr = "<<subsData->gThCCorr.form<<", gThCondCoef = {"<<subsData->gThCCorr.coef[0]<<", "<<subsData->gThCCorr.coef[1]<<", ";
-        out<<subsData->gThCCorr.coef[2]<<", "<<subsData->gThCCorr.coef[3]<<", "<<subsData->gThCCorr.coef[4]<<", "<<subsData->gThCCorr.coef[5]<<"}, ";
-        out<<"gThCondLimI = "<<subsData->gThCCorr.limI<<", gThCondLimS = "<<subsData->gThCCorr.limS;
-        }
-        out<<"); \n\n";
+        QString record;
+        ModelicaDataRecord(subsData,subsName,subsDescription,&record);
+        out<<record<<"\n";
 
         out<<"//To be copied in the FreeFluids.TMedia.Fluids package. Please change MediaData by MediaDataAL or MediaDataMZ as needed.\n";
         out<<"  package "<<subsName.toUtf8()<<"\n    extends FreeFluids.TMedia.TMedium(final mediumName = \""<<subsName.toUtf8()<<"\", final singleState = false,";
@@ -2260,6 +2481,7 @@ void FreeFluidsMainWindow::btnSubsToolsPropaneRef(){
 
 //Slot for performing the corresponding states calculation
 void FreeFluidsMainWindow::btnSubsToolsDoCScalc(){
+    perfStart("Corresponding states calculation");
     /*
     double Ttest=260.0;
     double rhoTest=12390.0;
@@ -2277,7 +2499,7 @@ void FreeFluidsMainWindow::btnSubsToolsDoCScalc(){
     ui->twSubsTools->horizontalHeaderItem(2)->setText("liq.th.cond.(W/m·K)");
     while(ui->twSubsTools->item(i,0)->text()>""){
         T=T=ui->twSubsTools->item(i,0)->text().toDouble();//Selected temperature
-        FF_CorrespondingStatesSat(subsData,subsDataRef,&T,result);
+        FF_PERF("FF_CorrespondingStatesSat",FF_CorrespondingStatesSat(subsData,subsDataRef,&T,result));
         ui->twSubsTools->item(i,1)->setText(QString::number(result[0]));
         ui->twSubsTools->item(i,2)->setText(QString::number(result[1]));
         i++;
@@ -2446,13 +2668,14 @@ void FreeFluidsMainWindow::writeMixResultsTable(int nPhases,FF_MixData*mix,FF_Th
 
 //Slot for adding a new substances to the composition table
 void FreeFluidsMainWindow::twMixCompositionAdd(){
+    perfStart("Substance addition to mixture");
     int subsId;
     QString subsName;
     double MW;
     int i=0;
-    subsId=subsListModel->record(ui->cbSubsCalcSelSubs->currentIndex()).value("Id").toInt();
-    subsName=subsListModel->record(ui->cbSubsCalcSelSubs->currentIndex()).value("Name").toString();
-    MW=subsListModel->record(ui->cbSubsCalcSelSubs->currentIndex()).value("MW").toDouble();
+    subsId=subsListModel->id(ui->cbSubsCalcSelSubs->currentIndex());
+    subsName=subsListModel->name(ui->cbSubsCalcSelSubs->currentIndex());
+    MW=subsListModel->MW(ui->cbSubsCalcSelSubs->currentIndex());
     while ((ui->twMixComposition->item(i,0)->text().toInt()>0)&&(i<(ui->twMixComposition->rowCount()-1))) i++;//We look for the first free position
     //we could use numSubs, but this allows to erase a substance and refill the empty row
     ui->twMixComposition->item(i,0)->setText(QString::number(subsId));//add Id
@@ -2486,7 +2709,7 @@ void  FreeFluidsMainWindow::twMixCompositionCalcFract(){
     }
     if (ui->cbMixCompositionMass->isChecked()==true) mass=true;
     else mass=false;
-    FF_FractionsCalculation( mix->numSubs, MW, q, mass, massFrac, moleFrac);//we obtain the fractions
+    FF_PERF("FF_FractionsCalculation",FF_FractionsCalculation( mix->numSubs, MW, q, mass, massFrac, moleFrac));//we obtain the fractions
     for (j=0;j< mix->numSubs;j++){//We fill the table with the results and calculate the mix molecular weight
         ui->twMixComposition->item(j,4)->setText(QString::number(massFrac[j]));
         ui->twMixComposition->item(j,5)->setText(QString::number(moleFrac[j]));
@@ -2537,7 +2760,7 @@ void  FreeFluidsMainWindow::cbMixCalcEosTypeLoad(int position){
         queryEos.bindValue(0,ui->twMixComposition->item(j,0)->text().toInt());
         queryEos.bindValue(1,eosTypeQs);
         //printf("Producto:%i\n",ui->twMixComposition->item(j,0)->text().toInt());
-        queryEos.exec();
+        FF_PERF_SQL(queryEos.exec());
         mixCalcEOSModel[j]->setQuery(queryEos);
         tvMixCalcSelEOS[j]->setColumnHidden(2,true);
         //tvMixCalcSelEOS[j]->resizeColumnsToContents();
@@ -2555,7 +2778,7 @@ void  FreeFluidsMainWindow::cbMixCalcEosTypeLoad(int position){
 
         queryCp0.addBindValue(ui->twMixComposition->item(j,0)->text().toInt());
         queryCp0.addBindValue("Cp0");
-        queryCp0.exec();
+        FF_PERF_SQL(queryCp0.exec());
         mixCalcCp0Model[j]->setQuery(queryCp0);
         tvMixCalcSelCp0[j]->setColumnHidden(2,true);
         tvMixCalcSelCp0[j]->setColumnWidth(0,75);
@@ -2717,7 +2940,7 @@ void FreeFluidsMainWindow::twMixIntParamEosDisplay(int row,int column){
             queryIntParam.bindValue(1,ui->twMixComposition->item(column,0)->text().toInt());
             queryIntParam.bindValue(2,eosTypeQs);
             queryIntParam.bindValue(3,mixRuleQs);
-            queryIntParam.exec();
+            FF_PERF_SQL(queryIntParam.exec());
             mixIntParamSelModel->setQuery(queryIntParam);
             tvMixIntParamSel->setColumnWidth(0,1);
             tvMixIntParamSel->setColumnWidth(20,250);
@@ -2731,7 +2954,7 @@ void FreeFluidsMainWindow::twMixIntParamEosDisplay(int row,int column){
         queryIntParam.bindValue(0,ui->twMixComposition->item(row,0)->text().toInt());
         queryIntParam.bindValue(1,ui->twMixComposition->item(column,0)->text().toInt());
         queryIntParam.bindValue(2,actModelQs);
-        queryIntParam.exec();
+        FF_PERF_SQL(queryIntParam.exec());
         mixIntParamSelModel->setQuery(queryIntParam);
         tvMixIntParamSel->setColumnWidth(0,1);
         tvMixIntParamSel->setColumnWidth(19,250);
@@ -2815,7 +3038,11 @@ void FreeFluidsMainWindow::twMixIntParamClear(){
 
 //Slot for substances and mixture creation
 void FreeFluidsMainWindow::btnMixCalcCreateSys(){
-    substance= new FF_SubstanceData[15];
+    perfStart("Mixture creation");
+    TraceScope trace("Mixture creation","GUI");
+    trace.arg("numSubs",mix->numSubs);
+    CalcArenaReset(&mixArena);//the substances of the previous creation are not used any more
+    substance=CalcArenaNew<FF_SubstanceData>(&mixArena,15);
 
     QString type;
     int i;//the loop variable
@@ -2877,17 +3104,22 @@ void FreeFluidsMainWindow::btnMixCalcCreateSys(){
         //printf("A:%f\n",substance[i].gThCCorr.coef[0]);
 
     }
-    subsPoint= new FF_SubstanceData*[15];
+    subsPoint=CalcArenaNew<FF_SubstanceData*>(&mixArena,15);
     for(i=0;i<15;i++)subsPoint[i]=&substance[i];
 
-    FF_MixFillDataWithSubsData(&mix->numSubs,subsPoint,mix);
+    FF_PERF("FF_MixFillDataWithSubsData",FF_MixFillDataWithSubsData(&mix->numSubs,subsPoint,mix));
+    //UNIFAC models compiled for the substances of the system, only the subgroups present are kept
+    if((unifacStore.base!=NULL)&&(UnifacStoreCurrent(&unifacStore)==0)) openUnifacStore();//the database has been edited
+    UnifacKernelBuild(FF_UNIFACStd,mix->numSubs,subsPoint,&unifacStore,&db,&mixUnifac[0]);
+    UnifacKernelBuild(FF_UNIFACPSRK,mix->numSubs,subsPoint,&unifacStore,&db,&mixUnifac[1]);
+    UnifacKernelBuild(FF_UNIFACDort,mix->numSubs,subsPoint,&unifacStore,&db,&mixUnifac[2]);
+    UnifacKernelBuild(FF_UNIFACNist,mix->numSubs,subsPoint,&unifacStore,&db,&mixUnifac[3]);
+    for(i=0;i<4;i++) mixSatWarm[i].valid=0;//the previous saturation solutions are not valid for the new system
 
     if (ui->cbMixCalcRefPhiSelec->currentIndex()==0) mix->refVpEos=0;
     else mix->refVpEos=1;
 
     //printf("de mix R:%f\n",mix->unifDortData.subsR[0]);
-    delete[] subsPoint;
-    delete[] substance;
 }
 
 //Slot for mixture exportation
@@ -3059,6 +3291,7 @@ void FreeFluidsMainWindow::btnMixCalcImportMix(){
 
 //Slot for mixture bubble P calculation, and display in table
 void FreeFluidsMainWindow::twMixCalcBubbleP(){
+    perfStart("Bubble P");
     //printf("Act/Eos: %i Mixrule: %i ActModel: %i form: %i 0: %f 1: %f\n",mix->thModelActEos,mix->mixRule,mix->actModel,mix->intForm,mix->intParam[0][1][0],mix->intParam[0][1][1]);
     int i;//the loop variable
     int nPhases=2;
@@ -3073,6 +3306,8 @@ void FreeFluidsMainWindow::twMixCalcBubbleP(){
     double phiL,phiG;
     double Z,Zg;
     double bubbleP;
+    SatResult sat;
+    int satDone=0;
     double bubblePguess=ui->leMixCalcPresGuess->text().toDouble()*1e5;
 
     for(i=0;i<15;i++){
@@ -3092,7 +3327,17 @@ void FreeFluidsMainWindow::twMixCalcBubbleP(){
     //And begin the calculations
     th0l.MW=thl.MW=MW;
     th0l.T=thl.T=th0g.T=thg.T=273.15+ui->leMixCalcTemp->text().toDouble();//we read the selected temperature
-    FF_BubbleP(mix,&thl.T,thl.c,&bubblePguess,&bubbleP,thg.c,thl.subsPhi,thg.subsPhi);
+    if(SatBubbleP(mix,thl.T,thl.c,bubblePguess,&mixSatWarm[0],&sat)==1){//Newton solver on the cubic kernel, with warm start
+        satDone=1;
+        bubbleP=sat.P;
+        for(i=0;i<mix->numSubs;i++){
+            thg.c[i]=sat.y[i];
+            thl.subsPhi[i]=exp(sat.lnPhiL[i]);
+            thg.subsPhi[i]=exp(sat.lnPhiG[i]);
+        }
+    }
+    else FF_PERF("FF_BubbleP",FF_BubbleP(mix,&thl.T,thl.c,&bubblePguess,&bubbleP,thg.c,thl.subsPhi,thg.subsPhi));
+    mixShowSolverInfo(&sat.telem,(satDone==1) ? NULL : "FF_BubbleP");
     thg.MW=0;
     for(i=0;i<mix->numSubs;i++)thg.MW=thg.MW+thg.c[i]*mix->baseProp[i].MW;
     th0g.MW=thg.MW;
@@ -3102,26 +3347,44 @@ void FreeFluidsMainWindow::twMixCalcBubbleP(){
 
 
     option='l';//determine only the liquid volume
-    FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state);
-    //printf("state:%c P:%f Vl:%f Vg:%f\n",state,thl.P,answerL[0],answerG[0]);
-    th0l.V=answerL[0];
-    thl.V=answerL[0];
-    Z=answerL[2];
-    //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
-    phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l);
+    if(satDone==1){//the volumes come from the final evaluation of the saturation solver
+        th0l.V=thl.V=sat.VL;
+        Z=sat.ZL;
+        phiL=0;
+        for(i=0;i<mix->numSubs;i++) phiL+=thl.c[i]*sat.lnPhiL[i];
+        phiL=exp(phiL);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state));
+        //printf("state:%c P:%f Vl:%f Vg:%f\n",state,thl.P,answerL[0],answerG[0]);
+        th0l.V=answerL[0];
+        thl.V=answerL[0];
+        Z=answerL[2];
+        //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
+        phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l));
     //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
-    FF_MixThermoEOS(mix,&refT,&refP,&thl);
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thl));
     //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
 
 
     option='g';//determine only the gas volume
-    FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state);
-    th0g.V=thg.V=answerG[0];
-    Zg=answerG[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g);
-    FF_MixThermoEOS(mix,&refT,&refP,&thg);
-    phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    if(satDone==1){
+        th0g.V=thg.V=sat.VG;
+        Zg=sat.ZG;
+        phiG=0;
+        for(i=0;i<mix->numSubs;i++) phiG+=thg.c[i]*sat.lnPhiG[i];
+        phiG=exp(phiG);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state));
+        th0g.V=thg.V=answerG[0];
+        Zg=answerG[2];
+        phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g));
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thg));
     //printf("T:%f P:%f rhoL:%f Vg:%f state:%c phiL:%f phiG:%f\n",thl.T,thl.P,MW/answerL[0]*0.001,answerG[0],state,phiL,phiG);
     /*
     */
@@ -3136,6 +3399,7 @@ void FreeFluidsMainWindow::twMixCalcBubbleP(){
 
 //Slot for mixture dew P calculation, and display in table
 void FreeFluidsMainWindow::twMixCalcDewP(){
+    perfStart("Dew P");
     int i;//the loop variable
     int nPhases=2;
     FF_ThermoProperties th0l,th0g,th0C;
@@ -3149,6 +3413,8 @@ void FreeFluidsMainWindow::twMixCalcDewP(){
     double phiL,phiG;
     double Z,Zg;
     double dewP;
+    SatResult sat;
+    int satDone=0;
     double dewPguess=ui->leMixCalcPresGuess->text().toDouble()*1e5;
 
     for (i=0;i<ui->twMixCalc->rowCount();i++){//we clear the content of the results table
@@ -3164,7 +3430,17 @@ void FreeFluidsMainWindow::twMixCalcDewP(){
     //Now we begin the calculations
     th0g.MW=thg.MW=MW;
     th0l.T=thl.T=th0g.T=thg.T=273.15+ui->leMixCalcTemp->text().toDouble();//we read the selected temperature
-    FF_DewP(mix,&thg.T,thg.c,&dewPguess,&dewP,thl.c,thl.subsPhi,thg.subsPhi);
+    if(SatDewP(mix,thg.T,thg.c,dewPguess,&mixSatWarm[1],&sat)==1){//Newton solver on the cubic kernel, with warm start
+        satDone=1;
+        dewP=sat.P;
+        for(i=0;i<mix->numSubs;i++){
+            thl.c[i]=sat.x[i];
+            thl.subsPhi[i]=exp(sat.lnPhiL[i]);
+            thg.subsPhi[i]=exp(sat.lnPhiG[i]);
+        }
+    }
+    else FF_PERF("FF_DewP",FF_DewP(mix,&thg.T,thg.c,&dewPguess,&dewP,thl.c,thl.subsPhi,thg.subsPhi));
+    mixShowSolverInfo(&sat.telem,(satDone==1) ? NULL : "FF_DewP");
     thl.MW=0;
     for(i=0;i<mix->numSubs;i++)thl.MW=thl.MW+thl.c[i]*mix->baseProp[i].MW;
     th0l.MW=thl.MW;
@@ -3173,21 +3449,39 @@ void FreeFluidsMainWindow::twMixCalcDewP(){
     thg.fraction=1;
 
     option='l';//determine only the liquid volume
-    FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state);
-    th0l.V=thl.V=answerL[0];
-    Z=answerL[2];
-    phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l);
-    FF_MixThermoEOS(mix,&refT,&refP,&thl);
+    if(satDone==1){//the volumes come from the final evaluation of the saturation solver
+        th0l.V=thl.V=sat.VL;
+        Z=sat.ZL;
+        phiL=0;
+        for(i=0;i<mix->numSubs;i++) phiL+=thl.c[i]*sat.lnPhiL[i];
+        phiL=exp(phiL);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state));
+        th0l.V=thl.V=answerL[0];
+        Z=answerL[2];
+        phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l));
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thl));
 
 
     option='g';//determine only the gas volume
-    FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state);
-    th0g.V=thg.V=answerG[0];
-    Zg=answerG[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g);
-    FF_MixThermoEOS(mix,&refT,&refP,&thg);
-    phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    if(satDone==1){
+        th0g.V=thg.V=sat.VG;
+        Zg=sat.ZG;
+        phiG=0;
+        for(i=0;i<mix->numSubs;i++) phiG+=thg.c[i]*sat.lnPhiG[i];
+        phiG=exp(phiG);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state));
+        th0g.V=thg.V=answerG[0];
+        Zg=answerG[2];
+        phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g));
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thg));
     //printf("T:%f P:%f rhoL:%f Vg:%f state:%c phiL:%f phiG:%f\n",thl.T,thl.P,MW/answerL[0]*0.001,answerG[0],state,phiL,phiG);
 
     writeMixResultsTable(nPhases,mix,&th0g,&thg,&th0l,&thl,&th0C,&thC);
@@ -3200,6 +3494,8 @@ void FreeFluidsMainWindow::twMixCalcDewP(){
 
 //Slot for the pressure envelope calculation for binary mixtures
 void FreeFluidsMainWindow::twMixCalcPenvelope(){
+    perfStart("Pressure envelope");
+    TraceScope trace("Pressure envelope","GUI");
     int numPoints=21;
     int i,j;//the loop variable
     double base[numPoints],liquid[numPoints],gas[numPoints],bP[numPoints],dP[numPoints];
@@ -3208,7 +3504,9 @@ void FreeFluidsMainWindow::twMixCalcPenvelope(){
     T=273.15+ui->leMixCalcTemp->text().toDouble();//we read the selected temperature
     for (j=0;j<ui->twMixEnvelope->rowCount();j++) for(i=0;i<ui->twMixEnvelope->columnCount();i++) ui->twMixEnvelope->item(j,i)->setText("");//we clear the content of the results table
 
-    FF_PressureEnvelope(mix,&T,&numPoints,base,bP,gas,dP,liquid);//the calculation
+    trace.arg("T",T);
+    trace.arg("points",numPoints);
+    FF_PERF("FF_PressureEnvelope",FF_PressureEnvelope(mix,&T,&numPoints,base,bP,gas,dP,liquid));//the calculation
     for(i=0;i<ui->twMixEnvelope->rowCount()-1;i++){
         ui->twMixEnvelope->item(i,0)->setText(QString::number(base[i]));
         ui->twMixEnvelope->item(i,1)->setText(QString::number(bP[i]));
@@ -3225,6 +3523,7 @@ void FreeFluidsMainWindow::twMixCalcPenvelope(){
 
 //Slot for mixture bubble T calculation, and display in table
 void FreeFluidsMainWindow::twMixCalcBubbleT(){
+    perfStart("Bubble T");
     //printf("Act/Eos: %i Mixrule: %i ActModel: %i form: %i 0: %f 1: %f\n",mix->thModelActEos,mix->mixRule,mix->actModel,mix->intForm,mix->intParam[0][1][0],mix->intParam[0][1][1]);
     int i;//the loop variable
     int nPhases=2;
@@ -3239,6 +3538,8 @@ void FreeFluidsMainWindow::twMixCalcBubbleT(){
     double phiL,phiG;
     double Z,Zg;
     double bubbleT;
+    SatResult sat;
+    int satDone=0;
     double bubbleTguess=ui->leMixCalcTempGuess->text().toDouble();
 
     //clear the content of the results table
@@ -3255,7 +3556,17 @@ void FreeFluidsMainWindow::twMixCalcBubbleT(){
     //And begin the calculations
     th0l.MW=thl.MW=MW;
     th0l.P=thl.P=th0g.P=thg.P=ui->leMixCalcPres->text().toDouble()*1e5;//we read the selected pressure
-    FF_BubbleT(mix,&thl.P,thl.c,&bubbleTguess,&bubbleT,thg.c,thl.subsPhi,thg.subsPhi);
+    if(SatBubbleT(mix,thl.P,thl.c,bubbleTguess,&mixSatWarm[2],&sat)==1){//Newton solver on the cubic kernel, with warm start
+        satDone=1;
+        bubbleT=sat.T;
+        for(i=0;i<mix->numSubs;i++){
+            thg.c[i]=sat.y[i];
+            thl.subsPhi[i]=exp(sat.lnPhiL[i]);
+            thg.subsPhi[i]=exp(sat.lnPhiG[i]);
+        }
+    }
+    else FF_PERF("FF_BubbleT",FF_BubbleT(mix,&thl.P,thl.c,&bubbleTguess,&bubbleT,thg.c,thl.subsPhi,thg.subsPhi));
+    mixShowSolverInfo(&sat.telem,(satDone==1) ? NULL : "FF_BubbleT");
     thg.MW=0;
     for(i=0;i<mix->numSubs;i++)thg.MW=thg.MW+thg.c[i]*mix->baseProp[i].MW;
     th0g.MW=thg.MW;
@@ -3265,26 +3576,44 @@ void FreeFluidsMainWindow::twMixCalcBubbleT(){
 
 
     option='l';//determine only the liquid volume
-    FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state);
-    //printf("state:%c P:%f Vl:%f Vg:%f\n",state,thl.P,answerL[0],answerG[0]);
-    th0l.V=answerL[0];
-    thl.V=answerL[0];
-    Z=answerL[2];
-    //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
-    phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l);
+    if(satDone==1){//the volumes come from the final evaluation of the saturation solver
+        th0l.V=thl.V=sat.VL;
+        Z=sat.ZL;
+        phiL=0;
+        for(i=0;i<mix->numSubs;i++) phiL+=thl.c[i]*sat.lnPhiL[i];
+        phiL=exp(phiL);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state));
+        //printf("state:%c P:%f Vl:%f Vg:%f\n",state,thl.P,answerL[0],answerG[0]);
+        th0l.V=answerL[0];
+        thl.V=answerL[0];
+        Z=answerL[2];
+        //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
+        phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l));
     //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
-    FF_MixThermoEOS(mix,&refT,&refP,&thl);
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thl));
     //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
 
 
     option='g';//determine only the gas volume
-    FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state);
-    th0g.V=thg.V=answerG[0];
-    Zg=answerG[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g);
-    FF_MixThermoEOS(mix,&refT,&refP,&thg);
-    phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    if(satDone==1){
+        th0g.V=thg.V=sat.VG;
+        Zg=sat.ZG;
+        phiG=0;
+        for(i=0;i<mix->numSubs;i++) phiG+=thg.c[i]*sat.lnPhiG[i];
+        phiG=exp(phiG);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state));
+        th0g.V=thg.V=answerG[0];
+        Zg=answerG[2];
+        phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g));
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thg));
     //printf("T:%f P:%f rhoL:%f Vg:%f state:%c phiL:%f phiG:%f\n",thl.T,thl.P,MW/answerL[0]*0.001,answerG[0],state,phiL,phiG);
     /*
     */
@@ -3298,6 +3627,7 @@ void FreeFluidsMainWindow::twMixCalcBubbleT(){
 
 //Slot for mixture dew T calculation, and display in table
 void FreeFluidsMainWindow::twMixCalcDewT(){
+    perfStart("Dew T");
     //printf("Act/Eos: %i Mixrule: %i ActModel: %i form: %i 0: %f 1: %f\n",mix->thModelActEos,mix->mixRule,mix->actModel,mix->intForm,mix->intParam[0][1][0],mix->intParam[0][1][1]);
     int i;//the loop variable
     int nPhases=2;
@@ -3312,6 +3642,8 @@ void FreeFluidsMainWindow::twMixCalcDewT(){
     double phiL,phiG;
     double Z,Zg;
     double dewT;
+    SatResult sat;
+    int satDone=0;
     double dewTguess=0;
 
     //we clear the content of the results table
@@ -3328,7 +3660,17 @@ void FreeFluidsMainWindow::twMixCalcDewT(){
     //And begin the calculations
     th0l.MW=thl.MW=MW;
     th0l.P=thl.P=th0g.P=thg.P=ui->leMixCalcPres->text().toDouble()*1e5;//we read the selected pressure
-    FF_DewT(mix,&thl.P,thl.c,&dewTguess,&dewT,thg.c,thl.subsPhi,thg.subsPhi);
+    if(SatDewT(mix,thl.P,thl.c,dewTguess,&mixSatWarm[3],&sat)==1){//Newton solver on the cubic kernel, with warm start
+        satDone=1;
+        dewT=sat.T;
+        for(i=0;i<mix->numSubs;i++){
+            thg.c[i]=sat.x[i];
+            thl.subsPhi[i]=exp(sat.lnPhiG[i]);
+            thg.subsPhi[i]=exp(sat.lnPhiL[i]);
+        }
+    }
+    else FF_PERF("FF_DewT",FF_DewT(mix,&thl.P,thl.c,&dewTguess,&dewT,thg.c,thl.subsPhi,thg.subsPhi));
+    mixShowSolverInfo(&sat.telem,(satDone==1) ? NULL : "FF_DewT");
     thg.MW=0;
     for(i=0;i<mix->numSubs;i++)thg.MW=thg.MW+thg.c[i]*mix->baseProp[i].MW;
     th0g.MW=thg.MW;
@@ -3338,26 +3680,44 @@ void FreeFluidsMainWindow::twMixCalcDewT(){
 
 
     option='l';//determine only the liquid volume
-    FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state);
-    //printf("state:%c P:%f Vl:%f Vg:%f\n",state,thl.P,answerL[0],answerG[0]);
-    th0l.V=answerL[0];
-    thl.V=answerL[0];
-    Z=answerL[2];
-    //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
-    phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l);
+    if(satDone==1){//the volumes come from the final evaluation of the saturation solver
+        th0l.V=thl.V=sat.VG;
+        Z=sat.ZG;
+        phiL=0;
+        for(i=0;i<mix->numSubs;i++) phiL+=thl.c[i]*sat.lnPhiG[i];
+        phiL=exp(phiL);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thl.T,&thl.P,thl.c,&option,answerL,answerG,&state));
+        //printf("state:%c P:%f Vl:%f Vg:%f\n",state,thl.P,answerL[0],answerG[0]);
+        th0l.V=answerL[0];
+        thl.V=answerL[0];
+        Z=answerL[2];
+        //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
+        phiL=exp(answerL[1]+answerL[2]-1)/answerL[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thl.c,&refT,&refP,&th0l));
     //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
-    FF_MixThermoEOS(mix,&refT,&refP,&thl);
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thl));
     //printf("state:%c P:%f Vl:%f Pcalc:%f\n",state,thl.P,thl.V,Z*R*thl.T/thl.V);
 
 
     option='g';//determine only the gas volume
-    FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state);
-    th0g.V=thg.V=answerG[0];
-    Zg=answerG[2];
-    FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g);
-    FF_MixThermoEOS(mix,&refT,&refP,&thg);
-    phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    if(satDone==1){
+        th0g.V=thg.V=sat.VL;
+        Zg=sat.ZL;
+        phiG=0;
+        for(i=0;i<mix->numSubs;i++) phiG+=thg.c[i]*sat.lnPhiL[i];
+        phiG=exp(phiG);
+    }
+    else{
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thg.T,&thg.P,thg.c,&option,answerL,answerG,&state));
+        th0g.V=thg.V=answerG[0];
+        Zg=answerG[2];
+        phiG=exp(answerG[1]+answerG[2]-1)/answerG[2];
+    }
+    FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thg.c,&refT,&refP,&th0g));
+    FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thg));
     //printf("T:%f P:%f rhoL:%f Vg:%f state:%c phiL:%f phiG:%f\n",thl.T,thl.P,MW/answerL[0]*0.001,answerG[0],state,phiL,phiG);
     /*
     */
@@ -3371,6 +3731,8 @@ void FreeFluidsMainWindow::twMixCalcDewT(){
 
 //Slot for the temperature envelope calculation for binary mixtures
 void FreeFluidsMainWindow::twMixCalcTenvelope(){
+    perfStart("Temperature envelope");
+    TraceScope trace("Temperature envelope","GUI");
     int numPoints=21;
     int i,j;//the loop variable
     double base[numPoints],liquid[numPoints],gas[numPoints],bT[numPoints],dT[numPoints];
@@ -3379,7 +3741,9 @@ void FreeFluidsMainWindow::twMixCalcTenvelope(){
     P=ui->leMixCalcPres->text().toDouble()*1e5;//we read the selected pressure
     for (j=0;j<ui->twMixEnvelope->rowCount();j++) for(i=0;i<ui->twMixEnvelope->columnCount();i++) ui->twMixEnvelope->item(j,i)->setText("");//we clear the content of the results table
 
-    FF_TemperatureEnvelope(mix,&P,&numPoints,base,bT,gas,dT,liquid);//the calculation
+    trace.arg("P",P);
+    trace.arg("points",numPoints);
+    FF_PERF("FF_TemperatureEnvelope",FF_TemperatureEnvelope(mix,&P,&numPoints,base,bT,gas,dT,liquid));//the calculation
     for(i=0;i<ui->twMixEnvelope->rowCount()-1;i++){
         ui->twMixEnvelope->item(i,0)->setText(QString::number(base[i]));
         ui->twMixEnvelope->item(i,1)->setText(QString::number(bT[i]));
@@ -3396,13 +3760,15 @@ void FreeFluidsMainWindow::twMixCalcTenvelope(){
 
 //Slot for mixture VL flash P,T calculation, and display in table
 void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
+    perfStart("Two phases flash");
+    TraceScope trace("Two phases flash","GUI");
     FF_FeedData data;
     //printf("Act/Eos: %i Mixrule: %i ActModel: %i form: %i 0: %f 1: %f\n",mix->thModelActEos,mix->mixRule,mix->actModel,mix->intForm,mix->intParam[0][1][0],mix->intParam[0][1][1]);
     int i;//the loop variable
     int nPhases=2;
     FF_ThermoProperties th0A,th0B,th0C;//for ideal gas properties. C will not be used
     FF_PhaseThermoProp thA,thB,thC;//here will be stored the result of the calculations for the gas and liquid phases
-    double c[mix->numSubs];//feed concentration
+    double c[15];//feed concentration
     double refT=298.15;//reference temperature for thermodynamic properties (as ideal gas)
     double refP=1.01325e5;//reference pressure
     char option='s';//for asking for both states (liquid and gas) calculation, and state determination
@@ -3412,6 +3778,9 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
     double phiA,phiB;
     double Za,Zb;
     double Gr;//Modified reduced gibbs energy
+    GlobalOptSettings optSet;//settings for the parallel global optimizers
+    int parallelDone=0;//will be 1 if the parallel optimizer has been applied
+    getGlobalOptSettings(&optSet);
 
     //we clear the content of the results table
     for (i=0;i<ui->twMixCalc->rowCount();i++){
@@ -3433,10 +3802,22 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
     data.mix=mix;
     data.P=thB.P;
     data.T=thB.T;
+    trace.arg("T",thB.T);
+    trace.arg("P",thB.P);
+    trace.arg("numSubs",mix->numSubs);
 
-    if(ui->rbMixCalcStd->isChecked()) FF_TwoPhasesFlashPT(mix,&thB.T,&thB.P,c,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction);
-    else if(ui->rbMixCalcGlobalOptSA->isChecked()) FF_TwoPhasesFlashPTSA(&data,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction,&Gr);
-    else if(ui->rbMixCalcGlobalOptDE->isChecked()) FF_TwoPhasesFlashPTDE(&data,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction,&Gr);
+    if(ui->rbMixCalcStd->isChecked()) FF_PERF("FF_TwoPhasesFlashPT",FF_TwoPhasesFlashPT(mix,&thB.T,&thB.P,c,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction));
+    else if(ui->rbMixCalcGlobalOptSA->isChecked()){
+        if(ui->chbMixCalcParallel->isChecked()) parallelDone=FF_PERF("TwoPhasesFlashPTParallelSA",TwoPhasesFlashPTParallelSA(&data,&optSet,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction,&Gr));
+        if(parallelDone==0) FF_PERF("FF_TwoPhasesFlashPTSA",FF_TwoPhasesFlashPTSA(&data,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction,&Gr));
+    }
+    else if(ui->rbMixCalcGlobalOptDE->isChecked()){
+        if(ui->chbMixCalcParallel->isChecked()) parallelDone=FF_PERF("TwoPhasesFlashPTParallelDE",TwoPhasesFlashPTParallelDE(&data,&optSet,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction,&Gr));
+        if(parallelDone==0) FF_PERF("FF_TwoPhasesFlashPTDE",FF_TwoPhasesFlashPTDE(&data,thB.c,thA.c,thB.subsPhi,thA.subsPhi,&thA.fraction,&Gr));
+    }
+    if(parallelDone==1) mixShowSolverInfo(&mixTelem,NULL);
+    else if(ui->rbMixCalcStd->isChecked()) mixShowSolverInfo(NULL,"FF_TwoPhasesFlashPT");
+    else mixShowSolverInfo(NULL,ui->rbMixCalcGlobalOptSA->isChecked() ? "FF_TwoPhasesFlashPTSA" : "FF_TwoPhasesFlashPTDE");
 
     thB.fraction=1-thA.fraction;
     thB.MW=0;
@@ -3449,7 +3830,7 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
     th0A.MW=thA.MW;
     if(mix->thModelActEos==1){//if phi-phi used, use eos for the expected liquid phase
         option='s';
-        FF_MixVfromTPeos(mix,&thB.T,&thB.P,thB.c,&option,answerL,answerG,&state);
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thB.T,&thB.P,thB.c,&option,answerL,answerG,&state));
         if((state=='L')||(state=='l')||(state=='U')||(state=='u')){
             th0B.V=thB.V=answerL[0];
             Zb=answerL[2];
@@ -3461,12 +3842,12 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
             phiB=exp(answerG[1]+answerG[2]-1)/answerG[2];
         }
         ui->twMixCalc->item(6,2)->setText(QString::number(Zb));
-        FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thB.c,&refT,&refP,&th0B);
-        FF_MixThermoEOS(mix,&refT,&refP,&thB);
+        FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thB.c,&refT,&refP,&th0B));
+        FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thB));
     }
     if(mix->thModelActEos!=2){//If not LLE gamma-gamma used, use eos for the expected gas phase
         option='s';
-        FF_MixVfromTPeos(mix,&thA.T,&thA.P,thA.c,&option,answerL,answerG,&state);
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thA.T,&thA.P,thA.c,&option,answerL,answerG,&state));
         if((state=='L')||(state=='l')||(state=='U')||(state=='u')){
             th0A.V=thA.V=answerL[0];
             Za=answerL[2];
@@ -3478,8 +3859,8 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
             phiA=exp(answerG[1]+answerG[2]-1)/answerG[2];
         }
         ui->twMixCalc->item(6,1)->setText(QString::number(Za));
-        FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thA.c,&refT,&refP,&th0A);
-        FF_MixThermoEOS(mix,&refT,&refP,&thA);
+        FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thA.c,&refT,&refP,&th0A));
+        FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thA));
     }
     if(ui->rbMixCalcStd->isChecked()){
         Gr=0;
@@ -3490,10 +3871,10 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
     writeMixResultsTable(nPhases,mix,&th0A,&thA,&th0B,&thB,&th0C,&thC);
     ui->leMixCalcGibbs->setText(QString::number(Gr));
     if(mix->thModelActEos!=1){
-        FF_SubsActivityData actData[mix->numSubs];
+        FF_SubsActivityData actData[15];
         FF_ExcessData excData;
         //FF_Activity(mix,&thB.T,thB.c,actData);
-        FF_ActivityDerivatives(&mix->actModel,&mix->numSubs,mix->baseProp,mix->intParam,&mix->intForm,&thB.T,thB.c,actData,&excData);
+        FF_PERF("FF_ActivityDerivatives",FF_ActivityDerivatives(&mix->actModel,&mix->numSubs,mix->baseProp,mix->intParam,&mix->intForm,&thB.T,thB.c,actData,&excData));
         double gE=0;
         double hE=-thB.T*excData.dgE_dT;
         for (i=0;i<mix->numSubs;i++){
@@ -3506,6 +3887,8 @@ void FreeFluidsMainWindow::twMixCalc2PhFlashPT(){
 
 //Slot for mixture three phases P,T flash calculation, and display in table
 void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
+    perfStart("Three phases flash");
+    TraceScope trace("Three phases flash","GUI");
     //FF_VLflashPTGO();
     FF_FeedData data;
     //printf("Act/Eos: %i Mixrule: %i ActModel: %i form: %i 0: %f 1: %f\n",mix->thModelActEos,mix->mixRule,mix->actModel,mix->intForm,mix->intParam[0][1][0],mix->intParam[0][1][1]);
@@ -3542,8 +3925,12 @@ void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
     data.mix=mix;
     data.P=thA.P;
     data.T=thA.T;
+    trace.arg("T",thA.T);
+    trace.arg("P",thA.P);
+    trace.arg("numSubs",mix->numSubs);
 
-    FF_ThreePhasesFlashPTSA(&data,thA.c,thB.c,thC.c,thA.subsPhi,thB.subsPhi,thC.subsPhi,&thA.fraction,&thB.fraction,&Gr);
+    FF_PERF("FF_ThreePhasesFlashPTSA",FF_ThreePhasesFlashPTSA(&data,thA.c,thB.c,thC.c,thA.subsPhi,thB.subsPhi,thC.subsPhi,&thA.fraction,&thB.fraction,&Gr));
+    mixShowSolverInfo(NULL,"FF_ThreePhasesFlashPTSA");
     thC.fraction=1-thA.fraction-thB.fraction;
     thA.MW=0;
     thB.MW=0;
@@ -3559,7 +3946,7 @@ void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
 
     if(mix->thModelActEos==1){//if phi-phi used, use eos for the expected liquid phases
         option='s';
-        FF_MixVfromTPeos(mix,&thB.T,&thB.P,thB.c,&option,answerL,answerG,&state);
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thB.T,&thB.P,thB.c,&option,answerL,answerG,&state));
         if((state=='L')||(state=='l')||(state=='U')||(state=='u')){
             th0B.V=thB.V=answerL[0];
             Zb=answerL[2];
@@ -3571,10 +3958,10 @@ void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
             //phiB=exp(answerG[1]+answerG[2]-1)/answerG[2];
         }
         ui->twMixCalc->item(6,2)->setText(QString::number(Zb));
-        FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thB.c,&refT,&refP,&th0B);
-        FF_MixThermoEOS(mix,&refT,&refP,&thB);
+        FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thB.c,&refT,&refP,&th0B));
+        FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thB));
 
-        FF_MixVfromTPeos(mix,&thC.T,&thC.P,thC.c,&option,answerL,answerG,&state);
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thC.T,&thC.P,thC.c,&option,answerL,answerG,&state));
         if((state=='L')||(state=='l')||(state=='U')||(state=='u')){
             th0C.V=thC.V=answerL[0];
             Zc=answerL[2];
@@ -3586,13 +3973,13 @@ void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
             //phiC=exp(answerG[1]+answerG[2]-1)/answerG[2];
         }
         ui->twMixCalc->item(6,3)->setText(QString::number(Zc));
-        FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thC.c,&refT,&refP,&th0C);
-        FF_MixThermoEOS(mix,&refT,&refP,&thC);
+        FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thC.c,&refT,&refP,&th0C));
+        FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thC));
     }
 
     if(mix->thModelActEos!=2){//If not LLE gamma-gamma used, use eos for the expected gas phase
         option='s';
-        FF_MixVfromTPeos(mix,&thA.T,&thA.P,thA.c,&option,answerL,answerG,&state);
+        FF_PERF("FF_MixVfromTPeos",FF_MixVfromTPeos(mix,&thA.T,&thA.P,thA.c,&option,answerL,answerG,&state));
         if((state=='L')||(state=='l')||(state=='U')||(state=='u')){
             th0A.V=thA.V=answerL[0];
             Za=answerL[2];
@@ -3604,8 +3991,8 @@ void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
             //phiA=exp(answerG[1]+answerG[2]-1)/answerG[2];
         }
         ui->twMixCalc->item(6,1)->setText(QString::number(Za));
-        FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thA.c,&refT,&refP,&th0A);
-        FF_MixThermoEOS(mix,&refT,&refP,&thA);
+        FF_PERF("FF_MixIdealThermoEOS",FF_MixIdealThermoEOS(&mix->numSubs,mix->cp0Corr,thA.c,&refT,&refP,&th0A));
+        FF_PERF("FF_MixThermoEOS",FF_MixThermoEOS(mix,&refT,&refP,&thA));
     }
     if(ui->rbMixCalcStd->isChecked()){
         Gr=0;
@@ -3619,8 +4006,59 @@ void FreeFluidsMainWindow::twMixCalc3PhFlashPT(){
 
 }
 
+//Reads the settings for the parallel global optimizers
+void FreeFluidsMainWindow::getGlobalOptSettings(GlobalOptSettings *set){
+    GlobalOptDefaultSettings(set);
+    set->nThreads=ui->sbMixCalcThreads->value();
+    set->unifac=mixUnifacKernel();
+    set->telem=&mixTelem;
+}
+
+//The precompiled UNIFAC model for the selected activity model, or NULL if not available
+const UnifacKernel *FreeFluidsMainWindow::mixUnifacKernel(){
+    int i;
+    for(i=0;i<4;i++) if((mixUnifac[i].nSubs>0)&&(mixUnifac[i].nSubs==mix->numSubs)&&(mixUnifac[i].model==mix->actModel)) return &mixUnifac[i];
+    return NULL;
+}
+
+//Tangent plane distance minimization with the selected optimizer
+void FreeFluidsMainWindow::stabilityCheck(FF_FeedData *data,double *tpd,double tpdX[]){
+    GlobalOptSettings optSet;
+    int parallelDone=0;
+    getGlobalOptSettings(&optSet);
+    if(ui->chbMixCalcParallel->isChecked()){
+        if(ui->rbMixCalcGlobalOptSA->isChecked()) parallelDone=FF_PERF("StabilityCheckParallelSA",StabilityCheckParallelSA(data,&optSet,tpd,tpdX));
+        else if(ui->rbMixCalcGlobalOptDE->isChecked()) parallelDone=FF_PERF("StabilityCheckParallelDE",StabilityCheckParallelDE(data,&optSet,tpd,tpdX));
+    }
+    if(parallelDone==1){
+        mixShowSolverInfo(&mixTelem,NULL);
+        return;
+    }
+    if(ui->rbMixCalcGlobalOptSA->isChecked()) FF_PERF("FF_StabilityCheckSA",FF_StabilityCheckSA(data,tpd,tpdX));
+    else FF_PERF("FF_StabilityCheck",FF_StabilityCheck(data,tpd,tpdX));
+    mixShowSolverInfo(NULL,ui->rbMixCalcGlobalOptSA->isChecked() ? "FF_StabilityCheckSA" : "FF_StabilityCheck");
+}
+
+//Shows the convergence record of the last mixture calculation, with its iterations in the tool tip. ffRoutine is the
+//FreeFluidsC routine that did the calculation instead, if any, that does not give a record
+void FreeFluidsMainWindow::mixShowSolverInfo(const SolverTelemetry *tel,const char *ffRoutine){
+    QString text,detail;
+    if(tel!=NULL){
+        text=QString::fromStdString(SolverTelemetrySummary(tel));
+        detail=QString::fromStdString(SolverTelemetryDetail(tel));
+    }
+    if(ffRoutine!=NULL){
+        if(!text.isEmpty()) text+=". ";
+        text+=QString("Solved by %1 (FreeFluidsC, no convergence record)").arg(ffRoutine);
+    }
+    ui->leMixResSolverInfo->setText(text);
+    ui->leMixResSolverInfo->setCursorPosition(0);
+    ui->leMixResSolverInfo->setToolTip(detail.isEmpty() ? text : "<pre>"+detail.toHtmlEscaped()+"</pre>");
+}
+
 //Slot for checking stability of a composition
 void FreeFluidsMainWindow::mixCalcStabCheck(){
+    perfStart("Stability check");
     FF_FeedData data;
     int i;
     double tpd,tpdX[15];
@@ -3631,8 +4069,7 @@ void FreeFluidsMainWindow::mixCalcStabCheck(){
     for (i=0;i< mix->numSubs;i++){
         data.z[i]=ui->twMixComposition->item(i,5)->text().toDouble();//substance molar fraction
     }
-    if(ui->rbMixCalcGlobalOptSA->isChecked()) FF_StabilityCheckSA(&data,&tpd,tpdX);
-    else FF_StabilityCheck(&data,&tpd,tpdX);
+    stabilityCheck(&data,&tpd,tpdX);
 
     ui->leMixCalcStabResult->setText(QString::number(tpd));
 
@@ -3640,6 +4077,7 @@ void FreeFluidsMainWindow::mixCalcStabCheck(){
 
 //Slot for checking stability of the results obtained
 void FreeFluidsMainWindow::mixResStabCheck(){
+    perfStart("Results stability check");
     FF_FeedData data;
     int i;
     double tpd,tpdX[15];
@@ -3662,16 +4100,16 @@ void FreeFluidsMainWindow::mixResStabCheck(){
             data.z[i]=ui->twMixCalc->item(29+i,3)->text().toDouble();//substance molar fraction
         }
     }
-    if(ui->rbMixCalcGlobalOptSA->isChecked()) FF_StabilityCheckSA(&data,&tpd,tpdX);
-    else FF_StabilityCheck(&data,&tpd,tpdX);
+    stabilityCheck(&data,&tpd,tpdX);
     ui->leMixResStabResult->setText(QString::number(tpd));
 
 }
 
 //Slot for calculating transport properties
 void FreeFluidsMainWindow::mixResCalcTransport(){
+    perfStart("Transport properties");
     int i,j;
-    double c[mix->numSubs],P,T,V,visc,thCond,surfTens;//molar concentrations
+    double c[15],P,T,V,visc,thCond,surfTens;//molar concentrations
     if(ui->rbMixResPh1->isChecked()) j=1;
     else if(ui->rbMixResPh2->isChecked()) j=2;
     else if(ui->rbMixResPh3->isChecked()) j=3;
@@ -3680,7 +4118,7 @@ void FreeFluidsMainWindow::mixResCalcTransport(){
     T=273.15+ui->leMixCalcTemp->text().toDouble();
     if(ui->rbMixResAsLiq->isChecked()){
         int useParachor=1;
-        double rhoL,rhoG,y[mix->numSubs];
+        double rhoL,rhoG,y[15];
         if(j==2){
             rhoL=1e6/ui->twMixCalc->item(7,2)->text().toDouble();
             rhoG=1e6/ui->twMixCalc->item(7,1)->text().toDouble();
@@ -3691,29 +4129,216 @@ void FreeFluidsMainWindow::mixResCalcTransport(){
             rhoG=1e6/ui->twMixCalc->item(7,2)->text().toDouble();
             for (i=0;i<mix->numSubs;i++) y[i]=ui->twMixCalc->item(29+i,2)->text().toDouble();
         }
-        FF_MixLiqViscTeja(mix,&T,&P,c,&visc);
+        FF_PERF("FF_MixLiqViscTeja",FF_MixLiqViscTeja(mix,&T,&P,c,&visc));
         ui->twMixCalc->item(77,j)->setText(QString::number(visc));
-        FF_MixLiqThCondLi(mix,&T,&P,c,&thCond);
+        FF_PERF("FF_MixLiqThCondLi",FF_MixLiqThCondLi(mix,&T,&P,c,&thCond));
         ui->twMixCalc->item(78,j)->setText(QString::number(thCond));
         for (i=0;i<mix->numSubs;i++){
             if(!(mix->baseProp[i].Pa>0)) useParachor=0;
         }
         //FF_MixLiqSurfTensLinear(mix,&T,&P,c,&surfTens);
-        if(useParachor==0) FF_MixLiqSurfTensWinterfeld(mix,&T,&P,c,&surfTens);
-        else FF_MixLiqSurfTensMcLeod(mix,&rhoL,&rhoG,c,y,&surfTens);
+        if(useParachor==0) FF_PERF("FF_MixLiqSurfTensWinterfeld",FF_MixLiqSurfTensWinterfeld(mix,&T,&P,c,&surfTens));
+        else FF_PERF("FF_MixLiqSurfTensMcLeod",FF_MixLiqSurfTensMcLeod(mix,&rhoL,&rhoG,c,y,&surfTens));
         ui->twMixCalc->item(79,j)->setText(QString::number(surfTens));
     }
     else{
         //FF_MixGasViscTPcpWilke(mix,&T,&P,c,&visc);
-        FF_MixGasViscTPcpLucas(mix,&T,&P,c,&visc);
+        FF_PERF("FF_MixGasViscTPcpLucas",FF_MixGasViscTPcpLucas(mix,&T,&P,c,&visc));
         ui->twMixCalc->item(77,j)->setText(QString::number(visc));
-        FF_MixLpGasThCondTpMason(mix,&T,c,&thCond);
+        FF_PERF("FF_MixLpGasThCondTpMason",FF_MixLpGasThCondTpMason(mix,&T,c,&thCond));
         ui->twMixCalc->item(78,j)->setText(QString::number(thCond));
         ui->twMixCalc->item(79,j)->setText("");
     }
 
 }
 
+//Time taken by a parallel optimizer until its best values were within the tolerance
+static QString GlobalOptTolText(double tolTime){
+    if(tolTime<0) return QString("  tol. not reached");
+    return QString("  to tol.: %1 ms").arg(tolTime,0,'f',1);
+}
+
+//Compares time and Gibbs energy reached by the single thread and the parallel global optimizers, for the actual mixture and conditions.
+//FreeFluidsC does not report when its optimizers reach the tolerance, so the time to tol. of the serial runs is taken from
+//the parallel optimizers run with a single thread
+void FreeFluidsMainWindow::on_actionBenchmark_global_optimizers_triggered()
+{
+    FF_FeedData data;
+    GlobalOptSettings optSet;
+    QElapsedTimer timer;
+    QString report;
+    int i,nThreads;
+    double x[15],y[15],phiB[15],phiA[15],beta,Gr,tolTime;
+    data.mix=mix;
+    data.P=1e5*ui->leMixCalcPres->text().toDouble();
+    data.T=273.15+ui->leMixCalcTemp->text().toDouble();
+    for (i=0;i< mix->numSubs;i++) data.z[i]=ui->twMixComposition->item(i,5)->text().toDouble();
+    getGlobalOptSettings(&optSet);
+    optSet.tolTime=&tolTime;
+    nThreads=GlobalOptThreads(&optSet);
+    report=QString("Two phases P,T flash. %1 substances, T: %2 K, P: %3 Pa\n\n").arg(mix->numSubs).arg(data.T).arg(data.P);
+
+    timer.start();
+    FF_PERF("FF_TwoPhasesFlashPTSA",FF_TwoPhasesFlashPTSA(&data,x,y,phiB,phiA,&beta,&Gr));
+    report+=QString("S.A. single thread: %1 ms  to tol.: not reported  Gr: %2\n").arg(timer.elapsed()).arg(Gr,0,'g',10);
+    timer.start();
+    FF_PERF("FF_TwoPhasesFlashPTDE",FF_TwoPhasesFlashPTDE(&data,x,y,phiB,phiA,&beta,&Gr));
+    report+=QString("D.E. single thread: %1 ms  to tol.: not reported  Gr: %2\n").arg(timer.elapsed()).arg(Gr,0,'g',10);
+
+    optSet.nThreads=1;
+    timer.start();
+    if(TwoPhasesFlashPTParallelSA(&data,&optSet,x,y,phiB,phiA,&beta,&Gr)==0){
+        report+="\nThe parallel optimizers do not support phi-gamma models";
+        QMessageBox::information(this,"Global optimizers benchmark",report);
+        return;
+    }
+    report+=QString("Parallel tempering S.A., 1 thread: %1 ms%2  Gr: %3\n").arg(timer.elapsed()).arg(GlobalOptTolText(tolTime)).arg(Gr,0,'g',10);
+    optSet.nThreads=nThreads;
+    timer.start();
+    TwoPhasesFlashPTParallelSA(&data,&optSet,x,y,phiB,phiA,&beta,&Gr);
+    report+=QString("Parallel tempering S.A., %1 threads: %2 ms%3  Gr: %4\n").arg(nThreads).arg(timer.elapsed()).arg(GlobalOptTolText(tolTime)).arg(Gr,0,'g',10);
+    optSet.nThreads=1;
+    timer.start();
+    TwoPhasesFlashPTParallelDE(&data,&optSet,x,y,phiB,phiA,&beta,&Gr);
+    report+=QString("Parallel D.E., 1 thread: %1 ms%2  Gr: %3\n").arg(timer.elapsed()).arg(GlobalOptTolText(tolTime)).arg(Gr,0,'g',10);
+    optSet.nThreads=nThreads;
+    timer.start();
+    TwoPhasesFlashPTParallelDE(&data,&optSet,x,y,phiB,phiA,&beta,&Gr);
+    report+=QString("Parallel D.E., %1 threads: %2 ms%3  Gr: %4\n").arg(nThreads).arg(timer.elapsed()).arg(GlobalOptTolText(tolTime)).arg(Gr,0,'g',10);
+    QMessageBox::information(this,"Global optimizers benchmark",report);
+}
+
+//Checks the specialized cubic mixture fugacity kernel against the generic calculation, for the actual mixture and conditions
+void FreeFluidsMainWindow::on_actionCheck_cubic_mixture_kernel_triggered()
+{
+    CubicMixKernel ker;
+    QElapsedTimer timer;
+    QString report;
+    int i,nEval=10000;
+    double T,P,x[15],lnPhi[15],phi[15],Z,V,maxDiffRef,maxDiffGeneric;
+    char option='l',state;
+    qint64 tKernel,tGeneric;
+    P=1e5*ui->leMixCalcPres->text().toDouble();
+    T=273.15+ui->leMixCalcTemp->text().toDouble();
+    for (i=0;i< mix->numSubs;i++) x[i]=ui->twMixComposition->item(i,5)->text().toDouble();
+    if(CubicMixKernelInit(mix,&ker)==0){
+        QMessageBox::information(this,"Cubic mixture kernel","The kernel applies only to cubic EOS with VdW or PR mixing rules");
+        return;
+    }
+    CubicMixKernelCheck(mix,T,P,x,&maxDiffRef,&maxDiffGeneric);
+    report=QString("Max. ln(phi) difference against scalar reference: %1\n").arg(maxDiffRef);
+    report+=QString("Max. ln(phi) difference against FF_MixPhiEOS: %1\n\n").arg(maxDiffGeneric);
+    timer.start();
+    CubicMixKernelSetT(mix,T,&ker);
+    for(i=0;i<nEval;i++) CubicMixLnPhi(&ker,P,x,option,lnPhi,&Z,&V,&state);
+    tKernel=timer.nsecsElapsed();
+    timer.start();
+    for(i=0;i<nEval;i++) FF_MixPhiEOS(mix,&T,&P,x,&option,phi);
+    tGeneric=timer.nsecsElapsed();
+    report+=QString("Time per liquid evaluation. Kernel: %1 us  Generic: %2 us").arg(1e-3*tKernel/nEval).arg(1e-3*tGeneric/nEval);
+    QMessageBox::information(this,"Cubic mixture kernel",report);
+}
+
+void FreeFluidsMainWindow::on_actionCheck_UNIFAC_kernel_triggered()
+{
+    const UnifacKernel *current=mixUnifacKernel();
+    UnifacKernel *ker;
+    FF_SubsActivityData actData[15];
+    FF_ExcessData excData;
+    QElapsedTimer timer;
+    QString report;
+    int i,nEval=10000;
+    double T,x[15],lnGammaC[15],lnGammaR[15],maxDiff;
+    qint64 tKernel,tGeneric;
+    if(current==NULL){
+        QMessageBox::information(this,"UNIFAC kernel","No precompiled UNIFAC model for the selected activity model. Create the system first");
+        return;
+    }
+    ker=new UnifacKernel;
+    *ker=*current;
+    T=273.15+ui->leMixCalcTemp->text().toDouble();
+    for (i=0;i< mix->numSubs;i++) x[i]=ui->twMixComposition->item(i,5)->text().toDouble();
+    maxDiff=UnifacKernelCheck(mix,ker,T,x);
+    report=QString("Subgroups: %1  Main group pairs without parameters: %2\n").arg(ker->nSg).arg(ker->missing);
+    report+=QString("Max. ln(gamma) difference against FF_ActivityDerivatives: %1\n\n").arg(maxDiff);
+    timer.start();
+    for(i=0;i<nEval;i++) UnifacKernelLnGamma(ker,x,lnGammaC,lnGammaR);
+    tKernel=timer.nsecsElapsed();
+    timer.start();
+    for(i=0;i<nEval;i++) FF_ActivityDerivatives(&mix->actModel,&mix->numSubs,mix->baseProp,mix->intParam,&mix->intForm,&T,x,actData,&excData);
+    tGeneric=timer.nsecsElapsed();
+    report+=QString("Time per evaluation. Kernel: %1 us  Generic (with derivatives): %2 us").arg(1e-3*tKernel/nEval).arg(1e-3*tGeneric/nEval);
+    delete ker;
+    QMessageBox::information(this,"UNIFAC kernel",report);
+}
+
+//Database file the UNIFAC store is generated from. Empty if the database is not a file
+QString FreeFluidsMainWindow::unifacDbFile(){
+    return (db.driverName()=="QSQLITE") ? db.databaseName() : QString();
+}
+
+//Opens the UNIFAC store next to the database, generating it again if it is missing or does not match the database.
+//If it can not be written the store is left closed, and the parameters are read from the database
+void FreeFluidsMainWindow::openUnifacStore(){
+    QString dbFile=unifacDbFile();
+    QString path=UnifacStorePath(dbFile);
+    UnifacStoreClose(&unifacStore);
+    if(UnifacStoreOpen(path,dbFile,&unifacStore)==1) return;
+    if(WriteUnifacToBinary(&db,path)==1) UnifacStoreOpen(path,dbFile,&unifacStore);
+}
+
+void FreeFluidsMainWindow::on_actionRegenerate_UNIFAC_store_triggered()
+{
+    QElapsedTimer timer;
+    qint64 tWrite,tOpen;
+    int ok;
+    QString dbFile=unifacDbFile();
+    UnifacStoreClose(&unifacStore);
+    timer.start();
+    ok=WriteUnifacToBinary(&db,UnifacStorePath(dbFile));
+    tWrite=timer.nsecsElapsed();
+    timer.start();
+    if(ok==1) ok=UnifacStoreOpen(UnifacStorePath(dbFile),dbFile,&unifacStore);
+    tOpen=timer.nsecsElapsed();
+    if(ok==0){
+        QMessageBox::warning(this,"UNIFAC store","It has been impossible to write the UNIFAC store. The database will be used");
+        return;
+    }
+    QMessageBox::information(this,"UNIFAC store",QString("UNIFAC store written in %1 ms and opened in %2 ms").arg(1e-6*tWrite).arg(1e-6*tOpen));
+}
+
+void FreeFluidsMainWindow::on_actionBulk_Modelica_export_triggered()
+{
+    perfStart("Modelica bulk export");
+    std::vector<int> ids;
+    bool ok;
+    QString selection=QInputDialog::getText(this,"Bulk Modelica export","Product ids separated by commas, or SQL condition on Products:",QLineEdit::Normal,"",&ok);
+    if (!ok||(ModelicaSelectIds(selection,&db,&ids)==0)) return;
+    QString packageName=QInputDialog::getText(this,"Bulk Modelica export","Package name (Compatible with Modelica):",QLineEdit::Normal,"MediaData",&ok);
+    if (!ok) return;
+    QString fileName=QFileDialog::getSaveFileName(this,"Package file. The .sd files will be written in the same directory",packageName+".mo","*.mo");
+    if (fileName.isEmpty()) return;
+    QElapsedTimer timer;
+    timer.start();
+    int n=ModelicaBulkExport(ids,ModelicaName(packageName),fileName,0,&db);
+    if (n<0) QMessageBox::warning(this,"Bulk Modelica export","The package file could not be written");
+    else QMessageBox::information(this,"Bulk Modelica export",QString("%1 substances exported in %2 ms").arg(n).arg(timer.elapsed()));
+}
+
+//Starts recording a trace of the calculations, or stops it and saves it in Chrome trace format
+void FreeFluidsMainWindow::on_actionRecord_trace_toggled(bool checked)
+{
+    if (checked){
+        TraceStart();
+        return;
+    }
+    QString fileName=QFileDialog::getSaveFileName(this,"Trace file, for chrome://tracing or Perfetto","FreeFluidsTrace.json","*.json");
+    if (fileName.isEmpty()) fileName=QDir::temp().filePath("FreeFluidsTrace.json");
+    int n=TraceStop(fileName.toLocal8Bit().constData());
+    if (n<0) QMessageBox::warning(this,"Trace recording","The trace file could not be written");
+    else ui->statusBar->showMessage(QString("%1 trace events written to %2").arg(n).arg(fileName),10000);
+}
+
 void FreeFluidsMainWindow::on_actionDisplay_license_triggered()
 {
     QDialog *dia = new QDialog(this);
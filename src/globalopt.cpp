@@ -0,0 +1,479 @@
+/*
+ * globalopt.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "globalopt.h"
+#include "perftrace.h"
+#include "cubicmixkernel.h"
+#include "calcarena.h"
+
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+//Fills the settings with the default values
+void GlobalOptDefaultSettings(GlobalOptSettings *set){
+    set->nThreads=0;
+    set->seed=12345;
+    set->nPop=0;
+    set->nGen=500;
+    set->F=0.6;
+    set->CR=0.9;
+    set->nChains=8;
+    set->nRounds=200;
+    set->nSteps=50;
+    set->tempMin=1e-4;
+    set->tempMax=1e-1;
+    set->tol=1e-9;
+    set->unifac=NULL;
+    set->telem=NULL;
+    set->tolTime=NULL;
+}
+
+//Returns the number of threads that will be really used with the given settings
+int GlobalOptThreads(const GlobalOptSettings *set){
+    int n=set->nThreads;
+    if(n<1) n=std::thread::hardware_concurrency();
+    if(n<1) n=1;
+    return n;
+}
+
+//Executes task(0..nTasks-1,worker) distributing the tasks between nThreads threads. The calling thread works also, as worker 0.
+//The worker index is below nThreads, and lets the task use data private to its thread
+static void RunParallel(int nTasks,int nThreads,const std::function<void(int,int)> &task){
+    if(nThreads>nTasks) nThreads=nTasks;
+    if(nThreads<=1){
+        for(int i=0;i<nTasks;i++) task(i,0);
+        return;
+    }
+    std::atomic<int> next(0);
+    auto worker=[&](int w){
+        int i,n=0;
+        TraceScope trace("Global optimizer tasks","GlobalOpt");
+        while((i=next.fetch_add(1))<nTasks){
+            task(i,w);
+            n++;
+        }
+        trace.arg("tasks",n);
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(nThreads-1);
+    for(int i=1;i<nThreads;i++) pool.emplace_back(worker,i);
+    worker(0);
+    for(auto &t:pool) t.join();
+}
+
+//Objective functions. The variables are always in (0,1)
+//For the flash theta[i] is the fraction of substance i that goes to phase A (gas)
+//For the stability check theta[i] are the unnormalized trial phase molar fractions
+typedef struct{
+    FF_FeedData *data;
+    int n;
+    int stability;//0:flash, 1:tangent plane distance
+    double dRef[15];//for stability: ln(z)+ln(phi(z))
+    int useKernel;//1 if the specialized cubic kernel is used for the fugacity coefficients
+    CubicMixKernel ker;
+    int useUnifac;//1 if the precompiled UNIFAC kernel is used for the activity coefficients
+    UnifacKernel unifac;
+} GlobalOptProblem;
+
+//Natural logarithm of the fugacity coefficients of a phase. For gamma-gamma models the activity coefficients are used,
+//as the reference fugacity is the same for all phases. Returns 0 for phi-gamma models, that are not supported
+static int PhaseLnPhi(const GlobalOptProblem *prob,double x[],double lnPhi[]){
+    FF_FeedData *data=prob->data;
+    FF_MixData *mix=data->mix;
+    int i;
+    if(prob->useKernel==1){
+        double Z,V;
+        char state;
+        if(CubicMixLnPhi(&prob->ker,data->P,x,'s',lnPhi,&Z,&V,&state)==1) return 1;
+        //no root with physical volume, FreeFluidsC solves it
+    }
+    if(mix->thModelActEos==1){
+        char option='s';
+        double phi[15];
+        FF_MixPhiEOS(mix,&data->T,&data->P,x,&option,phi);
+        for(i=0;i<mix->numSubs;i++) lnPhi[i]=log(phi[i]);
+        return 1;
+    }
+    else if(prob->useUnifac==1){
+        double lnGammaC[15],lnGammaR[15];
+        UnifacKernelLnGamma(&prob->unifac,x,lnGammaC,lnGammaR);
+        for(i=0;i<mix->numSubs;i++) lnPhi[i]=lnGammaC[i]+lnGammaR[i];
+        return 1;
+    }
+    else if(mix->thModelActEos==2){
+        FF_SubsActivityData actData[15];
+        FF_ExcessData excData;
+        FF_ActivityDerivatives(&mix->actModel,&mix->numSubs,mix->baseProp,mix->intParam,&mix->intForm,&data->T,x,actData,&excData);
+        for(i=0;i<mix->numSubs;i++) lnPhi[i]=actData[i].lnGammaC+actData[i].lnGammaR+actData[i].lnGammaSG;
+        return 1;
+    }
+    return 0;
+}
+
+static const double thetaMin=1e-12;
+
+//Splits the feed between both phases according to theta
+static void FlashSplit(const GlobalOptProblem *prob,const double theta[],double x[],double y[],double *beta){
+    int i;
+    double nA[15];
+    *beta=0;
+    for(i=0;i<prob->n;i++){
+        nA[i]=theta[i]*prob->data->z[i];
+        *beta+=nA[i];
+    }
+    for(i=0;i<prob->n;i++){
+        if(*beta>thetaMin) y[i]=nA[i]/ *beta;
+        else y[i]=prob->data->z[i];
+        if(*beta<1-thetaMin) x[i]=(prob->data->z[i]-nA[i])/(1- *beta);
+        else x[i]=prob->data->z[i];
+    }
+}
+
+static double Objective(const GlobalOptProblem *prob,const double theta[]){
+    int i;
+    double lnPhiA[15],lnPhiB[15],f=0;
+    if(prob->stability==0){
+        double x[15],y[15],beta;
+        FlashSplit(prob,theta,x,y,&beta);
+        if((beta<=thetaMin)||(beta>=1-thetaMin)){//single phase
+            PhaseLnPhi(prob,prob->data->z,lnPhiB);
+            for(i=0;i<prob->n;i++) if(prob->data->z[i]>0) f+=prob->data->z[i]*(log(prob->data->z[i])+lnPhiB[i]);
+            return f;
+        }
+        PhaseLnPhi(prob,x,lnPhiB);
+        PhaseLnPhi(prob,y,lnPhiA);
+        for(i=0;i<prob->n;i++){
+            if(x[i]>0) f+=(1-beta)*x[i]*(log(x[i])+lnPhiB[i]);
+            if(y[i]>0) f+=beta*y[i]*(log(y[i])+lnPhiA[i]);
+        }
+    }
+    else{
+        double w[15],sum=0;
+        for(i=0;i<prob->n;i++) sum+=theta[i];
+        for(i=0;i<prob->n;i++) w[i]=theta[i]/sum;
+        PhaseLnPhi(prob,w,lnPhiA);
+        for(i=0;i<prob->n;i++) if(w[i]>0) f+=w[i]*(log(w[i])+lnPhiA[i]-prob->dRef[i]);
+    }
+    return f;
+}
+
+static int SetProblem(FF_FeedData *data,const GlobalOptSettings *set,int stability,GlobalOptProblem *prob){
+    int i;
+    double lnPhi[15];
+    prob->data=data;
+    prob->n=data->mix->numSubs;
+    prob->stability=stability;
+    prob->useKernel=0;
+    if((data->mix->thModelActEos==1)&&(CubicMixKernelInit(data->mix,&prob->ker)==1)){
+        CubicMixKernelSetT(data->mix,data->T,&prob->ker);
+        prob->useKernel=1;
+    }
+    prob->useUnifac=0;
+    if((data->mix->thModelActEos==2)&&(set->unifac!=NULL)&&(set->unifac->nSubs==data->mix->numSubs)&&(set->unifac->model==data->mix->actModel)){
+        prob->unifac=*set->unifac;
+        UnifacKernelSetT(&prob->unifac,data->T);
+        prob->useUnifac=1;
+    }
+    if(PhaseLnPhi(prob,data->z,lnPhi)==0) return 0;
+    for(i=0;i<prob->n;i++) prob->dRef[i]=log(data->z[i])+lnPhi[i];
+    return 1;
+}
+
+//Copy of the problem for a worker thread, with its own mixture and feed data. FreeFluidsC does not document
+//FF_MixPhiEOS and FF_ActivityDerivatives as reentrant, and they receive the FF_MixData by non const pointer,
+//so no two threads evaluate on the same structure. FF_MixData holds no pointers (it is saved with fwrite), so a plain copy is complete
+typedef struct{
+    FF_MixData mix;
+    FF_FeedData data;
+    GlobalOptProblem prob;
+} GlobalOptWorker;
+
+//Returns the problem to be used by every worker: worker 0, the calling thread, uses the original one
+static const GlobalOptProblem **WorkerProblems(CalcArena *arena,const GlobalOptProblem *prob,int nThreads){
+    const GlobalOptProblem **probs=CalcArenaNew<const GlobalOptProblem*>(arena,nThreads);
+    GlobalOptWorker *workers=CalcArenaNew<GlobalOptWorker>(arena,nThreads-1);
+    probs[0]=prob;
+    for(int i=1;i<nThreads;i++){
+        GlobalOptWorker *w=&workers[i-1];
+        w->mix=*prob->data->mix;
+        w->data=*prob->data;
+        w->data.mix=&w->mix;
+        w->prob=*prob;
+        w->prob.data=&w->data;
+        probs[i]=&w->prob;
+    }
+    return probs;
+}
+
+static double Clamp(double v){
+    if(v<thetaMin) return thetaMin;
+    if(v>1-thetaMin) return 1-thetaMin;
+    return v;
+}
+
+//Milliseconds elapsed since start
+static double ElapsedMs(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+}
+
+//Differential evolution, rand/1/bin. The trial vectors are generated serially from a single generator, and evaluated in parallel
+static double DifferentialEvolution(const GlobalOptProblem *prob,const GlobalOptSettings *set,double best[]){
+    int n=prob->n;
+    int nPop=set->nPop>0 ? set->nPop : 10*n;
+    if(nPop<5) nPop=5;
+    int nThreads=GlobalOptThreads(set);
+    if(nThreads>nPop) nThreads=nPop;
+    int i,j,g,iBest=0;
+    std::mt19937 gen(set->seed);
+    std::uniform_real_distribution<double> unif(0.0,1.0);
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+    CalcArena *arena=CalcArenaThread();//the working arrays are scratch memory, reused between calls
+    CalcArenaPos mark=CalcArenaMark(arena);
+    double *pop=CalcArenaNew<double>(arena,nPop*n),*trial=CalcArenaNew<double>(arena,nPop*n);
+    double *f=CalcArenaNew<double>(arena,nPop),*fTrial=CalcArenaNew<double>(arena,nPop);
+    const GlobalOptProblem **probs=WorkerProblems(arena,prob,nThreads);
+
+    for(i=0;i<nPop*n;i++) pop[i]=Clamp(unif(gen));
+    RunParallel(nPop,nThreads,[&](int k,int w){f[k]=Objective(probs[w],&pop[k*n]);});
+
+    for(g=0;g<set->nGen;g++){
+        for(i=0;i<nPop;i++){
+            int a,b,c;
+            do a=gen()%nPop; while(a==i);
+            do b=gen()%nPop; while((b==i)||(b==a));
+            do c=gen()%nPop; while((c==i)||(c==a)||(c==b));
+            int jRand=gen()%n;
+            for(j=0;j<n;j++){
+                if((j==jRand)||(unif(gen)<set->CR)){
+                    double v=pop[a*n+j]+set->F*(pop[b*n+j]-pop[c*n+j]);
+                    if(v<thetaMin) v=pop[i*n+j]*unif(gen);//bounce back inside the domain
+                    else if(v>1-thetaMin) v=pop[i*n+j]+(1-pop[i*n+j])*unif(gen);
+                    trial[i*n+j]=Clamp(v);
+                }
+                else trial[i*n+j]=pop[i*n+j];
+            }
+        }
+        RunParallel(nPop,nThreads,[&](int k,int w){fTrial[k]=Objective(probs[w],&trial[k*n]);});
+        for(i=0;i<nPop;i++){
+            if(fTrial[i]<=f[i]){
+                f[i]=fTrial[i];
+                for(j=0;j<n;j++) pop[i*n+j]=trial[i*n+j];
+            }
+        }
+        double fMin=f[0],fMax=f[0];
+        for(i=1;i<nPop;i++){
+            if(f[i]<fMin) fMin=f[i];
+            if(f[i]>fMax) fMax=f[i];
+        }
+        if(set->telem!=NULL) SolverTelemetryStep(set->telem,SOLVER_STEP_DE,fMax-fMin,fMin);
+        if((fMax-fMin)<set->tol){
+            if(set->telem!=NULL) SolverTelemetryEnd(set->telem,SOLVER_CONVERGED,fMax-fMin);
+            if(set->tolTime!=NULL) *set->tolTime=ElapsedMs(start);
+            break;
+        }
+    }
+    if(g>=set->nGen){
+        if(set->telem!=NULL) SolverTelemetryEnd(set->telem,SOLVER_MAXITER,set->telem->residual);
+        if(set->tolTime!=NULL) *set->tolTime=-1;
+    }
+    for(i=1;i<nPop;i++) if(f[i]<f[iBest]) iBest=i;
+    for(j=0;j<n;j++) best[j]=pop[iBest*n+j];
+    double fBest=f[iBest];
+    CalcArenaRelease(arena,&mark);
+    return fBest;
+}
+
+//Parallel tempering: every chain runs Metropolis steps at its own temperature, in parallel, with its own generator.
+//Between rounds, neighbour chains exchange their states. The whole schedule is run, it has converged if at the end
+//the best values found by the chains are within tol
+static double ParallelTempering(const GlobalOptProblem *prob,const GlobalOptSettings *set,double best[]){
+    int n=prob->n;
+    int nChains=set->nChains>1 ? set->nChains : 2;
+    int nThreads=GlobalOptThreads(set);
+    if(nThreads>nChains) nThreads=nChains;
+    int i,j,r;
+    CalcArena *arena=CalcArenaThread();//the working arrays are scratch memory, reused between calls
+    CalcArenaPos mark=CalcArenaMark(arena);
+    double *temp=CalcArenaNew<double>(arena,nChains),*step=CalcArenaNew<double>(arena,nChains);
+    double *x=CalcArenaNew<double>(arena,nChains*n),*f=CalcArenaNew<double>(arena,nChains);
+    double *xBest=CalcArenaNew<double>(arena,nChains*n),*fBest=CalcArenaNew<double>(arena,nChains);
+    std::mt19937 *gen=CalcArenaNew<std::mt19937>(arena,nChains);
+    const GlobalOptProblem **probs=WorkerProblems(arena,prob,nThreads);
+    std::mt19937 master(set->seed);
+    std::uniform_real_distribution<double> unif(0.0,1.0);
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+    double spread=HUGE_VAL,tolTime=-1;
+
+    for(i=0;i<nChains;i++){
+        temp[i]=set->tempMin*pow(set->tempMax/set->tempMin,(double)i/(nChains-1));
+        step[i]=0.05+0.45*i/(nChains-1);//hotter chains make larger moves
+        std::seed_seq seq{set->seed,(unsigned int)i+1};
+        gen[i].seed(seq);
+        for(j=0;j<n;j++) x[i*n+j]=Clamp(unif(gen[i]));
+    }
+    RunParallel(nChains,nThreads,[&](int k,int w){
+        f[k]=fBest[k]=Objective(probs[w],&x[k*n]);
+        for(int m=0;m<n;m++) xBest[k*n+m]=x[k*n+m];
+    });
+
+    for(r=0;r<set->nRounds;r++){
+        RunParallel(nChains,nThreads,[&](int k,int w){
+            std::normal_distribution<double> norm(0.0,step[k]);
+            std::uniform_real_distribution<double> u(0.0,1.0);
+            double cand[15],fCand;
+            int m,accepted=0;
+            for(int s=0;s<set->nSteps;s++){
+                for(m=0;m<n;m++) cand[m]=x[k*n+m];
+                m=gen[k]()%n;
+                cand[m]=cand[m]+norm(gen[k]);
+                if(cand[m]<thetaMin) cand[m]=-cand[m];//reflection on the bounds
+                else if(cand[m]>1) cand[m]=2-cand[m];
+                cand[m]=Clamp(cand[m]);
+                fCand=Objective(probs[w],cand);
+                if((fCand<=f[k])||(u(gen[k])<exp((f[k]-fCand)/temp[k]))){
+                    x[k*n+m]=cand[m];
+                    f[k]=fCand;
+                    accepted++;
+                    if(fCand<fBest[k]){
+                        fBest[k]=fCand;
+                        for(int l=0;l<n;l++) xBest[k*n+l]=x[k*n+l];
+                    }
+                }
+            }
+            //keeps the acceptance ratio near 0.3
+            if(accepted>0.4*set->nSteps) step[k]=step[k]*1.2;
+            else if(accepted<0.2*set->nSteps) step[k]=step[k]*0.8;
+            if(step[k]>0.5) step[k]=0.5;
+            else if(step[k]<1e-6) step[k]=1e-6;
+        });
+        double fMin=fBest[0],fMax=fBest[0];//the residual is the spread of the best values found by the chains
+        for(i=1;i<nChains;i++){
+            if(fBest[i]<fMin) fMin=fBest[i];
+            if(fBest[i]>fMax) fMax=fBest[i];
+        }
+        spread=fMax-fMin;
+        if((spread<set->tol)&&(tolTime<0)) tolTime=ElapsedMs(start);
+        if(set->telem!=NULL) SolverTelemetryStep(set->telem,SOLVER_STEP_SA,spread,fMin);
+        for(i=r%2;i<nChains-1;i=i+2){//alternating even and odd pairs
+            double delta=(f[i]-f[i+1])*(1/temp[i]-1/temp[i+1]);
+            if((delta>=0)||(unif(master)<exp(delta))){
+                for(j=0;j<n;j++){
+                    double aux=x[i*n+j];
+                    x[i*n+j]=x[(i+1)*n+j];
+                    x[(i+1)*n+j]=aux;
+                }
+                double aux=f[i];
+                f[i]=f[i+1];
+                f[i+1]=aux;
+            }
+        }
+    }
+    int iBest=0;
+    for(i=1;i<nChains;i++) if(fBest[i]<fBest[iBest]) iBest=i;
+    if(set->telem!=NULL) SolverTelemetryEnd(set->telem,(spread<set->tol) ? SOLVER_CONVERGED : SOLVER_MAXITER,spread);
+    if(set->tolTime!=NULL) *set->tolTime=(spread<set->tol) ? tolTime : -1;
+    for(j=0;j<n;j++) best[j]=xBest[iBest*n+j];
+    double fMin=fBest[iBest];
+    CalcArenaRelease(arena,&mark);
+    return fMin;
+}
+
+//Prepares the flash results from the optimum found
+static void FlashResults(const GlobalOptProblem *prob,const double theta[],double x[],double y[],double phiB[],double phiA[],double *beta){
+    int i;
+    double lnPhi[15];
+    FlashSplit(prob,theta,x,y,beta);
+    PhaseLnPhi(prob,x,lnPhi);
+    for(i=0;i<prob->n;i++) phiB[i]=exp(lnPhi[i]);
+    PhaseLnPhi(prob,y,lnPhi);
+    for(i=0;i<prob->n;i++) phiA[i]=exp(lnPhi[i]);
+}
+
+//Two phases P,T flash by parallel differential evolution. Returns 0 if the thermodynamic model is not supported
+int TwoPhasesFlashPTParallelDE(FF_FeedData *data,const GlobalOptSettings *set,double x[],double y[],double phiB[],double phiA[],double *beta,double *Gr){
+    GlobalOptProblem prob;
+    double theta[15];
+    if(set->telem!=NULL) SolverTelemetryBegin(set->telem,"TwoPhasesFlashPTParallelDE",SOLVER_STEP_RANDOM);
+    if(SetProblem(data,set,0,&prob)==0){
+        if(set->telem!=NULL) SolverTelemetryEnd(set->telem,SOLVER_UNSUPPORTED,0);
+        return 0;
+    }
+    *Gr=DifferentialEvolution(&prob,set,theta);
+    FlashResults(&prob,theta,x,y,phiB,phiA,beta);
+    return 1;
+}
+
+//Two phases P,T flash by parallel tempering simulated annealing. Returns 0 if the thermodynamic model is not supported
+int TwoPhasesFlashPTParallelSA(FF_FeedData *data,const GlobalOptSettings *set,double x[],double y[],double phiB[],double phiA[],double *beta,double *Gr){
+    GlobalOptProblem prob;
+    double theta[15];
+    if(set->telem!=NULL) SolverTelemetryBegin(set->telem,"TwoPhasesFlashPTParallelSA",SOLVER_STEP_RANDOM);
+    if(SetProblem(data,set,0,&prob)==0){
+        if(set->telem!=NULL) SolverTelemetryEnd(set->telem,SOLVER_UNSUPPORTED,0);
+        return 0;
+    }
+    *Gr=ParallelTempering(&prob,set,theta);
+    FlashResults(&prob,theta,x,y,phiB,phiA,beta);
+    return 1;
+}
+
+//Normalizes the optimum found for the stability check
+static void StabilityResults(const GlobalOptProblem *prob,const double theta[],double tpdX[]){
+    int i;
+    double sum=0;
+    for(i=0;i<prob->n;i++) sum+=theta[i];
+    for(i=0;i<prob->n;i++) tpdX[i]=theta[i]/sum;
+}
+
+//Tangent plane distance minimization by parallel differential evolution. Returns 0 if the thermodynamic model is not supported
+int StabilityCheckParallelDE(FF_FeedData *data,const GlobalOptSettings *set,double *tpd,double tpdX[]){
+    GlobalOptProblem prob;
+    double theta[15];
+    if(set->telem!=NULL) SolverTelemetryBegin(set->telem,"StabilityCheckParallelDE",SOLVER_STEP_RANDOM);
+    if(SetProblem(data,set,1,&prob)==0){
+        if(set->telem!=NULL) SolverTelemetryEnd(set->telem,SOLVER_UNSUPPORTED,0);
+        return 0;
+    }
+    *tpd=DifferentialEvolution(&prob,set,theta);
+    StabilityResults(&prob,theta,tpdX);
+    return 1;
+}
+
+//Tangent plane distance minimization by parallel tempering simulated annealing. Returns 0 if the thermodynamic model is not supported
+int StabilityCheckParallelSA(FF_FeedData *data,const GlobalOptSettings *set,double *tpd,double tpdX[]){
+    GlobalOptProblem prob;
+    double theta[15];
+    if(set->telem!=NULL) SolverTelemetryBegin(set->telem,"StabilityCheckParallelSA",SOLVER_STEP_RANDOM);
+    if(SetProblem(data,set,1,&prob)==0){
+        if(set->telem!=NULL) SolverTelemetryEnd(set->telem,SOLVER_UNSUPPORTED,0);
+        return 0;
+    }
+    *tpd=ParallelTempering(&prob,set,theta);
+    StabilityResults(&prob,theta,tpdX);
+    return 1;
+}
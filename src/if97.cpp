@@ -0,0 +1,490 @@
+/*
+ * if97.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "if97.h"
+
+#include <math.h>
+
+#define IF97_R 461.526 //specific gas constant, J/(kg*K)
+#define IF97_M (IF97_MW*1e-3) //kg/mol
+
+//Region 1: gamma=sum n*(7.1-pi)^I*(tau-1.222)^J, pi=p/16.53 MPa, tau=1386/T
+static const int if97I1[34]={0,0,0,0,0,0,0,0,1,1,1,1,1,1,2,2,2,2,2,3,3,3,4,4,4,5,8,8,21,23,29,30,31,32};
+static const int if97J1[34]={-2,-1,0,1,2,3,4,5,-9,-7,-1,0,1,3,-3,0,1,3,17,-4,0,6,-5,-2,10,-8,-11,-6,-29,-31,-38,-39,-40,-41};
+static const double if97N1[34]={0.14632971213167,-0.84548187169114,-0.37563603672040e1,0.33855169168385e1,-0.95791963387872,
+    0.15772038513228,-0.16616417199501e-1,0.81214629983568e-3,0.28319080123804e-3,-0.60706301565874e-3,-0.18990068218419e-1,
+    -0.32529748770505e-1,-0.21841717175414e-1,-0.52838357969930e-4,-0.47184321073267e-3,-0.30001780793026e-3,0.47661393906987e-4,
+    -0.44141845330846e-5,-0.72694996297594e-15,-0.31679644845054e-4,-0.28270797985312e-5,-0.85205128120103e-9,-0.22425281908000e-5,
+    -0.65171222895601e-6,-0.14341729937924e-12,-0.40516996860117e-6,-0.12734301741641e-8,-0.17424871230634e-9,-0.68762131295531e-18,
+    0.14478307828521e-19,0.26335781662795e-22,-0.11947622640071e-22,0.18228094581404e-23,-0.93537087292458e-25};
+
+//Region 2, ideal part: gamma0=ln(pi)+sum n0*tau^J0, and residual part: gammar=sum n*pi^I*(tau-0.5)^J. pi=p/1 MPa, tau=540/T
+static const int if97J0[9]={0,1,-5,-4,-3,-2,-1,2,3};
+static const double if97N0[9]={-0.96927686500217e1,0.10086655968018e2,-0.56087911283020e-2,0.71452738081455e-1,-0.40710498223928,
+    0.14240819171444e1,-0.43839511319450e1,-0.28408632460772,0.21268463753307e-1};
+static const int if97I2[43]={1,1,1,1,1,2,2,2,2,2,3,3,3,3,3,4,4,4,5,6,6,6,7,7,7,8,8,9,10,10,10,16,16,18,20,20,20,21,22,23,24,24,24};
+static const int if97J2[43]={0,1,2,3,6,1,2,4,7,36,0,1,3,6,35,1,2,3,7,3,16,35,0,11,25,8,36,13,4,10,14,29,50,57,20,35,48,21,53,39,26,40,58};
+static const double if97N2[43]={-0.17731742473213e-2,-0.17834862292358e-1,-0.45996013696365e-1,-0.57581259083432e-1,-0.50325278727930e-1,
+    -0.33032641670203e-4,-0.18948987516315e-3,-0.39392777243355e-2,-0.43797295650573e-1,-0.26674547914087e-4,0.20481737692309e-7,
+    0.43870667284435e-6,-0.32277677238570e-4,-0.15033924542148e-2,-0.40668253562649e-1,-0.78847309559367e-9,0.12790717852285e-7,
+    0.48225372718507e-6,0.22922076337661e-5,-0.16714766451061e-10,-0.21171472321355e-2,-0.23895741934104e2,-0.59059564324270e-17,
+    -0.12621808899101e-5,-0.38946842435739e-1,0.11256211360459e-10,-0.82311340897998e1,0.19809712802088e-7,0.10406965210174e-18,
+    -0.10234747095929e-12,-0.10018179379511e-8,-0.80882908646985e-10,0.10693031879409,-0.33662250574171,0.89185845355421e-24,
+    0.30629316876232e-12,-0.42002467698208e-5,-0.59056029685639e-25,0.37826947613457e-5,-0.12768608934681e-14,0.73087610595061e-28,
+    0.55414715350778e-16,-0.94369707241210e-6};
+
+//Region 4 and boundary between regions 2 and 3
+static const double if97N4[10]={0.11670521452767e4,-0.72421316703206e6,-0.17073846940092e2,0.12020824702470e5,-0.32325550322333e7,
+    0.14915108613530e2,-0.48232657361591e4,0.40511340542057e6,-0.23855557567849,0.65017534844798e3};
+static const double if97NB23[5]={0.34805185628969e3,-0.11671859879975e1,0.10192970039326e-2,0.57254459862746e3,0.13918839778870e2};
+
+//Backward T(p,h) of region 1: theta=sum n*pi^I*(eta+1)^J, pi=p/1 MPa, eta=h/2500 kJ/kg
+static const int if97I1ph[20]={0,0,0,0,0,0,1,1,1,1,1,1,1,2,2,3,3,4,5,6};
+static const int if97J1ph[20]={0,1,2,6,22,32,0,1,2,3,4,10,32,10,32,10,32,32,32,32};
+static const double if97N1ph[20]={-0.23872489924521e3,0.40421188637945e3,0.11349746881718e3,-0.58457616048039e1,-0.15285482413140e-3,
+    -0.10866707695377e-5,-0.13391744872602e2,0.43211039183559e2,-0.54010067170506e2,0.30535892203916e2,-0.65964749423638e1,
+    0.93965400878363e-2,0.11573647505340e-6,-0.25858641282073e-4,-0.40644363084799e-8,0.66456186191635e-7,0.80670734103027e-10,
+    -0.93477771213947e-12,0.58265442020601e-14,-0.15020185953503e-16};
+
+//Backward T(p,s) of region 1: theta=sum n*pi^I*(sigma+2)^J, sigma=s/1 kJ/(kg*K)
+static const int if97I1ps[20]={0,0,0,0,0,0,1,1,1,1,1,1,2,2,2,2,2,3,3,4};
+static const int if97J1ps[20]={0,1,2,3,11,31,0,1,2,3,12,31,0,1,2,9,31,10,32,32};
+static const double if97N1ps[20]={0.17478268058307e3,0.34806930892873e2,0.65292584978455e1,0.33039981775489,-0.19281382923196e-6,
+    -0.24909197244573e-22,-0.26107636489332,0.22592965981586,-0.64256463395226e-1,0.78876289270526e-2,0.35672110607366e-9,
+    0.17332496994895e-23,0.56608900654837e-3,-0.32635483139717e-3,0.44778286690632e-4,-0.51322156908507e-9,-0.42522657042207e-25,
+    0.26400441360689e-12,0.78124600459723e-28,-0.30732199903668e-30};
+
+//Backward T(p,h) of region 2, subregions a, b and c, and the B2bc boundary
+static const int if97I2aph[34]={0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2,3,3,4,4,4,5,5,5,6,6,7};
+static const int if97J2aph[34]={0,1,2,3,7,20,0,1,2,3,7,9,11,18,44,0,2,7,36,38,40,42,44,24,44,12,32,44,32,36,42,34,44,28};
+static const double if97N2aph[34]={0.10898952318288e4,0.84951654495535e3,-0.10781748091826e3,0.33153654801263e2,-0.74232016790248e1,
+    0.11765048724356e2,0.18445749355790e1,-0.41792700549624e1,0.62478196935812e1,-0.17344563108114e2,-0.20058176862096e3,
+    0.27196065473796e3,-0.45511318285818e3,0.30919688604755e4,0.25226640357872e6,-0.61707422868339e-2,-0.31078046629583,
+    0.11670873077107e2,0.12812798404046e9,-0.98554909623276e9,0.28224546973002e10,-0.35948971410703e10,0.17227349913197e10,
+    -0.13551334240775e5,0.12848734664650e8,0.13865724283226e1,0.23598832556514e6,-0.13105236545054e8,0.73999835474766e4,
+    -0.55196697030060e6,0.37154085996233e7,0.19127729239660e5,-0.41535164835634e6,-0.62459855192507e2};
+static const int if97I2bph[38]={0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,4,4,5,5,5,6,7,7,9,9};
+static const int if97J2bph[38]={0,1,2,12,18,24,28,40,0,2,6,12,18,24,28,40,2,8,18,40,1,2,12,24,2,12,18,24,28,40,18,24,40,28,2,28,1,40};
+static const double if97N2bph[38]={0.14895041079516e4,0.74307798314034e3,-0.97708318797837e2,0.24742464705674e1,-0.63281320016026,
+    0.11385952129658e1,-0.47811863648625,0.85208123431544e-2,0.93747147377932,0.33593118604916e1,0.33809355601454e1,
+    0.16844539671904,0.73875745236695,-0.47128737436186,0.15020273139707,-0.21764114219750e-2,-0.21810755324761e-1,
+    -0.10829784403677,-0.46333324635812e-1,0.71280351959551e-4,0.11032831789999e-3,0.18955248387902e-3,0.30891541160537e-2,
+    0.13555504554949e-2,0.28640237477456e-6,-0.10779857357512e-4,-0.76462712454814e-4,0.14052392818316e-4,-0.31083814331434e-4,
+    -0.10302738212103e-5,0.28217281635040e-6,0.12704902271945e-5,0.73803353468292e-7,-0.11030139238909e-7,-0.81456365207833e-13,
+    -0.25180545682962e-10,-0.17565233969407e-17,0.86934156344163e-14};
+static const int if97I2cph[23]={-7,-7,-6,-6,-5,-5,-2,-2,-1,-1,0,0,1,1,2,6,6,6,6,6,6,6,6};
+static const int if97J2cph[23]={0,4,0,2,0,2,0,1,0,2,0,1,4,8,4,0,1,4,10,12,16,20,22};
+static const double if97N2cph[23]={-0.32368398555242e13,0.73263350902181e13,0.35825089945447e12,-0.58340131851590e12,-0.10783068217470e11,
+    0.20825544563171e11,0.61074783564516e6,0.85977722535580e6,-0.25745723604170e5,0.31081088422714e5,0.12082315865936e4,
+    0.48219755109255e3,0.37966001272486e1,-0.10842984880077e2,-0.45364172676660e-1,0.14559115658698e-12,0.11261597407230e-11,
+    -0.17804982240686e-10,0.12324579690832e-6,-0.11606921130984e-5,0.27846367088554e-4,-0.59270038474176e-3,0.12918582991878e-2};
+static const double if97NB2bc[5]={0.90584278514723e3,-0.67955786399241,0.12809002730136e-3,0.26526571908428e4,0.45257578905948e1};
+
+//Backward T(p,s) of region 2, subregions a, b and c
+static const double if97I2aps[46]={-1.5,-1.5,-1.5,-1.5,-1.5,-1.5,-1.25,-1.25,-1.25,-1,-1,-1,-1,-1,-1,-0.75,-0.75,-0.5,-0.5,-0.5,-0.5,
+    -0.25,-0.25,-0.25,-0.25,0.25,0.25,0.25,0.25,0.5,0.5,0.5,0.5,0.5,0.5,0.5,0.75,0.75,0.75,0.75,1,1,1.25,1.25,1.5,1.5};
+static const int if97J2aps[46]={-24,-23,-19,-13,-11,-10,-19,-15,-6,-26,-21,-17,-16,-9,-8,-15,-14,-26,-13,-9,-7,-27,-25,-11,-6,1,4,8,11,
+    0,1,5,6,10,14,16,0,4,9,17,7,18,3,15,5,18};
+static const double if97N2aps[46]={-0.39235983861984e6,0.51526573827270e6,0.40482443161048e5,-0.32193790923902e3,0.96961424218694e2,
+    -0.22867846371773e2,-0.44942914124357e6,-0.50118336020166e4,0.35684463560015,0.44235335848190e5,-0.13673388811708e5,
+    0.42163260207864e6,0.22516925837475e5,0.47442144865646e3,-0.14931130797647e3,-0.19781126320452e6,-0.23554399470760e5,
+    -0.19070616302076e5,0.55375669883164e5,0.38293691437363e4,-0.60391860580567e3,0.19363102620331e4,0.42660643698610e4,
+    -0.59780638872718e4,-0.70401463926862e3,0.33836784107553e3,0.20862786635187e2,0.33834172656196e-1,-0.43124428414893e-4,
+    0.16653791356412e3,-0.13986292055898e3,-0.78849547999872,0.72132411753872e-1,-0.59754839398283e-2,-0.12141358953904e-4,
+    0.23227096733871e-6,-0.10538463566194e2,0.20718925496502e1,-0.72193155260427e-1,0.20749887081120e-6,-0.18340657911379e-1,
+    0.29036272348696e-6,0.21037527893619,0.25681239729999e-3,-0.12799002933781e-1,-0.82198102652018e-5};
+static const int if97I2bps[44]={-6,-6,-5,-5,-4,-4,-4,-3,-3,-3,-3,-2,-2,-2,-2,-1,-1,-1,-1,-1,0,0,0,0,0,0,0,1,1,1,1,1,1,2,2,2,3,3,3,4,4,5,5,5};
+static const int if97J2bps[44]={0,11,0,11,0,1,11,0,1,11,12,0,1,6,10,0,1,5,8,9,0,1,2,4,5,6,9,0,1,2,3,7,8,0,1,5,0,1,3,0,1,0,1,2};
+static const double if97N2bps[44]={0.31687665083497e6,0.20864175881858e2,-0.39859399803599e6,-0.21816058518877e2,0.22369785194242e6,
+    -0.27841703445817e4,0.99207436071480e1,-0.75197512299157e5,0.29708605951158e4,-0.34406878548526e1,0.38815564249115,
+    0.17511295085750e5,-0.14237112854449e4,0.10943803364167e1,0.89971619308495,-0.33759740098958e4,0.47162885818355e3,
+    -0.19188241993679e1,0.41078580492196,-0.33465378172097,0.13870034777505e4,-0.40663326195838e3,0.41727347159610e2,
+    0.21932549434532e1,-0.10320050009077e1,0.35882943516703,0.52511453726066e-2,0.12838916450705e2,-0.28642437219381e1,
+    0.56912683664855,-0.99962954584931e-1,-0.32632037778459e-2,0.23320922576723e-3,-0.15334809857450,0.29072288239902e-1,
+    0.37534702741167e-3,0.17296691702411e-2,-0.38556050844504e-3,-0.35017712292608e-4,-0.14566393631492e-4,0.56420857267269e-5,
+    0.41286150074605e-7,-0.20684671118824e-7,0.16409393674725e-8};
+static const int if97I2cps[30]={-2,-2,-1,0,0,0,0,1,1,1,1,2,2,2,3,3,3,4,4,4,5,5,5,6,6,7,7,7,7,7};
+static const int if97J2cps[30]={0,1,0,0,1,2,3,0,1,3,4,0,1,2,0,1,5,0,1,4,0,1,2,0,1,0,1,3,4,5};
+static const double if97N2cps[30]={0.90968501005365e3,0.24045667088420e4,-0.59162326387130e3,0.54145404128074e3,-0.27098308411192e3,
+    0.97976525097926e3,-0.46966772959435e3,0.14399274604723e2,-0.19104204230429e2,0.53299167111971e1,-0.21252975375934e2,
+    -0.31147334413760,0.60334840894623,-0.42764839702509e-1,0.58185597255259e-2,-0.14597008284753e-1,0.56631175631027e-2,
+    -0.76155864584577e-4,0.22440342919332e-3,-0.12561095013413e-4,0.63323132660934e-6,-0.20541989675375e-5,0.36405370390082e-7,
+    -0.29759897789215e-8,0.10136618529763e-7,0.59925719692351e-11,-0.20677870105164e-10,-0.20874278181886e-10,0.10162166825089e-9,
+    -0.16429828281347e-9};
+
+//Dimensionless Gibbs energy and its derivatives: g, g_pi, g_pipi, g_tau, g_tautau, g_pitau
+typedef struct{
+    double pi,tau;
+    double g,gp,gpp,gt,gtt,gpt;
+} IF97Gibbs;
+
+//Integer power, as the exponents of the tables are small integers
+static inline double IF97Pow(double x,int n){
+    double r=1;
+    if(n<0){
+        x=1/x;
+        n=-n;
+    }
+    while(n){
+        if(n&1) r*=x;
+        x*=x;
+        n>>=1;
+    }
+    return r;
+}
+
+static void IF97Gibbs1(double T,double P,IF97Gibbs *g){
+    g->pi=P/16.53e6;
+    g->tau=1386/T;
+    double a=7.1-g->pi,b=g->tau-1.222;
+    g->g=g->gp=g->gpp=g->gt=g->gtt=g->gpt=0;
+    for(int i=0;i<34;i++){
+        int I=if97I1[i],J=if97J1[i];
+        double aI=IF97Pow(a,I-2),bJ=IF97Pow(b,J-2);
+        double n=if97N1[i];
+        g->g+=n*aI*a*a*bJ*b*b;
+        g->gp-=n*I*aI*a*bJ*b*b;
+        g->gpp+=n*I*(I-1)*aI*bJ*b*b;
+        g->gt+=n*aI*a*a*J*bJ*b;
+        g->gtt+=n*aI*a*a*J*(J-1)*bJ;
+        g->gpt-=n*I*aI*a*J*bJ*b;
+    }
+}
+
+static void IF97Gibbs2(double T,double P,IF97Gibbs *g){
+    int i;
+    double pi=P/1e6,tau=540/T;
+    double b=tau-0.5;
+    g->pi=pi;
+    g->tau=tau;
+    g->g=log(pi);
+    g->gp=1/pi;
+    g->gpp=-1/(pi*pi);
+    g->gt=g->gtt=g->gpt=0;
+    for(i=0;i<9;i++){
+        int J=if97J0[i];
+        double tJ=IF97Pow(tau,J-2);
+        g->g+=if97N0[i]*tJ*tau*tau;
+        g->gt+=if97N0[i]*J*tJ*tau;
+        g->gtt+=if97N0[i]*J*(J-1)*tJ;
+    }
+    for(i=0;i<43;i++){
+        int I=if97I2[i],J=if97J2[i];
+        double pI=IF97Pow(pi,I-2),bJ=IF97Pow(b,J-2);
+        double n=if97N2[i];
+        g->g+=n*pI*pi*pi*bJ*b*b;
+        g->gp+=n*I*pI*pi*bJ*b*b;
+        g->gpp+=n*I*(I-1)*pI*bJ*b*b;
+        g->gt+=n*pI*pi*pi*J*bJ*b;
+        g->gtt+=n*pI*pi*pi*J*(J-1)*bJ;
+        g->gpt+=n*I*pI*pi*J*bJ*b;
+    }
+}
+
+//ln of the fugacity coefficient: the Gibbs energy minus the one of the ideal gas at the same T,P (region 2 ideal part)
+static double IF97LnPhi(double T,double P,const IF97Gibbs *g){
+    double pi=P/1e6,tau=540/T,g0=log(pi);
+    for(int i=0;i<9;i++) g0+=if97N0[i]*IF97Pow(tau,if97J0[i]);
+    return g->g-g0;
+}
+
+//Properties from the Gibbs energy. Ps is the reducing pressure and Ts the reducing temperature of the region
+static void IF97Props(double T,double P,double Ps,const IF97Gibbs *g,FF_ThermoProperties *th){
+    double RT=IF97_R*T,tau=g->tau;
+    double v=IF97_R*T*g->gp/Ps;
+    double dvdp=IF97_R*T*g->gpp/(Ps*Ps);
+    double dvdT=IF97_R*(g->gp-tau*g->gpt)/Ps;
+    double h=RT*tau*g->gt;
+    double s=IF97_R*(tau*g->gt-g->g);
+    double cp=-IF97_R*tau*tau*g->gtt;
+    double dPdv=1/dvdp,dPdT=-dvdT/dvdp;
+    double cv=cp+T*dvdT*dvdT/dvdp;
+    th->MW=IF97_MW;
+    th->T=T;
+    th->P=P;
+    th->V=v*IF97_M;
+    th->H=h*IF97_M;
+    th->U=(h-P*v)*IF97_M;
+    th->S=s*IF97_M;
+    th->G=RT*g->g*IF97_M;
+    th->A=th->G-P*th->V;
+    th->Cp=cp*IF97_M;
+    th->Cv=cv*IF97_M;
+    th->dP_dT=dPdT;
+    th->dP_dV=dPdv/IF97_M;
+    double w2=-v*v*dPdv*cp/cv;
+    th->SS=(w2>0) ? sqrt(w2) : NAN;
+    th->IT=th->V+T*th->dP_dT/th->dP_dV;
+    th->JT=-th->IT/th->Cp;
+}
+
+//Pressure of the B23 line at T, and temperature at P
+static double IF97PB23(double T){
+    return (if97NB23[0]+if97NB23[1]*T+if97NB23[2]*T*T)*1e6;
+}
+
+static double IF97TB23(double P){
+    return if97NB23[3]+sqrt((P*1e-6-if97NB23[4])/if97NB23[2]);
+}
+
+//Saturation pressure at T (Pa), by the region 4 equation. 0 outside its range
+double IF97Psat(double T){
+    const double *n=if97N4;
+    if((T<273.15)||(T>647.096)) return 0;
+    double th=T+n[8]/(T-n[9]);
+    double A=th*th+n[0]*th+n[1];
+    double B=n[2]*th*th+n[3]*th+n[4];
+    double C=n[5]*th*th+n[6]*th+n[7];
+    double x=2*C/(-B+sqrt(B*B-4*A*C));
+    return x*x*x*x*1e6;
+}
+
+//Saturation temperature at P (K), by the region 4 equation. 0 outside its range
+double IF97Tsat(double P){
+    const double *n=if97N4;
+    if((P<611.213)||(P>22.064e6)) return 0;
+    double be=pow(P*1e-6,0.25);
+    double E=be*be+n[2]*be+n[5];
+    double F=n[0]*be*be+n[3]*be+n[6];
+    double G=n[1]*be*be+n[4]*be+n[7];
+    double D=2*G/(-F-sqrt(F*F-4*E*G));
+    return (n[9]+D-sqrt((n[9]+D)*(n[9]+D)-4*(n[8]+n[9]*D)))/2;
+}
+
+//Region of the state: 1 liquid, 2 vapor, 3 near critical, 5 high temperature. 0 if outside the range of IF97
+int IF97Region(double T,double P){
+    if((T<273.15)||(P<=0)) return 0;
+    if(T<=623.15){
+        if(P>100e6) return 0;
+        return (P>=IF97Psat(T)) ? 1 : 2;
+    }
+    if(T<=1073.15){
+        if(P>100e6) return 0;
+        if(T<=863.15) return (P<=IF97PB23(T)) ? 2 : 3;
+        return 2;
+    }
+    if((T<=2273.15)&&(P<=50e6)) return 5;
+    return 0;
+}
+
+//Properties at T,P in regions 1 and 2. lnPhi receives ln of the fugacity coefficient, and can be NULL.
+//Returns the region, or 0 if the state is not in regions 1 or 2
+int IF97ThermoTP(double T,double P,FF_ThermoProperties *th,double *lnPhi){
+    IF97Gibbs g;
+    int region=IF97Region(T,P);
+    if(region==1){
+        IF97Gibbs1(T,P,&g);
+        IF97Props(T,P,16.53e6,&g,th);
+    }
+    else if(region==2){
+        IF97Gibbs2(T,P,&g);
+        IF97Props(T,P,1e6,&g,th);
+    }
+    else return 0;
+    if(lnPhi!=NULL) *lnPhi=IF97LnPhi(T,P,&g);
+    return region;
+}
+
+//Properties by the forward equation of region 1 or 2, without checking that T,P belong to it.
+//Used on the saturation and boundary lines, where IF97Region can fall on either side by rounding
+static void IF97RegionProps(int region,double T,double P,FF_ThermoProperties *th){
+    IF97Gibbs g;
+    if(region==1){
+        IF97Gibbs1(T,P,&g);
+        IF97Props(T,P,16.53e6,&g,th);
+    }
+    else{
+        IF97Gibbs2(T,P,&g);
+        IF97Props(T,P,1e6,&g,th);
+    }
+}
+
+//Saturated liquid and gas at T, up to 623.15 K. Returns 0 outside the range
+int IF97SatT(double T,double *P,FF_ThermoProperties *thL,FF_ThermoProperties *thG){
+    if((T<273.15)||(T>623.15)) return 0;
+    *P=IF97Psat(T);
+    IF97RegionProps(1,T,*P,thL);
+    IF97RegionProps(2,T,*P,thG);
+    return 1;
+}
+
+//Backward equations, with P in Pa, h in J/kg and s in J/(kg*K)
+static double IF97T1ph(double P,double h){
+    double pi=P*1e-6,eta=h/2500e3+1,T=0;
+    for(int i=0;i<20;i++) T+=if97N1ph[i]*IF97Pow(pi,if97I1ph[i])*IF97Pow(eta,if97J1ph[i]);
+    return T;
+}
+
+static double IF97T1ps(double P,double s){
+    double pi=P*1e-6,sigma=s*1e-3+2,T=0;
+    for(int i=0;i<20;i++) T+=if97N1ps[i]*IF97Pow(pi,if97I1ps[i])*IF97Pow(sigma,if97J1ps[i]);
+    return T;
+}
+
+static double IF97T2ph(double P,double h){
+    int i;
+    double pi=P*1e-6,eta=h/2000e3,T=0;
+    double hk=h*1e-3;
+    if(pi<=4){
+        for(i=0;i<34;i++) T+=if97N2aph[i]*IF97Pow(pi,if97I2aph[i])*IF97Pow(eta-2.1,if97J2aph[i]);
+    }
+    else if(pi<=if97NB2bc[0]+if97NB2bc[1]*hk+if97NB2bc[2]*hk*hk){
+        for(i=0;i<38;i++) T+=if97N2bph[i]*IF97Pow(pi-2,if97I2bph[i])*IF97Pow(eta-2.6,if97J2bph[i]);
+    }
+    else{
+        for(i=0;i<23;i++) T+=if97N2cph[i]*IF97Pow(pi+25,if97I2cph[i])*IF97Pow(eta-1.8,if97J2cph[i]);
+    }
+    return T;
+}
+
+static double IF97T2ps(double P,double s){
+    int i;
+    double pi=P*1e-6,T=0;
+    if(pi<=4){
+        double sigma=s/2e3-2;
+        for(i=0;i<46;i++) T+=if97N2aps[i]*pow(pi,if97I2aps[i])*IF97Pow(sigma,if97J2aps[i]);
+    }
+    else if(s>=5.85e3){
+        double sigma=10-s/0.7853e3;
+        for(i=0;i<44;i++) T+=if97N2bps[i]*IF97Pow(pi,if97I2bps[i])*IF97Pow(sigma,if97J2bps[i]);
+    }
+    else{
+        double sigma=2-s/2.9251e3;
+        for(i=0;i<30;i++) T+=if97N2cps[i]*IF97Pow(pi,if97I2cps[i])*IF97Pow(sigma,if97J2cps[i]);
+    }
+    return T;
+}
+
+//Liquid-gas mixture at the saturation of P, with gas fraction q
+static void IF97Mixture(const FF_ThermoProperties *thL,const FF_ThermoProperties *thG,double q,FF_ThermoProperties *th,double *liqFraction){
+    double T=thL->T,P=thL->P;
+    th->MW=IF97_MW;
+    th->T=T;
+    th->P=P;
+    th->V=thL->V+q*(thG->V-thL->V);
+    th->H=thL->H+q*(thG->H-thL->H);
+    th->U=thL->U+q*(thG->U-thL->U);
+    th->S=thL->S+q*(thG->S-thL->S);
+    th->A=th->U-T*th->S;
+    th->G=th->A+P*th->V;
+    th->Cp=th->Cv=th->SS=th->JT=th->IT=NAN;
+    th->dP_dT=(thG->H-thL->H)/(T*(thG->V-thL->V));//Clapeyron
+    th->dP_dV=0;
+    *liqFraction=1-q;
+}
+
+//State from P and H ('H'), or P and S ('S'), both molar
+static int IF97ThermoPX(double P,char var,double X,FF_ThermoProperties *th,double *liqFraction){
+    FF_ThermoProperties thL,thG;
+    double x=X/IF97_M,T,Ts,XL,XG;//specific
+    int region;
+    if((P<611.213)||(P>100e6)) return 0;
+    if(P<=IF97PB23(623.15)){
+        Ts=IF97Tsat(P);
+        if(Ts<=0) return 0;
+        IF97RegionProps(1,Ts,P,&thL);
+        IF97RegionProps(2,Ts,P,&thG);
+        XL=(var=='H') ? thL.H : thL.S;
+        XG=(var=='H') ? thG.H : thG.S;
+        if(!(XL<XG)) return 0;
+        if((X>=XL)&&(X<=XG)){
+            IF97Mixture(&thL,&thG,(X-XL)/(XG-XL),th,liqFraction);
+            return 4;
+        }
+        region=(X<XL) ? 1 : 2;
+    }
+    else{
+        FF_ThermoProperties thB;
+        IF97RegionProps(1,623.15,P,&thB);
+        if(((var=='H') ? thB.H : thB.S)>=X) region=1;
+        else{
+            IF97RegionProps(2,IF97TB23(P),P,&thB);
+            if(((var=='H') ? thB.H : thB.S)<=X) region=2;
+            else return 0;//region 3
+        }
+    }
+    if(region==1) T=(var=='H') ? IF97T1ph(P,x) : IF97T1ps(P,x);
+    else T=(var=='H') ? IF97T2ph(P,x) : IF97T2ps(P,x);
+    if(!(T>=273.15)||!(T<=1073.15)) return 0;
+    //one Newton correction on the forward equation of the region
+    IF97Gibbs g;
+    if(region==1) IF97Gibbs1(T,P,&g);
+    else IF97Gibbs2(T,P,&g);
+    double cp=-IF97_R*g.tau*g.tau*g.gtt;
+    if(var=='H') T+=(x-IF97_R*T*g.tau*g.gt)/cp;
+    else T+=(x-IF97_R*(g.tau*g.gt-g.g))*T/cp;
+    if(region==1) IF97Gibbs1(T,P,&g);
+    else IF97Gibbs2(T,P,&g);
+    IF97Props(T,P,(region==1) ? 16.53e6 : 1e6,&g,th);
+    *liqFraction=(region==1) ? 1 : 0;
+    return region;
+}
+
+//State from P and molar H. Returns the region (4 for liquid-gas mixtures), or 0 if not covered
+int IF97ThermoPH(double P,double H,FF_ThermoProperties *th,double *liqFraction){
+    return IF97ThermoPX(P,'H',H,th,liqFraction);
+}
+
+//State from P and molar S. Returns the region (4 for liquid-gas mixtures), or 0 if not covered
+int IF97ThermoPS(double P,double S,FF_ThermoProperties *th,double *liqFraction){
+    return IF97ThermoPX(P,'S',S,th,liqFraction);
+}
+
+//Compares IF97 with the IAPWS95 model of the engine on a T,P grid in regions 1 and 2. The IAPWS95 volume is solved by
+//Newton method on ln(V) from the IF97 one
+void IF97Check(const PureFlashEngine *eng,IF97Deviations *dev){
+    int i,j,it;
+    double maxV=-1;
+    dev->nPoints=0;
+    dev->maxV=dev->maxCp=dev->maxSS=dev->maxH=dev->maxS=0;
+    dev->worstT=dev->worstP=0;
+    for(i=0;i<40;i++) for(j=0;j<40;j++){
+        double T=273.16+(1073.15-273.16)*i/39;
+        double P=1e3*pow(1e5,(double)j/39);//1 kPa to 100 MPa
+        FF_ThermoProperties thI,th9;
+        if(IF97ThermoTP(T,P,&thI,NULL)==0) continue;
+        double lnV=log(thI.V);
+        for(it=0;it<50;it++){
+            PureFlashProps(eng,T,exp(lnV),&th9);
+            if(!(th9.dP_dV<0)) break;
+            double d=(th9.P-P)/(th9.V*th9.dP_dV);
+            lnV-=d;
+            if(fabs(d)<1e-12) break;
+        }
+        if(!(th9.dP_dV<0)||(it==50)) continue;
+        PureFlashProps(eng,T,exp(lnV),&th9);
+        double eV=fabs(thI.V/th9.V-1);
+        if(eV>maxV){
+            maxV=eV;
+            dev->worstT=T;
+            dev->worstP=P;
+        }
+        dev->maxV=maxV;
+        dev->maxH=fmax(dev->maxH,fabs(thI.H-th9.H));
+        dev->maxS=fmax(dev->maxS,fabs(thI.S-th9.S));
+        dev->maxCp=fmax(dev->maxCp,fabs(thI.Cp/th9.Cp-1));
+        dev->maxSS=fmax(dev->maxSS,fabs(thI.SS/th9.SS-1));
+        dev->nPoints++;
+    }
+}
@@ -1,8 +1,10 @@
 #include "freefluidsmainwindow.h"
+#include "benchmark.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    if (BenchRequested(argc,argv)) return BenchMain(argc,argv);//command line benchmarks, without window
     //QCoreApplication::setAttribute(Qt::AA_DontUseNativeMenuBar);
     QApplication a(argc, argv);
     FreeFluidsMainWindow w;
@@ -0,0 +1,217 @@
+/*
+ * modelicaexport.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "modelicaexport.h"
+#include "databasetools.h"
+#include "dbconnection.h"
+#include "perfcounters.h"
+
+#include <string.h>
+#include <map>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QtSql>
+
+static std::map<int,FF_SubstanceData*> modelicaCache;
+static std::mutex modelicaCacheMutex;
+
+//Converts a substance name to a valid Modelica identifier
+QString ModelicaName(const QString &name){
+    QString id;
+    for (int i=0;i<name.size();i++){
+        QChar ch=name[i];
+        if (((ch>='a')&&(ch<='z'))||((ch>='A')&&(ch<='Z'))||((ch>='0')&&(ch<='9'))) id+=ch;
+        else id+='_';
+    }
+    if (id.isEmpty()||id[0].isDigit()) id.prepend('_');
+    return id;
+}
+
+//Gives the substance a PR78 EOS from its basic data if it has no cubic EOS, as needed by ExternalMedia
+void ModelicaDefaultCubic(FF_SubstanceData *subs){
+    if ((subs->cubicData.eos==0)&&(subs->baseProp.MW>0)&&(subs->baseProp.Tc>0)&&(subs->baseProp.Pc>0)&&(subs->baseProp.w>0)){
+        subs->cubicData.eos=FF_PR78;
+        subs->cubicData.MW=subs->baseProp.MW;
+        subs->cubicData.Tc=subs->baseProp.Tc;
+        subs->cubicData.Pc=subs->baseProp.Pc;
+        subs->cubicData.w=subs->baseProp.w;
+        subs->cubicData.c=0;
+    }
+}
+
+//Writes a correlation as its form, coefficients and limits, with the names used by DataRecord
+static void ModelicaCorrelation(QTextStream &out,const char *prefix,const FF_Correlation *corr,int nCoef){
+    if (corr->form<=0) return;
+    out<<",\n    "<<prefix<<"Corr = "<<corr->form<<", "<<prefix<<"Coef = {";
+    for (int i=0;i<nCoef;i++) out<<corr->coef[i]<<((i<nCoef-1) ? ", " : "}, ");
+    out<<prefix<<"LimI = "<<corr->limI<<", "<<prefix<<"LimS = "<<corr->limS;
+}
+
+//Appends the FreeFluids.MediaCommon.DataRecord declaration of the substance to out
+void ModelicaDataRecord(const FF_SubstanceData *subs,const QString &name,const QString &description,QString *out){
+    QTextStream s(out);
+    s.setRealNumberNotation(QTextStream::ScientificNotation);
+    s<<"  constant FreeFluids.MediaCommon.DataRecord "<<name<<"(\n    name = \""<<name<<"\", description = \""<<description;
+    s<<"\", CAS = \""<<subs->CAS<<"\", family = "<<subs->baseProp.type<<", MW = "<<subs->baseProp.MW<<", molarMass = "<<subs->baseProp.MW*1e-3;
+    s<<", Tc = "<<subs->baseProp.Tc<<", criticalPressure = "<<subs->baseProp.Pc<<", Vc = "<<subs->baseProp.Vc<<", Zc = "<<subs->baseProp.Zc;
+    s<<", w = "<<subs->baseProp.w<<", Tb = "<<subs->baseProp.Tb;
+    if (subs->baseProp.mu<1.0e2) s<<", mu = "<<subs->baseProp.mu;
+    if (subs->lIsothComp.y>0) s<<", IsothComp = "<<subs->lIsothComp.y;
+    if (subs->baseProp.LnuA>0.0) s<<", lnuA = "<<subs->baseProp.LnuA<<", lnuB = "<<subs->baseProp.LnuB;
+    ModelicaCorrelation(s,"Cp0",&subs->cp0Corr,13);
+    ModelicaCorrelation(s,"Vp",&subs->vpCorr,6);
+    ModelicaCorrelation(s,"Bt",&subs->btCorr,6);
+    ModelicaCorrelation(s,"Hv",&subs->hVsatCorr,6);
+    ModelicaCorrelation(s,"lDens",&subs->lDensCorr,6);
+    ModelicaCorrelation(s,"lCp",&subs->lCpCorr,6);
+    ModelicaCorrelation(s,"lTfromHsat",&subs->lTfromHCorr,6);
+    ModelicaCorrelation(s,"lVisc",&subs->lViscCorr,6);
+    ModelicaCorrelation(s,"lThCond",&subs->lThCCorr,6);
+    ModelicaCorrelation(s,"lSurfTens",&subs->lSurfTCorr,6);
+    ModelicaCorrelation(s,"lBulkModR",&subs->lBulkModRCorr,6);
+    ModelicaCorrelation(s,"gSatDens",&subs->gDensCorr,6);
+    ModelicaCorrelation(s,"gVisc",&subs->gViscCorr,6);
+    ModelicaCorrelation(s,"gThCond",&subs->gThCCorr,6);
+    s<<"); \n";
+}
+
+//Product ids from a comma separated list of ids, or from a SQL condition on the Products table. Returns the number of ids
+int ModelicaSelectIds(const QString &selection,QSqlDatabase *db,std::vector<int> *ids){
+    QStringList items=selection.split(',',QString::SkipEmptyParts);
+    bool isList=(items.size()>0);
+    ids->clear();
+    for (int i=0;i<items.size();i++){
+        int id=items[i].trimmed().toInt(&isList);
+        if (!isList) break;
+        ids->push_back(id);
+    }
+    if (isList) return ids->size();
+    ids->clear();
+    QSqlQuery query(*db);
+    FF_PERF_SQL(query.exec("SELECT Id FROM Products WHERE ("+selection+") ORDER BY Name"));
+    while (query.next()) ids->push_back(query.value(0).toInt());
+    return ids->size();
+}
+
+//Substance loaded by GetPreferredData, kept in memory for the following exports. Can be called from several threads,
+//each one with its own connection
+const FF_SubstanceData *ModelicaCachedSubstance(int id,QSqlDatabase *db){
+    std::unique_lock<std::mutex> lock(modelicaCacheMutex);
+    std::map<int,FF_SubstanceData*>::iterator it=modelicaCache.find(id);
+    if (it!=modelicaCache.end()) return it->second;
+    lock.unlock();
+    FF_SubstanceData *subs=new FF_SubstanceData;
+    GetPreferredData(id,subs,db);
+    lock.lock();
+    it=modelicaCache.find(id);
+    if (it!=modelicaCache.end()){//loaded meanwhile by other thread
+        delete subs;
+        return it->second;
+    }
+    modelicaCache[id]=subs;
+    return subs;
+}
+
+//Empties the substance cache. To be called when the database is modified
+void ModelicaClearCache(){
+    std::lock_guard<std::mutex> lock(modelicaCacheMutex);
+    for (std::map<int,FF_SubstanceData*>::iterator it=modelicaCache.begin();it!=modelicaCache.end();++it) delete it->second;
+    modelicaCache.clear();
+}
+
+//Writes a package with the DataRecord of each substance to fileName, and a .sd file for each one in the same directory.
+//The substances are loaded and formatted by nThreads threads, the workers using their own database connection (see dbconnection.h).
+//nThreads=0 uses all the available cores. Returns the number of substances exported, or -1 if the package can not be written
+int ModelicaBulkExport(const std::vector<int> &ids,const QString &packageName,const QString &fileName,int nThreads,QSqlDatabase *db){
+    std::vector<const FF_SubstanceData*> loaded(ids.size()),subs;
+    std::vector<QString> names;
+    std::map<QString,int> used;
+    std::atomic<unsigned> next(0);
+    unsigned i;
+    if (nThreads<=0) nThreads=std::thread::hardware_concurrency();
+    if (nThreads<1) nThreads=1;
+    if ((unsigned)nThreads>ids.size()) nThreads=(ids.size()>0) ? ids.size() : 1;
+    //Runs the work on the calling thread and nThreads-1 more, taking items in order until all are done
+    auto parallel=[&](std::function<void(unsigned k,QSqlDatabase *conn)> work,unsigned n,bool useDb){
+        auto worker=[&](QSqlDatabase *conn){
+            unsigned k;
+            while ((k=next++)<n) work(k,conn);
+        };
+        std::vector<std::thread> threads;
+        next=0;
+        //each worker uses its own connection. If it can not be opened the worker leaves the items to the others
+        for (int t=1;t<nThreads;t++) threads.push_back(std::thread([&](){
+            QSqlDatabase *conn=useDb ? DbConnectionForThread() : NULL;
+            if ((conn!=NULL)||!useDb) worker(conn);
+        }));
+        worker(db);
+        for (unsigned t=0;t<threads.size();t++) threads[t].join();
+    };
+
+    parallel([&](unsigned k,QSqlDatabase *conn){loaded[k]=ModelicaCachedSubstance(ids[k],conn);},ids.size(),true);
+    for (i=0;i<ids.size();i++){
+        const FF_SubstanceData *s=loaded[i];
+        if (!(s->baseProp.MW>0)) continue;//not found
+        QString name=ModelicaName(QString::fromUtf8(s->name));
+        if (used[name]++>0) name+="_"+QString::number(s->id);
+        subs.push_back(s);
+        names.push_back(name);
+    }
+
+    //The records are formatted in parallel, each one in its own buffer
+    std::vector<QString> records(subs.size());
+    parallel([&](unsigned k,QSqlDatabase *){ModelicaDataRecord(subs[k],names[k],QString::fromUtf8(subs[k]->name),&records[k]);},subs.size(),false);
+
+    QString package;
+    int size=0;
+    for (i=0;i<records.size();i++) size+=records[i].size()+1;
+    package.reserve(size+256);
+    package+="within FreeFluids.MediaCommon;\npackage "+packageName+"\n";
+    for (i=0;i<records.size();i++) package+=records[i]+"\n";
+    package+="end "+packageName+";\n";
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return -1;
+    QByteArray bytes=package.toUtf8();
+    file.write(bytes);
+    file.close();
+
+    //binary substance files, for ExternalMedia
+    QDir dir=QFileInfo(fileName).absoluteDir();
+    for (i=0;i<subs.size();i++){
+        FF_SubstanceData data=*subs[i];
+        ModelicaDefaultCubic(&data);
+        QFile sd(dir.filePath(names[i]+".sd"));
+        if (sd.open(QFile::WriteOnly | QFile::Truncate)){
+            sd.write((const char*)&data,sizeof(FF_SubstanceData));
+            sd.close();
+        }
+    }
+    return subs.size();
+}
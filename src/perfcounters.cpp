@@ -0,0 +1,231 @@
+/*
+ * perfcounters.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "perfcounters.h"
+
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+//Counter of one thread. There is a single writer, so relaxed loads and stores are enough, without read-modify-write
+struct PerfCounter{
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> ns;
+    std::atomic<uint64_t> maxNs;
+    std::atomic<uint32_t> hist[PERF_BUCKETS];
+};
+
+//Table of counters of a thread
+struct PerfBlock{
+    std::atomic<unsigned> epoch;//action to which the counts belong
+    PerfCounter c[PERF_MAX_COUNTERS];
+};
+
+static struct{
+    std::mutex mutex;//for registration, and for the list of blocks
+    const char *names[PERF_MAX_COUNTERS];
+    enum PerfKind kinds[PERF_MAX_COUNTERS];
+    std::atomic<int> nCounters;
+    std::vector<PerfBlock*> blocks;//of the living threads
+    uint64_t retiredCount[PERF_MAX_COUNTERS],retiredNs[PERF_MAX_COUNTERS],retiredMax[PERF_MAX_COUNTERS];//of the finished threads
+    uint64_t retiredHist[PERF_MAX_COUNTERS][PERF_BUCKETS];
+    const char *action;
+    std::chrono::steady_clock::time_point actionStart;
+} perf;
+
+static std::atomic<unsigned> perfEpoch(1);
+static std::atomic<bool> perfEnabled(true);
+
+//Histogram bucket of a duration: two buckets per power of two
+static inline int PerfBucket(uint64_t ns){
+    if (ns<2) return 0;
+    int b=63;
+    while (!(ns>>b)) b--;
+    int i=2*b+(int)((ns>>(b-1))&1);
+    return i<PERF_BUCKETS ? i : PERF_BUCKETS-1;
+}
+
+//Upper limit of a bucket, ns
+static double PerfBucketTop(int i){
+    int b=i/2;
+    return (i%2) ? ldexp(1.0,b+1) : ldexp(1.5,b);
+}
+
+static void PerfBlockClear(PerfBlock *block){
+    for (int i=0;i<perf.nCounters.load(std::memory_order_relaxed);i++){
+        PerfCounter &c=block->c[i];
+        c.count.store(0,std::memory_order_relaxed);
+        c.ns.store(0,std::memory_order_relaxed);
+        c.maxNs.store(0,std::memory_order_relaxed);
+        for (int j=0;j<PERF_BUCKETS;j++) c.hist[j].store(0,std::memory_order_relaxed);
+    }
+}
+
+//Owner of the block of a thread. The block is created on the first record, and its counts are kept when the thread ends
+struct PerfThread{
+    PerfBlock *block;
+    PerfThread():block(NULL){}
+    PerfBlock *get(){
+        if (block==NULL){
+            block=new PerfBlock;
+            for (int i=0;i<PERF_MAX_COUNTERS;i++){
+                PerfCounter &c=block->c[i];
+                c.count.store(0);
+                c.ns.store(0);
+                c.maxNs.store(0);
+                for (int j=0;j<PERF_BUCKETS;j++) c.hist[j].store(0);
+            }
+            block->epoch.store(perfEpoch.load());
+            std::lock_guard<std::mutex> lock(perf.mutex);
+            perf.blocks.push_back(block);
+        }
+        return block;
+    }
+    ~PerfThread(){
+        if (block==NULL) return;
+        std::lock_guard<std::mutex> lock(perf.mutex);
+        perf.blocks.erase(std::remove(perf.blocks.begin(),perf.blocks.end(),block),perf.blocks.end());
+        if (block->epoch.load()==perfEpoch.load()){
+            for (int i=0;i<perf.nCounters.load();i++){
+                PerfCounter &c=block->c[i];
+                perf.retiredCount[i]+=c.count.load();
+                perf.retiredNs[i]+=c.ns.load();
+                perf.retiredMax[i]=std::max(perf.retiredMax[i],(uint64_t)c.maxNs.load());
+                for (int j=0;j<PERF_BUCKETS;j++) perf.retiredHist[i][j]+=c.hist[j].load();
+            }
+        }
+        delete block;
+    }
+};
+
+static thread_local PerfThread perfThread;
+
+//Registers a counter and returns its index. Called once per call site by the macros. Returns -1 if the table is full
+int PerfRegister(const char *name,enum PerfKind kind){
+    std::lock_guard<std::mutex> lock(perf.mutex);
+    int n=perf.nCounters.load();
+    for (int i=0;i<n;i++) if ((perf.kinds[i]==kind)&&(strcmp(perf.names[i],name)==0)) return i;//same function, other call site
+    if (n>=PERF_MAX_COUNTERS) return -1;
+    perf.names[n]=name;
+    perf.kinds[n]=kind;
+    perf.nCounters.store(n+1);
+    return n;
+}
+
+//Name and kind of a registered counter
+const char *PerfCounterName(int id){
+    return perf.names[id];
+}
+
+enum PerfKind PerfCounterKind(int id){
+    return perf.kinds[id];
+}
+
+//Adds a call of the given duration to the counter, in the table of the calling thread
+void PerfRecord(int id,uint64_t ns){
+    PerfBlock *block=perfThread.get();
+    unsigned epoch=perfEpoch.load(std::memory_order_relaxed);
+    if (block->epoch.load(std::memory_order_relaxed)!=epoch){
+        PerfBlockClear(block);
+        block->epoch.store(epoch,std::memory_order_release);
+    }
+    PerfCounter &c=block->c[id];
+    c.count.store(c.count.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+    c.ns.store(c.ns.load(std::memory_order_relaxed)+ns,std::memory_order_relaxed);
+    if (ns>c.maxNs.load(std::memory_order_relaxed)) c.maxNs.store(ns,std::memory_order_relaxed);
+    std::atomic<uint32_t> &h=c.hist[PerfBucket(ns)];
+    h.store(h.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+}
+
+//Enables or disables the recording. Enabled by default
+void PerfSetEnabled(bool enabled){
+    perfEnabled.store(enabled);
+}
+
+bool PerfEnabled(){
+    return perfEnabled.load(std::memory_order_relaxed);
+}
+
+//Starts a new action: the counters of all threads are cleared (each thread does it lazily, on its next record)
+void PerfBegin(const char *action){
+    std::lock_guard<std::mutex> lock(perf.mutex);
+    perfEpoch.fetch_add(1);
+    memset(perf.retiredCount,0,sizeof(perf.retiredCount));
+    memset(perf.retiredNs,0,sizeof(perf.retiredNs));
+    memset(perf.retiredMax,0,sizeof(perf.retiredMax));
+    memset(perf.retiredHist,0,sizeof(perf.retiredHist));
+    perf.action=action;
+    perf.actionStart=std::chrono::steady_clock::now();
+}
+
+//Totals of all the threads, including the finished ones, since the last PerfBegin
+void PerfSnapshot(PerfSnapshotData *snap){
+    std::lock_guard<std::mutex> lock(perf.mutex);
+    int i,j,n=perf.nCounters.load();
+    unsigned epoch=perfEpoch.load();
+    std::vector<uint64_t> count(perf.retiredCount,perf.retiredCount+n),ns(perf.retiredNs,perf.retiredNs+n),maxNs(perf.retiredMax,perf.retiredMax+n);
+    std::vector<uint64_t> hist(n*PERF_BUCKETS);
+    for (i=0;i<n;i++) for (j=0;j<PERF_BUCKETS;j++) hist[i*PERF_BUCKETS+j]=perf.retiredHist[i][j];
+    for (size_t k=0;k<perf.blocks.size();k++){
+        PerfBlock *block=perf.blocks[k];
+        if (block->epoch.load(std::memory_order_acquire)!=epoch) continue;//nothing recorded in this action
+        for (i=0;i<n;i++){
+            PerfCounter &c=block->c[i];
+            count[i]+=c.count.load(std::memory_order_relaxed);
+            ns[i]+=c.ns.load(std::memory_order_relaxed);
+            maxNs[i]=std::max(maxNs[i],(uint64_t)c.maxNs.load(std::memory_order_relaxed));
+            for (j=0;j<PERF_BUCKETS;j++) hist[i*PERF_BUCKETS+j]+=c.hist[j].load(std::memory_order_relaxed);
+        }
+    }
+    snap->action=perf.action;
+    snap->wall=(perf.action==NULL) ? 0 : std::chrono::duration<double>(std::chrono::steady_clock::now()-perf.actionStart).count();
+    snap->calls=snap->sqlTrips=0;
+    snap->sqlTime=0;
+    snap->stats.clear();
+    for (i=0;i<n;i++){
+        if (count[i]==0) continue;
+        PerfStat stat;
+        stat.name=perf.names[i];
+        stat.kind=perf.kinds[i];
+        stat.count=count[i];
+        stat.total=ns[i]*1e-9;
+        stat.mean=stat.total/count[i];
+        stat.max=maxNs[i]*1e-9;
+        uint64_t below=0,limit=count[i]-count[i]/100;//calls that must be under the percentile
+        for (j=0;j<PERF_BUCKETS;j++){
+            below+=hist[i*PERF_BUCKETS+j];
+            if (below>=limit) break;
+        }
+        stat.p99=std::min(PerfBucketTop(j<PERF_BUCKETS ? j : PERF_BUCKETS-1)*1e-9,stat.max);
+        if (stat.kind==PERF_SQL){
+            snap->sqlTrips+=stat.count;
+            snap->sqlTime+=stat.total;
+        }
+        else snap->calls+=stat.count;
+        snap->stats.push_back(stat);
+    }
+    std::sort(snap->stats.begin(),snap->stats.end(),[](const PerfStat &a,const PerfStat &b){return a.total>b.total;});
+}
@@ -0,0 +1,224 @@
+/*
+ * perftrace.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "perftrace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+typedef struct{
+    const char *name,*cat;
+    char ph;//'B' or 'E'
+    int nArgs;
+    double ts;//microseconds from TraceStart
+    const char *argName[TRACE_MAX_ARGS];
+    double argValue[TRACE_MAX_ARGS];
+} TraceEvent;
+
+//Events of a thread
+struct TraceBuffer{
+    int tid;
+    unsigned epoch;//recording to which the events belong
+    int dropped;//begin events not recorded because the buffer was full
+    std::vector<int> open;//begin events without end. -1 for the dropped ones
+    std::vector<TraceEvent> events;
+};
+
+std::atomic<bool> traceEnabled(false);
+
+static struct{
+    std::mutex mutex;//for the lists of buffers
+    std::vector<TraceBuffer*> buffers;//of the living threads
+    std::vector<TraceBuffer*> retired;//of the finished threads, for the current recording
+    int nThreads;
+    int mainTid;
+    std::chrono::steady_clock::time_point start;
+} trace;
+
+static std::atomic<unsigned> traceEpoch(0);
+
+//Owner of the buffer of a thread. The buffer is created on the first event, and kept until TraceStop if the thread ends
+struct TraceThread{
+    TraceBuffer *buffer;
+    TraceThread():buffer(NULL){}
+    TraceBuffer *get(){
+        if (buffer==NULL){
+            buffer=new TraceBuffer;
+            buffer->epoch=traceEpoch.load();
+            buffer->dropped=0;
+            std::lock_guard<std::mutex> lock(trace.mutex);
+            buffer->tid=++trace.nThreads;
+            trace.buffers.push_back(buffer);
+        }
+        else if (buffer->epoch!=traceEpoch.load(std::memory_order_relaxed)){//first event of a new recording
+            buffer->epoch=traceEpoch.load();
+            buffer->dropped=0;
+            buffer->open.clear();
+            buffer->events.clear();
+        }
+        return buffer;
+    }
+    ~TraceThread(){
+        if (buffer==NULL) return;
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        trace.buffers.erase(std::remove(trace.buffers.begin(),trace.buffers.end(),buffer),trace.buffers.end());
+        if ((buffer->epoch==traceEpoch.load())&&!buffer->events.empty()) trace.retired.push_back(buffer);
+        else delete buffer;
+    }
+};
+
+static thread_local TraceThread traceThread;
+
+static double TraceNow(){
+    return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-trace.start).count();
+}
+
+//Starts recording, discarding any previous events. The calling thread is named as the main one
+void TraceStart(){
+    traceEnabled.store(false);
+    {
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        for (size_t i=0;i<trace.retired.size();i++) delete trace.retired[i];
+        trace.retired.clear();
+        trace.start=std::chrono::steady_clock::now();
+        traceEpoch.fetch_add(1);
+    }
+    trace.mainTid=traceThread.get()->tid;
+    traceEnabled.store(true);
+}
+
+//Appends a begin event to the buffer of the calling thread and returns its position, or -1 if not recorded.
+//The name and category must be string literals, or live until TraceStop
+int TraceBegin(const char *name,const char *cat){
+    TraceBuffer *buf=traceThread.get();
+    if (buf->events.size()>=TRACE_MAX_EVENTS){
+        buf->dropped++;
+        buf->open.push_back(-1);
+        return -1;
+    }
+    TraceEvent ev;
+    ev.name=name;
+    ev.cat=cat;
+    ev.ph='B';
+    ev.nArgs=0;
+    ev.ts=TraceNow();
+    buf->events.push_back(ev);
+    buf->open.push_back((int)buf->events.size()-1);
+    return (int)buf->events.size()-1;
+}
+
+//Adds an argument to a recorded begin event of the calling thread. It can be done at any moment before TraceStop
+void TraceArg(int event,const char *name,double value){
+    TraceBuffer *buf=traceThread.get();
+    if ((event<0)||(event>=(int)buf->events.size())) return;//from a previous recording
+    TraceEvent &ev=buf->events[event];
+    if (ev.nArgs>=TRACE_MAX_ARGS) return;
+    ev.argName[ev.nArgs]=name;
+    ev.argValue[ev.nArgs]=value;
+    ev.nArgs++;
+}
+
+//Appends the end event of the last begin event of the calling thread
+void TraceEnd(){
+    TraceBuffer *buf=traceThread.get();
+    if (buf->open.empty()) return;//begun in a previous recording
+    int begin=buf->open.back();
+    buf->open.pop_back();
+    if (begin<0) return;
+    TraceEvent ev;
+    ev.name=buf->events[begin].name;
+    ev.cat=buf->events[begin].cat;
+    ev.ph='E';
+    ev.nArgs=0;
+    ev.ts=TraceNow();
+    buf->events.push_back(ev);
+}
+
+//Writes a string literal as JSON
+static void TraceWriteString(FILE *f,const char *s){
+    fputc('"',f);
+    for (;*s;s++){
+        if ((*s=='"')||(*s=='\\')) fputc('\\',f);
+        if ((unsigned char)*s>=32) fputc(*s,f);
+    }
+    fputc('"',f);
+}
+
+//Stops recording and writes the events to the file. To be called when no calculation is running. Returns the number
+//of events written, or -1 if the file could not be written
+int TraceStop(const char *fileName){
+    traceEnabled.store(false);
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    unsigned epoch=traceEpoch.load();
+    std::vector<TraceBuffer*> all=trace.retired;
+    for (size_t i=0;i<trace.buffers.size();i++) if (trace.buffers[i]->epoch==epoch) all.push_back(trace.buffers[i]);
+    FILE *f=fopen(fileName,"w");
+    int n=0,dropped=0;
+    if (f==NULL) return -1;
+    fprintf(f,"{\"traceEvents\":[\n");
+    fprintf(f,"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"FreeFluidsGui\"}}",trace.mainTid);
+    for (size_t i=0;i<all.size();i++){
+        TraceBuffer *buf=all[i];
+        fprintf(f,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":",buf->tid);
+        if (buf->tid==trace.mainTid) fprintf(f,"\"Main\"}}");
+        else fprintf(f,"\"Worker %i\"}}",buf->tid);
+        for (size_t j=0;j<buf->events.size();j++){
+            const TraceEvent &ev=buf->events[j];
+            fprintf(f,",\n{\"name\":");
+            TraceWriteString(f,ev.name);
+            fprintf(f,",\"cat\":");
+            TraceWriteString(f,ev.cat);
+            fprintf(f,",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%i",ev.ph,ev.ts,buf->tid);
+            if (ev.nArgs>0){
+                fprintf(f,",\"args\":{");
+                for (int k=0;k<ev.nArgs;k++){
+                    if (k>0) fputc(',',f);
+                    TraceWriteString(f,ev.argName[k]);
+                    if (std::isfinite(ev.argValue[k])) fprintf(f,":%.10g",ev.argValue[k]);
+                    else fprintf(f,":null");//nan and inf are not valid JSON
+                }
+                fputc('}',f);
+            }
+            fputc('}',f);
+            n++;
+        }
+        dropped+=buf->dropped;
+    }
+    fprintf(f,"\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%i}}\n",dropped);
+    int ok=(ferror(f)==0);
+    fclose(f);
+    for (size_t i=0;i<trace.retired.size();i++) delete trace.retired[i];
+    trace.retired.clear();
+    for (size_t i=0;i<trace.buffers.size();i++){//free the memory of the living threads, it will not be used again
+        trace.buffers[i]->events.clear();
+        trace.buffers[i]->events.shrink_to_fit();
+        trace.buffers[i]->open.clear();
+    }
+    return ok ? n : -1;
+}
@@ -0,0 +1,530 @@
+/*
+ * pureflash.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "pureflash.h"
+#include "satcache.h"
+#include "perftrace.h"
+#include "FFphysprop.h"
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define PURE_FLASH_BLOCK 64 //points taken by a thread each time
+
+//Ideal gas part at T,V
+static void PureFlashIdeal(const PureFlashEngine *eng,double T,double V,FF_ThermoProperties *th0){
+    double refT=eng->refT,refP=eng->refP;
+    th0->MW=eng->MW;
+    th0->T=T;
+    th0->V=V;
+    th0->P=R*T/V;
+    if(eng->water==1) FF_IdealThermoWater(th0);
+    else FF_IdealThermoEOS(&eng->subs->cp0Corr.form,eng->subs->cp0Corr.coef,&refT,&refP,th0);
+}
+
+//Thermodynamic properties at T,V with the model class of the engine
+template<class Model> static void PureFlashPropsModel(const PureFlashEngine *eng,double T,double V,FF_ThermoProperties *th){
+    FF_ThermoProperties th0;
+    double r[6];
+    PureFlashIdeal(eng,T,V,&th0);
+    EosKernelModel<Model>::Get(&eng->ker).ArrDer(T,V,r);
+    double RT=R*T;
+    double Z=1-V*r[1];
+    double Ur=-RT*T*r[3];
+    double Cv0=th0.Cp-R;
+    th->MW=eng->MW;
+    th->T=T;
+    th->V=V;
+    th->P=RT*(1/V-r[1]);
+    th->H=th0.H+Ur+RT*(Z-1);
+    th->U=th0.H-RT+Ur;
+    th->S=th0.S-R*(T*r[3]+r[0]);
+    th->A=th->U-T*th->S;
+    th->G=th->A+th->P*V;
+    th->Cv=Cv0-R*T*(2*r[3]+T*r[4]);
+    th->dP_dT=R*(1/V-r[1])-RT*r[5];
+    th->dP_dV=RT*(-1/(V*V)-r[2]);
+    th->Cp=th->Cv-T*th->dP_dT*th->dP_dT/th->dP_dV;
+    th->IT=V+T*th->dP_dT/th->dP_dV;
+    th->JT=-th->IT/th->Cp;
+    double ss2=-th->Cp/th->Cv*th->dP_dV*V*V/(eng->MW*1e-3);
+    th->SS=(ss2>0) ? sqrt(ss2) : NAN;
+}
+
+template<class Model> struct PureFlashPropsOp{
+    static void Run(const PureFlashEngine *eng,double T,double V,FF_ThermoProperties *th){
+        PureFlashPropsModel<Model>(eng,T,V,th);
+    }
+};
+
+//Thermodynamic properties at T,V with the model of the engine
+void PureFlashProps(const PureFlashEngine *eng,double T,double V,FF_ThermoProperties *th){
+    EosKernelDispatch<PureFlashPropsOp>(&eng->ker,eng,T,V,th);
+}
+
+//Value of a variable of the state, and its derivatives with respect to T and ln(V)
+static double PureFlashVar(char var,const FF_ThermoProperties *th,double *dT,double *dLnV){
+    double T=th->T,V=th->V;
+    switch(var){
+    case 'P':
+        *dT=th->dP_dT;
+        *dLnV=V*th->dP_dV;
+        return th->P;
+    case 'T':
+        *dT=1;
+        *dLnV=0;
+        return T;
+    case 'V':
+        *dT=0;
+        *dLnV=V;
+        return V;
+    case 'H':
+        *dT=th->Cv+V*th->dP_dT;
+        *dLnV=V*(T*th->dP_dT+V*th->dP_dV);
+        return th->H;
+    case 'S':
+        *dT=th->Cv/T;
+        *dLnV=V*th->dP_dT;
+        return th->S;
+    default://'U'
+        *dT=th->Cv;
+        *dLnV=V*(T*th->dP_dT-th->P);
+        return th->U;
+    }
+}
+
+//The two known variables of the specification
+static void PureFlashSpecVars(enum PureFlashSpec spec,char var[2]){
+    static const char vars[7][2]={{'P','H'},{'P','S'},{'P','U'},{'T','S'},{'U','V'},{'V','H'},{'V','S'}};
+    var[0]=vars[spec][0];
+    var[1]=vars[spec][1];
+    if(spec==PURE_FLASH_UV){//V first, as the other V specifications
+        var[0]='V';
+        var[1]='U';
+    }
+}
+
+//Newton method on T and ln(V) for the two known variables. Steps are limited, and shortened when they enter the
+//mechanically unstable region. th receives the properties at the solution
+template<class Model> static int PureFlashNewton(const PureFlashEngine *eng,const char var[2],const double target[2],double *T,double *V,FF_ThermoProperties *th){
+    int it,k;
+    double lnV=log(*V);
+    PureFlashPropsModel<Model>(eng,*T,*V,th);
+    for(it=0;it<60;it++){
+        double f[2],J[2][2];
+        for(k=0;k<2;k++) f[k]=PureFlashVar(var[k],th,&J[k][0],&J[k][1])-target[k];
+        double det=J[0][0]*J[1][1]-J[0][1]*J[1][0];
+        if(!(fabs(det)>0)) return 0;
+        double dT=-(f[0]*J[1][1]-f[1]*J[0][1])/det;
+        double dLnV=-(J[0][0]*f[1]-J[1][0]*f[0])/det;
+        int done=(fabs(dT)<=1e-10* *T)&&(fabs(dLnV)<=1e-10);
+        double s=1;
+        if(fabs(dT)>0.1* *T) s=0.1* *T/fabs(dT);
+        if(fabs(dLnV)*s>0.5) s=0.5/fabs(dLnV);
+        for(k=0;k<20;k++){
+            double Tn=*T+s*dT,lnVn=lnV+s*dLnV;
+            if(Tn>0){
+                PureFlashPropsModel<Model>(eng,Tn,exp(lnVn),th);
+                if((th->dP_dV<0)&&(th->H==th->H)){
+                    *T=Tn;
+                    lnV=lnVn;
+                    break;
+                }
+            }
+            s=0.5*s;
+        }
+        if(k==20) return 0;
+        if(done){
+            *V=exp(lnV);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//Pressure, ln(f/(RT)) and their derivatives with respect to ln(V), at T,V. ln(f/(RT))=Arr+Z-1-ln(V), it does not need
+//a positive pressure, as the liquid volumes taken from the seed table can have
+template<class Model> static void PureFlashPhase(const PureFlashEngine *eng,double T,double V,double *P,double *dP,double *lnF,double *dLnF,double *Hr){
+    double r[6],RT=R*T;
+    EosKernelModel<Model>::Get(&eng->ker).ArrDer(T,V,r);
+    *P=RT*(1/V-r[1]);
+    *dP=V*RT*(-1/(V*V)-r[2]);
+    double Z=1-V*r[1];
+    *lnF=r[0]+Z-1-log(V);
+    *dLnF=-V*V*r[2]-1;
+    *Hr=RT*(Z-1-T*r[3]);
+}
+
+//Saturation at T by Newton method on ln(VL) and ln(VG), from the seed table. Returns also dPsat/dT, from Clapeyron equation
+template<class Model> static int PureFlashSat(const PureFlashEngine *eng,double T,double *P,double *VL,double *VG,double *dPdT){
+    int k,it;
+    double lnVL,lnVG,PL,PG,dPL,dPG,fL,fG,dFL,dFG,HL,HG;
+    if((eng->nSat<2)||(T<eng->satT[0])||(T>eng->satT[eng->nSat-1])) return 0;
+    for(k=0;(k<eng->nSat-2)&&(T>eng->satT[k+1]);k++);
+    double t=(T-eng->satT[k])/(eng->satT[k+1]-eng->satT[k]);
+    lnVL=eng->satLnVL[k]+t*(eng->satLnVL[k+1]-eng->satLnVL[k]);
+    lnVG=eng->satLnVG[k]+t*(eng->satLnVG[k+1]-eng->satLnVG[k]);
+    for(it=0;it<50;it++){
+        PureFlashPhase<Model>(eng,T,exp(lnVL),&PL,&dPL,&fL,&dFL,&HL);
+        PureFlashPhase<Model>(eng,T,exp(lnVG),&PG,&dPG,&fG,&dFG,&HG);
+        double RT=R*T;
+        double f0=(PL-PG)/RT,f1=fL-fG;
+        double J00=dPL/RT,J01=-dPG/RT,J10=dFL,J11=-dFG;
+        double det=J00*J11-J01*J10;
+        if(!(fabs(det)>0)) return 0;
+        double dL=-(f0*J11-f1*J01)/det;
+        double dG=-(J00*f1-J10*f0)/det;
+        double s=1;
+        if(fabs(dL)>0.3) s=0.3/fabs(dL);
+        if(fabs(dG)*s>0.3) s=0.3/fabs(dG);
+        lnVL+=s*dL;
+        lnVG+=s*dG;
+        if((fabs(dL)<1e-11)&&(fabs(dG)<1e-11)) break;
+    }
+    if((it==50)||!(lnVG-lnVL>1e-4)) return 0;//not converged, or trivial solution
+    *VL=exp(lnVL);
+    *VG=exp(lnVG);
+    *P=PG;
+    *dPdT=(HG-HL)/(T*(*VG-*VL));
+    return 1;
+}
+
+template<class Model> struct PureFlashSatOp{
+    static int Run(const PureFlashEngine *eng,double T,double *P,double *VL,double *VG,double *dPdT){
+        return PureFlashSat<Model>(eng,T,P,VL,VG,dPdT);
+    }
+};
+
+//Saturation at T: pressure and volumes of liquid and gas. Returns 0 if T is outside the saturation table or it does not converge
+int PureFlashSatT(const PureFlashEngine *eng,double T,double *P,double *VL,double *VG){
+    double dPdT;
+    return EosKernelDispatch<PureFlashSatOp>(&eng->ker,eng,T,P,VL,VG,&dPdT);
+}
+
+//Saturation temperature at P, by Newton method on ln(Psat)
+template<class Model> static int PureFlashSatP(const PureFlashEngine *eng,double P,double *T,double *VL,double *VG,double *dPdT){
+    int k,it;
+    double lnP=log(P),Ps;
+    if((eng->nSat<2)||!(P>0)||(lnP<eng->satLnP[0])||(lnP>eng->satLnP[eng->nSat-1])) return 0;
+    for(k=0;(k<eng->nSat-2)&&(lnP>eng->satLnP[k+1]);k++);
+    double t=(lnP-eng->satLnP[k])/(eng->satLnP[k+1]-eng->satLnP[k]);
+    *T=1/(1/eng->satT[k]+t*(1/eng->satT[k+1]-1/eng->satT[k]));//ln(Psat) is nearly linear in 1/T
+    for(it=0;it<30;it++){
+        if(PureFlashSat<Model>(eng,*T,&Ps,VL,VG,dPdT)==0) return 0;
+        double dT=-(log(Ps)-lnP)*Ps/ *dPdT;
+        if(*T+dT<eng->satT[0]) dT=eng->satT[0]-*T;
+        else if(*T+dT>eng->satT[eng->nSat-1]) dT=eng->satT[eng->nSat-1]-*T;
+        if(fabs(dT)<=1e-11* *T) return 1;
+        *T+=dT;
+    }
+    return 0;
+}
+
+//Liquid fraction of a single phase state
+static double PureFlashLiquid(const PureFlashEngine *eng,double T,double V){
+    if(T>eng->Tc) return 0;
+    if(eng->nSat>=2){
+        int k;
+        if(T<eng->satT[0]) return (log(V)<0.5*(eng->satLnVL[0]+eng->satLnVG[0])) ? 1 : 0;
+        for(k=0;(k<eng->nSat-2)&&(T>eng->satT[k+1]);k++);
+        double t=(T-eng->satT[k])/(eng->satT[k+1]-eng->satT[k]);
+        double lnVL=eng->satLnVL[k]+t*(eng->satLnVL[k+1]-eng->satLnVL[k]);
+        double lnVG=eng->satLnVG[k]+t*(eng->satLnVG[k+1]-eng->satLnVG[k]);
+        return (log(V)<0.5*(lnVL+lnVG)) ? 1 : 0;
+    }
+    return (V<eng->Vc) ? 1 : 0;
+}
+
+//Liquid-gas mixture with gas fraction q
+template<class Model> static void PureFlashMixture(const PureFlashEngine *eng,double T,double P,double dPdT,double VL,double VG,double q,FF_ThermoProperties *th,double *liqFraction){
+    FF_ThermoProperties thL,thG;
+    PureFlashPropsModel<Model>(eng,T,VL,&thL);
+    PureFlashPropsModel<Model>(eng,T,VG,&thG);
+    th->MW=eng->MW;
+    th->T=T;
+    th->P=P;
+    th->V=VL+q*(VG-VL);
+    th->H=thL.H+q*(thG.H-thL.H);
+    th->U=thL.U+q*(thG.U-thL.U);
+    th->S=thL.S+q*(thG.S-thL.S);
+    th->A=th->U-T*th->S;
+    th->G=th->A+P*th->V;
+    th->Cp=th->Cv=th->SS=th->JT=th->IT=NAN;
+    th->dP_dT=dPdT;
+    th->dP_dV=0;
+    *liqFraction=1-q;
+}
+
+//Known P or T, below the end of the saturation table: the state is a mixture if the second variable is between the
+//saturated values, otherwise the Newton method starts from the saturated phase on its side.
+//Returns 1 if solved, 0 if not, -1 if the saturation is not known
+template<class Model> static int PureFlashFromSat(const PureFlashEngine *eng,const char var[2],const double target[2],FF_ThermoProperties *th,double *liqFraction){
+    double T,P,VL,VG,dPdT,d0,d1,V;
+    FF_ThermoProperties thL,thG;
+    if(var[0]=='P'){
+        if(PureFlashSatP<Model>(eng,target[0],&T,&VL,&VG,&dPdT)==0) return -1;
+        P=target[0];
+    }
+    else if(PureFlashSat<Model>(eng,target[0],&P,&VL,&VG,&dPdT)==0) return -1;
+    else T=target[0];
+    PureFlashPropsModel<Model>(eng,T,VL,&thL);
+    PureFlashPropsModel<Model>(eng,T,VG,&thG);
+    double XL=PureFlashVar(var[1],&thL,&d0,&d1),XG=PureFlashVar(var[1],&thG,&d0,&d1);
+    if((target[1]>=XL)&&(target[1]<=XG)){
+        PureFlashMixture<Model>(eng,T,P,dPdT,VL,VG,(target[1]-XL)/(XG-XL),th,liqFraction);
+        return 1;
+    }
+    V=(target[1]<XL) ? VL : VG;
+    if(PureFlashNewton<Model>(eng,var,target,&T,&V,th)==0) return 0;
+    *liqFraction=PureFlashLiquid(eng,T,V);
+    return 1;
+}
+
+//Nearest node of the coarse table to the known variables
+static int PureFlashSeed(const PureFlashEngine *eng,const char var[2],const double target[2],double *T,double *V){
+    int i,j,k,found=0;
+    double dMin=HUGE_VAL;
+    for(i=0;i<PURE_FLASH_NT;i++) for(j=0;j<PURE_FLASH_NV;j++){
+        double P=eng->gridP[i][j],d=0;
+        if(!(P==P)) continue;//unstable node
+        for(k=0;k<2;k++){
+            double e;
+            switch(var[k]){
+            case 'P': e=((P>0)&&(target[k]>0)) ? log(P/target[k]) : 10; break;
+            case 'T': e=log(eng->gridT[i]/target[k]); break;
+            case 'V': e=eng->gridLnV[j]-log(target[k]); break;
+            case 'H': e=(eng->gridH[i][j]-target[k])/(R*eng->Tc); break;
+            case 'S': e=(eng->gridS[i][j]-target[k])/R; break;
+            default: e=(eng->gridU[i][j]-target[k])/(R*eng->Tc); break;
+            }
+            d+=e*e;
+        }
+        if(d<dMin){
+            dMin=d;
+            *T=eng->gridT[i];
+            *V=exp(eng->gridLnV[j]);
+            found=1;
+        }
+    }
+    return found;
+}
+
+//Value of the second variable for the mixture with volume V at T, minus the target, and its gas fraction
+template<class Model> static int PureFlashMixtureVRes(const PureFlashEngine *eng,char var,double V,double target,double T,double *g,double *q){
+    FF_ThermoProperties thL,thG;
+    double d0,d1,P,VL,VG,dPdT;
+    if(PureFlashSat<Model>(eng,T,&P,&VL,&VG,&dPdT)==0) return 0;
+    PureFlashPropsModel<Model>(eng,T,VL,&thL);
+    PureFlashPropsModel<Model>(eng,T,VG,&thG);
+    *q=(V-VL)/(VG-VL);
+    double XL=PureFlashVar(var,&thL,&d0,&d1),XG=PureFlashVar(var,&thG,&d0,&d1);
+    *g=XL+*q*(XG-XL)-target;
+    return 1;
+}
+
+//Known V and U, H or S, inside the saturation dome: T is found by regula falsi (Illinois) over the saturation table
+template<class Model> static int PureFlashMixtureV(const PureFlashEngine *eng,char var,double V,double target,FF_ThermoProperties *th,double *liqFraction){
+    double Ta=eng->satT[0],Tb=eng->satT[eng->nSat-1],ga,gb,qa,qb,T=Ta,g=0,q=0,P,VL,VG,dPdT;
+    int it,side=0;
+    if(PureFlashMixtureVRes<Model>(eng,var,V,target,Ta,&ga,&qa)==0) return 0;
+    if(PureFlashMixtureVRes<Model>(eng,var,V,target,Tb,&gb,&qb)==0) return 0;
+    if(ga*gb>0) return 0;
+    for(it=0;it<100;it++){
+        T=(Ta*gb-Tb*ga)/(gb-ga);
+        if(PureFlashMixtureVRes<Model>(eng,var,V,target,T,&g,&q)==0) return 0;
+        if(g*gb>0){
+            Tb=T;
+            gb=g;
+            if(side==-1) ga=0.5*ga;
+            side=-1;
+        }
+        else{
+            Ta=T;
+            ga=g;
+            if(side==1) gb=0.5*gb;
+            side=1;
+        }
+        if((fabs(Tb-Ta)<=1e-11*T)||(g==0)) break;
+    }
+    if(!((q>=0)&&(q<=1))) return 0;
+    if(PureFlashSat<Model>(eng,T,&P,&VL,&VG,&dPdT)==0) return 0;
+    PureFlashMixture<Model>(eng,T,P,dPdT,VL,VG,q,th,liqFraction);
+    return 1;
+}
+
+//State from the two known variables, with the model class of the engine. All the Newton and saturation loops below
+//are instantiated for the model, with its Helmholtz derivatives inlined
+template<class Model> static int PureFlashModel(const PureFlashEngine *eng,enum PureFlashSpec spec,double x,double y,FF_ThermoProperties *th,double *liqFraction){
+    char var[2];
+    double target[2],T,V,P,VL,VG,dPdT;
+    int done;
+    PureFlashSpecVars(spec,var);
+    target[0]=(spec==PURE_FLASH_UV) ? y : x;
+    target[1]=(spec==PURE_FLASH_UV) ? x : y;
+    if((var[0]=='P')||(var[0]=='T')){
+        done=PureFlashFromSat<Model>(eng,var,target,th,liqFraction);
+        if(done>=0) return done;
+    }
+    //no saturation: supercritical, or without saturation table
+    if(PureFlashSeed(eng,var,target,&T,&V)==0) return 0;
+    done=PureFlashNewton<Model>(eng,var,target,&T,&V,th);
+    if((var[0]!='V')||(eng->nSat<2)){
+        if(done==1) *liqFraction=PureFlashLiquid(eng,T,V);
+        return done;
+    }
+    //known V: the single phase solution is valid above the saturation table, or inside it out of the dome. Below the
+    //table it is kept only if there is no mixture with the same V
+    if((done==1)&&((T>eng->satT[eng->nSat-1])||((PureFlashSat<Model>(eng,T,&P,&VL,&VG,&dPdT)==1)&&((V<=VL)||(V>=VG))))){
+        *liqFraction=PureFlashLiquid(eng,T,V);
+        return 1;
+    }
+    FF_ThermoProperties thSingle=*th;
+    if(PureFlashMixtureV<Model>(eng,var[1],target[0],target[1],th,liqFraction)==1) return 1;
+    if((done==1)&&(T<eng->satT[0])){
+        *th=thSingle;
+        *liqFraction=PureFlashLiquid(eng,T,V);
+        return 1;
+    }
+    return 0;
+}
+
+template<class Model> struct PureFlashOp{
+    static int Run(const PureFlashEngine *eng,enum PureFlashSpec spec,double x,double y,FF_ThermoProperties *th,double *liqFraction){
+        return PureFlashModel<Model>(eng,spec,x,y,th,liqFraction);
+    }
+};
+
+//State from the two known variables, in the order of the specification name (P and H for PURE_FLASH_PH, U and V for
+//PURE_FLASH_UV, V and H for PURE_FLASH_DH). liqFraction is the liquid molar fraction: 1 for liquid, 0 for gas or
+//supercritical fluid. In the two phases region Cp, Cv, SS, JT and IT are not defined and are returned as NaN.
+//Returns 0 if the state is not found
+int PureFlash(const PureFlashEngine *eng,enum PureFlashSpec spec,double x,double y,FF_ThermoProperties *th,double *liqFraction){
+    return EosKernelDispatch<PureFlashOp>(&eng->ker,eng,spec,x,y,th,liqFraction);
+}
+
+//Batch of states with the model class of the engine, dispatched once for the whole batch
+template<class Model> struct PureFlashBatchOp{
+    static int Run(const PureFlashEngine *eng,enum PureFlashSpec spec,int n,const double x[],const double y[],
+                   FF_ThermoProperties th[],double liqFraction[],int solved[],int nThreads);
+};
+
+template<class Model> int PureFlashBatchOp<Model>::Run(const PureFlashEngine *eng,enum PureFlashSpec spec,int n,const double x[],const double y[],
+                                                      FF_ThermoProperties th[],double liqFraction[],int solved[],int nThreads){
+    std::atomic<int> next(0),nSolved(0);
+    if(nThreads<=0) nThreads=std::thread::hardware_concurrency();
+    if(nThreads>(n+PURE_FLASH_BLOCK-1)/PURE_FLASH_BLOCK) nThreads=(n+PURE_FLASH_BLOCK-1)/PURE_FLASH_BLOCK;
+    if(nThreads<1) nThreads=1;
+    TraceScope trace("Pure flash batch","PureFlash");
+    trace.arg("points",n);
+    trace.arg("threads",nThreads);
+    auto worker=[&](){
+        int i,i0,nOk=0;
+        while((i0=next.fetch_add(PURE_FLASH_BLOCK))<n){
+            int i1=(i0+PURE_FLASH_BLOCK<n) ? i0+PURE_FLASH_BLOCK : n;
+            for(i=i0;i<i1;i++){
+                int ok=PureFlashModel<Model>(eng,spec,x[i],y[i],&th[i],&liqFraction[i]);
+                if(ok==0) th[i].T=liqFraction[i]=NAN;
+                if(solved!=NULL) solved[i]=ok;
+                nOk+=ok;
+            }
+        }
+        nSolved+=nOk;
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(nThreads-1);
+    for(int i=1;i<nThreads;i++) pool.emplace_back(worker);
+    worker();
+    for(auto &t:pool) t.join();
+    return nSolved;
+}
+
+//Batch of states, calculated by nThreads threads (0 uses all the available cores). solved[] can be NULL.
+//The points not solved have T=NaN. Returns the number of points solved
+int PureFlashBatch(const PureFlashEngine *eng,enum PureFlashSpec spec,int n,const double x[],const double y[],
+                   FF_ThermoProperties th[],double liqFraction[],int solved[],int nThreads){
+    return EosKernelDispatch<PureFlashBatchOp>(&eng->ker,eng,spec,n,x,y,th,liqFraction,solved,nThreads);
+}
+
+//Prepares the engine for the active EOS of the substance, with the given reference state for the ideal gas part.
+//The substance must not change while the engine is used. Returns 0 if the substance has no EOS
+int PureFlashInit(FF_SubstanceData *subs,double refT,double refP,PureFlashEngine *eng){
+    int i,j,nNodes;
+    double Tmin,Tmax,Vmin,Vmax;
+    SatProps sp;
+    if(EosKernelBuild(subs,&eng->ker)==0) return 0;
+    eng->subs=subs;
+    eng->refT=refT;
+    eng->refP=refP;
+    if(subs->model==FF_SAFTtype) eng->MW=subs->saftData.MW;
+    else if(subs->model==FF_SWtype) eng->MW=subs->swData.MW;
+    else eng->MW=subs->cubicData.MW;
+    if(!(eng->MW>0)) eng->MW=subs->baseProp.MW;
+    eng->water=(subs->model==FF_SWtype)&&(subs->swData.eos==FF_IAPWS95);
+    //saturation seeds, equally spaced in 1/T
+    eng->nSat=0;
+    if(SatCacheRange(subs,&Tmin,&Tmax,&nNodes)==1){
+        for(i=0;i<PURE_FLASH_NSAT;i++){
+            double T=1/(1/Tmin+(1/Tmax-1/Tmin)*i/(PURE_FLASH_NSAT-1));
+            if((SatCacheProps(subs,T,&sp)==0)||!(sp.P>0)||!(sp.VG>sp.VL)) continue;
+            eng->satT[eng->nSat]=T;
+            eng->satLnP[eng->nSat]=log(sp.P);
+            eng->satLnVL[eng->nSat]=log(sp.VL);
+            eng->satLnVG[eng->nSat]=log(sp.VG);
+            eng->nSat++;
+        }
+    }
+    if(eng->nSat<2) eng->nSat=0;
+    if(eng->nSat>0){
+        eng->Tc=eng->satT[eng->nSat-1];
+        eng->Vc=exp(0.5*(eng->satLnVL[eng->nSat-1]+eng->satLnVG[eng->nSat-1]));
+        Tmin=eng->satT[0];
+        Vmin=0.9*exp(eng->satLnVL[0]);
+        Vmax=2*exp(eng->satLnVG[0]);
+    }
+    else{
+        eng->Tc=subs->baseProp.Tc;
+        eng->Vc=(subs->baseProp.Vc>0) ? subs->baseProp.Vc : 0.29*R*subs->baseProp.Tc/subs->baseProp.Pc;
+        Tmin=0.4*eng->Tc;
+        Vmin=0.25*eng->Vc;
+        Vmax=0;
+    }
+    if(!(eng->Tc>0)||!(eng->Vc>0)) return 0;
+    if(Vmax<1e4*eng->Vc) Vmax=1e4*eng->Vc;
+    //coarse table, geometric in T and V
+    for(i=0;i<PURE_FLASH_NT;i++) eng->gridT[i]=Tmin*pow(4*eng->Tc/Tmin,(double)i/(PURE_FLASH_NT-1));
+    for(j=0;j<PURE_FLASH_NV;j++) eng->gridLnV[j]=log(Vmin)+(log(Vmax)-log(Vmin))*j/(PURE_FLASH_NV-1);
+    for(i=0;i<PURE_FLASH_NT;i++) for(j=0;j<PURE_FLASH_NV;j++){
+        FF_ThermoProperties th;
+        PureFlashProps(eng,eng->gridT[i],exp(eng->gridLnV[j]),&th);
+        int stable=(th.dP_dV<0)&&(th.P>0)&&(th.H==th.H)&&(th.S==th.S);
+        eng->gridP[i][j]=stable ? th.P : NAN;
+        eng->gridH[i][j]=th.H;
+        eng->gridS[i][j]=th.S;
+        eng->gridU[i][j]=th.U;
+    }
+    return 1;
+}
@@ -0,0 +1,355 @@
+/*
+ * satcache.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "satcache.h"
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+//Columns of the table
+enum{SC_LNP,SC_RHOL,SC_LNRHOG,SC_HL,SC_HG,SC_SL,SC_SG,SC_CPL,SC_ARRL,SC_ZL,SC_DPDTL,SC_DPDVL,SC_NCOL};
+
+#define SC_MAXNODES 1024 //maximum number of nodes of a table
+#define SC_MAXTABLES 16 //maximum number of substances kept
+#define SC_INITINT 24 //initial number of intervals, before refinement
+#define SC_MAXDEPTH 8 //maximum number of bisections of an initial interval
+
+//Tables are not modified once built, so they are shared between threads without locking
+typedef struct{
+    int subsId;//key: product id, EOS model and EOS id
+    int model;
+    int eosId;
+    std::vector<double> T;//nodes
+    std::vector<double> v;//values, SC_NCOL per node
+    std::vector<double> d;//slopes, SC_NCOL per node
+} SatTable;
+
+typedef std::shared_ptr<const SatTable> SatTableRef;
+
+//Tables of all the threads. The mutex is taken only when a thread does not find the table in its own list
+static std::vector<SatTableRef> satTables;
+static std::mutex satTablesMutex;
+//Changed each time tables are discarded. A thread whose list has another generation empties it
+static std::atomic<unsigned> satGeneration(1);
+
+//Tables already used by the thread
+typedef struct{
+    unsigned generation;
+    std::vector<SatTableRef> tables;
+} SatThreadTables;
+
+static thread_local SatThreadTables satThread={0,std::vector<SatTableRef>()};
+
+//EOS id of the active EOS of the substance, 0 if it is not supported by the cache
+static int SatCacheEosId(const FF_SubstanceData *subs){
+    switch(subs->model){
+    case FF_SAFTtype:
+        return subs->saftData.id;
+    case FF_SWtype:
+        return subs->swData.id;
+    case FF_CubicType:
+    case FF_CubicPRtype:
+    case FF_CubicSRKtype:
+        return subs->cubicData.id;
+    default:
+        return 0;
+    }
+}
+
+static inline int SatCacheIs(const SatTable *tab,int subsId,int model,int eosId){
+    return (tab->subsId==subsId)&&(tab->model==model)&&(tab->eosId==eosId);
+}
+
+//Exact calculation of the saturated properties at T. Returns 0 if it fails or the phases are not distinct
+static int SatCachePoint(FF_SubstanceData *subs,double T,double col[SC_NCOL]){
+    double P,answerL[3],answerG[3];
+    char option='s',state;
+    FF_ThermoProperties th;
+    FF_VpEOSs(&T,subs,&P);
+    if(!((P>0)&&(P<1e10))) return 0;
+    FF_VfromTPeosS(&T,&P,subs,&option,answerL,answerG,&state);
+    if(!((answerL[0]>0)&&(answerG[0]>1.02*answerL[0]))) return 0;//too close to the critical point
+    th.T=T;
+    th.V=answerG[0];
+    FF_ExtResidualThermoEOSs(subs,&th);
+    col[SC_LNP]=log(P);
+    col[SC_LNRHOG]=-log(answerG[0]);
+    col[SC_HG]=th.H;
+    col[SC_SG]=th.S;
+    th.V=answerL[0];
+    FF_ExtResidualThermoEOSs(subs,&th);
+    col[SC_RHOL]=1/answerL[0];
+    col[SC_HL]=th.H;
+    col[SC_SL]=th.S;
+    col[SC_CPL]=th.Cp;
+    col[SC_ARRL]=th.A/(R*T);
+    col[SC_ZL]=th.P*th.V/(R*T);
+    col[SC_DPDTL]=th.dP_dT;
+    col[SC_DPDVL]=th.dP_dV;
+    if(!(col[SC_HG]>col[SC_HL])) return 0;
+    return 1;
+}
+
+//d(lnPsat)/dT from Clapeyron equation
+static double SatCacheClapeyron(double T,const double col[SC_NCOL]){
+    return (col[SC_HG]-col[SC_HL])/(T*(exp(-col[SC_LNRHOG])-1/col[SC_RHOL])*exp(col[SC_LNP]));
+}
+
+//Cubic Hermite interpolation in [T0,T1]
+static inline double SatCacheHermite(double t,double h,double f0,double f1,double d0,double d1){
+    double t2=t*t,t3=t2*t;
+    return (2*t3-3*t2+1)*f0+(t3-2*t2+t)*h*d0+(-2*t3+3*t2)*f1+(t3-t2)*h*d1;
+}
+
+static inline double SatCacheHermiteDer(double t,double h,double f0,double f1,double d0,double d1){
+    double t2=t*t;
+    return ((6*t2-6*t)*(f0-f1))/h+(3*t2-4*t+1)*d0+(3*t2-2*t)*d1;
+}
+
+//Checks if the midpoint is reproduced by interpolation between the interval ends. The other properties are checked
+//against linear interpolation, more demanding than the final cubic one
+static int SatCacheMidOk(double Ta,double Tb,const double a[SC_NCOL],const double b[SC_NCOL],const double m[SC_NCOL]){
+    double h=Tb-Ta;
+    double Tm=0.5*(Ta+Tb);
+    double lnP=SatCacheHermite(0.5,h,a[SC_LNP],b[SC_LNP],SatCacheClapeyron(Ta,a),SatCacheClapeyron(Tb,b));
+    double dH=m[SC_HG]-m[SC_HL];
+    double tol[SC_NCOL];
+    tol[SC_LNP]=1e-8;
+    tol[SC_RHOL]=1e-4*m[SC_RHOL];
+    tol[SC_LNRHOG]=1e-4;
+    tol[SC_HL]=tol[SC_HG]=1e-4*dH;
+    tol[SC_SL]=tol[SC_SG]=1e-4*dH/Tm;
+    tol[SC_CPL]=1e-3*(fabs(m[SC_CPL])+R);
+    tol[SC_ARRL]=1e-4*(fabs(m[SC_ARRL])+1);
+    tol[SC_ZL]=1e-3*fabs(m[SC_ZL])+1e-9;
+    tol[SC_DPDTL]=1e-3*fabs(m[SC_DPDTL]);
+    tol[SC_DPDVL]=1e-3*fabs(m[SC_DPDVL]);
+    if(!(fabs(lnP-m[SC_LNP])<=tol[SC_LNP])) return 0;
+    for(int j=1;j<SC_NCOL;j++) if(!(fabs(0.5*(a[j]+b[j])-m[j])<=tol[j])) return 0;
+    return 1;
+}
+
+//Adds the nodes inside (Ta,Tb) and the node Tb, bisecting the interval until the midpoint is well interpolated
+static void SatCacheRefine(FF_SubstanceData *subs,SatTable *tab,double Ta,double Tb,const double a[SC_NCOL],const double b[SC_NCOL],int depth){
+    double Tm=0.5*(Ta+Tb);
+    double m[SC_NCOL];
+    if((depth<SC_MAXDEPTH)&&(tab->T.size()+2<SC_MAXNODES)&&(SatCachePoint(subs,Tm,m)==1)&&(SatCacheMidOk(Ta,Tb,a,b,m)==0)){
+        SatCacheRefine(subs,tab,Ta,Tm,a,m,depth+1);
+        SatCacheRefine(subs,tab,Tm,Tb,m,b,depth+1);
+        return;
+    }
+    tab->T.push_back(Tb);
+    tab->v.insert(tab->v.end(),b,b+SC_NCOL);
+}
+
+//Builds the table. If the EOS can not give saturation points the table is left empty
+static void SatCacheBuild(FF_SubstanceData *subs,SatTable *tab){
+    double Tc,Tmin,Tmax,a[SC_NCOL],b[SC_NCOL];
+    int i,j,n;
+    tab->T.clear();
+    tab->v.clear();
+    tab->d.clear();
+    switch(subs->model){
+    case FF_SAFTtype: Tc=subs->saftData.Tc; break;
+    case FF_SWtype: Tc=subs->swData.Tc; break;
+    default: Tc=subs->cubicData.Tc; break;
+    }
+    if(!(Tc>0)) Tc=subs->baseProp.Tc;
+    if(!(Tc>0)) return;
+    //lower end: the first temperature from 0.25 Tc (about the lowest reduced triple points) with a valid calculation
+    for(Tmin=0.25*Tc;Tmin<0.9*Tc;Tmin+=0.05*Tc) if(SatCachePoint(subs,Tmin,a)==1) break;
+    if(!(Tmin<0.9*Tc)) return;
+    //upper end: as close as possible to the critical point of the EOS, that can be different from the experimental one
+    for(Tmax=0.999*Tc;Tmax>Tmin;Tmax=Tc-2*(Tc-Tmax)) if(SatCachePoint(subs,Tmax,b)==1) break;
+    if(!(Tmax>Tmin)) return;
+    tab->T.push_back(Tmin);
+    tab->v.insert(tab->v.end(),a,a+SC_NCOL);
+    //initial intervals, closer near the critical point, each one refined as needed
+    double Tprev=Tmin;
+    for(i=1;i<=SC_INITINT;i++){
+        double s=1-(double)i/SC_INITINT;
+        double Ti=(i==SC_INITINT) ? Tmax : Tmax-(Tmax-Tmin)*s*s;
+        if((i<SC_INITINT)&&(SatCachePoint(subs,Ti,b)==0)) continue;
+        if(i==SC_INITINT) SatCachePoint(subs,Tmax,b);
+        memcpy(a,&tab->v[(tab->T.size()-1)*SC_NCOL],sizeof(a));//the table storage can move while refining
+        SatCacheRefine(subs,tab,Tprev,Ti,a,b,0);
+        Tprev=Ti;
+    }
+    //slopes: Clapeyron for ln(Psat), three points formula for the other properties
+    n=tab->T.size();
+    tab->d.resize(n*SC_NCOL);
+    for(i=0;i<n;i++){
+        const double *f=&tab->v[i*SC_NCOL];
+        double *df=&tab->d[i*SC_NCOL];
+        df[SC_LNP]=SatCacheClapeyron(tab->T[i],f);
+        for(j=1;j<SC_NCOL;j++){
+            if(i==0) df[j]=(tab->v[SC_NCOL+j]-f[j])/(tab->T[1]-tab->T[0]);
+            else if(i==n-1) df[j]=(f[j]-tab->v[(i-1)*SC_NCOL+j])/(tab->T[i]-tab->T[i-1]);
+            else{
+                double h0=tab->T[i]-tab->T[i-1],h1=tab->T[i+1]-tab->T[i];
+                double f0=tab->v[(i-1)*SC_NCOL+j],f2=tab->v[(i+1)*SC_NCOL+j];
+                df[j]=(h0*h0*f2-h1*h1*f0+(h1*h1-h0*h0)*f[j])/(h0*h1*(h0+h1));
+            }
+        }
+    }
+}
+
+//Returns the table of the substance, building it if it does not exist. The thread list is searched first, without
+//locking. The table stays valid while the thread list holds it, that is until the next call from the same thread.
+//Substances without a product id or EOS id are not cached, as the key could not tell them apart
+static const SatTable *SatCacheTable(FF_SubstanceData *subs){
+    int eosId=SatCacheEosId(subs);
+    if((subs->id<=0)||(eosId<=0)) return NULL;
+    unsigned generation=satGeneration.load(std::memory_order_acquire);
+    if(satThread.generation!=generation){
+        satThread.tables.clear();
+        satThread.generation=generation;
+    }
+    for(size_t k=0;k<satThread.tables.size();k++) if(SatCacheIs(satThread.tables[k].get(),subs->id,subs->model,eosId)) return satThread.tables[k].get();
+    SatTableRef tab;
+    {
+        std::lock_guard<std::mutex> lock(satTablesMutex);
+        for(size_t k=0;k<satTables.size();k++) if(SatCacheIs(satTables[k].get(),subs->id,subs->model,eosId)){
+            tab=satTables[k];
+            break;
+        }
+        if(!tab){
+            std::shared_ptr<SatTable> built=std::make_shared<SatTable>();
+            built->subsId=subs->id;
+            built->model=subs->model;
+            built->eosId=eosId;
+            SatCacheBuild(subs,built.get());
+            if(satTables.size()>=SC_MAXTABLES) satTables.erase(satTables.begin());//the oldest one is discarded
+            satTables.push_back(built);
+            tab=built;
+        }
+    }
+    if(satThread.tables.size()>=SC_MAXTABLES) satThread.tables.erase(satThread.tables.begin());
+    satThread.tables.push_back(tab);
+    return tab.get();
+}
+
+//Interpolated values at T in the interval k
+static void SatCacheInterpolate(const SatTable *tab,int k,double T,double col[SC_NCOL]){
+    double h=tab->T[k+1]-tab->T[k];
+    double t=(T-tab->T[k])/h;
+    const double *f0=&tab->v[k*SC_NCOL],*f1=&tab->v[(k+1)*SC_NCOL];
+    const double *d0=&tab->d[k*SC_NCOL],*d1=&tab->d[(k+1)*SC_NCOL];
+    for(int j=0;j<SC_NCOL;j++) col[j]=SatCacheHermite(t,h,f0[j],f1[j],d0[j],d1[j]);
+}
+
+//Interval containing T, by bisection. -1 if outside the table
+static int SatCacheFind(const SatTable *tab,double T){
+    int lo=0,hi=tab->T.size()-1;
+    if((hi<1)||!(T>=tab->T[0])||!(T<=tab->T[hi])) return -1;
+    while(hi-lo>1){
+        int mid=(lo+hi)/2;
+        if(T<tab->T[mid]) hi=mid;
+        else lo=mid;
+    }
+    return lo;
+}
+
+//Saturated properties at T. Returns 0 if T is outside the range of the table, or if it can not be built
+int SatCacheProps(FF_SubstanceData *subs,double T,SatProps *sp){
+    double col[SC_NCOL];
+    const SatTable *tab=SatCacheTable(subs);
+    if(tab==NULL) return 0;
+    int k=SatCacheFind(tab,T);
+    if(k<0) return 0;
+    SatCacheInterpolate(tab,k,T,col);
+    sp->T=T;
+    sp->P=exp(col[SC_LNP]);
+    sp->VL=1/col[SC_RHOL];
+    sp->VG=exp(-col[SC_LNRHOG]);
+    sp->HL=col[SC_HL];
+    sp->HG=col[SC_HG];
+    sp->SL=col[SC_SL];
+    sp->SG=col[SC_SG];
+    sp->dP_dT=(sp->HG-sp->HL)/(T*(sp->VG-sp->VL));
+    sp->CpL=col[SC_CPL];
+    sp->ArrL=col[SC_ARRL];
+    sp->ZL=col[SC_ZL];
+    sp->dP_dTL=col[SC_DPDTL];
+    sp->dP_dVL=col[SC_DPDVL];
+    return 1;
+}
+
+//Saturation temperature at P, inverting the table. Returns 0 if P is outside the range of the table
+int SatCacheTsat(FF_SubstanceData *subs,double P,double *T){
+    const SatTable *tab=SatCacheTable(subs);
+    if((tab==NULL)||(tab->T.size()<2)||!(P>0)) return 0;
+    double lnP=log(P);
+    int lo=0,hi=tab->T.size()-1;
+    if(!(lnP>=tab->v[SC_LNP])||!(lnP<=tab->v[hi*SC_NCOL+SC_LNP])) return 0;
+    while(hi-lo>1){//ln(Psat) increases with T
+        int mid=(lo+hi)/2;
+        if(lnP<tab->v[mid*SC_NCOL+SC_LNP]) hi=mid;
+        else lo=mid;
+    }
+    double h=tab->T[lo+1]-tab->T[lo];
+    double f0=tab->v[lo*SC_NCOL+SC_LNP],f1=tab->v[(lo+1)*SC_NCOL+SC_LNP];
+    double d0=tab->d[lo*SC_NCOL+SC_LNP],d1=tab->d[(lo+1)*SC_NCOL+SC_LNP];
+    double tLo=0,tHi=1,t=(f1>f0) ? (lnP-f0)/(f1-f0) : 0.5;
+    for(int i=0;i<50;i++){//Newton, kept inside the bracket
+        double f=SatCacheHermite(t,h,f0,f1,d0,d1)-lnP;
+        if(f>0) tHi=t;
+        else tLo=t;
+        if(fabs(f)<1e-12) break;
+        double df=SatCacheHermiteDer(t,h,f0,f1,d0,d1)*h;
+        double tNew=(df>0) ? t-f/df : 0.5*(tLo+tHi);
+        if(!((tNew>tLo)&&(tNew<tHi))) tNew=0.5*(tLo+tHi);
+        t=tNew;
+    }
+    *T=tab->T[lo]+t*h;
+    return 1;
+}
+
+//Temperature range covered by the table of the substance, and number of nodes. Returns 0 if there is no table
+int SatCacheRange(FF_SubstanceData *subs,double *Tmin,double *Tmax,int *nNodes){
+    const SatTable *tab=SatCacheTable(subs);
+    if((tab==NULL)||(tab->T.size()<2)) return 0;
+    *Tmin=tab->T.front();
+    *Tmax=tab->T.back();
+    *nNodes=tab->T.size();
+    return 1;
+}
+
+//Discards the tables of a substance, whatever its EOS
+void SatCacheInvalidate(int subsId){
+    std::lock_guard<std::mutex> lock(satTablesMutex);
+    for(size_t k=satTables.size();k>0;k--) if(satTables[k-1]->subsId==subsId) satTables.erase(satTables.begin()+k-1);
+    satGeneration.fetch_add(1,std::memory_order_release);
+}
+
+//Discards all the tables
+void SatCacheClear(){
+    std::lock_guard<std::mutex> lock(satTablesMutex);
+    satTables.clear();
+    satGeneration.fetch_add(1,std::memory_order_release);
+}
@@ -0,0 +1,262 @@
+/*
+ * satsolver.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "satsolver.h"
+#include "cubicmixkernel.h"
+#include "eostcache.h"
+#include "dualnumber.h"
+
+#include <math.h>
+
+enum SatType{SAT_BUBBLE_P,SAT_DEW_P,SAT_BUBBLE_T,SAT_DEW_T};
+static const char *satNames[4]={"SatBubbleP","SatDewP","SatBubbleT","SatDewT"};
+
+typedef Dual<2> SatDual;//derivatives with respect to T (0) and P (1)
+
+//ln(phi) of a phase from the kernel, and its derivatives with respect to T and P. The derivatives use the same
+//expressions as CubicMixLnPhiRef, evaluated with dual numbers. Z is an implicit function of A and B, its derivatives
+//come from the cubic equation
+static int SatPhase(FF_MixData *mix,CubicMixKernel *ker,double T,double P,const double x[],char option,double lnPhi[],
+                    double dlnPhi_dT[],double dlnPhi_dP[],double *Z,double *V){
+    int i,j,k,n=ker->n;
+    char state;
+    double b=0,u=ker->u,w=ker->w,dk;
+    SatDual Td=DualVar<2>(T,0),Pd=DualVar<2>(P,1);
+    SatDual sqa[15],kij[15][15],dn2a[15],a=DualConst<2>(0);
+    CubicMixKernelSetT(mix,T,ker);
+    if(CubicMixLnPhi(ker,P,x,option,lnPhi,Z,V,&state)==0) return 0;
+    for(i=0;i<n;i++){
+        SatDual ai=DualConst<2>(ker->a[i]);
+        ai.d[0]=ker->da[i];
+        sqa[i]=sqrt(ai);
+        b+=x[i]*ker->b[i];
+    }
+    for(i=0;i<n;i++) for(j=0;j<n;j++){
+        kij[i][j]=DualConst<2>(CubicMixKernelKijDer(ker,i,j,T,&dk));
+        kij[i][j].d[0]=dk;
+    }
+    //a=sum(xi*xj*aij), with aij=sqrt(ai*aj)(1-kij+(kij-kji)*xi) for the PR rule
+    for(i=0;i<n;i++) for(j=0;j<n;j++){
+        SatDual sq=sqa[i]*sqa[j];
+        SatDual aij=sq*(1-kij[i][j]);
+        if(ker->rule==FF_PR) aij+=sq*(kij[i][j]-kij[j][i])*x[i];
+        a+=x[i]*x[j]*aij;
+    }
+    //d(n^2*a)/dnk
+    for(k=0;k<n;k++){
+        dn2a[k]=DualConst<2>(0);
+        for(j=0;j<n;j++){
+            SatDual sq=sqa[k]*sqa[j];
+            dn2a[k]+=x[j]*sq*(2-kij[k][j]-kij[j][k]);
+            if(ker->rule==FF_PR) dn2a[k]+=2*x[k]*x[j]*sq*(kij[k][j]-kij[j][k])+x[j]*x[j]*sq*(kij[j][k]-kij[k][j]);
+        }
+        if(ker->rule==FF_PR) for(i=0;i<n;i++) for(j=0;j<n;j++){
+            dn2a[k]-=x[i]*x[i]*x[j]*sqa[i]*sqa[j]*(kij[i][j]-kij[j][i]);
+        }
+    }
+    SatDual RT=R*Td;
+    SatDual A=a*Pd/(RT*RT);
+    SatDual B=b*Pd/RT;
+    //Z^3-(1+B-uB)Z^2+(A+wB^2-uB-uB^2)Z-(AB+wB^2+wB^3)=0, differentiated at constant Z gives dF, then dZ=-dF/(dF/dZ)
+    SatDual Zd=DualConst<2>(*Z);
+    SatDual F=Zd*Zd*Zd-(1+B-u*B)*Zd*Zd+(A+w*B*B-u*B-u*B*B)*Zd-(A*B+w*B*B+w*B*B*B);
+    double c2=-(1+B.v-u*B.v),c1=A.v+w*B.v*B.v-u*B.v-u*B.v*B.v;
+    double dF_dZ=3* *Z* *Z+2*c2* *Z+c1;
+    if(dF_dZ==0) return 0;
+    for(k=0;k<2;k++) Zd.d[k]=-F.d[k]/dF_dZ;
+    double sq=sqrt(u*u-4*w);
+    SatDual L=log((2*Zd+B*(u+sq))/(2*Zd+B*(u-sq)));
+    for(i=0;i<n;i++){
+        SatDual lnPhiD=ker->b[i]/b*(Zd-1)-log(Zd-B)+A/(B*sq)*(ker->b[i]/b-dn2a[i]/a)*L-ker->c[i]*Pd/RT;
+        dlnPhi_dT[i]=lnPhiD.d[0];
+        dlnPhi_dP[i]=lnPhiD.d[1];
+        if(!(fabs(lnPhi[i])<1e10)) return 0;
+    }
+    return 1;
+}
+
+//Wilson K values at T,P, and their temperature derivatives divided by K
+static void SatWilsonK(const CubicMixKernel *ker,double T,double P,double K[],double dlnK_dT[]){
+    int i;
+    for(i=0;i<ker->n;i++){
+        double f=5.373*(1+ker->omega[i]);
+        K[i]=ker->Pc[i]/P*exp(f*(1-ker->Tc[i]/T));
+        dlnK_dT[i]=f*ker->Tc[i]/(T*T);
+    }
+}
+
+//Initial estimation of the saturation variable and the incipient phase composition from Wilson K values
+static void SatWilsonStart(const CubicMixKernel *ker,int type,double fixed,const double z[],double guess,double *var,double w[]){
+    int i,it,n=ker->n;
+    double K[15],dlnK[15],S,dS,T,P;
+    if((type==SAT_BUBBLE_P)||(type==SAT_DEW_P)){
+        T=fixed;
+        SatWilsonK(ker,T,1.0,K,dlnK);//K*P, the Wilson vapor pressure
+        S=0;
+        for(i=0;i<n;i++) S+=(type==SAT_BUBBLE_P) ? z[i]*K[i] : z[i]/K[i];
+        P=(type==SAT_BUBBLE_P) ? S : 1/S;
+        if(guess>0) P=guess;
+        *var=P;
+    }
+    else{
+        P=fixed;
+        T=0;
+        for(i=0;i<n;i++) T+=z[i]*0.7*ker->Tc[i];
+        if(guess>0) T=guess;
+        else for(it=0;it<50;it++){//Newton on ln(sum(z*K)) or ln(sum(z/K))
+            SatWilsonK(ker,T,P,K,dlnK);
+            S=dS=0;
+            for(i=0;i<n;i++){
+                double t=(type==SAT_BUBBLE_T) ? z[i]*K[i] : z[i]/K[i];
+                S+=t;
+                dS+=(type==SAT_BUBBLE_T) ? t*dlnK[i] : -t*dlnK[i];
+            }
+            double dT=-log(S)*S/dS;
+            if(dT>0.1*T) dT=0.1*T;
+            else if(dT<-0.1*T) dT=-0.1*T;
+            T+=dT;
+            if(fabs(dT)<1e-6*T) break;
+        }
+        *var=T;
+    }
+    SatWilsonK(ker,T,P,K,dlnK);
+    S=0;
+    for(i=0;i<n;i++){
+        w[i]=((type==SAT_BUBBLE_P)||(type==SAT_BUBBLE_T)) ? z[i]*K[i] : z[i]/K[i];
+        S+=w[i];
+    }
+    for(i=0;i<n;i++) w[i]=w[i]/S;
+}
+
+//Common solver for the four cases
+static int SatSolve(FF_MixData *mix,int type,double fixed,const double z[],double guess,SatWarmStart *warm,SatResult *res){
+    int i,it,n=mix->numSubs;
+    int bubble=(type==SAT_BUBBLE_P)||(type==SAT_BUBBLE_T);
+    int inP=(type==SAT_BUBBLE_P)||(type==SAT_DEW_P);
+    CubicMixKernel ker;
+    double var,w[15],T,P,maxDz=0;
+    double lnPhiZ[15],dTZ[15],dPZ[15],lnPhiW[15],dTW[15],dPW[15],ZZ,VZ,ZW,VW,resid=0;
+    SolverTelemetry *tel=&res->telem;
+    SolverTelemetryBegin(tel,satNames[type],guess>0 ? SOLVER_STEP_GUESS : SOLVER_STEP_WILSON);
+    if((mix->thModelActEos!=1)||(CubicMixKernelInit(mix,&ker)==0)) return SolverTelemetryEnd(tel,SOLVER_UNSUPPORTED,0);
+    res->warm=0;
+    if((warm!=NULL)&&(warm->valid==1)&&(warm->numSubs==n)){
+        for(i=0;i<n;i++) if(fabs(warm->z[i]-z[i])>maxDz) maxDz=fabs(warm->z[i]-z[i]);
+        if((fabs(warm->fixed-fixed)<=0.1*fixed)&&(maxDz<=0.1)) res->warm=1;
+    }
+    if(res->warm==1){
+        var=warm->var;
+        for(i=0;i<n;i++) w[i]=warm->w[i];
+        tel->start=SOLVER_STEP_WARM;
+    }
+    else SatWilsonStart(&ker,type,fixed,z,guess,&var,w);
+    for(it=1;it<=100;it++){
+        double S=0,dS=0,diff=0,t[15],f,df;
+        enum SolverStep step=SOLVER_STEP_NEWTON;
+        T=inP ? fixed : var;
+        P=inP ? var : fixed;
+        //the fixed composition phase and the incipient one
+        if(SatPhase(mix,&ker,T,P,z,bubble ? 'l' : 'g',lnPhiZ,dTZ,dPZ,&ZZ,&VZ)==0) return SolverTelemetryEnd(tel,SOLVER_EOS_FAILURE,resid);
+        if(SatPhase(mix,&ker,T,P,w,bubble ? 'g' : 'l',lnPhiW,dTW,dPW,&ZW,&VW)==0) return SolverTelemetryEnd(tel,SOLVER_EOS_FAILURE,resid);
+        //bubble: incipient=z*phiZ/phiW; dew: incipient=z*phiZ/phiW as well, as phiZ is then the gas
+        for(i=0;i<n;i++){
+            t[i]=z[i]*exp(lnPhiZ[i]-lnPhiW[i]);
+            S+=t[i];
+        }
+        for(i=0;i<n;i++){
+            t[i]=t[i]/S;
+            if(fabs(t[i]-w[i])>diff) diff=fabs(t[i]-w[i]);
+            dS+=t[i]*(inP ? (dPZ[i]-dPW[i]) : (dTZ[i]-dTW[i]));
+        }
+        f=log(S);
+        resid=(fabs(f)>diff) ? fabs(f) : diff;
+        if((fabs(f)<1e-10)&&(diff<1e-9)) break;
+        for(i=0;i<n;i++) w[i]=t[i];
+        if(!(fabs(dS)>0)) return SolverTelemetryEnd(tel,SOLVER_SINGULAR,resid);
+        if(inP){//Newton in ln(P)
+            df=-f/(dS*P);
+            if(fabs(df)>0.5) step=SOLVER_STEP_NEWTON_CLIPPED;
+            if(df>0.5) df=0.5;
+            else if(df<-0.5) df=-0.5;
+            var=P*exp(df);
+        }
+        else{
+            df=-f/dS;
+            if(fabs(df)>0.1*T) step=SOLVER_STEP_NEWTON_CLIPPED;
+            if(df>0.1*T) df=0.1*T;
+            else if(df<-0.1*T) df=-0.1*T;
+            var=T+df;
+        }
+        SolverTelemetryStep(tel,step,resid,var);
+        if(!(var>0)) return SolverTelemetryEnd(tel,SOLVER_DIVERGED,resid);
+    }
+    if(it>100) return SolverTelemetryEnd(tel,SOLVER_MAXITER,resid);
+    for(i=0;i<n;i++) if(fabs(w[i]-z[i])>1e-6) break;
+    if(i==n) return SolverTelemetryEnd(tel,SOLVER_TRIVIAL,resid);//trivial solution
+    res->T=T;
+    res->P=P;
+    res->iterations=it;
+    for(i=0;i<n;i++){
+        res->x[i]=bubble ? z[i] : w[i];
+        res->y[i]=bubble ? w[i] : z[i];
+        res->lnPhiL[i]=bubble ? lnPhiZ[i] : lnPhiW[i];
+        res->lnPhiG[i]=bubble ? lnPhiW[i] : lnPhiZ[i];
+    }
+    res->ZL=bubble ? ZZ : ZW;
+    res->VL=bubble ? VZ : VW;
+    res->ZG=bubble ? ZW : ZZ;
+    res->VG=bubble ? VW : VZ;
+    if(warm!=NULL){
+        warm->valid=1;
+        warm->numSubs=n;
+        warm->fixed=fixed;
+        warm->var=inP ? P : T;
+        for(i=0;i<n;i++){
+            warm->z[i]=z[i];
+            warm->w[i]=w[i];
+        }
+    }
+    return SolverTelemetryEnd(tel,SOLVER_CONVERGED,resid);
+}
+
+//Bubble pressure at T for the liquid composition x. Pguess is used if >0 and there is no usable warm start.
+//Returns 0 if the mixture is not supported or the calculation has not converged
+int SatBubbleP(FF_MixData *mix,double T,const double x[],double Pguess,SatWarmStart *warm,SatResult *res){
+    return SatSolve(mix,SAT_BUBBLE_P,T,x,Pguess,warm,res);
+}
+
+//Dew pressure at T for the gas composition y
+int SatDewP(FF_MixData *mix,double T,const double y[],double Pguess,SatWarmStart *warm,SatResult *res){
+    return SatSolve(mix,SAT_DEW_P,T,y,Pguess,warm,res);
+}
+
+//Bubble temperature at P for the liquid composition x
+int SatBubbleT(FF_MixData *mix,double P,const double x[],double Tguess,SatWarmStart *warm,SatResult *res){
+    return SatSolve(mix,SAT_BUBBLE_T,P,x,Tguess,warm,res);
+}
+
+//Dew temperature at P for the gas composition y
+int SatDewT(FF_MixData *mix,double P,const double y[],double Tguess,SatWarmStart *warm,SatResult *res){
+    return SatSolve(mix,SAT_DEW_T,P,y,Tguess,warm,res);
+}
@@ -0,0 +1,146 @@
+/*
+ * solvertelemetry.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "solvertelemetry.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+static std::atomic<bool> solverTelemEnabled(true);
+
+//Enables or disables the recording of the iterations in the ring, for the records begun afterwards. The summary is
+//always filled. Enabled by default
+void SolverTelemetrySetEnabled(bool enabled){
+    solverTelemEnabled.store(enabled);
+}
+
+bool SolverTelemetryEnabled(){
+    return solverTelemEnabled.load(std::memory_order_relaxed);
+}
+
+//Starts a record
+void SolverTelemetryBegin(SolverTelemetry *tel,const char *solver,enum SolverStep start){
+    tel->solver=solver;
+    tel->status=SOLVER_RUNNING;
+    tel->start=start;
+    tel->iterations=0;
+    tel->residual=0;
+    for (int i=0;i<SOLVER_STEP_COUNT;i++) tel->steps[i]=0;
+    tel->detail=SolverTelemetryEnabled() ? 1 : 0;
+}
+
+//Closes a record with the final status. It returns 1 if converged, else 0, to be used as the solver result
+int SolverTelemetryEnd(SolverTelemetry *tel,enum SolverStatus status,double residual){
+    tel->status=status;
+    tel->residual=residual;
+    return (status==SOLVER_CONVERGED) ? 1 : 0;
+}
+
+const char *SolverStepName(enum SolverStep step){
+    switch(step){
+    case SOLVER_STEP_WILSON: return "Wilson";
+    case SOLVER_STEP_WARM: return "warm start";
+    case SOLVER_STEP_GUESS: return "guess";
+    case SOLVER_STEP_RANDOM: return "random";
+    case SOLVER_STEP_SS: return "SS";
+    case SOLVER_STEP_NEWTON: return "Newton";
+    case SOLVER_STEP_NEWTON_CLIPPED: return "Newton clipped";
+    case SOLVER_STEP_DE: return "DE generation";
+    case SOLVER_STEP_SA: return "SA round";
+    default: return "";
+    }
+}
+
+const char *SolverStatusName(enum SolverStatus status){
+    switch(status){
+    case SOLVER_RUNNING: return "not finished";
+    case SOLVER_CONVERGED: return "converged";
+    case SOLVER_MAXITER: return "max. iterations";
+    case SOLVER_EOS_FAILURE: return "EOS failure";
+    case SOLVER_SINGULAR: return "singular derivative";
+    case SOLVER_DIVERGED: return "diverged";
+    case SOLVER_TRIVIAL: return "trivial solution";
+    case SOLVER_UNSUPPORTED: return "not supported";
+    default: return "";
+    }
+}
+
+//One line summary of a record
+std::string SolverTelemetrySummary(const SolverTelemetry *tel){
+    char buf[256];
+    std::string steps;
+    for (int i=0;i<SOLVER_STEP_COUNT;i++){
+        if (tel->steps[i]==0) continue;
+        snprintf(buf,sizeof(buf),"%s%s %i",steps.empty() ? "" : ", ",SolverStepName((enum SolverStep)i),tel->steps[i]);
+        steps+=buf;
+    }
+    snprintf(buf,sizeof(buf),"%s: %s, %i it. from %s (%s), residual %.3g",tel->solver,SolverStatusName(tel->status),tel->iterations,
+             SolverStepName(tel->start),steps.c_str(),tel->residual);
+    return buf;
+}
+
+//The recorded iterations, one per line, oldest first. Empty if the record was made without detail
+std::string SolverTelemetryDetail(const SolverTelemetry *tel){
+    char buf[128];
+    std::string s;
+    int first=(tel->iterations>SOLVER_TELEM_RING) ? tel->iterations-SOLVER_TELEM_RING+1 : 1;
+    if (!tel->detail) return s;
+    for (int i=first;i<=tel->iterations;i++){
+        const SolverIteration &it=tel->ring[(i-1)%SOLVER_TELEM_RING];
+        snprintf(buf,sizeof(buf),"%4i %-15s residual %-12.4g value %.8g\n",it.iteration,SolverStepName(it.step),it.residual,it.var);
+        s+=buf;
+    }
+    return s;
+}
+
+//Statistics of many records
+void SolverTelemetryStatsInit(SolverTelemetryStats *stats){
+    memset(stats,0,sizeof(SolverTelemetryStats));
+}
+
+//Failed points are worse than any converged one
+static long SolverTelemetryBadness(enum SolverStatus status,int iterations){
+    return (status==SOLVER_CONVERGED) ? iterations : 1000000L+iterations;
+}
+
+void SolverTelemetryAccumulate(SolverTelemetryStats *stats,const SolverTelemetry *tel,double x,double y){
+    int i,j;
+    stats->calls++;
+    stats->status[tel->status]++;
+    stats->start[tel->start]++;
+    for (i=0;i<SOLVER_STEP_COUNT;i++) stats->steps[i]+=tel->steps[i];
+    stats->iterations+=tel->iterations;
+    if (tel->iterations>stats->maxIterations) stats->maxIterations=tel->iterations;
+    long bad=SolverTelemetryBadness(tel->status,tel->iterations);
+    for (i=0;i<stats->nWorst;i++) if (bad>SolverTelemetryBadness(stats->worst[i].status,stats->worst[i].iterations)) break;
+    if (i>=SOLVER_TELEM_WORST) return;
+    if (stats->nWorst<SOLVER_TELEM_WORST) stats->nWorst++;
+    for (j=stats->nWorst-1;j>i;j--) stats->worst[j]=stats->worst[j-1];
+    stats->worst[i].x=x;
+    stats->worst[i].y=y;
+    stats->worst[i].iterations=tel->iterations;
+    stats->worst[i].status=tel->status;
+    stats->worst[i].residual=tel->residual;
+}
@@ -0,0 +1,46 @@
+/*
+ * subscalcplan.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "subscalcplan.h"
+
+//Builds the plan for the requested rows. Rows that can not be calculated for the substance, as those of a missing
+//correlation, must not be requested, so they do not bring their dependencies into the plan
+void SubsCalcPlanBuild(SubsCalcMask requested,SubsCalcPlan *plan){
+    SubsCalcMask rows=(requested&SUBS_CALC_ALL)|SUBS_CALC_STATE;
+    plan->rows=rows;
+    plan->thermo=(rows&SUBS_CALC_THERMO)!=0;
+    plan->satPhases=(rows&SUBS_CALC_RANGE(25,34))!=0;
+    plan->liqDens=(rows&SUBS_CALC_RANGE(41,43))!=0;
+    plan->liqVisc=(rows&SUBS_CALC_ROW(44))!=0;
+    plan->liqThC=(rows&SUBS_CALC_RANGE(45,46))!=0;
+    plan->surfTens=(rows&SUBS_CALC_RANGE(47,49))!=0;
+    plan->gasVisc=(rows&SUBS_CALC_RANGE(50,51))!=0;
+    plan->gasThC=(rows&SUBS_CALC_RANGE(52,53))!=0;
+    plan->liqCp=(rows&SUBS_CALC_RANGE(54,55))!=0;
+    plan->arr=(rows&SUBS_CALC_ARR)!=0;
+    //the saturated phases need the vapor pressure, and so do the pressure corrections of liquid density and viscosity
+    plan->vp=(rows&SUBS_CALC_VP_ROWS)!=0;
+    //the saturated enthalpies, entropies and heat capacity add the ideal gas part, and so does the Chung gas conductivity
+    plan->ideal=((rows&SUBS_CALC_IDEAL)!=0)||plan->satPhases||plan->gasThC;
+}
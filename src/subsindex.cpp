@@ -0,0 +1,270 @@
+/*
+ * subsindex.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "subsindex.h"
+#include "perfcounters.h"
+
+#include <algorithm>
+#include <QtSql>
+
+#define SUBS_LIST_PAGE 256 //rows added to the list model each time the view asks for more
+
+//Lower case letters and digits only, so "n-Hexane" is found by "nhex", and "64-17-5" by "6417"
+static std::string SubsIndexNormalize(const QString &text){
+    std::string s;
+    QString low=text.toLower();
+    for (int i=0;i<low.size();i++){
+        QChar ch=low[i];
+        if (ch.isLetterOrNumber()) s+=QString(ch).toUtf8().constData();
+    }
+    return s;
+}
+
+static inline uint32_t SubsIndexTrigram(const std::string &s,size_t i){
+    return ((uint32_t)(unsigned char)s[i]<<16)|((uint32_t)(unsigned char)s[i+1]<<8)|(unsigned char)s[i+2];
+}
+
+static void SubsIndexAddKey(SubsIndex *index,int entry,const QString &text){
+    std::string key=SubsIndexNormalize(text);
+    if (key.empty()) return;
+    SubsIndexEntry *e=&index->entries[entry];
+    for (int k=e->firstKey;k<e->firstKey+e->nKeys;k++) if (index->keys[k]==key) return;
+    index->keys.push_back(key);
+    index->keyEntry.push_back(entry);
+    e->nKeys++;
+    for (size_t i=0;i+3<=key.size();i++){
+        std::vector<int> &post=index->trigrams[SubsIndexTrigram(key,i)];
+        if (post.empty()||(post.back()!=entry)) post.push_back(entry);
+    }
+}
+
+//Builds the index from the database. Returns the number of products
+int SubsIndexBuild(QSqlDatabase *db,SubsIndex *index){
+    QSqlQuery query(*db);
+    QSqlRecord fields=db->record("Products");
+    QString select="SELECT Id,Name,MW";
+    bool hasCAS=fields.contains("CAS"),hasFormula=fields.contains("Formula");
+    if (hasCAS) select+=",CAS";
+    if (hasFormula) select+=",Formula";
+    index->entries.clear();
+    index->keys.clear();
+    index->keyEntry.clear();
+    index->sortedKeys.clear();
+    index->trigrams.clear();
+    index->byId.clear();
+    query.setForwardOnly(true);
+    FF_PERF_SQL(query.exec(select+" FROM Products ORDER BY Name"));
+    while (query.next()){
+        SubsIndexEntry e;
+        e.id=query.value(0).toInt();
+        e.name=query.value(1).toString();
+        e.MW=query.value(2).toDouble();
+        e.firstKey=index->keys.size();
+        e.nKeys=0;
+        int entry=index->entries.size();
+        index->entries.push_back(e);
+        index->byId[e.id]=entry;
+        SubsIndexAddKey(index,entry,e.name);
+        if (hasCAS) SubsIndexAddKey(index,entry,query.value(3).toString());
+        if (hasFormula) SubsIndexAddKey(index,entry,query.value(hasCAS ? 4 : 3).toString());
+    }
+    //synonyms, if the database has them. They are added as keys of their product, after all the other keys
+    QSqlRecord synFields=db->record("Synonyms");
+    if (synFields.contains("IdProduct")&&(synFields.contains("Synonym")||synFields.contains("Name"))){
+        std::vector<std::vector<QString> > synonyms(index->entries.size());
+        FF_PERF_SQL(query.exec(QString("SELECT IdProduct,")+(synFields.contains("Synonym") ? "Synonym" : "Name")+" FROM Synonyms"));
+        while (query.next()){
+            std::unordered_map<int,int>::const_iterator it=index->byId.find(query.value(0).toInt());
+            if (it!=index->byId.end()) synonyms[it->second].push_back(query.value(1).toString());
+        }
+        //the keys of each entry must be contiguous, so they are rebuilt entry by entry
+        std::vector<std::string> oldKeys;
+        oldKeys.swap(index->keys);
+        index->keyEntry.clear();
+        index->trigrams.clear();
+        for (size_t i=0;i<index->entries.size();i++){
+            SubsIndexEntry *e=&index->entries[i];
+            int first=e->firstKey,n=e->nKeys;
+            e->firstKey=index->keys.size();
+            e->nKeys=0;
+            for (int k=first;k<first+n;k++) SubsIndexAddKey(index,i,QString::fromUtf8(oldKeys[k].c_str()));
+            for (size_t k=0;k<synonyms[i].size();k++) SubsIndexAddKey(index,i,synonyms[i][k]);
+        }
+    }
+    index->sortedKeys.resize(index->keys.size());
+    for (size_t k=0;k<index->keys.size();k++) index->sortedKeys[k]=k;
+    const std::vector<std::string> &keys=index->keys;
+    std::sort(index->sortedKeys.begin(),index->sortedKeys.end(),[&keys](int a,int b){return keys[a]<keys[b];});
+    return index->entries.size();
+}
+
+//Finds up to maxResults entries matching the text. Entries with a key starting with the text go first, then the ones
+//containing it, each group in name order. Returns the number of entries found
+int SubsIndexFind(const SubsIndex *index,const QString &text,int maxResults,std::vector<int> *found){
+    std::string q=SubsIndexNormalize(text);
+    std::vector<int> prefix,contain;
+    size_t k;
+    found->clear();
+    if (q.empty()) return 0;
+    //prefix matches, from the sorted keys
+    std::vector<int>::const_iterator it=std::lower_bound(index->sortedKeys.begin(),index->sortedKeys.end(),q,
+                                                          [index](int a,const std::string &b){return index->keys[a]<b;});
+    for (;it!=index->sortedKeys.end();++it){
+        const std::string &key=index->keys[*it];
+        if (key.compare(0,q.size(),q)!=0) break;
+        prefix.push_back(index->keyEntry[*it]);
+    }
+    std::sort(prefix.begin(),prefix.end());
+    prefix.erase(std::unique(prefix.begin(),prefix.end()),prefix.end());
+    //substring matches, intersecting the trigram posting lists, from the shortest one
+    if ((q.size()>=3)&&((int)prefix.size()<maxResults)){
+        std::vector<const std::vector<int>*> lists;
+        for (k=0;k+3<=q.size();k++){
+            std::unordered_map<uint32_t,std::vector<int> >::const_iterator t=index->trigrams.find(SubsIndexTrigram(q,k));
+            if (t==index->trigrams.end()){
+                lists.clear();
+                break;
+            }
+            lists.push_back(&t->second);
+        }
+        if (!lists.empty()){
+            std::sort(lists.begin(),lists.end(),[](const std::vector<int> *a,const std::vector<int> *b){return a->size()<b->size();});
+            std::vector<int> cand=*lists[0],next;
+            for (k=1;(k<lists.size())&&!cand.empty();k++){
+                next.clear();
+                std::set_intersection(cand.begin(),cand.end(),lists[k]->begin(),lists[k]->end(),std::back_inserter(next));
+                cand.swap(next);
+            }
+            for (k=0;(k<cand.size())&&((int)(prefix.size()+contain.size())<maxResults);k++){
+                const SubsIndexEntry *e=&index->entries[cand[k]];
+                bool match=false;
+                for (int j=e->firstKey;(j<e->firstKey+e->nKeys)&&!match;j++) match=(index->keys[j].find(q)!=std::string::npos);
+                if (match&&!std::binary_search(prefix.begin(),prefix.end(),cand[k])) contain.push_back(cand[k]);
+            }
+        }
+    }
+    for (k=0;(k<prefix.size())&&((int)found->size()<maxResults);k++) found->push_back(prefix[k]);
+    for (k=0;(k<contain.size())&&((int)found->size()<maxResults);k++) found->push_back(contain[k]);
+    return found->size();
+}
+
+//Entry of a product id, -1 if not present
+int SubsIndexEntryOfId(const SubsIndex *index,int id){
+    std::unordered_map<int,int>::const_iterator it=index->byId.find(id);
+    return (it==index->byId.end()) ? -1 : it->second;
+}
+
+SubsListModel::SubsListModel(const SubsIndex *index,QObject *parent) : QAbstractTableModel(parent),index(index),fetched(0){
+}
+
+int SubsListModel::rowCount(const QModelIndex &parent) const{
+    return parent.isValid() ? 0 : fetched;
+}
+
+int SubsListModel::columnCount(const QModelIndex &parent) const{
+    return parent.isValid() ? 0 : 3;
+}
+
+QVariant SubsListModel::data(const QModelIndex &idx,int role) const{
+    if (!idx.isValid()||(idx.row()>=fetched)||((role!=Qt::DisplayRole)&&(role!=Qt::EditRole))) return QVariant();
+    const SubsIndexEntry *e=&index->entries[idx.row()];
+    switch (idx.column()){
+    case 0: return e->id;
+    case 1: return e->name;
+    case 2: return e->MW;
+    }
+    return QVariant();
+}
+
+QVariant SubsListModel::headerData(int section,Qt::Orientation orientation,int role) const{
+    static const char *names[3]={"Id","Name","MW"};
+    if ((orientation==Qt::Horizontal)&&(role==Qt::DisplayRole)&&(section>=0)&&(section<3)) return QString(names[section]);
+    return QAbstractTableModel::headerData(section,orientation,role);
+}
+
+bool SubsListModel::canFetchMore(const QModelIndex &parent) const{
+    return !parent.isValid()&&(fetched<(int)index->entries.size());
+}
+
+void SubsListModel::fetchMore(const QModelIndex &parent){
+    if (parent.isValid()) return;
+    int n=std::min(SUBS_LIST_PAGE,(int)index->entries.size()-fetched);
+    if (n<=0) return;
+    beginInsertRows(QModelIndex(),fetched,fetched+n-1);
+    fetched+=n;
+    endInsertRows();
+}
+
+//Makes the row available
+void SubsListModel::ensureFetched(int row){
+    if ((row<fetched)||(row>=(int)index->entries.size())) return;
+    int n=std::min(row+SUBS_LIST_PAGE,(int)index->entries.size())-fetched;
+    beginInsertRows(QModelIndex(),fetched,fetched+n-1);
+    fetched+=n;
+    endInsertRows();
+}
+
+//Call after rebuilding the index
+void SubsListModel::reset(){
+    beginResetModel();
+    fetched=std::min(SUBS_LIST_PAGE,(int)index->entries.size());
+    endResetModel();
+}
+
+int SubsListModel::id(int row) const{
+    return ((row>=0)&&(row<(int)index->entries.size())) ? index->entries[row].id : 0;
+}
+
+QString SubsListModel::name(int row) const{
+    return ((row>=0)&&(row<(int)index->entries.size())) ? index->entries[row].name : QString();
+}
+
+double SubsListModel::MW(int row) const{
+    return ((row>=0)&&(row<(int)index->entries.size())) ? index->entries[row].MW : 0;
+}
+
+SubsMatchModel::SubsMatchModel(QObject *parent) : QAbstractListModel(parent){
+}
+
+int SubsMatchModel::rowCount(const QModelIndex &parent) const{
+    return parent.isValid() ? 0 : ids.size();
+}
+
+QVariant SubsMatchModel::data(const QModelIndex &idx,int role) const{
+    if (!idx.isValid()||(idx.row()>=(int)ids.size())) return QVariant();
+    if ((role==Qt::DisplayRole)||(role==Qt::EditRole)) return names[idx.row()];
+    if (role==Qt::UserRole) return ids[idx.row()];
+    return QVariant();
+}
+
+void SubsMatchModel::setMatches(const SubsIndex *index,const std::vector<int> &found){
+    beginResetModel();
+    ids.resize(found.size());
+    names.resize(found.size());
+    for (size_t k=0;k<found.size();k++){
+        ids[k]=index->entries[found[k]].id;
+        names[k]=index->entries[found[k]].name;
+    }
+    endResetModel();
+}
@@ -0,0 +1,256 @@
+/*
+ * unifackernel.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "unifackernel.h"
+#include "perfcounters.h"
+
+#include <math.h>
+#include <string.h>
+
+//Database columns and tables of each UNIFAC variant
+typedef struct{
+    const char *subgroup,*group,*Rk,*Qk,*interaction;
+    int hasBC;//interaction with temperature dependence
+} UnifacKernelColumns;
+
+static int UnifacKernelGetColumns(enum FF_ActModel model,UnifacKernelColumns *col,double *rExp){
+    *rExp=1;
+    switch(model){
+    case FF_UNIFACStd:
+        *col={"SubgroupVL","GroupVL","Rk","Qk","UnifacStInteraction",0};
+        break;
+    case FF_UNIFACPSRK:
+        *col={"SubgroupPSRK","GroupPSRK","RkPSRK","QkPSRK","UnifacPSRKInteraction",1};
+        break;
+    case FF_UNIFACDort:
+        *col={"SubgroupDortmund","GroupDortmund","RkDortmund","QkDortmund","UnifacDortInteraction",1};
+        *rExp=0.75;
+        break;
+    case FF_UNIFACNist:
+        *col={"SubgroupNist","GroupNist","RkNist","QkNist","UnifacNistInteraction",1};
+        *rExp=0.75;
+        break;
+    default:
+        return 0;
+    }
+    return 1;
+}
+
+//Source of the parameters: the binary store if it is open, if not the database
+typedef struct{
+    enum FF_ActModel model;
+    const UnifacStore *store;
+    UnifacKernelColumns col;
+    QSqlQuery *subgQuery,*interQuery;
+} UnifacKernelSource;
+
+static int UnifacKernelSourceSubgroup(UnifacKernelSource *src,int subgroup,int *group,double *Rk,double *Qk){
+    if(src->store!=NULL) return UnifacStoreGetSubgroup(src->store,src->model,subgroup,group,Rk,Qk);
+    src->subgQuery->addBindValue(subgroup);
+    FF_PERF_SQL(src->subgQuery->exec());
+    if(!src->subgQuery->next()) return 0;
+    if(src->subgQuery->value(2).isNull()) return 0;
+    *group=src->subgQuery->value(0).toInt();
+    *Rk=src->subgQuery->value(1).toDouble();
+    *Qk=src->subgQuery->value(2).toDouble();
+    return 1;
+}
+
+//Interaction a(i,j)=A+B*T+C*T^2 between main groups i and j
+static int UnifacKernelSourceInteraction(UnifacKernelSource *src,int i,int j,double *A,double *B,double *C){
+    QSqlQuery *query=src->interQuery;
+    if(src->store!=NULL) return UnifacStoreGetInteraction(src->store,src->model,i,j,A,B,C);
+    query->addBindValue(i);
+    query->addBindValue(j);
+    query->addBindValue(j);
+    query->addBindValue(i);
+    FF_PERF_SQL(query->exec());
+    if(!query->next()) return 0;
+    const char *a="Aij",*b="Bij",*c="Cij";
+    if(query->value(query->record().indexOf("i")).toInt()!=i) a="Aji",b="Bji",c="Cji";
+    *A=query->value(query->record().indexOf(a)).toDouble();
+    *B=*C=0;
+    if(src->col.hasBC==1){
+        *B=query->value(query->record().indexOf(b)).toDouble();
+        *C=query->value(query->record().indexOf(c)).toDouble();
+    }
+    return 1;
+}
+
+//Subgroup composition of a substance for the UNIFAC variant
+static int (*UnifacKernelComposition(enum FF_ActModel model,FF_SubstanceData *subs))[2]{
+    switch(model){
+    case FF_UNIFACStd: return subs->UnifStdSubg;
+    case FF_UNIFACPSRK: return subs->UnifPSRKSubg;
+    case FF_UNIFACDort: return subs->UnifDortSubg;
+    default: return subs->UnifNistSubg;
+    }
+}
+
+//Builds the kernel for the substances and the UNIFAC variant, reading the subgroups and interactions from the binary
+//store if it is open, or from the database if not.
+//Returns 0 if the model is not a UNIFAC one, a subgroup is not found, or there are too many subgroups
+int UnifacKernelBuild(enum FF_ActModel model,int numSubs,FF_SubstanceData *subs[],const UnifacStore *store,QSqlDatabase *db,UnifacKernel *ker){
+    int i,j,k,m,n;
+    UnifacKernelSource src;
+    memset(ker,0,sizeof(UnifacKernel));
+    if((numSubs<1)||(numSubs>15)) return 0;
+    if(UnifacKernelGetColumns(model,&src.col,&ker->rExp)==0) return 0;
+    src.model=model;
+    src.store=((store!=NULL)&&(store->base!=NULL)) ? store : NULL;
+    //subgroups present and their occurrence
+    for(i=0;i<numSubs;i++){
+        int (*comp)[2]=UnifacKernelComposition(model,subs[i]);
+        for(j=0;j<20;j++){
+            if(comp[j][0]<=0) break;
+            for(k=0;k<ker->nSg;k++) if(ker->subg[k]==comp[j][0]) break;
+            if(k==ker->nSg){
+                if(ker->nSg==UK_MAXSG) return 0;
+                ker->subg[k]=comp[j][0];
+                ker->nSg++;
+            }
+            ker->nu[k][i]+=comp[j][1];
+        }
+    }
+    if(ker->nSg==0) return 0;
+    QSqlQuery subgQuery(*db),interQuery(*db);
+    if(src.store==NULL){
+        subgQuery.prepare(QString("SELECT ")+src.col.group+","+src.col.Rk+","+src.col.Qk+" FROM UnifacSubgroups WHERE ("+src.col.subgroup+"=?)");
+        interQuery.prepare(QString("SELECT * FROM ")+src.col.interaction+" WHERE (i=? AND j=?) OR (i=? AND j=?)");
+    }
+    src.subgQuery=&subgQuery;
+    src.interQuery=&interQuery;
+    for(k=0;k<ker->nSg;k++){
+        if(UnifacKernelSourceSubgroup(&src,ker->subg[k],&ker->group[k],&ker->Rk[k],&ker->Qk[k])==0) return 0;
+    }
+    for(i=0;i<numSubs;i++){
+        for(k=0;k<ker->nSg;k++){
+            ker->r[i]+=ker->nu[k][i]*ker->Rk[k];
+            ker->q[i]+=ker->nu[k][i]*ker->Qk[k];
+        }
+        ker->rP[i]=pow(ker->r[i],ker->rExp);
+    }
+    //interactions between main groups, copied to every pair of their subgroups
+    for(m=0;m<ker->nSg;m++) for(n=0;n<ker->nSg;n++){
+        if(ker->group[m]==ker->group[n]) continue;
+        for(k=0;k<m;k++) if((ker->group[k]==ker->group[m])) break;//already done with a previous subgroup of the same main group
+        for(j=0;j<n;j++) if((ker->group[j]==ker->group[n])) break;
+        if((k<m)||(j<n)){
+            ker->A[m][n]=ker->A[k][j];
+            ker->B[m][n]=ker->B[k][j];
+            ker->C[m][n]=ker->C[k][j];
+        }
+        else if(UnifacKernelSourceInteraction(&src,ker->group[m],ker->group[n],&ker->A[m][n],&ker->B[m][n],&ker->C[m][n])==0){
+            if(ker->group[m]<ker->group[n]) ker->missing++;
+        }
+    }
+    ker->model=model;
+    ker->nSubs=numSubs;
+    ker->T=0;
+    return 1;
+}
+
+//Residual ln(Gamma) of the subgroups, from the subgroup fractions X. Only the subgroups with X>0 contribute to theta
+static void UnifacKernelGroups(const UnifacKernel *ker,const double X[],double lnGammaK[]){
+    int k,m,nSg=ker->nSg;
+    double theta[UK_MAXSG],S[UK_MAXSG],t[UK_MAXSG],sum=0;
+    for(m=0;m<nSg;m++){
+        theta[m]=ker->Qk[m]*X[m];
+        sum+=theta[m];
+        S[m]=0;
+    }
+    for(m=0;m<nSg;m++) theta[m]=theta[m]/sum;
+    //S(k)=sum(theta(m)*Psi(m,k))
+    for(m=0;m<nSg;m++){
+        if(theta[m]==0) continue;
+        for(k=0;k<nSg;k++) S[k]+=theta[m]*ker->Psi[m][k];
+    }
+    for(m=0;m<nSg;m++) t[m]=theta[m]/S[m];
+    //ln(Gamma(k))=Q(k)*(1-ln(S(k))-sum(Psi(k,m)*theta(m)/S(m)))
+    for(k=0;k<nSg;k++){
+        double dot=0;
+        for(m=0;m<nSg;m++) dot+=ker->Psi[k][m]*t[m];
+        lnGammaK[k]=ker->Qk[k]*(1-log(S[k])-dot);
+    }
+}
+
+//Calculates Psi and the pure substance residual terms. Does nothing if T has not changed
+void UnifacKernelSetT(UnifacKernel *ker,double T){
+    int i,m,n;
+    double X[UK_MAXSG],sum;
+    if(T==ker->T) return;
+    for(m=0;m<ker->nSg;m++) for(n=0;n<ker->nSg;n++){
+        ker->Psi[m][n]=exp(-(ker->A[m][n]+ker->B[m][n]*T+ker->C[m][n]*T*T)/T);
+    }
+    ker->T=T;
+    for(i=0;i<ker->nSubs;i++){
+        sum=0;
+        for(m=0;m<ker->nSg;m++) sum+=ker->nu[m][i];
+        for(m=0;m<ker->nSg;m++) X[m]=ker->nu[m][i]/sum;
+        UnifacKernelGroups(ker,X,ker->lnGammaPure[i]);
+    }
+}
+
+//Natural logarithm of the activity coefficients, combinatorial and residual parts
+void UnifacKernelLnGamma(const UnifacKernel *ker,const double x[],double lnGammaC[],double lnGammaR[]){
+    int i,m,nSubs=ker->nSubs,nSg=ker->nSg;
+    double sR=0,sRP=0,sQ=0,sNu=0,X[UK_MAXSG],lnGammaK[UK_MAXSG];
+    for(i=0;i<nSubs;i++){
+        sR+=x[i]*ker->r[i];
+        sRP+=x[i]*ker->rP[i];
+        sQ+=x[i]*ker->q[i];
+    }
+    for(i=0;i<nSubs;i++){
+        double V=ker->r[i]/sR,VP=ker->rP[i]/sRP,F=ker->q[i]/sQ;
+        lnGammaC[i]=1-VP+log(VP)-5*ker->q[i]*(1-V/F+log(V/F));
+    }
+    for(m=0;m<nSg;m++){
+        X[m]=0;
+        for(i=0;i<nSubs;i++) X[m]+=ker->nu[m][i]*x[i];
+        sNu+=X[m];
+    }
+    for(m=0;m<nSg;m++) X[m]=X[m]/sNu;
+    UnifacKernelGroups(ker,X,lnGammaK);
+    for(i=0;i<nSubs;i++){
+        lnGammaR[i]=0;
+        for(m=0;m<nSg;m++) if(ker->nu[m][i]>0) lnGammaR[i]+=ker->nu[m][i]*(lnGammaK[m]-ker->lnGammaPure[i][m]);
+    }
+}
+
+//Compares the kernel with FF_ActivityDerivatives, setting it at T. Returns the maximum absolute difference in ln(gamma)
+double UnifacKernelCheck(FF_MixData *mix,UnifacKernel *ker,double T,const double x[]){
+    int i;
+    double c[15],lnGammaC[15],lnGammaR[15],diff,maxDiff=0;
+    FF_SubsActivityData actData[15];
+    FF_ExcessData excData;
+    for(i=0;i<ker->nSubs;i++) c[i]=x[i];
+    UnifacKernelSetT(ker,T);
+    UnifacKernelLnGamma(ker,c,lnGammaC,lnGammaR);
+    FF_ActivityDerivatives(&mix->actModel,&mix->numSubs,mix->baseProp,mix->intParam,&mix->intForm,&T,c,actData,&excData);
+    for(i=0;i<ker->nSubs;i++){
+        diff=fabs(lnGammaC[i]+lnGammaR[i]-(actData[i].lnGammaC+actData[i].lnGammaR+actData[i].lnGammaSG));
+        if(diff>maxDiff) maxDiff=diff;
+    }
+    return maxDiff;
+}
@@ -0,0 +1,155 @@
+/*
+ * unifacstore.cpp
+ *
+ *  Created on: 19/10/2026
+ *      Author: Carlos Trujillo
+ *
+ *This file is part of the "Free Fluids" application
+ *Copyright (C) 2008-2026  Carlos Trujillo Gonzalez
+
+ *This program is free software; you can redistribute it and/or
+ *modify it under the terms of the GNU General Public License version 3
+ *as published by the Free Software Foundation
+
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+
+ *You should have received a copy of the GNU General Public License
+ *along with this program; if not, write to the Free Software
+ *Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+
+#include "unifacstore.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+#define UNIFAC_STORE_FILE "UnifacParam.ffu"
+
+//Position of the variant in the store
+static int UnifacStoreVariantIndex(enum FF_ActModel model){
+    switch(model){
+    case FF_UNIFACStd: return 0;
+    case FF_UNIFACPSRK: return 1;
+    case FF_UNIFACDort: return 2;
+    case FF_UNIFACNist: return 3;
+    default: return -1;
+    }
+}
+
+//Checks that a table lies inside the file
+static int UnifacStoreInside(const UnifacStore *store,int64_t offset,int64_t bytes){
+    return (offset>=(int64_t)sizeof(UnifacStoreHeader))&&(bytes>=0)&&(offset+bytes<=store->size)&&(offset%8==0);
+}
+
+//Size and modification time of the database file, as kept in the store header. Returns 0 if it is not a file
+int UnifacStoreFingerprint(const QString &dbFile,int64_t *dbSize,int64_t *dbTime){
+    *dbSize=*dbTime=0;
+    if(dbFile.isEmpty()) return 0;
+    QFileInfo info(dbFile);
+    if(!info.isFile()) return 0;
+    *dbSize=info.size();
+    *dbTime=info.lastModified().toMSecsSinceEpoch();
+    return 1;
+}
+
+//Path of the store for the database file: in the same directory, or in the application one if it is not a file
+QString UnifacStorePath(const QString &dbFile){
+    QFileInfo info(dbFile);
+    if((!dbFile.isEmpty())&&info.isFile()) return info.absoluteDir().filePath(UNIFAC_STORE_FILE);
+    return QDir(QCoreApplication::applicationDirPath()).filePath(UNIFAC_STORE_FILE);
+}
+
+//Opens and maps the store file. If dbFile is not empty, the store must have been generated from that database file as
+//it is now. Returns 0 if the file does not exist, is not a valid store, or does not match the database
+int UnifacStoreOpen(const QString &fileName,const QString &dbFile,UnifacStore *store){
+    int k;
+    const UnifacStoreHeader *h;
+    store->file=new QFile(fileName);
+    store->base=NULL;
+    store->size=0;
+    store->dbFile=dbFile;
+    if(store->file->open(QIODevice::ReadOnly)){
+        store->size=store->file->size();
+        if(store->size>=(qint64)sizeof(UnifacStoreHeader)) store->base=store->file->map(0,store->size);
+    }
+    if(store->base==NULL){
+        UnifacStoreClose(store);
+        return 0;
+    }
+    h=(const UnifacStoreHeader*)store->base;
+    if((h->magic!=UNIFAC_STORE_MAGIC)||(h->version!=UNIFAC_STORE_VERSION)||(h->nVariants!=UNIFAC_STORE_VARIANTS)||
+            (UnifacStoreCurrent(store)==0)){
+        UnifacStoreClose(store);
+        return 0;
+    }
+    for(k=0;k<UNIFAC_STORE_VARIANTS;k++){
+        const UnifacStoreVariant *v=&h->variant[k];
+        int64_t nIndex=(int64_t)(v->maxGroup+1)*(v->maxGroup+1);
+        if((v->maxSubgroup<0)||(v->maxGroup<0)||(v->nInteractions<0)||
+                !UnifacStoreInside(store,v->subgroupOffset,(v->maxSubgroup+1)*(int64_t)sizeof(UnifacStoreSubgroup))||
+                !UnifacStoreInside(store,v->indexOffset,nIndex*(int64_t)sizeof(int32_t))||
+                !UnifacStoreInside(store,v->interactionOffset,v->nInteractions*(int64_t)sizeof(UnifacStoreInteraction))){
+            UnifacStoreClose(store);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+//Returns 1 if the store is open and its database file has not changed since the store was generated
+int UnifacStoreCurrent(const UnifacStore *store){
+    int64_t dbSize,dbTime;
+    if(store->base==NULL) return 0;
+    if(store->dbFile.isEmpty()) return 1;
+    const UnifacStoreHeader *h=(const UnifacStoreHeader*)store->base;
+    if(UnifacStoreFingerprint(store->dbFile,&dbSize,&dbTime)==0) return 0;
+    return (h->dbSize==dbSize)&&(h->dbTime==dbTime);
+}
+
+//Unmaps and closes the store
+void UnifacStoreClose(UnifacStore *store){
+    if(store->file!=NULL){
+        if(store->base!=NULL) store->file->unmap((uchar*)store->base);
+        store->file->close();
+        delete store->file;
+    }
+    store->file=NULL;
+    store->base=NULL;
+    store->size=0;
+    store->dbFile.clear();
+}
+
+//Main group, Rk and Qk of a subgroup for the UNIFAC variant. Returns 0 if not available
+int UnifacStoreGetSubgroup(const UnifacStore *store,enum FF_ActModel model,int subgroup,int *group,double *Rk,double *Qk){
+    int k=UnifacStoreVariantIndex(model);
+    if((store->base==NULL)||(k<0)) return 0;
+    const UnifacStoreVariant *v=&((const UnifacStoreHeader*)store->base)->variant[k];
+    if((subgroup<1)||(subgroup>v->maxSubgroup)) return 0;
+    const UnifacStoreSubgroup *s=(const UnifacStoreSubgroup*)(store->base+v->subgroupOffset)+subgroup;
+    if(s->group<=0) return 0;
+    *group=s->group;
+    *Rk=s->Rk;
+    *Qk=s->Qk;
+    return 1;
+}
+
+//Interaction parameters between main groups i and j for the UNIFAC variant. Returns 0 if not available
+int UnifacStoreGetInteraction(const UnifacStore *store,enum FF_ActModel model,int i,int j,double *A,double *B,double *C){
+    int k=UnifacStoreVariantIndex(model);
+    if((store->base==NULL)||(k<0)) return 0;
+    const UnifacStoreVariant *v=&((const UnifacStoreHeader*)store->base)->variant[k];
+    if((i<1)||(j<1)||(i>v->maxGroup)||(j>v->maxGroup)) return 0;
+    int32_t pos=((const int32_t*)(store->base+v->indexOffset))[i*(v->maxGroup+1)+j];
+    if((pos<0)||(pos>=v->nInteractions)) return 0;
+    const UnifacStoreInteraction *inter=(const UnifacStoreInteraction*)(store->base+v->interactionOffset)+pos;
+    *A=inter->A;
+    *B=inter->B;
+    *C=inter->C;
+    return 1;
+}